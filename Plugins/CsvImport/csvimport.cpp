@@ -34,9 +34,12 @@ bool CsvImport::beforeImport(const ImportManager::StandardImportConfig& config)
 
     stream = new QTextStream(file);
     stream->setCodec(config.codec.toLatin1().data());
+    deserializer = new CsvDeserializer(stream, csvFormat);
+    pendingEntries.clear();
 
     if (!extractColumns())
     {
+        safe_delete(deserializer);
         safe_delete(stream);
         safe_delete(file);
         return false;
@@ -47,15 +50,17 @@ bool CsvImport::beforeImport(const ImportManager::StandardImportConfig& config)
 
 void CsvImport::afterImport()
 {
+    pendingEntries.clear();
+    safe_delete(deserializer);
     safe_delete(stream);
     safe_delete(file);
 }
 
 bool CsvImport::extractColumns()
 {
-    QStringList deserializedEntry = CsvSerializer::deserializeOneEntry(*stream, csvFormat);
-    while (deserializedEntry.isEmpty() && !stream->atEnd())
-        deserializedEntry = CsvSerializer::deserializeOneEntry(*stream, csvFormat);
+    QStringList deserializedEntry = deserializer->nextRow();
+    while (deserializedEntry.isEmpty() && !deserializer->atEnd())
+        deserializedEntry = deserializer->nextRow();
 
     if (deserializedEntry.isEmpty())
     {
@@ -74,7 +79,7 @@ bool CsvImport::extractColumns()
         for (int i = 1, total = deserializedEntry.size(); i <= total; ++i)
             columnNames << colTmp.arg(i);
 
-        stream->seek(0);
+        deserializer->rewind();
     }
 
     return true;
@@ -118,12 +123,15 @@ QList<ImportPlugin::ColumnDefinition> CsvImport::getColumns() const
 
 QList<QVariant> CsvImport::next()
 {
-    QStringList deserializedEntry = CsvSerializer::deserializeOneEntry(*stream, csvFormat);
+    if (pendingEntries.isEmpty())
+        pendingEntries = deserializer->nextBatch(BATCH_SIZE);
 
     QList<QVariant> values;
-    if (deserializedEntry.isEmpty())
+    if (pendingEntries.isEmpty())
         return values;
 
+    QStringList deserializedEntry = pendingEntries.takeFirst();
+
     if (cfg.CsvImport.NullValues.get())
     {
         QString nullVal = cfg.CsvImport.NullValueString.get();
@@ -6,6 +6,7 @@
 #include "plugins/genericplugin.h"
 #include "config_builder.h"
 #include "csvserializer.h"
+#include "csvdeserializer.h"
 
 CFG_CATEGORIES(CsvImportConfig,
      CFG_CATEGORY(CsvImport,
@@ -45,8 +46,16 @@ class CSVIMPORTSHARED_EXPORT CsvImport : public GenericPlugin, public ImportPlug
         bool extractColumns();
         void defineCsvFormat();
 
+        static const int BATCH_SIZE = 1000;
+
         QFile* file = nullptr;
         QTextStream* stream = nullptr;
+        CsvDeserializer* deserializer = nullptr;
+
+        /**
+         * @brief Entries already parsed, but not yet returned by next().
+         */
+        QList<QStringList> pendingEntries;
         QStringList columnNames;
         CsvFormat csvFormat;
         CFG_LOCAL(CsvImportConfig, cfg)
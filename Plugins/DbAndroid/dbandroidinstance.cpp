@@ -43,11 +43,12 @@ bool DbAndroidInstance::deregisterFunction(const QString& name, int argCount)
     return true;
 }
 
-bool DbAndroidInstance::registerScalarFunction(const QString& name, int argCount)
+bool DbAndroidInstance::registerScalarFunction(const QString& name, int argCount, bool deterministic)
 {
     // Unsupported by native Android driver
     UNUSED(name);
     UNUSED(argCount);
+    UNUSED(deterministic);
     return true;
 }
 
@@ -112,6 +113,17 @@ bool DbAndroidInstance::closeInternal()
     return true;
 }
 
+QIODevice* DbAndroidInstance::openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, QIODevice::OpenMode mode)
+{
+    // Unsupported by native Android driver
+    UNUSED(database);
+    UNUSED(table);
+    UNUSED(column);
+    UNUSED(rowId);
+    UNUSED(mode);
+    return nullptr;
+}
+
 bool DbAndroidInstance::registerCollationInternal(const QString& name)
 {
     // Unsupported by native Android driver
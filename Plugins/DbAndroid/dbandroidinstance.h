@@ -22,9 +22,10 @@ class DbAndroidInstance : public AbstractDb
         SqlQueryPtr prepare(const QString& query);
         QString getTypeLabel();
         bool deregisterFunction(const QString& name, int argCount);
-        bool registerScalarFunction(const QString& name, int argCount);
+        bool registerScalarFunction(const QString& name, int argCount, bool deterministic);
         bool registerAggregateFunction(const QString& name, int argCount);
         bool initAfterCreated();
+        QIODevice* openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, QIODevice::OpenMode mode);
 
     protected:
         bool isOpenInternal();
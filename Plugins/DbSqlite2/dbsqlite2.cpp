@@ -26,3 +26,19 @@ bool DbSqlite2::checkIfDbServedByPlugin(Db* db) const
 {
     return (db && dynamic_cast<DbSqlite2Instance*>(db));
 }
+
+DbPluginStdFileBase::FormatSupport DbSqlite2::getFormatSupport(DbPluginStdFileBase::FileFormat format) const
+{
+    switch (format)
+    {
+        case FileFormat::SQLITE2:
+            return FormatSupport::YES;
+        case FileFormat::SQLITE3:
+        case FileFormat::OTHER:
+            return FormatSupport::NO;
+        case FileFormat::UNKNOWN:
+        case FileFormat::EMPTY:
+            break;
+    }
+    return FormatSupport::PROBE;
+}
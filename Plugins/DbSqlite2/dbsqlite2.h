@@ -19,6 +19,7 @@ class DBSQLITE2SHARED_EXPORT DbSqlite2 : public GenericPlugin, public DbPluginSt
 
     protected:
         Db *newInstance(const QString &name, const QString &path, const QHash<QString, QVariant> &options);
+        FormatSupport getFormatSupport(FileFormat format) const;
 };
 
 #endif // DBSQLITE2_H
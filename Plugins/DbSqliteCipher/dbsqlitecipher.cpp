@@ -112,3 +112,11 @@ Db *DbSqliteCipher::newInstance(const QString &name, const QString &path, const
 {
     return new DbSqliteCipherInstance(name, path, options);
 }
+
+DbPluginStdFileBase::FormatSupport DbSqliteCipher::getFormatSupport(DbPluginStdFileBase::FileFormat format) const
+{
+    if (format == FileFormat::SQLITE2)
+        return FormatSupport::NO;
+
+    return FormatSupport::PROBE;
+}
@@ -30,6 +30,7 @@ class DBSQLITECIPHERSHARED_EXPORT DbSqliteCipher : public GenericPlugin, public
 
     protected:
         Db *newInstance(const QString &name, const QString &path, const QHash<QString, QVariant> &options);
+        FormatSupport getFormatSupport(FileFormat format) const;
 
     private:
         bool initValid = false;
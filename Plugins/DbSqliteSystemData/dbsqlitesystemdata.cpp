@@ -34,3 +34,11 @@ Db *DbSqliteSystemData::newInstance(const QString &name, const QString &path, co
 {
     return new DbSqliteSystemDataInstance(name, path, options);
 }
+
+DbPluginStdFileBase::FormatSupport DbSqliteSystemData::getFormatSupport(DbPluginStdFileBase::FileFormat format) const
+{
+    if (format == FileFormat::SQLITE2)
+        return FormatSupport::NO;
+
+    return FormatSupport::PROBE;
+}
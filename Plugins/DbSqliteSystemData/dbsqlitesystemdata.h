@@ -21,6 +21,7 @@ class DbSqliteSystemData : public GenericPlugin, public DbPluginStdFileBase
 
     protected:
         Db *newInstance(const QString &name, const QString &path, const QHash<QString, QVariant> &options);
+        FormatSupport getFormatSupport(FileFormat format) const;
 };
 
 #endif // DBSQLITEWX_H
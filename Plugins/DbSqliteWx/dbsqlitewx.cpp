@@ -34,3 +34,11 @@ Db *DbSqliteWx::newInstance(const QString &name, const QString &path, const QHas
 {
     return new DbSqliteWxInstance(name, path, options);
 }
+
+DbPluginStdFileBase::FormatSupport DbSqliteWx::getFormatSupport(DbPluginStdFileBase::FileFormat format) const
+{
+    if (format == FileFormat::SQLITE2)
+        return FormatSupport::NO;
+
+    return FormatSupport::PROBE;
+}
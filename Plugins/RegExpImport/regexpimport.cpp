@@ -43,7 +43,7 @@ bool RegExpImport::beforeImport(const ImportManager::StandardImportConfig& confi
     safe_delete(file);
     safe_delete(stream);
     groups.clear();
-    buffer.clear();
+    resetBuffers();
     columns.clear();
 
 
@@ -100,7 +100,7 @@ void RegExpImport::afterImport()
     safe_delete(re);
     safe_delete(file);
     safe_delete(stream);
-    buffer.clear();
+    resetBuffers();
     groups.clear();
 }
 
@@ -115,17 +115,28 @@ QList<ImportPlugin::ColumnDefinition> RegExpImport::getColumns() const
 
 QList<QVariant> RegExpImport::next()
 {
-    QRegularExpressionMatch match = re->match(buffer);
+    // Lines are appended one by one until the record matches, just like the whole text was matched again after each line,
+    // but thanks to partial matching each attempt starts from the earliest position where a match can still begin.
+    QRegularExpressionMatch match;
     QString line;
-    while (!match.hasMatch() && !(line = stream->readLine()).isNull())
+    forever
     {
+        match = re->match(buffer.midRef(subjectStart), matchOffset - subjectStart, QRegularExpression::PartialPreferCompleteMatch);
+        if (match.hasMatch())
+            break;
+
+        if (match.hasPartialMatch())
+            matchOffset = qMax(matchOffset, subjectStart + match.capturedStart());
+        else
+            matchOffset = buffer.size();
+
+        compactBuffer();
+        if (!readLine(line))
+            return QList<QVariant>();
+
         buffer += line;
-        match = re->match(buffer);
     }
 
-    if (!match.hasMatch())
-        return QList<QVariant>();
-
     QList<QVariant> values;
     for (const QVariant& group : groups)
     {
@@ -135,11 +146,68 @@ QList<QVariant> RegExpImport::next()
             values << match.captured(group.toString());
     }
 
-    buffer = buffer.mid(match.capturedEnd());
+    subjectStart += match.capturedEnd();
+    matchOffset = subjectStart;
+    compactBuffer();
 
     return values;
 }
 
+bool RegExpImport::readLine(QString& line)
+{
+    int idx;
+    while ((idx = readBuffer.indexOf('\n', readPos)) == -1)
+    {
+        if (stream->atEnd())
+        {
+            if (readPos >= readBuffer.size())
+                return false;
+
+            line = readBuffer.mid(readPos);
+            readBuffer.clear();
+            readPos = 0;
+            return true;
+        }
+
+        readBuffer.remove(0, readPos);
+        readPos = 0;
+        readBuffer += stream->read(BLOCK_SIZE);
+    }
+
+    int end = idx;
+    if (end > readPos && readBuffer[end - 1] == '\r')
+        end--;
+
+    line = readBuffer.mid(readPos, end - readPos);
+    readPos = idx + 1;
+    return true;
+}
+
+void RegExpImport::compactBuffer()
+{
+    // Skipped text can be dropped, as long as a match is not attempted at the subject start (where ^ would match),
+    // so some margin is left for lookbehind assertions.
+    if (matchOffset - subjectStart > LOOKBEHIND_MARGIN)
+        subjectStart = matchOffset - LOOKBEHIND_MARGIN;
+
+    // Removing is deferred, so the buffer is not moved in memory after every match
+    if (subjectStart < BLOCK_SIZE)
+        return;
+
+    buffer.remove(0, subjectStart);
+    matchOffset -= subjectStart;
+    subjectStart = 0;
+}
+
+void RegExpImport::resetBuffers()
+{
+    buffer.clear();
+    subjectStart = 0;
+    matchOffset = 0;
+    readBuffer.clear();
+    readPos = 0;
+}
+
 CfgMain* RegExpImport::getConfig()
 {
     return &cfg;
@@ -40,13 +40,45 @@ class REGEXPIMPORTSHARED_EXPORT RegExpImport : public GenericPlugin, public Impo
         bool validateOptions();
 
     private:
+        bool readLine(QString& line);
+        void compactBuffer();
+        void resetBuffers();
+
         CFG_LOCAL(RegExpImportConfig, cfg)
         QRegularExpression* re = nullptr;
         QList<QVariant> groups;
         QStringList columns;
         QFile* file = nullptr;
         QTextStream* stream = nullptr;
+
+        /**
+         * @brief Lines read from the file, joined together (without line separators).
+         *
+         * Records are matched against the part starting at the subjectStart. Text before that is either already consumed
+         * by previous matches, or it was skipped as not matching, so it's removed from time to time.
+         */
         QString buffer;
+        int subjectStart = 0;
+
+        /**
+         * @brief Position in the buffer where the next match can begin at the earliest.
+         *
+         * Positions before it were already proven not to start any match, no matter how many more lines are appended.
+         */
+        int matchOffset = 0;
+
+        /**
+         * @brief Decoded text read from the file in blocks, not yet split into lines.
+         */
+        QString readBuffer;
+        int readPos = 0;
+
+        static const int BLOCK_SIZE = 65536;
+
+        /**
+         * @brief Number of characters kept before the matchOffset for lookbehind assertions, when skipped text is dropped.
+         */
+        static const int LOOKBEHIND_MARGIN = 1024;
 };
 
 #endif // REGEXPIMPORT_H
@@ -44,12 +44,15 @@ bool SqlExport::beforeExportQueryResults(const QString& query, QList<QueryExecut
     UNUSED(providedData);
     static_qstring(dropDdl, "DROP TABLE IF EXISTS %1;");
 
-    Dialect dialect = db->getDialect();
+    dialect = db->getDialect();
     QStringList colDefs;
     for (QueryExecutor::ResultColumnPtr resCol : columns)
         colDefs << wrapObjIfNeeded(resCol->displayName, dialect);
 
     this->columns = colDefs.join(", ");
+    columnCount = colDefs.size();
+    theTable = wrapObjIfNeeded(cfg.SqlExport.QueryTable.get(), dialect);
+    prepareInsertPrefix(false);
 
     writeHeader();
     if (cfg.SqlExport.IncludeQueryInComments.get())
@@ -64,7 +67,6 @@ bool SqlExport::beforeExportQueryResults(const QString& query, QList<QueryExecut
     if (!cfg.SqlExport.GenerateCreateTable.get())
         return true;
 
-    theTable = wrapObjIfNeeded(cfg.SqlExport.QueryTable.get(), dialect);
     QString ddl = "CREATE TABLE " + theTable + " (" + this->columns + ");";
     writeln("");
 
@@ -77,10 +79,13 @@ bool SqlExport::beforeExportQueryResults(const QString& query, QList<QueryExecut
 
 bool SqlExport::exportQueryResultsRow(SqlResultsRowPtr row)
 {
-    QStringList argList = rowToArgList(row);
-    QString argStr = argList.join(", ");
-    QString sql = "INSERT INTO " + theTable + " (" + this->columns + ") VALUES (" + argStr + ");";
-    writeln(sql);
+    writeInsertRow(row);
+    return true;
+}
+
+bool SqlExport::afterExportQueryResults()
+{
+    flushInsert();
     return true;
 }
 
@@ -102,13 +107,14 @@ bool SqlExport::exportTable(const QString& database, const QString& table, const
 {
     static_qstring(dropDdl, "DROP TABLE IF EXISTS %1;");
 
-    Dialect dialect = db->getDialect();
+    dialect = db->getDialect();
 
     QStringList colList;
     for (const QString& colName : columnNames)
         colList << wrapObjIfNeeded(colName, dialect);
 
     columns = colList.join(", ");
+    columnCount = colList.size();
 
     if (isTableExport())
     {
@@ -122,6 +128,7 @@ bool SqlExport::exportTable(const QString& database, const QString& table, const
     writeln(tr("-- Table: %1").arg(fullName));
 
     theTable = getNameForObject(database, table, true, dialect);
+    prepareInsertPrefix(!cfg.SqlExport.FormatDdlsOnly.get());
 
     if (cfg.SqlExport.GenerateDrop.get())
         writeln(formatQuery(dropDdl.arg(theTable)));
@@ -132,18 +139,19 @@ bool SqlExport::exportTable(const QString& database, const QString& table, const
 
 bool SqlExport::exportTableRow(SqlResultsRowPtr data)
 {
-    QStringList argList = rowToArgList(data);
-    QString argStr = argList.join(", ");
-    QString sql = "INSERT INTO " + theTable + " (" + columns + ") VALUES (" + argStr + ");";
-    if (!cfg.SqlExport.FormatDdlsOnly.get())
-        sql = formatQuery(sql);
+    writeInsertRow(data);
+    return true;
+}
 
-    writeln(sql);
+bool SqlExport::afterExportTable()
+{
+    flushInsert();
     return true;
 }
 
 bool SqlExport::afterExport()
 {
+    flushInsert();
     writeCommit();
     writeFkEnable();
     return true;
@@ -263,9 +271,70 @@ QString SqlExport::getNameForObject(const QString& database, const QString& name
     return obj;
 }
 
-QStringList SqlExport::rowToArgList(SqlResultsRowPtr row)
+void SqlExport::prepareInsertPrefix(bool useFormatter)
 {
-    return valueListToSqlList(row->valueList(), db->getDialect());
+    static_qstring(insertTpl, "INSERT INTO %1 (%2) VALUES ");
+    static_qstring(sampleValuesTpl, "(%1);");
+
+    insertBuffer.clear();
+    rowsInInsert = 0;
+    rowsPerInsert = qBound(1, cfg.SqlExport.RowsPerInsert.get(), MAX_ROWS_PER_INSERT);
+    if (dialect == Dialect::Sqlite2)
+        rowsPerInsert = 1; // no multi-row VALUES in SQLite 2
+
+    insertPrefix = insertTpl.arg(theTable, columns);
+    if (!useFormatter || !cfg.SqlExport.UseFormatter.get())
+        return;
+
+    // Formatting sample statement and cutting off its values. All the rest of the statement is the same for all rows,
+    // so there's no need to run the formatter for each of them. The sample contains only NULLs, so the last VALUES keyword
+    // is the one that ends the prefix (column names, even if named "values", are wrapped).
+    QStringList sampleValues;
+    for (int i = 0; i < columnCount; i++)
+        sampleValues << "NULL";
+
+    QString formatted = formatQuery(insertPrefix + sampleValuesTpl.arg(sampleValues.join(", ")));
+    int idx = formatted.lastIndexOf("VALUES", -1, Qt::CaseInsensitive);
+    if (idx < 0)
+        return;
+
+    insertPrefix = formatted.left(idx + 6) + " ";
+}
+
+void SqlExport::writeInsertRow(SqlResultsRowPtr row)
+{
+    if (rowsInInsert == 0)
+        insertBuffer += insertPrefix;
+    else
+        insertBuffer += QLatin1String(",\n    ");
+
+    insertBuffer += QLatin1Char('(');
+    bool first = true;
+    for (const QVariant& value : row->valueList())
+    {
+        if (!first)
+            insertBuffer += QLatin1String(", ");
+
+        appendValueAsSql(insertBuffer, value, dialect);
+        first = false;
+    }
+    insertBuffer += QLatin1Char(')');
+
+    if (++rowsInInsert >= rowsPerInsert || insertBuffer.size() >= MAX_INSERT_LENGTH)
+        flushInsert();
+}
+
+void SqlExport::flushInsert()
+{
+    if (rowsInInsert == 0)
+        return;
+
+    insertBuffer += QLatin1String(";\n");
+    write(insertBuffer);
+
+    // Keeps allocated memory for the next statement
+    insertBuffer.resize(0);
+    rowsInInsert = 0;
 }
 
 void SqlExport::validateOptions()
@@ -13,6 +13,7 @@ CFG_CATEGORIES(SqlExportConfig,
          CFG_ENTRY(bool,    UseFormatter,           false)
          CFG_ENTRY(bool,    FormatDdlsOnly,         false)
          CFG_ENTRY(bool,    GenerateDrop,           false)
+         CFG_ENTRY(int,     RowsPerInsert,          1)
      )
 )
 
@@ -33,11 +34,13 @@ class SQLEXPORTSHARED_EXPORT SqlExport : public GenericExportPlugin
         bool beforeExportQueryResults(const QString& query, QList<QueryExecutor::ResultColumnPtr>& columns,
                                       const QHash<ExportManager::ExportProviderFlag,QVariant> providedData);
         bool exportQueryResultsRow(SqlResultsRowPtr row);
+        bool afterExportQueryResults();
         bool exportTable(const QString& database, const QString& table, const QStringList& columnNames, const QString& ddl, SqliteCreateTablePtr createTable,
                          const QHash<ExportManager::ExportProviderFlag,QVariant> providedData);
         bool exportVirtualTable(const QString& database, const QString& table, const QStringList& columnNames, const QString& ddl, SqliteCreateVirtualTablePtr createTable,
                                 const QHash<ExportManager::ExportProviderFlag,QVariant> providedData);
         bool exportTableRow(SqlResultsRowPtr data);
+        bool afterExportTable();
         bool afterExport();
         bool beforeExportDatabase(const QString& database);
         bool exportIndex(const QString& database, const QString& name, const QString& ddl, SqliteCreateIndexPtr createIndex);
@@ -55,11 +58,44 @@ class SQLEXPORTSHARED_EXPORT SqlExport : public GenericExportPlugin
         void writeFkDisable();
         void writeFkEnable();
         QString formatQuery(const QString& sql);
+        void prepareInsertPrefix(bool useFormatter);
+        void writeInsertRow(SqlResultsRowPtr row);
+        void flushInsert();
         QString getNameForObject(const QString& database, const QString& name, bool wrapped, Dialect dialect = Dialect::Sqlite3);
-        QStringList rowToArgList(SqlResultsRowPtr row);
 
         QString theTable;
         QString columns;
+
+        /**
+         * @brief Beginning of INSERT statement for current table, up to the VALUES keyword.
+         *
+         * It's formatted (if requested) only once per table, instead of formatting every single INSERT.
+         */
+        QString insertPrefix;
+
+        /**
+         * @brief INSERT statement being built. Reused for all rows, so it's not reallocated for each of them.
+         */
+        QString insertBuffer;
+
+        int columnCount = 0;
+        int rowsInInsert = 0;
+        int rowsPerInsert = 1;
+
+        /**
+         * @brief Maximum number of rows in a single INSERT.
+         *
+         * SQLite older than 3.8.8 limits VALUES to 500 rows (SQLITE_MAX_COMPOUND_SELECT).
+         */
+        static const int MAX_ROWS_PER_INSERT = 500;
+
+        /**
+         * @brief Length of INSERT statement (in characters), after which the statement is ended, regardless of number of its rows.
+         *
+         * Keeps statements with big values far below the SQLITE_MAX_SQL_LENGTH and limits memory used by the insertBuffer.
+         */
+        static const int MAX_INSERT_LENGTH = 1048576;
+        Dialect dialect = Dialect::Sqlite3;
         CFG_LOCAL(SqlExportConfig, cfg)
 };
 
@@ -0,0 +1,22 @@
+include($$PWD/../TestUtils/test_common.pri)
+
+QT       += testlib
+QT       -= gui
+
+TARGET = benchmarks
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+SOURCES += main.cpp \
+    csvbenchmark.cpp \
+    bulkinsertbenchmark.cpp \
+    insertgenerationbenchmark.cpp \
+    regexpfunctionbenchmark.cpp
+
+HEADERS += \
+    csvbenchmark.h \
+    bulkinsertbenchmark.h \
+    insertgenerationbenchmark.h \
+    regexpfunctionbenchmark.h
@@ -0,0 +1,78 @@
+#include "bulkinsertbenchmark.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "db/bulkinserter.h"
+#include "dbsqlite3mock.h"
+#include "testdata.h"
+#include "benchmarkutils.h"
+#include <QtTest>
+#include <QElapsedTimer>
+
+void BulkInsertBenchmark::initTestCase()
+{
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+}
+
+void BulkInsertBenchmark::cleanupTestCase()
+{
+    db->close();
+    delete db;
+    db = nullptr;
+}
+
+void BulkInsertBenchmark::init()
+{
+    db->exec("DROP TABLE IF EXISTS test;");
+    db->exec("CREATE TABLE test (id INTEGER UNIQUE, txt TEXT, num REAL, nothing, data BLOB);");
+}
+
+void BulkInsertBenchmark::benchmarkSingleRowInsert()
+{
+    // The way rows were inserted before BulkInserter, for comparison
+    static const qint64 rows = 1000000;
+    QElapsedTimer timer;
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        db->begin();
+        SqlQueryPtr query = db->prepare("INSERT INTO test (id, txt, num, nothing, data) VALUES (?, ?, ?, ?, ?);");
+        for (qint64 i = 1; i <= rows; i++)
+        {
+            query->setArgs(generateTestRow(i));
+            QVERIFY(query->execute());
+        }
+        db->commit();
+        printThroughput("Single row INSERT, 1M rows:", rows, "rows", timer.nsecsElapsed());
+    }
+}
+
+void BulkInsertBenchmark::benchmarkBulkInsert_data()
+{
+    QTest::addColumn<qint64>("rows");
+    QTest::newRow("1M") << static_cast<qint64>(1000000);
+
+    // Takes a while and needs lots of memory for the in-memory database, so it's executed only on demand
+    if (qEnvironmentVariableIsSet("SQLITESTUDIO_LONG_BENCHMARKS"))
+        QTest::newRow("10M") << static_cast<qint64>(10000000);
+}
+
+void BulkInsertBenchmark::benchmarkBulkInsert()
+{
+    QFETCH(qint64, rows);
+    QElapsedTimer timer;
+    QBENCHMARK_ONCE
+    {
+        timer.start();
+        db->begin();
+        BulkInserter inserter(db, "test", columns);
+        QVERIFY(inserter.begin());
+        for (qint64 i = 1; i <= rows; i++)
+            QVERIFY(inserter.insert(generateTestRow(i)));
+
+        QVERIFY(inserter.finish());
+        db->commit();
+        printThroughput(QString("Multi-row INSERT, %1 rows:").arg(QTest::currentDataTag()), rows, "rows", timer.nsecsElapsed());
+    }
+    QCOMPARE(db->exec("SELECT count(*) FROM test;")->getSingleCell().toLongLong(), rows);
+}
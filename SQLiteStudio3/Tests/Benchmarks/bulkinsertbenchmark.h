@@ -0,0 +1,29 @@
+#ifndef BULKINSERTBENCHMARK_H
+#define BULKINSERTBENCHMARK_H
+
+#include <QObject>
+#include <QStringList>
+
+class Db;
+
+/**
+ * @brief Compares inserting rows with BulkInserter against executing single row INSERT for every row.
+ */
+class BulkInsertBenchmark : public QObject
+{
+        Q_OBJECT
+
+    private:
+        Db* db = nullptr;
+        const QStringList columns = {"id", "txt", "num", "nothing", "data"};
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void init();
+        void benchmarkSingleRowInsert();
+        void benchmarkBulkInsert_data();
+        void benchmarkBulkInsert();
+};
+
+#endif // BULKINSERTBENCHMARK_H
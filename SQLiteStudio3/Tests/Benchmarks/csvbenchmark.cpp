@@ -0,0 +1,61 @@
+#include "csvbenchmark.h"
+#include "csvserializer.h"
+#include "csvdeserializer.h"
+#include "testdata.h"
+#include "benchmarkutils.h"
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+CsvFormat CsvBenchmark::importCsvFormat()
+{
+    // Same as used by the CsvImport plugin
+    CsvFormat format;
+    format.columnSeparator = ",";
+    format.rowSeparators = QStringList({"\r\n", "\n", "\r"});
+    format.multipleRowSeparators = true;
+    format.strictRowSeparator = true;
+    return format;
+}
+
+void CsvBenchmark::initTestCase()
+{
+    data = generateTestCsv(ROWS);
+}
+
+void CsvBenchmark::benchmarkCsvLegacy()
+{
+    CsvFormat format = importCsvFormat();
+    QElapsedTimer timer;
+    QBENCHMARK
+    {
+        timer.start();
+        QTextStream stream(data);
+        int rows = 0;
+        while (!stream.atEnd())
+        {
+            CsvSerializer::deserializeOneEntry(stream, format);
+            rows++;
+        }
+
+        QCOMPARE(rows, static_cast<int>(ROWS));
+        printThroughput("Legacy CSV deserialization:", data.size() / 1048576.0, "MB", timer.nsecsElapsed());
+    }
+}
+
+void CsvBenchmark::benchmarkCsvBuffered()
+{
+    QElapsedTimer timer;
+    QBENCHMARK
+    {
+        timer.start();
+        QTextStream stream(data);
+        CsvDeserializer deserializer(&stream, importCsvFormat());
+        int rows = 0;
+        while (!deserializer.atEnd())
+            rows += deserializer.nextBatch(1000).size();
+
+        QCOMPARE(rows, static_cast<int>(ROWS));
+        printThroughput("Buffered CSV deserialization:", data.size() / 1048576.0, "MB", timer.nsecsElapsed());
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef CSVBENCHMARK_H
+#define CSVBENCHMARK_H
+
+#include "csvformat.h"
+#include <QObject>
+#include <QByteArray>
+
+/**
+ * @brief Compares CSV deserialization with the CsvDeserializer against the entry-by-entry CsvSerializer::deserializeOneEntry().
+ */
+class CsvBenchmark : public QObject
+{
+        Q_OBJECT
+
+    private:
+        CsvFormat importCsvFormat();
+
+        QByteArray data;
+        static const int ROWS = 5000;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void benchmarkCsvLegacy();
+        void benchmarkCsvBuffered();
+};
+
+#endif // CSVBENCHMARK_H
@@ -0,0 +1,59 @@
+#include "insertgenerationbenchmark.h"
+#include "common/utils_sql.h"
+#include "testdata.h"
+#include "benchmarkutils.h"
+#include <QtTest>
+#include <QElapsedTimer>
+
+void InsertGenerationBenchmark::initTestCase()
+{
+    for (int i = 0; i < ROWS; i++)
+        rows << generateTestRow(i);
+}
+
+void InsertGenerationBenchmark::benchmarkInsertsWithArgList()
+{
+    // The way SqlExport used to build INSERT statements for exported rows
+    QString prefix = "INSERT INTO test (id, txt, num, nothing, data) VALUES (";
+    QElapsedTimer timer;
+    QBENCHMARK
+    {
+        timer.start();
+        qint64 bytes = 0;
+        for (const QList<QVariant>& row : rows)
+        {
+            QString sql = prefix + valueListToSqlList(row, Dialect::Sqlite3).join(", ") + ");";
+            bytes += sql.toUtf8().size();
+        }
+        printThroughput("INSERT generation with argument lists:", bytes / 1048576.0, "MB", timer.nsecsElapsed());
+    }
+}
+
+void InsertGenerationBenchmark::benchmarkInsertsWithBuffer()
+{
+    // The way SqlExport builds INSERT statements now
+    QString prefix = "INSERT INTO test (id, txt, num, nothing, data) VALUES ";
+    QString buffer;
+    QElapsedTimer timer;
+    QBENCHMARK
+    {
+        timer.start();
+        qint64 bytes = 0;
+        for (const QList<QVariant>& row : rows)
+        {
+            buffer.resize(0);
+            buffer += prefix;
+            buffer += QLatin1Char('(');
+            for (int i = 0, total = row.size(); i < total; i++)
+            {
+                if (i > 0)
+                    buffer += QLatin1String(", ");
+
+                appendValueAsSql(buffer, row[i], Dialect::Sqlite3);
+            }
+            buffer += QLatin1String(");");
+            bytes += buffer.toUtf8().size();
+        }
+        printThroughput("INSERT generation with reused buffer:", bytes / 1048576.0, "MB", timer.nsecsElapsed());
+    }
+}
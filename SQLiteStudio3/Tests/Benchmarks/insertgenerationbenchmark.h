@@ -0,0 +1,25 @@
+#ifndef INSERTGENERATIONBENCHMARK_H
+#define INSERTGENERATIONBENCHMARK_H
+
+#include <QObject>
+#include <QList>
+#include <QVariant>
+
+/**
+ * @brief Compares building INSERT statements from lists of SQL values against appending values to a reused buffer.
+ */
+class InsertGenerationBenchmark : public QObject
+{
+        Q_OBJECT
+
+    private:
+        QList<QList<QVariant>> rows;
+        static const int ROWS = 100000;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void benchmarkInsertsWithArgList();
+        void benchmarkInsertsWithBuffer();
+};
+
+#endif // INSERTGENERATIONBENCHMARK_H
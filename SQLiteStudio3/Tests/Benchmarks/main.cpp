@@ -0,0 +1,33 @@
+#include "csvbenchmark.h"
+#include "bulkinsertbenchmark.h"
+#include "insertgenerationbenchmark.h"
+#include "regexpfunctionbenchmark.h"
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "mocks.h"
+#include <QtTest>
+
+// Benchmarks are kept out of the unit test suite, as they take long and only print numbers.
+// Command line arguments are passed to each benchmark class, so all QTest options can be used.
+int main(int argc, char** argv)
+{
+    initKeywords();
+    Lexer::staticInit();
+    initMocks();
+
+    int result = 0;
+
+    CsvBenchmark csvBenchmark;
+    result |= QTest::qExec(&csvBenchmark, argc, argv);
+
+    BulkInsertBenchmark bulkInsertBenchmark;
+    result |= QTest::qExec(&bulkInsertBenchmark, argc, argv);
+
+    InsertGenerationBenchmark insertGenerationBenchmark;
+    result |= QTest::qExec(&insertGenerationBenchmark, argc, argv);
+
+    RegExpFunctionBenchmark regExpFunctionBenchmark;
+    result |= QTest::qExec(&regExpFunctionBenchmark, argc, argv);
+
+    return result;
+}
@@ -0,0 +1,57 @@
+#include "regexpfunctionbenchmark.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "sqlitestudio.h"
+#include "dbsqlite3mock.h"
+#include "regexpfunctionmanagermock.h"
+#include <QtTest>
+
+QString RegExpFunctionBenchmark::filterQuery(const QString& pattern)
+{
+    // Same form of condition as the one generated by the SqlTableModel::applyRegExpFilter()
+    QStringList conditions;
+    for (int i = 1; i <= COLUMNS; i++)
+        conditions << QString("c%1 REGEXP '%2'").arg(i).arg(pattern);
+
+    return "SELECT count(*) FROM test WHERE " + conditions.join(" OR ");
+}
+
+void RegExpFunctionBenchmark::initTestCase()
+{
+    SQLITESTUDIO->setFunctionManager(new RegExpFunctionManagerMock());
+
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+
+    QStringList columns;
+    QStringList values;
+    for (int i = 1; i <= COLUMNS; i++)
+    {
+        columns << QString("c%1 TEXT").arg(i);
+        values << QString("'value ' || x || ' in column %1'").arg(i);
+    }
+
+    db->exec(QString("CREATE TABLE test (%1);").arg(columns.join(", ")));
+    db->exec(QString("WITH RECURSIVE seq(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM seq WHERE x < %1) "
+                     "INSERT INTO test SELECT %2 FROM seq;").arg(ROWS).arg(values.join(", ")));
+}
+
+void RegExpFunctionBenchmark::cleanupTestCase()
+{
+    db->close();
+    delete db;
+    db = nullptr;
+
+    SQLITESTUDIO->setFunctionManager(new FunctionManagerMock());
+}
+
+void RegExpFunctionBenchmark::benchmarkFilter()
+{
+    // Pattern that doesn't match anything, so the function is evaluated for every column of every row
+    QString query = filterQuery("^value [0-9]+ in column 9$");
+    QBENCHMARK
+    {
+        SqlQueryPtr results = db->exec(query);
+        QCOMPARE(results->getSingleCell().toInt(), 0);
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef REGEXPFUNCTIONBENCHMARK_H
+#define REGEXPFUNCTIONBENCHMARK_H
+
+#include <QObject>
+#include <QString>
+
+class Db;
+
+/**
+ * @brief Measures filtering of a table with the REGEXP function, the way the data grid filters by regular expression.
+ */
+class RegExpFunctionBenchmark : public QObject
+{
+        Q_OBJECT
+
+    private:
+        QString filterQuery(const QString& pattern);
+
+        Db* db = nullptr;
+        static const int COLUMNS = 5;
+        static const int ROWS = 50000;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void benchmarkFilter();
+};
+
+#endif // REGEXPFUNCTIONBENCHMARK_H
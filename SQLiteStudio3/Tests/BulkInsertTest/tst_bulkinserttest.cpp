@@ -0,0 +1,192 @@
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "db/bulkinserter.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include "testdata.h"
+#include <QString>
+#include <QtTest>
+
+class BulkInsertTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        BulkInsertTest();
+
+    private:
+        Db* db = nullptr;
+        const QStringList columns = {"id", "txt", "num", "nothing", "data"};
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void init();
+        void testIncompleteBatch();
+        void testSingleColumn();
+        void testMissingValues();
+        void testRowErrorHandler();
+        void testRowErrorHandlerWithConflictFail();
+        void testErrorWithoutHandler();
+        void testDeferIndexes();
+};
+
+BulkInsertTest::BulkInsertTest()
+{
+}
+
+void BulkInsertTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+    initMocks();
+
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+}
+
+void BulkInsertTest::cleanupTestCase()
+{
+    db->close();
+    delete db;
+    db = nullptr;
+}
+
+void BulkInsertTest::init()
+{
+    db->exec("DROP TABLE IF EXISTS test;");
+    db->exec("CREATE TABLE test (id INTEGER UNIQUE, txt TEXT, num REAL, nothing, data BLOB);");
+}
+
+void BulkInsertTest::testIncompleteBatch()
+{
+    BulkInserter inserter(db, "test", columns);
+    QVERIFY(inserter.getRowsPerStatement() > 1);
+
+    int rows = inserter.getRowsPerStatement() * 3 + 7;
+    QVERIFY(inserter.begin());
+    for (int i = 1; i <= rows; i++)
+        QVERIFY(inserter.insert(generateTestRow(i)));
+
+    QVERIFY(inserter.finish());
+    QCOMPARE(inserter.getRowCount(), static_cast<qint64>(rows));
+
+    SqlQueryPtr results = db->exec("SELECT count(*), sum(id), max(txt) FROM test;");
+    SqlResultsRowPtr row = results->next();
+    QCOMPARE(row->value(0).toInt(), rows);
+    QCOMPARE(row->value(1).toLongLong(), static_cast<qint64>(rows) * (rows + 1) / 2);
+
+    results = db->exec("SELECT txt, num, data FROM test WHERE id = 5;");
+    row = results->next();
+    QCOMPARE(row->value(0).toString(), QString("value 5"));
+    QCOMPARE(row->value(1).toDouble(), 2.5);
+    QCOMPARE(row->value(2).toByteArray(), QByteArray("5"));
+}
+
+void BulkInsertTest::testSingleColumn()
+{
+    BulkInserter inserter(db, "test", {"id"});
+    QCOMPARE(inserter.getRowsPerStatement(), static_cast<int>(BulkInserter::MAX_ROWS_PER_STATEMENT));
+
+    int rows = inserter.getRowsPerStatement() * 2 + 3;
+    QVERIFY(inserter.begin());
+    for (int i = 1; i <= rows; i++)
+        QVERIFY(inserter.insert({i}));
+
+    QVERIFY(inserter.finish());
+    QCOMPARE(db->exec("SELECT count(*) FROM test;")->getSingleCell().toInt(), rows);
+}
+
+void BulkInsertTest::testMissingValues()
+{
+    BulkInserter inserter(db, "test", {"id", "txt"});
+    QVERIFY(inserter.begin());
+    QVERIFY(inserter.insert({1}));
+    QVERIFY(inserter.insert({2, "a", "ignored"}));
+    QVERIFY(inserter.finish());
+
+    SqlQueryPtr results = db->exec("SELECT txt FROM test ORDER BY id;");
+    QVERIFY(results->next()->value(0).isNull());
+    QCOMPARE(results->next()->value(0).toString(), QString("a"));
+}
+
+void BulkInsertTest::testRowErrorHandler()
+{
+    BulkInserter inserter(db, "test", columns);
+    QList<qint64> failedRows;
+    inserter.setRowErrorHandler([&failedRows](qint64 rowNumber, const QString&) -> bool
+    {
+        failedRows << rowNumber;
+        return true;
+    });
+
+    // Duplicated id (violating UNIQUE) in the middle of the second batch
+    int rows = inserter.getRowsPerStatement() * 2 + 10;
+    int duplicateAt = inserter.getRowsPerStatement() + 5;
+    QVERIFY(inserter.begin());
+    for (int i = 1; i <= rows; i++)
+        QVERIFY(inserter.insert(generateTestRow(i == duplicateAt ? 1 : i)));
+
+    QVERIFY(inserter.finish());
+    QCOMPARE(failedRows, QList<qint64>({duplicateAt}));
+    QCOMPARE(db->exec("SELECT count(*) FROM test;")->getSingleCell().toInt(), rows - 1);
+}
+
+void BulkInsertTest::testRowErrorHandlerWithConflictFail()
+{
+    // With FAIL, rows inserted by the failing statement before the conflicting one stay in the table
+    db->exec("DROP TABLE test;");
+    db->exec("CREATE TABLE test (id INTEGER UNIQUE ON CONFLICT FAIL, txt TEXT, num REAL, nothing, data BLOB);");
+
+    BulkInserter inserter(db, "test", columns);
+    QList<qint64> failedRows;
+    inserter.setRowErrorHandler([&failedRows](qint64 rowNumber, const QString&) -> bool
+    {
+        failedRows << rowNumber;
+        return true;
+    });
+
+    int rows = inserter.getRowsPerStatement() * 2;
+    int duplicateAt = inserter.getRowsPerStatement() + 5;
+    QVERIFY(inserter.begin());
+    for (int i = 1; i <= rows; i++)
+        QVERIFY(inserter.insert(generateTestRow(i == duplicateAt ? 1 : i)));
+
+    QVERIFY(inserter.finish());
+    QCOMPARE(failedRows, QList<qint64>({duplicateAt}));
+    QCOMPARE(db->exec("SELECT count(*) FROM test;")->getSingleCell().toInt(), rows - 1);
+}
+
+void BulkInsertTest::testErrorWithoutHandler()
+{
+    BulkInserter inserter(db, "test", columns);
+    QVERIFY(inserter.begin());
+    QVERIFY(inserter.insert(generateTestRow(1)));
+    QVERIFY(inserter.insert(generateTestRow(1)));
+    QVERIFY(!inserter.finish());
+    QVERIFY(!inserter.getErrorText().isEmpty());
+    QCOMPARE(db->exec("SELECT count(*) FROM test;")->getSingleCell().toInt(), 0);
+}
+
+void BulkInsertTest::testDeferIndexes()
+{
+    db->exec("CREATE INDEX test_txt ON test (txt);");
+
+    BulkInserter inserter(db, "test", columns);
+    inserter.setDeferIndexes(true);
+    QVERIFY(inserter.begin());
+    QCOMPARE(db->exec("SELECT count(*) FROM sqlite_master WHERE name = 'test_txt';")->getSingleCell().toInt(), 0);
+
+    for (int i = 1; i <= 1000; i++)
+        QVERIFY(inserter.insert(generateTestRow(i)));
+
+    QVERIFY(inserter.finish());
+    QCOMPARE(db->exec("SELECT count(*) FROM sqlite_master WHERE name = 'test_txt';")->getSingleCell().toInt(), 1);
+    QCOMPARE(db->exec("PRAGMA integrity_check;")->getSingleCell().toString(), QString("ok"));
+}
+
+QTEST_APPLESS_MAIN(BulkInsertTest)
+
+#include "tst_bulkinserttest.moc"
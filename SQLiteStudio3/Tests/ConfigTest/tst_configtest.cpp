@@ -0,0 +1,185 @@
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "services/impl/configimpl.h"
+#include "common/global.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QDataStream>
+#include <QFile>
+
+class ConfigTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        ConfigTest();
+
+    private:
+        /**
+         * @brief Reads the setting directly from the config file, with a separate connection.
+         * @return Stored value, or invalid QVariant if the setting is not in the file.
+         */
+        QVariant getStoredValue(const QString& group, const QString& key);
+
+        QTemporaryDir* homeDir = nullptr;
+        ConfigImpl* config = nullptr;
+        QString configFile;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void init();
+        void cleanup();
+        void testReadUnflushedValue();
+        void testFlushOnTimer();
+        void testFlushOnShutdown();
+        void testDiscardOnMassSaveRollback();
+        void testDiscardOnTransactionRollback();
+};
+
+ConfigTest::ConfigTest()
+{
+}
+
+QVariant ConfigTest::getStoredValue(const QString& group, const QString& key)
+{
+    DbSqlite3Mock db("check", configFile);
+    if (!db.open())
+        return QVariant();
+
+    QByteArray bytes = db.exec("SELECT value FROM settings WHERE [group] = ? AND [key] = ?", {group, key})->getSingleCell().toByteArray();
+    db.close();
+
+    QVariant value;
+    if (bytes.isNull())
+        return value;
+
+    QDataStream stream(bytes);
+    stream >> value;
+    return value;
+}
+
+void ConfigTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+
+    // Config file is created in the global config location, so it's redirected from the real home directory
+    homeDir = new QTemporaryDir();
+    QVERIFY(homeDir->isValid());
+    qputenv("HOME", homeDir->path().toLocal8Bit());
+    qputenv("APPDATA", homeDir->path().toLocal8Bit());
+}
+
+void ConfigTest::cleanupTestCase()
+{
+    safe_delete(homeDir);
+}
+
+void ConfigTest::init()
+{
+    initMocks();
+
+    config = new ConfigImpl();
+    config->init();
+    configFile = config->getConfigFilePath();
+    QVERIFY(configFile.startsWith(homeDir->path()));
+}
+
+void ConfigTest::cleanup()
+{
+    safe_delete(config);
+    QFile::remove(configFile);
+}
+
+void ConfigTest::testReadUnflushedValue()
+{
+    config->set("TestGroup", "key", 123);
+
+    // Value is served from the memory before it's written to the file
+    QCOMPARE(config->get("TestGroup", "key"), QVariant(123));
+    QVERIFY(!getStoredValue("TestGroup", "key").isValid());
+
+    config->set("TestGroup", "key", "abc");
+    QCOMPARE(config->get("TestGroup", "key"), QVariant("abc"));
+    QVERIFY(!getStoredValue("TestGroup", "key").isValid());
+}
+
+void ConfigTest::testFlushOnTimer()
+{
+    config->set("TestGroup", "key1", 123);
+    config->set("TestGroup", "key2", "abc");
+    QVERIFY(!getStoredValue("TestGroup", "key1").isValid());
+
+    QTRY_VERIFY_WITH_TIMEOUT(getStoredValue("TestGroup", "key1").isValid(), 5000);
+    QCOMPARE(getStoredValue("TestGroup", "key1"), QVariant(123));
+    QCOMPARE(getStoredValue("TestGroup", "key2"), QVariant("abc"));
+}
+
+void ConfigTest::testFlushOnShutdown()
+{
+    config->set("TestGroup", "key", 123);
+    QVERIFY(!getStoredValue("TestGroup", "key").isValid());
+
+    config->cleanUp();
+    QCOMPARE(getStoredValue("TestGroup", "key"), QVariant(123));
+
+    // Value is loaded back by the next instance
+    safe_delete(config);
+    config = new ConfigImpl();
+    config->init();
+    QCOMPARE(config->get("TestGroup", "key"), QVariant(123));
+}
+
+void ConfigTest::testDiscardOnMassSaveRollback()
+{
+    config->set("TestGroup", "key", 123);
+
+    // Change made before the mass save is written, so the rollback doesn't affect it
+    config->beginMassSave();
+    QCOMPARE(getStoredValue("TestGroup", "key"), QVariant(123));
+
+    config->set("TestGroup", "key", 456);
+    config->set("TestGroup", "newKey", "abc");
+    QCOMPARE(config->get("TestGroup", "key"), QVariant(456));
+    QCOMPARE(config->get("TestGroup", "newKey"), QVariant("abc"));
+
+    config->rollbackMassSave();
+    QCOMPARE(config->get("TestGroup", "key"), QVariant(123));
+    QVERIFY(!config->get("TestGroup", "newKey").isValid());
+
+    // Discarded changes are not written later on
+    config->cleanUp();
+    QCOMPARE(getStoredValue("TestGroup", "key"), QVariant(123));
+    QVERIFY(!getStoredValue("TestGroup", "newKey").isValid());
+}
+
+void ConfigTest::testDiscardOnTransactionRollback()
+{
+    config->set("TestGroup", "key", 123);
+
+    config->begin();
+    QCOMPARE(getStoredValue("TestGroup", "key"), QVariant(123));
+
+    config->set("TestGroup", "key", 456);
+    config->set("TestGroup", "newKey", "abc");
+    config->rollback();
+    QCOMPARE(config->get("TestGroup", "key"), QVariant(123));
+    QVERIFY(!config->get("TestGroup", "newKey").isValid());
+
+    // Committed changes stay
+    config->begin();
+    config->set("TestGroup", "key", 789);
+    config->commit();
+    QCOMPARE(config->get("TestGroup", "key"), QVariant(789));
+    QCOMPARE(getStoredValue("TestGroup", "key"), QVariant(789));
+}
+
+QTEST_GUILESS_MAIN(ConfigTest)
+
+#include "tst_configtest.moc"
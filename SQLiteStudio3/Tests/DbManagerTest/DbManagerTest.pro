@@ -0,0 +1,13 @@
+include($$PWD/../TestUtils/test_common.pri)
+
+QT       += testlib
+QT       -= gui
+
+TARGET = tst_dbmanagertest
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE = app
+
+SOURCES += tst_dbmanagertest.cpp
+DEFINES += SRCDIR=\\\"$$PWD/\\\"
@@ -0,0 +1,258 @@
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "db/db.h"
+#include "services/impl/dbmanagerimpl.h"
+#include "plugins/builtinplugin.h"
+#include "plugins/dbpluginstdfilebase.h"
+#include "sqlitestudio.h"
+#include "common/global.h"
+#include "dbsqlite3mock.h"
+#include "configmock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QThread>
+
+class ProbingConfigMock : public ConfigMock
+{
+    public:
+        QList<CfgDbPtr> dbList();
+        DbGroupPtr getDbGroup(const QString&);
+
+        QList<CfgDbPtr> dbs;
+};
+
+QList<Config::CfgDbPtr> ProbingConfigMock::dbList()
+{
+    return dbs;
+}
+
+Config::DbGroupPtr ProbingConfigMock::getDbGroup(const QString&)
+{
+    return DbGroupPtr::create();
+}
+
+class TestDbPlugin : public BuiltInPlugin, public DbPluginStdFileBase
+{
+        Q_OBJECT
+
+    public:
+        TestDbPlugin(int delay, bool accepting);
+
+        QString getLabel() const;
+        QList<DbPluginOption> getOptionsList() const;
+        bool checkIfDbServedByPlugin(Db* db) const;
+
+    protected:
+        Db* newInstance(const QString& name, const QString& path, const QHash<QString, QVariant>& options);
+        FormatSupport getFormatSupport(FileFormat format) const;
+
+    private:
+        int delay;
+        bool accepting;
+};
+
+TestDbPlugin::TestDbPlugin(int delay, bool accepting) :
+    delay(delay), accepting(accepting)
+{
+}
+
+QString TestDbPlugin::getLabel() const
+{
+    return getName();
+}
+
+QList<DbPluginOption> TestDbPlugin::getOptionsList() const
+{
+    return QList<DbPluginOption>();
+}
+
+bool TestDbPlugin::checkIfDbServedByPlugin(Db* db) const
+{
+    return db && db->getConnectionOptions().value(DB_PLUGIN).toString() == getName();
+}
+
+Db* TestDbPlugin::newInstance(const QString& name, const QString& path, const QHash<QString, QVariant>& options)
+{
+    QThread::msleep(delay);
+    return new DbSqlite3Mock(name, path, options);
+}
+
+DbPluginStdFileBase::FormatSupport TestDbPlugin::getFormatSupport(DbPluginStdFileBase::FileFormat format) const
+{
+    Q_UNUSED(format);
+    return accepting ? FormatSupport::YES : FormatSupport::NO;
+}
+
+class SlowDbPlugin : public TestDbPlugin
+{
+        Q_OBJECT
+
+    public:
+        explicit SlowDbPlugin(bool accepting) : TestDbPlugin(500, accepting) {}
+};
+
+class FastDbPlugin : public TestDbPlugin
+{
+        Q_OBJECT
+
+    public:
+        explicit FastDbPlugin(bool accepting) : TestDbPlugin(0, accepting) {}
+};
+
+class DbManagerTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        DbManagerTest();
+
+    private:
+        void addDbFile(const QString& name, const QHash<QString, QVariant>& options = QHash<QString, QVariant>());
+        bool waitForProbes();
+        QString getHandlingPlugin(const QString& name);
+
+        QTemporaryDir* tempDir = nullptr;
+        ProbingConfigMock* config = nullptr;
+        DbManagerImpl* dbManager = nullptr;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void init();
+        void cleanup();
+        void testProbedInPluginsOrder();
+        void testProbedWithNextPluginIfNotAccepted();
+        void testNotAcceptedByAnyPlugin();
+        void testProbedOnlyWithPluginFromOptions();
+};
+
+DbManagerTest::DbManagerTest()
+{
+}
+
+void DbManagerTest::addDbFile(const QString& name, const QHash<QString, QVariant>& options)
+{
+    QString path = tempDir->path() + "/" + name + ".db";
+    DbSqlite3Mock db(name, path);
+    db.open();
+    db.exec("CREATE TABLE test (id INTEGER PRIMARY KEY);");
+    db.close();
+
+    Config::CfgDbPtr cfgDb = Config::CfgDbPtr::create();
+    cfgDb->name = name;
+    cfgDb->path = path;
+    cfgDb->options = options;
+    config->dbs << cfgDb;
+}
+
+bool DbManagerTest::waitForProbes()
+{
+    QSignalSpy spy(dbManager, SIGNAL(dbListLoaded()));
+    dbManager->notifyDatabasesAreLoaded();
+    return spy.count() > 0 || spy.wait(5000);
+}
+
+QString DbManagerTest::getHandlingPlugin(const QString& name)
+{
+    Db* db = dbManager->getByName(name);
+    if (!db || !db->isValid())
+        return QString();
+
+    return db->getConnectionOptions().value(DB_PLUGIN).toString();
+}
+
+void DbManagerTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+}
+
+void DbManagerTest::init()
+{
+    initMocks();
+
+    config = new ProbingConfigMock();
+    SQLITESTUDIO->setConfig(config);
+
+    tempDir = new QTemporaryDir();
+    QVERIFY(tempDir->isValid());
+}
+
+void DbManagerTest::cleanup()
+{
+    safe_delete(dbManager);
+    safe_delete(tempDir);
+}
+
+void DbManagerTest::testProbedInPluginsOrder()
+{
+    addDbFile("db1");
+    addDbFile("db2");
+    dbManager = new DbManagerImpl();
+
+    // Both plugins accept databases, but the one loaded first takes them, even though its probing ends last
+    SlowDbPlugin slowPlugin(true);
+    FastDbPlugin fastPlugin(true);
+    dbManager->rescanInvalidDatabasesForPlugin(&slowPlugin);
+    dbManager->rescanInvalidDatabasesForPlugin(&fastPlugin);
+    QVERIFY(waitForProbes());
+
+    QCOMPARE(getHandlingPlugin("db1"), slowPlugin.getName());
+    QCOMPARE(getHandlingPlugin("db2"), slowPlugin.getName());
+    QCOMPARE(dbManager->getValidDbList().size(), 2);
+}
+
+void DbManagerTest::testProbedWithNextPluginIfNotAccepted()
+{
+    addDbFile("db1");
+    dbManager = new DbManagerImpl();
+
+    SlowDbPlugin slowPlugin(false);
+    FastDbPlugin fastPlugin(true);
+    dbManager->rescanInvalidDatabasesForPlugin(&slowPlugin);
+    dbManager->rescanInvalidDatabasesForPlugin(&fastPlugin);
+    QVERIFY(waitForProbes());
+
+    QCOMPARE(getHandlingPlugin("db1"), fastPlugin.getName());
+}
+
+void DbManagerTest::testNotAcceptedByAnyPlugin()
+{
+    addDbFile("db1");
+    dbManager = new DbManagerImpl();
+
+    SlowDbPlugin slowPlugin(false);
+    FastDbPlugin fastPlugin(false);
+    dbManager->rescanInvalidDatabasesForPlugin(&slowPlugin);
+    dbManager->rescanInvalidDatabasesForPlugin(&fastPlugin);
+    QVERIFY(waitForProbes());
+
+    Db* db = dbManager->getByName("db1");
+    QVERIFY(db);
+    QVERIFY(!db->isValid());
+    QCOMPARE(dbManager->getValidDbList().size(), 0);
+}
+
+void DbManagerTest::testProbedOnlyWithPluginFromOptions()
+{
+    SlowDbPlugin slowPlugin(true);
+    FastDbPlugin fastPlugin(true);
+
+    QHash<QString, QVariant> options;
+    options[DB_PLUGIN] = fastPlugin.getName();
+    addDbFile("db1", options);
+    addDbFile("db2");
+    dbManager = new DbManagerImpl();
+
+    dbManager->rescanInvalidDatabasesForPlugin(&slowPlugin);
+    dbManager->rescanInvalidDatabasesForPlugin(&fastPlugin);
+    QVERIFY(waitForProbes());
+
+    QCOMPARE(getHandlingPlugin("db1"), fastPlugin.getName());
+    QCOMPARE(getHandlingPlugin("db2"), slowPlugin.getName());
+}
+
+QTEST_GUILESS_MAIN(DbManagerTest)
+
+#include "tst_dbmanagertest.moc"
@@ -4,6 +4,8 @@
 #include <QtTest>
 #include "tsvserializer.h"
 #include "csvserializer.h"
+#include "csvdeserializer.h"
+#include "testdata.h"
 
 // TODO Add tests for CsvSerializer
 
@@ -16,6 +18,8 @@ class DsvFormatsTestTest : public QObject
 
     private:
         QString toString(const QList<QStringList>& input);
+        CsvFormat importCsvFormat();
+        QList<QStringList> deserializeLegacy(QTextStream& stream, const CsvFormat& format);
 
         QList<QStringList> sampleData;
         QList<QStringList> sampleDeserializedData;
@@ -27,6 +31,9 @@ class DsvFormatsTestTest : public QObject
         void testTsv1();
         void testTsv2();
         void testCsv1();
+        void testCsvDeserializer();
+        void testCsvDeserializerBatches();
+        void testCsvTrailingRowSeparator();
 };
 
 DsvFormatsTestTest::DsvFormatsTestTest()
@@ -42,6 +49,26 @@ QString DsvFormatsTestTest::toString(const QList<QStringList>& input)
     return "QList(\n    "+outputLines.join(",\n    ")+"\n)";
 }
 
+CsvFormat DsvFormatsTestTest::importCsvFormat()
+{
+    // Same as used by the CsvImport plugin
+    CsvFormat format;
+    format.columnSeparator = ",";
+    format.rowSeparators = QStringList({"\r\n", "\n", "\r"});
+    format.multipleRowSeparators = true;
+    format.strictRowSeparator = true;
+    return format;
+}
+
+QList<QStringList> DsvFormatsTestTest::deserializeLegacy(QTextStream& stream, const CsvFormat& format)
+{
+    QList<QStringList> rows;
+    while (!stream.atEnd())
+        rows << CsvSerializer::deserializeOneEntry(stream, format);
+
+    return rows;
+}
+
 void DsvFormatsTestTest::initTestCase()
 {
     sampleData << QStringList{"a", "b c", "\"d\""};
@@ -105,6 +132,46 @@ void DsvFormatsTestTest::testCsv1()
     QVERIFY(result.first().size() == 2);
 }
 
+void DsvFormatsTestTest::testCsvDeserializer()
+{
+    QByteArray data = generateTestCsv(50);
+
+    QTextStream legacyStream(data);
+    QList<QStringList> expected = deserializeLegacy(legacyStream, importCsvFormat());
+
+    QTextStream stream(data);
+    CsvDeserializer deserializer(&stream, importCsvFormat());
+    QList<QStringList> result = deserializer.readAll();
+
+    QCOMPARE(result.size(), 50);
+    QCOMPARE(result.first(), QStringList({"0", "plain value 0", "quoted, \"value\" 0", "multi\r\nline", "3.14159"}));
+    QVERIFY2(result == expected, QString("Legacy: %1\nGot: %2").arg(toString(expected), toString(result)).toLocal8Bit().data());
+}
+
+void DsvFormatsTestTest::testCsvDeserializerBatches()
+{
+    QByteArray data = generateTestCsv(25);
+
+    QTextStream stream(data);
+    CsvDeserializer deserializer(&stream, importCsvFormat());
+    QCOMPARE(deserializer.nextBatch(10).size(), 10);
+    QCOMPARE(deserializer.nextBatch(10).size(), 10);
+    QCOMPARE(deserializer.nextBatch(10).size(), 5);
+    QVERIFY(deserializer.atEnd());
+    QVERIFY(deserializer.nextBatch(10).isEmpty());
+
+    deserializer.rewind();
+    QCOMPARE(deserializer.nextRow().first(), QString("0"));
+}
+
+void DsvFormatsTestTest::testCsvTrailingRowSeparator()
+{
+    QList<QStringList> result = CsvDeserializer(QString("a,b\r\nc,d\r\n"), importCsvFormat()).readAll();
+
+    QCOMPARE(result.size(), 2);
+    QCOMPARE(result[1], QStringList({"c", "d"}));
+}
+
 QTEST_APPLESS_MAIN(DsvFormatsTestTest)
 
 #include "tst_dsvformatstesttest.moc"
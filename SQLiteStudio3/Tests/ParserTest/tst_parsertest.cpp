@@ -6,6 +6,7 @@
 #include "parser/parsererror.h"
 #include <QString>
 #include <QtTest>
+#include <QElapsedTimer>
 #include <parser/ast/sqliteinsert.h>
 
 class ParserTest : public QObject
@@ -40,6 +41,8 @@ class ParserTest : public QObject
         void testCommentBeginMultiline();
         void testBetween();
         void testBigNum();
+        void testTokenViews();
+        void testLexerThroughput();
         void initTestCase();
         void cleanupTestCase();
 };
@@ -401,6 +404,64 @@ void ParserTest::testUniqConflict()
     QVERIFY(tokens[16]->type == Token::Type::PAR_RIGHT);
 }
 
+void ParserTest::testTokenViews()
+{
+    QString sql = "SELECT 'a''b', [x y] FROM t; -- comment\nDELETE FROM t WHERE c = ?1;";
+    Lexer lexer(Dialect::Sqlite3);
+    TokenList tokens = lexer.tokenize(sql);
+    QVector<Lexer::TokenView> views = lexer.tokenizeToViews(sql);
+
+    QVERIFY(tokens.size() == views.size());
+    for (int i = 0; i < tokens.size(); i++)
+    {
+        QVERIFY(tokens[i]->type == views[i].type);
+        QVERIFY(tokens[i]->lemonType == views[i].lemonType);
+        QVERIFY(tokens[i]->start == views[i].start);
+        QVERIFY(tokens[i]->end == views[i].start + views[i].length - 1);
+        QVERIFY(tokens[i]->value == views[i].value(sql));
+        QVERIFY(tokens[i]->value == views[i].valueRef(sql));
+    }
+}
+
+void ParserTest::testLexerThroughput()
+{
+    QString stmt = "INSERT INTO [some table] (id, name, value, created) VALUES (%1, 'name ''%1''', %1.5e2, X'0A0B'); "
+                   "/* multi-line\n comment */ UPDATE t SET x = x || 'abc' WHERE id >= %1 AND y <> :param;\n";
+    QString sql;
+    for (int i = 0; sql.size() < 1024 * 1024; i++)
+        sql += stmt.arg(i);
+
+    double megabytes = sql.size() * sizeof(QChar) / (1024.0 * 1024.0);
+
+    Lexer lexer(Dialect::Sqlite3);
+    QElapsedTimer timer;
+
+    timer.start();
+    TokenList tokens = lexer.tokenize(sql);
+    qint64 tokenizeTime = qMax(timer.elapsed(), 1LL);
+
+    timer.start();
+    QVector<Lexer::TokenView> views = lexer.tokenizeToViews(sql);
+    qint64 viewsTime = qMax(timer.elapsed(), 1LL);
+
+    timer.start();
+    lexer.prepare(sql);
+    int getTokenCount = 0;
+    while (lexer.getToken())
+        getTokenCount++;
+
+    qint64 getTokenTime = qMax(timer.elapsed(), 1LL);
+
+    qDebug() << "Lexer throughput for" << megabytes << "MB script:"
+             << "tokenize():" << (megabytes * 1000 / tokenizeTime) << "MB/s,"
+             << "tokenizeToViews():" << (megabytes * 1000 / viewsTime) << "MB/s,"
+             << "getToken():" << (megabytes * 1000 / getTokenTime) << "MB/s";
+
+    QVERIFY(tokens.size() == views.size());
+    QVERIFY(tokens.size() == getTokenCount);
+    QVERIFY(tokens.last()->end == sql.size() - 1);
+}
+
 void ParserTest::initTestCase()
 {
     initKeywords();
@@ -0,0 +1,139 @@
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "db/db.h"
+#include "db/queryexecutor.h"
+#include "schemaresolver.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+#include <QTemporaryDir>
+
+class QueryExecutorTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        QueryExecutorTest();
+
+    private:
+        QStringList execAndGetColumns(QueryExecutor& executor);
+
+        Db* db = nullptr;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void init();
+        void cleanup();
+        void testPlanCacheHit();
+        void testPlanCacheInvalidatedBySchemaChange();
+        void testPlanCacheInvalidatedByAttachedDbChange();
+};
+
+QueryExecutorTest::QueryExecutorTest()
+{
+}
+
+QStringList QueryExecutorTest::execAndGetColumns(QueryExecutor& executor)
+{
+    executor.exec();
+
+    QStringList columns;
+    for (const QueryExecutor::ResultColumnPtr& column : executor.getResultColumns())
+        columns << column->displayName;
+
+    return columns;
+}
+
+void QueryExecutorTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+}
+
+void QueryExecutorTest::init()
+{
+    initMocks();
+
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    db->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, txt TEXT);");
+    QueryExecutor::clearPlanCache();
+}
+
+void QueryExecutorTest::cleanup()
+{
+    db->close();
+    delete db;
+    db = nullptr;
+}
+
+void QueryExecutorTest::testPlanCacheHit()
+{
+    QueryExecutor executor(db, "SELECT * FROM test;");
+    executor.setAsyncMode(false);
+
+    QCOMPARE(execAndGetColumns(executor), QStringList({"id", "txt"}));
+    QVERIFY(!executor.isPlanFromCache());
+
+    QCOMPARE(execAndGetColumns(executor), QStringList({"id", "txt"}));
+    QVERIFY(executor.isPlanFromCache());
+
+    // Different query has its own plan
+    QueryExecutor otherExecutor(db, "SELECT txt FROM test;");
+    otherExecutor.setAsyncMode(false);
+    QCOMPARE(execAndGetColumns(otherExecutor), QStringList({"txt"}));
+    QVERIFY(!otherExecutor.isPlanFromCache());
+}
+
+void QueryExecutorTest::testPlanCacheInvalidatedBySchemaChange()
+{
+    QueryExecutor executor(db, "SELECT * FROM test;");
+    executor.setAsyncMode(false);
+
+    execAndGetColumns(executor);
+    execAndGetColumns(executor);
+    QVERIFY(executor.isPlanFromCache());
+
+    db->exec("ALTER TABLE test ADD COLUMN num REAL;");
+
+    QCOMPARE(execAndGetColumns(executor), QStringList({"id", "txt", "num"}));
+    QVERIFY(!executor.isPlanFromCache());
+}
+
+void QueryExecutorTest::testPlanCacheInvalidatedByAttachedDbChange()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QString otherPath = tempDir.path() + "/other.db";
+
+    Db* otherDb = new DbSqlite3Mock("otherdb", otherPath);
+    QVERIFY(otherDb->open());
+    otherDb->exec("CREATE TABLE other_test (a, b);");
+
+    // Attached with a statement, so the Db doesn't track it
+    QVERIFY(!db->exec(QString("ATTACH '%1' AS other;").arg(otherPath))->isError());
+
+    QueryExecutor executor(db, "SELECT * FROM other.other_test;");
+    executor.setAsyncMode(false);
+
+    QCOMPARE(execAndGetColumns(executor), QStringList({"a", "b"}));
+    QCOMPARE(execAndGetColumns(executor), QStringList({"a", "b"}));
+    QVERIFY(executor.isPlanFromCache());
+
+    // Change made by other connection is not reported to the main one, it's detected by the schema version only.
+    // Schema versions are checked at most once a second, unless the cache is cleared.
+    otherDb->exec("ALTER TABLE other_test ADD COLUMN c;");
+    SchemaResolver::clearCache();
+
+    QCOMPARE(execAndGetColumns(executor), QStringList({"a", "b", "c"}));
+    QVERIFY(!executor.isPlanFromCache());
+
+    db->exec("DETACH other;");
+    otherDb->close();
+    delete otherDb;
+}
+
+QTEST_APPLESS_MAIN(QueryExecutorTest)
+
+#include "tst_queryexecutortest.moc"
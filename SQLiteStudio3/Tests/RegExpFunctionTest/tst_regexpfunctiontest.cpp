@@ -0,0 +1,96 @@
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "sqlitestudio.h"
+#include "dbsqlite3mock.h"
+#include "regexpfunctionmanagermock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+
+class RegExpFunctionTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        RegExpFunctionTest();
+
+    private:
+        QString filterQuery(const QString& pattern);
+
+        Db* db = nullptr;
+        static const int COLUMNS = 5;
+        static const int ROWS = 100;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void cleanupTestCase();
+        void testMatch();
+        void testInvalidPattern();
+};
+
+RegExpFunctionTest::RegExpFunctionTest()
+{
+}
+
+QString RegExpFunctionTest::filterQuery(const QString& pattern)
+{
+    // Same form of condition as the one generated by the SqlTableModel::applyRegExpFilter()
+    QStringList conditions;
+    for (int i = 1; i <= COLUMNS; i++)
+        conditions << QString("c%1 REGEXP '%2'").arg(i).arg(pattern);
+
+    return "SELECT count(*) FROM test WHERE " + conditions.join(" OR ");
+}
+
+void RegExpFunctionTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+    initMocks();
+    SQLITESTUDIO->setFunctionManager(new RegExpFunctionManagerMock());
+
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+
+    QStringList columns;
+    QStringList values;
+    for (int i = 1; i <= COLUMNS; i++)
+    {
+        columns << QString("c%1 TEXT").arg(i);
+        values << QString("'value ' || x || ' in column %1'").arg(i);
+    }
+
+    db->exec(QString("CREATE TABLE test (%1);").arg(columns.join(", ")));
+    db->exec(QString("WITH RECURSIVE seq(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM seq WHERE x < %1) "
+                     "INSERT INTO test SELECT %2 FROM seq;").arg(ROWS).arg(values.join(", ")));
+}
+
+void RegExpFunctionTest::cleanupTestCase()
+{
+    db->close();
+    delete db;
+    db = nullptr;
+}
+
+void RegExpFunctionTest::testMatch()
+{
+    SqlQueryPtr results = db->exec(filterQuery("^value 1[0-9] in column 3$"));
+    QVERIFY(!results->isError());
+    QCOMPARE(results->getSingleCell().toInt(), 10);
+
+    results = db->exec(filterQuery("no such value"));
+    QVERIFY(!results->isError());
+    QCOMPARE(results->getSingleCell().toInt(), 0);
+}
+
+void RegExpFunctionTest::testInvalidPattern()
+{
+    SqlQueryPtr results = db->exec(filterQuery("value ("));
+    QVERIFY(results->isError());
+}
+
+QTEST_APPLESS_MAIN(RegExpFunctionTest)
+
+#include "tst_regexpfunctiontest.moc"
@@ -0,0 +1,153 @@
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "parser/ast/sqlitecreatetable.h"
+#include "db/db.h"
+#include "schemaresolver.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+
+class SchemaResolverTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        SchemaResolverTest();
+
+    private:
+        void createDependentObjects();
+
+        Db* db = nullptr;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void init();
+        void cleanup();
+        void testParsedObjectTokensAreNotShared();
+        void testDependentObjects();
+        void testDependencyGraphUpdatedOnSchemaChange();
+};
+
+SchemaResolverTest::SchemaResolverTest()
+{
+}
+
+void SchemaResolverTest::createDependentObjects()
+{
+    db->exec("CREATE TABLE parent (id INTEGER PRIMARY KEY, name TEXT);");
+    db->exec("CREATE TABLE child (id INTEGER PRIMARY KEY, parentId INTEGER, FOREIGN KEY (parentId) REFERENCES parent (id));");
+    db->exec("CREATE TABLE child2 (id INTEGER PRIMARY KEY, parentId INTEGER REFERENCES Parent (id), UNIQUE (parentId));");
+    db->exec("CREATE INDEX idx_child ON child (parentId);");
+    db->exec("CREATE VIEW v_parent AS SELECT p.name, c.id FROM parent p JOIN child c ON c.parentId = p.id;");
+    db->exec("CREATE TRIGGER trg_parent AFTER DELETE ON parent BEGIN DELETE FROM child WHERE parentId = old.id; END;");
+    db->exec("CREATE TRIGGER trg_view INSTEAD OF DELETE ON v_parent BEGIN DELETE FROM parent WHERE name = old.name; END;");
+}
+
+void SchemaResolverTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+}
+
+void SchemaResolverTest::init()
+{
+    initMocks();
+
+    db = new DbSqlite3Mock("testdb");
+    db->open();
+    SchemaResolver::clearCache();
+}
+
+void SchemaResolverTest::cleanup()
+{
+    SchemaResolver::dropDependencyGraphs(db);
+    db->close();
+    delete db;
+    db = nullptr;
+}
+
+void SchemaResolverTest::testParsedObjectTokensAreNotShared()
+{
+    db->exec("CREATE TABLE abc (id INTEGER PRIMARY KEY, name TEXT);");
+
+    SchemaResolver resolver(db);
+    SqliteQueryPtr query = resolver.getParsedObject("abc", SchemaResolver::TABLE);
+    QVERIFY(query);
+    QString ddl = query->tokens.detokenize();
+
+    // Renaming table in place, the same way TableModifier does it
+    for (const TokenPtr& token : query->tokens)
+    {
+        if (token->value == "abc")
+            token->value = "xyz";
+    }
+    QVERIFY(query->tokens.detokenize() != ddl);
+
+    SqliteQueryPtr nextQuery = resolver.getParsedObject("abc", SchemaResolver::TABLE);
+    QVERIFY(nextQuery);
+    QCOMPARE(nextQuery->tokens.detokenize(), ddl);
+    QCOMPARE(nextQuery.dynamicCast<SqliteCreateTable>()->table, QString("abc"));
+
+    // Both copies are served from the cache, but they're still independent
+    SqliteQueryPtr thirdQuery = resolver.getParsedObject("abc", SchemaResolver::TABLE);
+    QVERIFY(thirdQuery);
+    thirdQuery->tokens.first()->value = "DROP";
+    QCOMPARE(nextQuery->tokens.detokenize(), ddl);
+}
+
+void SchemaResolverTest::testDependentObjects()
+{
+    createDependentObjects();
+
+    SchemaResolver resolver(db);
+    QCOMPARE(resolver.getFkReferencingTables("parent"), QStringList({"child", "child2"}));
+    QCOMPARE(resolver.getFkReferencingTables("child"), QStringList());
+
+    // Automatic index of the UNIQUE constraint is not listed
+    QCOMPARE(resolver.getIndexesForTable("child"), QStringList({"idx_child"}));
+    QCOMPARE(resolver.getIndexesForTable("child2"), QStringList());
+
+    QCOMPARE(resolver.getTriggersForTable("parent"), QStringList({"trg_parent"}));
+    QCOMPARE(resolver.getTriggersForTable("child"), QStringList());
+    QCOMPARE(resolver.getTriggersForView("v_parent"), QStringList({"trg_view"}));
+
+    QCOMPARE(resolver.getViewsForTable("PARENT"), QStringList({"v_parent"}));
+    QCOMPARE(resolver.getViewsForTable("child"), QStringList({"v_parent"}));
+    QCOMPARE(resolver.getViewsForTable("child2"), QStringList());
+}
+
+void SchemaResolverTest::testDependencyGraphUpdatedOnSchemaChange()
+{
+    createDependentObjects();
+
+    SchemaResolver resolver(db);
+    QCOMPARE(resolver.getIndexesForTable("child"), QStringList({"idx_child"}));
+    QCOMPARE(resolver.getViewsForTable("child"), QStringList({"v_parent"}));
+
+    // Every change has to be seen by the next call, even though the graph was already built
+    db->exec("DROP INDEX idx_child;");
+    db->exec("CREATE INDEX idx_child_id ON child (id, parentId);");
+    QCOMPARE(resolver.getIndexesForTable("child"), QStringList({"idx_child_id"}));
+
+    db->exec("DROP TABLE child2;");
+    QCOMPARE(resolver.getFkReferencingTables("parent"), QStringList({"child"}));
+
+    db->exec("CREATE VIEW v_child AS SELECT * FROM child;");
+    QCOMPARE(resolver.getViewsForTable("child"), QStringList({"v_parent", "v_child"}));
+
+    // Modified DDL of the existing object
+    db->exec("DROP TRIGGER trg_parent;");
+    db->exec("CREATE TRIGGER trg_parent AFTER DELETE ON child BEGIN SELECT 1; END;");
+    QCOMPARE(resolver.getTriggersForTable("parent"), QStringList());
+    QCOMPARE(resolver.getTriggersForTable("child"), QStringList({"trg_parent"}));
+
+    // Other resolver of the same database shares the graph
+    SchemaResolver otherResolver(db);
+    QCOMPARE(otherResolver.getTriggersForTable("child"), QStringList({"trg_parent"}));
+    QCOMPARE(otherResolver.getViewsForTable("child"), QStringList({"v_parent", "v_child"}));
+}
+
+QTEST_APPLESS_MAIN(SchemaResolverTest)
+
+#include "tst_schemaresolvertest.moc"
@@ -0,0 +1,146 @@
+#include "parser/keywords.h"
+#include "parser/lexer.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "tablecopier.h"
+#include "dbsqlite3mock.h"
+#include "mocks.h"
+#include <QString>
+#include <QtTest>
+
+class TableCopierTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TableCopierTest();
+
+    private:
+        int countRows(Db* db);
+
+        Db* srcDb = nullptr;
+        Db* dstDb = nullptr;
+
+        /**
+         * @brief Number of source rows. It's not a multiple of the chunk size, so the last chunk is incomplete.
+         */
+        static const int ROWS = 10500;
+
+    private Q_SLOTS:
+        void initTestCase();
+        void init();
+        void cleanup();
+        void testCopy();
+        void testCommitInterval();
+        void testInterrupt();
+        void testSourceError();
+};
+
+TableCopierTest::TableCopierTest()
+{
+}
+
+int TableCopierTest::countRows(Db* db)
+{
+    return db->exec("SELECT count(*) FROM test;")->getSingleCell().toInt();
+}
+
+void TableCopierTest::initTestCase()
+{
+    initKeywords();
+    Lexer::staticInit();
+}
+
+void TableCopierTest::init()
+{
+    initMocks();
+
+    srcDb = new DbSqlite3Mock("srcdb");
+    srcDb->open();
+    srcDb->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, txt TEXT, num REAL, data BLOB);");
+    srcDb->exec(QString("WITH RECURSIVE seq(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM seq WHERE x < %1) "
+                        "INSERT INTO test SELECT x, 'value ' || x, x / 2.0, CASE WHEN x % 3 = 0 THEN NULL ELSE randomblob(16) END "
+                        "FROM seq;").arg(ROWS));
+
+    dstDb = new DbSqlite3Mock("dstdb");
+    dstDb->open();
+    dstDb->exec("CREATE TABLE test (id INTEGER PRIMARY KEY, txt TEXT, num REAL, data BLOB);");
+}
+
+void TableCopierTest::cleanup()
+{
+    srcDb->close();
+    dstDb->close();
+    delete srcDb;
+    delete dstDb;
+    srcDb = nullptr;
+    dstDb = nullptr;
+}
+
+void TableCopierTest::testCopy()
+{
+    TableCopier copier(srcDb, dstDb);
+    QVERIFY(dstDb->begin());
+    QVERIFY2(copier.copy("test", "test"), copier.getErrorText().toUtf8().constData());
+    QVERIFY(dstDb->commit());
+
+    QCOMPARE(copier.getCopiedRows(), static_cast<qint64>(ROWS));
+    QCOMPARE(countRows(dstDb), ROWS);
+
+    SqlQueryPtr results = srcDb->exec("SELECT id, txt, num, data FROM test WHERE id IN (1, 3, 10500) ORDER BY id;");
+    SqlQueryPtr copiedResults = dstDb->exec("SELECT id, txt, num, data FROM test WHERE id IN (1, 3, 10500) ORDER BY id;");
+    for (int i = 0; i < 3; i++)
+    {
+        QVERIFY(results->hasNext());
+        QVERIFY(copiedResults->hasNext());
+        QCOMPARE(copiedResults->next()->valueList(), results->next()->valueList());
+    }
+}
+
+void TableCopierTest::testCommitInterval()
+{
+    // Transaction is committed after every 2 chunks, so only the last incomplete chunk is left in the transaction for the caller
+    TableCopier copier(srcDb, dstDb);
+    copier.setCommitInterval(2000);
+    QVERIFY(dstDb->begin());
+    QVERIFY2(copier.copy("test", "test"), copier.getErrorText().toUtf8().constData());
+    QCOMPARE(copier.getCopiedRows(), static_cast<qint64>(ROWS));
+
+    QVERIFY(dstDb->rollback());
+    QCOMPARE(countRows(dstDb), 10000);
+}
+
+void TableCopierTest::testInterrupt()
+{
+    // Interrupted before the third chunk is inserted. The reader thread is still reading ahead and has to be stopped.
+    int checks = 0;
+    TableCopier copier(srcDb, dstDb);
+    copier.setInterruptCheck([&checks]() -> bool
+    {
+        return ++checks >= 3;
+    });
+
+    QVERIFY(dstDb->begin());
+    QVERIFY(!copier.copy("test", "test"));
+    QVERIFY(copier.getErrorText().isEmpty());
+    QCOMPARE(copier.getCopiedRows(), static_cast<qint64>(2000));
+    QVERIFY(dstDb->rollback());
+    QCOMPARE(countRows(dstDb), 0);
+
+    // Source database is free to use after the copier is done
+    QCOMPARE(countRows(srcDb), ROWS);
+}
+
+void TableCopierTest::testSourceError()
+{
+    TableCopier copier(srcDb, dstDb);
+    QVERIFY(dstDb->begin());
+    QVERIFY(!copier.copy("no_such_table", "test"));
+    QVERIFY(!copier.getErrorText().isEmpty());
+    QCOMPARE(copier.getCopiedRows(), static_cast<qint64>(0));
+    QVERIFY(dstDb->rollback());
+}
+
+QTEST_APPLESS_MAIN(TableCopierTest)
+
+#include "tst_tablecopiertest.moc"
@@ -18,6 +18,8 @@ class TableModifierTest : public QObject
 
     private:
         void verifyRe(const QString& re, const QString& sql, Qt::CaseSensitivity cs = Qt::CaseSensitive);
+        void forceRebuild();
+        int getSqliteVersion();
 
         Db* db = nullptr;
         static const constexpr char* mainTableDdl = "CREATE TABLE test (id int, val text, val2 text);";
@@ -33,6 +35,9 @@ class TableModifierTest : public QObject
         void testCase4();
         void testCase5();
         void testCase6();
+        void testNativeRename();
+        void testNativeAddAndDropColumn();
+        void testNativeFallback();
 };
 
 TableModifierTest::TableModifierTest()
@@ -45,8 +50,21 @@ void TableModifierTest::verifyRe(const QString& re, const QString& sql, Qt::Case
     QVERIFY2(regExp.exactMatch(sql), QString("Failed RegExp validation:\n%1\nfor SQL:\n%2").arg(re).arg(sql).toLatin1().data());
 }
 
+void TableModifierTest::forceRebuild()
+{
+    // Renaming in place is not done in legacy mode
+    db->exec("PRAGMA legacy_alter_table = 1;");
+}
+
+int TableModifierTest::getSqliteVersion()
+{
+    QStringList parts = db->exec("SELECT sqlite_version();")->getSingleCell().toString().split(".");
+    return parts.value(0).toInt() * 1000000 + parts.value(1).toInt() * 1000 + parts.value(2).toInt();
+}
+
 void TableModifierTest::testCase1()
 {
+    forceRebuild();
     db->exec("CREATE TABLE abc (id int, xyz text REFERENCES test (val));");
 
     TableModifier mod(db, "test");
@@ -76,6 +94,7 @@ void TableModifierTest::testCase1()
 
 void TableModifierTest::testCase2()
 {
+    forceRebuild();
     db->exec("CREATE TABLE abc (id int, xyz text REFERENCES test (val));");
 
     TableModifier mod(db, "test");
@@ -107,6 +126,7 @@ void TableModifierTest::testCase2()
 
 void TableModifierTest::testCase3()
 {
+    forceRebuild();
     db->exec("CREATE TABLE abc (id int, xyz text REFERENCES test (val));");
     db->exec("CREATE INDEX i1 ON test (val);");
     db->exec("CREATE INDEX i2 ON abc (id);");
@@ -143,6 +163,7 @@ void TableModifierTest::testCase3()
 
 void TableModifierTest::testCase4()
 {
+    forceRebuild();
     db->exec("CREATE TRIGGER t1 AFTER UPDATE OF Val ON Test BEGIN "
              "SELECT * FROM (SELECT Val FROM Test); "
              "UPDATE Test SET Val = (SELECT Val FROM Test) WHERE x = (SELECT Val FROM Test); "
@@ -176,6 +197,7 @@ void TableModifierTest::testCase4()
 
 void TableModifierTest::testCase5()
 {
+    forceRebuild();
     db->exec("CREATE VIEW v1 AS SELECT * FROM (SELECT Val FROM Test);");
     db->exec("CREATE TRIGGER t1 INSTEAD OF INSERT ON v1 BEGIN SELECT 1; END;");
     db->exec("CREATE TRIGGER t2 AFTER INSERT ON v1 BEGIN SELECT 1; END;");
@@ -232,6 +254,100 @@ void TableModifierTest::testCase6()
     verifyRe("CREATE VIEW v1 AS SELECT \\* FROM \\(SELECT Id, NULL FROM newTable\\);", sqls[i++]);
 }
 
+void TableModifierTest::testNativeRename()
+{
+    if (getSqliteVersion() < 3026000)
+        QSKIP("SQLite library is too old to rename in place.");
+
+    db->exec("CREATE TABLE abc (id int, xyz text REFERENCES test (val));");
+    db->exec("CREATE INDEX i1 ON test (val);");
+
+    TableModifier mod(db, "test");
+    createTable->table = "newTable";
+    createTable->columns[1]->name = "newCol";
+    mod.alterTable(createTable);
+    QStringList sqls = mod.generateSqls();
+
+    /*
+     * 1. Rename table.
+     * 2. Rename column.
+     * Index and referencing table are updated by SQLite.
+     */
+    QVERIFY(sqls.size() == 2);
+    int i = 0;
+    verifyRe("ALTER TABLE test RENAME TO newTable;", sqls[i++]);
+    verifyRe("ALTER TABLE newTable RENAME COLUMN val TO newCol;", sqls[i++]);
+    QVERIFY(!mod.isRebuildRequired());
+    QVERIFY(mod.getEstimatedRowsToRewrite() == 0);
+    QVERIFY(mod.getModifiedTables().contains("abc"));
+    QVERIFY(mod.getModifiedIndexes().contains("i1"));
+}
+
+void TableModifierTest::testNativeAddAndDropColumn()
+{
+    if (getSqliteVersion() < 3035005)
+        QSKIP("SQLite library is too old to drop columns in place.");
+
+    db->exec("INSERT INTO test VALUES (1, 'a', 'b');");
+    db->exec("INSERT INTO test VALUES (2, 'c', 'd');");
+
+    Parser parser(db->getDialect());
+    QVERIFY(parser.parse("CREATE TABLE x (newCol integer NOT NULL DEFAULT 5);"));
+    SqliteCreateTablePtr colDef = parser.getQueries().first().dynamicCast<SqliteCreateTable>();
+    SqliteCreateTable::Column* newColumn = colDef->columns.takeFirst();
+    newColumn->originalName = QString();
+    newColumn->setParent(createTable.data());
+
+    TableModifier mod(db, "test");
+    delete createTable->columns.takeAt(2);
+    createTable->columns << newColumn;
+    mod.alterTable(createTable);
+    QStringList sqls = mod.generateSqls();
+
+    QVERIFY(sqls.size() == 2);
+    int i = 0;
+    verifyRe("ALTER TABLE test DROP COLUMN val2;", sqls[i++]);
+    verifyRe("ALTER TABLE test ADD COLUMN newCol integer NOT NULL DEFAULT 5;", sqls[i++]);
+    QVERIFY(!mod.isRebuildRequired());
+    QVERIFY(mod.getEstimatedRowsToRewrite() == 2);
+}
+
+void TableModifierTest::testNativeFallback()
+{
+    Parser parser(db->getDialect());
+    QVERIFY(parser.parse("CREATE TABLE x (newCol integer NOT NULL);"));
+    SqliteCreateTablePtr colDef = parser.getQueries().first().dynamicCast<SqliteCreateTable>();
+    SqliteCreateTable::Column* newColumn = colDef->columns.takeFirst();
+    newColumn->originalName = QString();
+    newColumn->setParent(createTable.data());
+
+    // NOT NULL column without default value cannot be added in place
+    TableModifier mod(db, "test");
+    createTable->columns << newColumn;
+    mod.alterTable(createTable);
+    QStringList sqls = mod.generateSqls();
+
+    /*
+     * 1. Disable foreign keys.
+     * 2. Copy data to temp table.
+     * 3. Drop old table.
+     * 4. Create new.
+     * 5. Copy data from temp table to new one.
+     * 6. Drop temp table.
+     * 7. Enable foreign keys.
+     */
+    QVERIFY(sqls.size() == 7);
+    int i = 0;
+    verifyRe("PRAGMA foreign_keys = 0;", sqls[i++]);
+    verifyRe("CREATE TABLE sqlitestudio_temp_table.* AS SELECT \\* FROM test;", sqls[i++]);
+    verifyRe("DROP TABLE test;", sqls[i++]);
+    verifyRe("CREATE TABLE test .*newCol integer NOT NULL.*", sqls[i++]);
+    verifyRe("INSERT INTO test.*SELECT.*FROM sqlitestudio_temp_table.*", sqls[i++]);
+    verifyRe("DROP TABLE sqlitestudio_temp_table.*", sqls[i++]);
+    verifyRe("PRAGMA foreign_keys = 1;", sqls[i++]);
+    QVERIFY(mod.isRebuildRequired());
+}
+
 void TableModifierTest::initTestCase()
 {
     initKeywords();
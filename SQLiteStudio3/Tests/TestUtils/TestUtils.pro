@@ -23,7 +23,10 @@ SOURCES += \
     mocks.cpp \
     dbattachermock.cpp \
     dbmanagermock.cpp \
-    collationmanagermock.cpp
+    collationmanagermock.cpp \
+    testdata.cpp \
+    benchmarkutils.cpp \
+    regexpfunctionmanagermock.cpp
 
 HEADERS +=\
         testutils_global.h \
@@ -35,7 +38,10 @@ HEADERS +=\
     mocks.h \
     dbattachermock.h \
     dbmanagermock.h \
-    collationmanagermock.h
+    collationmanagermock.h \
+    testdata.h \
+    benchmarkutils.h \
+    regexpfunctionmanagermock.h
 
 unix:!symbian {
     maemo5 {
@@ -0,0 +1,8 @@
+#include "benchmarkutils.h"
+#include <QDebug>
+
+void printThroughput(const QString& label, double amount, const QString& unit, qint64 nsecs)
+{
+    double perSec = amount / (nsecs / 1000000000.0);
+    qDebug().noquote() << label << QString::number(perSec, 'f', 2) << unit + "/s";
+}
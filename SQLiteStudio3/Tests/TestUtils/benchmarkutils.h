@@ -0,0 +1,15 @@
+#ifndef BENCHMARKUTILS_H
+#define BENCHMARKUTILS_H
+
+#include <QString>
+
+/**
+ * @brief Prints throughput of a benchmarked operation.
+ * @param label Description of the operation.
+ * @param amount Amount of processed data (bytes, rows, etc).
+ * @param unit Unit of the \p amount.
+ * @param nsecs Time that the processing took, in nanoseconds.
+ */
+void printThroughput(const QString& label, double amount, const QString& unit, qint64 nsecs);
+
+#endif // BENCHMARKUTILS_H
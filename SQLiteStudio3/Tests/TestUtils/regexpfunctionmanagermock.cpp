@@ -0,0 +1,26 @@
+#include "regexpfunctionmanagermock.h"
+#include "services/impl/functionmanagerimpl.h"
+
+RegExpFunctionManagerMock::RegExpFunctionManagerMock()
+{
+    regExpFunction.name = "regexp";
+    regExpFunction.arguments = {"pattern", "arg"};
+    regExpFunction.undefinedArgs = false;
+    regExpFunction.functionPtr = FunctionManagerImpl::nativeRegExp;
+}
+
+QList<FunctionManager::NativeFunction*> RegExpFunctionManagerMock::getAllNativeFunctions() const
+{
+    return {const_cast<NativeFunction*>(&regExpFunction)};
+}
+
+QVariant RegExpFunctionManagerMock::evaluateScalar(const QString& name, int argCount, const QList<QVariant>& args, Db* db, bool& ok)
+{
+    if (name.toLower() != regExpFunction.name || argCount != 2)
+    {
+        ok = false;
+        return QVariant();
+    }
+
+    return regExpFunction.functionPtr(args, db, ok);
+}
@@ -0,0 +1,21 @@
+#ifndef REGEXPFUNCTIONMANAGERMOCK_H
+#define REGEXPFUNCTIONMANAGERMOCK_H
+
+#include "functionmanagermock.h"
+
+/**
+ * @brief Function manager providing only the native REGEXP function.
+ */
+class RegExpFunctionManagerMock : public FunctionManagerMock
+{
+    public:
+        RegExpFunctionManagerMock();
+
+        QList<NativeFunction*> getAllNativeFunctions() const;
+        QVariant evaluateScalar(const QString& name, int argCount, const QList<QVariant>& args, Db* db, bool& ok);
+
+    private:
+        NativeFunction regExpFunction;
+};
+
+#endif // REGEXPFUNCTIONMANAGERMOCK_H
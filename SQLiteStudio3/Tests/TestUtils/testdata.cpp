@@ -0,0 +1,20 @@
+#include "testdata.h"
+
+QList<QVariant> generateTestRow(qint64 i)
+{
+    return {i, QString("value %1").arg(i), i * 0.5, QVariant(), QByteArray::number(i)};
+}
+
+QByteArray generateTestCsv(int rows)
+{
+    QByteArray data;
+    for (int i = 0; i < rows; i++)
+    {
+        data += QByteArray::number(i) + ",plain value " + QByteArray::number(i) + ",\"quoted, \"\"value\"\" " +
+                QByteArray::number(i * 7) + "\",\"multi\r\nline\",3.14159\r\n";
+    }
+
+    // Legacy CSV deserialization doesn't recognize the row separator at the very end of the data
+    data.chop(2);
+    return data;
+}
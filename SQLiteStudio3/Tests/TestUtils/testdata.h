@@ -0,0 +1,22 @@
+#ifndef TESTDATA_H
+#define TESTDATA_H
+
+#include <QByteArray>
+#include <QList>
+#include <QVariant>
+
+/**
+ * @brief Generates a row with values of all basic types: integer, text, real, NULL and blob.
+ * @param i Row number, all values are derived from it.
+ * @return Values for columns of the test table: (id, txt, num, nothing, data).
+ */
+QList<QVariant> generateTestRow(qint64 i);
+
+/**
+ * @brief Generates CSV data with quoted values, escaped quotes and multi-line values.
+ * @param rows Number of rows to generate.
+ * @return CSV data with CRLF row separators, without the separator after the last row.
+ */
+QByteArray generateTestCsv(int rows);
+
+#endif // TESTDATA_H
@@ -23,6 +23,33 @@ db_ver_conv.depends = test_utils
 dsv.subdir = DsvFormatsTest
 dsv.depends = test_utils
 
+regexp_function.subdir = RegExpFunctionTest
+regexp_function.depends = test_utils
+
+bulk_insert.subdir = BulkInsertTest
+bulk_insert.depends = test_utils
+
+schema_resolver.subdir = SchemaResolverTest
+schema_resolver.depends = test_utils
+
+query_executor.subdir = QueryExecutorTest
+query_executor.depends = test_utils
+
+db_manager.subdir = DbManagerTest
+db_manager.depends = test_utils
+
+text_output_buffer.subdir = TextOutputBufferTest
+text_output_buffer.depends = test_utils
+
+table_copier.subdir = TableCopierTest
+table_copier.depends = test_utils
+
+config_impl.subdir = ConfigTest
+config_impl.depends = test_utils
+
+benchmarks.subdir = Benchmarks
+benchmarks.depends = test_utils
+
 SUBDIRS += \
     test_utils \
     completion_helper \
@@ -32,4 +59,13 @@ SUBDIRS += \
     hash_tables \
     db_ver_conv \
     dsv \
-    UtilsTest
+    UtilsTest \
+    regexp_function \
+    bulk_insert \
+    schema_resolver \
+    query_executor \
+    db_manager \
+    text_output_buffer \
+    table_copier \
+    config_impl \
+    benchmarks
@@ -0,0 +1,171 @@
+#include "common/textoutputbuffer.h"
+#include <QString>
+#include <QtTest>
+#include <QBuffer>
+#include <QTextCodec>
+#include <QTextEncoder>
+#include <QScopedPointer>
+
+// U+1F600, encoded as a surrogate pair in UTF-16
+static const QChar highSurrogate(0xD83D);
+static const QChar lowSurrogate(0xDE00);
+
+class TextOutputBufferTest : public QObject
+{
+        Q_OBJECT
+
+    public:
+        TextOutputBufferTest();
+
+    private:
+        QString testText();
+
+        QByteArray data;
+        QBuffer* device = nullptr;
+
+    private Q_SLOTS:
+        void init();
+        void cleanup();
+        void testChunkBoundaries_data();
+        void testChunkBoundaries();
+        void testSurrogatePairInSeparateWrites();
+        void testTrailingHighSurrogateFlushed();
+        void testTrailingHighSurrogateFlushedOnDestruction();
+        void testOtherCodec();
+        void testBackgroundWriting();
+};
+
+TextOutputBufferTest::TextOutputBufferTest()
+{
+}
+
+QString TextOutputBufferTest::testText()
+{
+    // Characters encoded in UTF-8 with 1, 2, 3 and 4 bytes. The last one is a surrogate pair in UTF-16.
+    QString piece = QString::fromUtf8("abc za\xc5\xbc\xc3\xb3\xc5\x82\xc4\x87 \xe2\x82\xac") + highSurrogate + lowSurrogate + "\n";
+
+    QString text;
+    for (int i = 0; i < 100; i++)
+        text += piece;
+
+    return text;
+}
+
+void TextOutputBufferTest::init()
+{
+    data.clear();
+    device = new QBuffer(&data);
+    device->open(QIODevice::WriteOnly);
+}
+
+void TextOutputBufferTest::cleanup()
+{
+    delete device;
+    device = nullptr;
+}
+
+void TextOutputBufferTest::testChunkBoundaries_data()
+{
+    QTest::addColumn<int>("bufferSize");
+    QTest::addColumn<int>("writeSize");
+
+    // Buffer and write sizes are odd, so surrogate pairs are split at the chunk boundaries
+    QTest::newRow("1 char buffer") << 1 << 1;
+    QTest::newRow("2 chars buffer") << 2 << 3;
+    QTest::newRow("13 chars buffer") << 13 << 1;
+    QTest::newRow("13 chars buffer, long writes") << 13 << 29;
+    QTest::newRow("default buffer") << static_cast<int>(TextOutputBuffer::DEFAULT_BUFFER_SIZE) << 7;
+}
+
+void TextOutputBufferTest::testChunkBoundaries()
+{
+    QFETCH(int, bufferSize);
+    QFETCH(int, writeSize);
+
+    QString text = testText();
+    TextOutputBuffer buffer(device, nullptr, bufferSize);
+    for (int i = 0; i < text.size(); i += writeSize)
+        buffer.write(text.mid(i, writeSize));
+
+    QVERIFY(buffer.flush());
+    QCOMPARE(data, text.toUtf8());
+}
+
+void TextOutputBufferTest::testSurrogatePairInSeparateWrites()
+{
+    QString pair = QString(highSurrogate) + lowSurrogate;
+
+    TextOutputBuffer buffer(device, nullptr);
+    buffer.setFlushPolicy(TextOutputBuffer::FlushPolicy::EVERY_WRITE);
+
+    // High surrogate alone is held until its pair comes
+    buffer.write(pair[0]);
+    QVERIFY(data.isEmpty());
+
+    buffer.write(pair[1]);
+    QCOMPARE(data, pair.toUtf8());
+
+    QVERIFY(buffer.flush());
+    QCOMPARE(data, pair.toUtf8());
+}
+
+void TextOutputBufferTest::testTrailingHighSurrogateFlushed()
+{
+    QString text = QString("abc") + highSurrogate;
+
+    TextOutputBuffer buffer(device, nullptr, 2);
+    buffer.write(text);
+    QCOMPARE(data, QByteArray("abc"));
+
+    // Nothing follows, so the unpaired surrogate is written as it is, instead of staying in the buffer
+    QVERIFY(buffer.flush());
+    QCOMPARE(data, text.toUtf8());
+    QVERIFY(data.size() > 3);
+}
+
+void TextOutputBufferTest::testTrailingHighSurrogateFlushedOnDestruction()
+{
+    QString text = QString("abc") + highSurrogate;
+    {
+        TextOutputBuffer buffer(device, nullptr);
+        buffer.write(text);
+    }
+    QCOMPARE(data, text.toUtf8());
+}
+
+void TextOutputBufferTest::testOtherCodec()
+{
+    QTextCodec* codec = QTextCodec::codecForName("UTF-16");
+    QVERIFY(codec);
+
+    // Byte order mark is written only once, at the beginning
+    QString text = testText();
+    QScopedPointer<QTextEncoder> encoder(codec->makeEncoder());
+    QByteArray expected = encoder->fromUnicode(text);
+
+    TextOutputBuffer buffer(device, codec, 13);
+    for (int i = 0; i < text.size(); i += 5)
+        buffer.write(text.mid(i, 5));
+
+    QVERIFY(buffer.flush());
+    QCOMPARE(data, expected);
+}
+
+void TextOutputBufferTest::testBackgroundWriting()
+{
+    QString text;
+    for (int i = 0; i < 50; i++)
+        text += testText();
+
+    TextOutputBuffer buffer(device, nullptr, 101);
+    buffer.setBackgroundWriting(true);
+    for (int i = 0; i < text.size(); i += 11)
+        buffer.write(text.mid(i, 11));
+
+    QVERIFY(buffer.flush());
+    QCOMPARE(data, text.toUtf8());
+}
+
+QTEST_APPLESS_MAIN(TextOutputBufferTest)
+
+#include "tst_textoutputbuffertest.moc"
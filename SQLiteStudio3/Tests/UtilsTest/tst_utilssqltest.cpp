@@ -14,6 +14,7 @@ private Q_SLOTS:
     void testRemoveEmpties();
     void testRemoveComments();
     void testRemoveCommentsAndEmpties();
+    void testAppendValueAsSql();
 };
 
 UtilsSqlTest::UtilsSqlTest()
@@ -70,6 +71,18 @@ void UtilsSqlTest::testRemoveCommentsAndEmpties()
     QVERIFY2(sp[0] == "select 'dfgh ;sdg /*''*/ dfga' from aa;", failure.arg(sp[0]).toLatin1().data());
 }
 
+void UtilsSqlTest::testAppendValueAsSql()
+{
+    QList<QVariant> values = {QVariant(), 5, 2.5, true, QByteArray("\x01\xab"), "it's", QString()};
+    QString sql = "x";
+    for (const QVariant& value : values)
+        appendValueAsSql(sql, value, Dialect::Sqlite3);
+
+    QCOMPARE(sql, QString("xNULL52.51X'01AB''it''s'NULL"));
+    QCOMPARE(valueListToSqlList(values, Dialect::Sqlite3),
+             QStringList({"NULL", "5", "2.5", "1", "X'01AB'", "'it''s'", "NULL"}));
+}
+
 QTEST_APPLESS_MAIN(UtilsSqlTest)
 
 #include "tst_utilssqltest.moc"
@@ -0,0 +1,161 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <QQueue>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+
+/**
+ * @brief Queue for passing items between a producer thread and a consumer thread.
+ *
+ * It holds at most the given number of items. The push() blocks while the queue is full,
+ * so a fast producer is slowed down to the pace of the consumer (and vice versa, pop() blocks while the queue is empty).
+ *
+ * Producer calls close() after pushing the last item. Consumer keeps popping until pop() returns false.
+ * Either side (or any other thread) can call abort() to make all pending and future calls return false immediately.
+ *
+ * Items should be batches of data (not single values), so the cost of locking is spread over many values.
+ */
+template <class T>
+class BoundedQueue
+{
+    public:
+        /**
+         * @brief Creates queue.
+         * @param capacity Maximum number of items in the queue.
+         */
+        explicit BoundedQueue(int capacity);
+
+        /**
+         * @brief Adds item at the end of the queue.
+         * @param item Item to add.
+         * @return true if the item was added, or false if the queue was closed or aborted.
+         *
+         * Blocks until there is free space in the queue.
+         */
+        bool push(const T& item);
+
+        /**
+         * @brief Takes item from the begining of the queue.
+         * @param item Item taken from the queue.
+         * @return true if the item was taken, or false if the queue was closed and all items were already taken, or if it was aborted.
+         *
+         * Blocks until there is any item in the queue.
+         */
+        bool pop(T& item);
+
+        /**
+         * @brief Takes item from the begining of the queue, if there is any.
+         * @param item Item taken from the queue.
+         * @return true if the item was taken, or false if the queue is empty or was aborted.
+         *
+         * Unlike pop(), it never blocks, so it can be called from the thread that has to stay responsive (like the UI thread).
+         */
+        bool tryPop(T& item);
+
+        /**
+         * @brief Marks that no more items will be pushed.
+         *
+         * Items that are already in the queue can still be popped.
+         */
+        void close();
+
+        /**
+         * @brief Stops passing items.
+         *
+         * Wakes up all threads waiting in push() or pop() and discards remaining items.
+         */
+        void abort();
+
+        /**
+         * @brief Tells if the queue was aborted.
+         * @return true if abort() was called.
+         */
+        bool isAborted();
+
+    private:
+        QQueue<T> queue;
+        QMutex mutex;
+        QWaitCondition notEmpty;
+        QWaitCondition notFull;
+        int capacity;
+        bool closed = false;
+        bool aborted = false;
+};
+
+template <class T>
+BoundedQueue<T>::BoundedQueue(int capacity) :
+    capacity(qMax(1, capacity))
+{
+}
+
+template <class T>
+bool BoundedQueue<T>::push(const T& item)
+{
+    QMutexLocker locker(&mutex);
+    while (queue.size() >= capacity && !aborted && !closed)
+        notFull.wait(&mutex);
+
+    if (aborted || closed)
+        return false;
+
+    queue.enqueue(item);
+    notEmpty.wakeOne();
+    return true;
+}
+
+template <class T>
+bool BoundedQueue<T>::pop(T& item)
+{
+    QMutexLocker locker(&mutex);
+    while (queue.isEmpty() && !aborted && !closed)
+        notEmpty.wait(&mutex);
+
+    if (aborted || queue.isEmpty())
+        return false;
+
+    item = queue.dequeue();
+    notFull.wakeOne();
+    return true;
+}
+
+template <class T>
+bool BoundedQueue<T>::tryPop(T& item)
+{
+    QMutexLocker locker(&mutex);
+    if (aborted || queue.isEmpty())
+        return false;
+
+    item = queue.dequeue();
+    notFull.wakeOne();
+    return true;
+}
+
+template <class T>
+void BoundedQueue<T>::close()
+{
+    QMutexLocker locker(&mutex);
+    closed = true;
+    notEmpty.wakeAll();
+    notFull.wakeAll();
+}
+
+template <class T>
+void BoundedQueue<T>::abort()
+{
+    QMutexLocker locker(&mutex);
+    aborted = true;
+    queue.clear();
+    notEmpty.wakeAll();
+    notFull.wakeAll();
+}
+
+template <class T>
+bool BoundedQueue<T>::isAborted()
+{
+    QMutexLocker locker(&mutex);
+    return aborted;
+}
+
+#endif // BOUNDEDQUEUE_H
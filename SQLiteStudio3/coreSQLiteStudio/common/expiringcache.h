@@ -27,6 +27,7 @@ class ExpiringCache : public QCache<K, V>
 
     private:
         bool expired(const K& key) const;
+        void pruneExpires();
 
         mutable QHash<K, qint64> expires;
         int expireMs;
@@ -46,20 +47,20 @@ ExpiringCache<K, V>::~ExpiringCache()
 template <class K, class V>
 bool ExpiringCache<K, V>::insert(const K& key, V* object, int cost)
 {
-    QList<K> keysBefore = QCache<K, V>::keys();
     bool result = QCache<K, V>::insert(key, object, cost);
     if (!result)
-        return false;
-
-    QList<K> keysAfter = QCache<K, V>::keys();
-
-    for (const K& keyBefore : keysBefore)
     {
-        if (!keysAfter.contains(keyBefore))
-            expires.remove(keyBefore);
+        expires.remove(key);
+        return false;
     }
 
     expires[key] = QDateTime::currentMSecsSinceEpoch() + expireMs;
+
+    // Entries evicted by the QCache are not reported, so their expire times are dropped
+    // once in a while, instead of comparing key lists on every insert.
+    if (expires.size() > QCache<K, V>::maxCost() * 2)
+        pruneExpires();
+
     return true;
 }
 
@@ -144,6 +145,17 @@ void ExpiringCache<K, V>::setExpireTime(int ms)
     expireMs = ms;
 }
 
+template <class K, class V>
+void ExpiringCache<K, V>::pruneExpires()
+{
+    QMutableHashIterator<K, qint64> it(expires);
+    while (it.hasNext())
+    {
+        if (!QCache<K, V>::contains(it.next().key()))
+            it.remove();
+    }
+}
+
 template <class K, class V>
 bool ExpiringCache<K, V>::expired(const K& key) const
 {
@@ -2,83 +2,239 @@
 #define OBJECTPOOL_H
 
 #include <QHash>
-#include <QHashIterator>
+#include <QList>
 #include <QMutex>
+#include <QMutexLocker>
 #include <QWaitCondition>
+#include <functional>
 
+/**
+ * @brief Pool of reusable objects shared between threads.
+ *
+ * Objects are created with the creator function - initially the minimum number of them, then more on demand,
+ * up to the maximum number. Reserved object has to be given back with release() when it's no longer needed.
+ * The pool owns all objects and deletes them when they're idle and clear() is called, or when clearAll()
+ * is called or the pool is deleted. The last two wait until all reserved objects are released, since reserved
+ * object cannot be deleted while it's in use by other thread.
+ */
 template <class T>
 class ObjectPool
 {
     public:
-        ObjectPool(quint32 min, quint32 max);
+        typedef std::function<T*()> Creator;
 
+        /**
+         * @brief Creates pool.
+         * @param min Number of objects created up front.
+         * @param max Maximum number of objects in the pool.
+         * @param creator Function creating new object. It may return null if the object could not be created.
+         */
+        ObjectPool(quint32 min, quint32 max, Creator creator = []() {return new T();});
+
+        /**
+         * @brief Deletes all objects.
+         *
+         * Waits until all reserved objects are released (see clearAll()).
+         */
+        ~ObjectPool();
+
+        /**
+         * @brief Takes idle object from the pool.
+         * @return Reserved object, or null if a new object was needed, but the creator function failed.
+         *
+         * If all objects are reserved and the pool has already maximum number of objects, this method blocks
+         * until any object is released. It also returns null while clearAll() is in progress.
+         */
         T* reserve();
+
+        /**
+         * @brief Takes idle object from the pool, without waiting.
+         * @return Reserved object, or null if there is no object available at the moment,
+         * or clearAll() is in progress.
+         */
+        T* tryReserve();
+
+        /**
+         * @brief Gives back reserved object.
+         * @param obj Object to release.
+         */
         void release(T* obj);
 
+        /**
+         * @brief Deletes all idle objects.
+         *
+         * Reserved objects stay in the pool, until they are released and clear() is called again.
+         */
+        void clear();
+
+        /**
+         * @brief Deletes all objects, waiting for reserved objects to be released.
+         * @param reservedHandler Function called periodically for each object that is still reserved,
+         * for example to interrupt the work done with the object, so it's released sooner. Can be null.
+         *
+         * No object can be reserved while this method is in progress. Once it returns, the pool is empty
+         * and can be used again.
+         */
+        void clearAll(std::function<void(T*)> reservedHandler = nullptr);
+
     private:
+        T* reserveInternal(bool wait);
+
         QHash<T*, bool> pool;
         QMutex mutex;
         QWaitCondition waitCond;
-        int min;
+        Creator creator;
         int max;
+        int creating = 0;
+        bool clearing = false;
+
+        /**
+         * @brief How long clearAll() waits for releases before calling the reserved objects handler again.
+         */
+        static const int CLEAR_ALL_WAIT_MS = 100;
 };
 
 template <class T>
-ObjectPool::ObjectPool(quint32 min, quint32 max)
-    : min(min), max(max)
+ObjectPool<T>::ObjectPool(quint32 min, quint32 max, Creator creator)
+    : creator(creator), max(qMax(min, max))
 {
-    Q_ASSERT(min > 0);
     T* obj = nullptr;
-    for (int i = 0; i < min; i++)
+    for (quint32 i = 0; i < min; i++)
+    {
+        obj = creator();
+        if (obj)
+            pool[obj] = false;
+    }
+}
+
+template <class T>
+ObjectPool<T>::~ObjectPool()
+{
+    clearAll();
+}
+
+template <class T>
+T* ObjectPool<T>::reserve()
+{
+    return reserveInternal(true);
+}
+
+template <class T>
+T* ObjectPool<T>::tryReserve()
+{
+    return reserveInternal(false);
+}
+
+template <class T>
+void ObjectPool<T>::release(T* obj)
+{
+    QMutexLocker locker(&mutex);
+    if (!pool.contains(obj))
+        return;
+
+    pool[obj] = false;
+    waitCond.wakeAll(); // wakes both reserve() and clearAll()
+}
+
+template <class T>
+void ObjectPool<T>::clear()
+{
+    QMutexLocker locker(&mutex);
+    QMutableHashIterator<T*, bool> it(pool);
+    while (it.hasNext())
     {
-        obj = new T();
-        pool[obj] = false;
+        it.next();
+        if (it.value())
+            continue;
+
+        delete it.key();
+        it.remove();
     }
 }
 
-T* ObjectPool::reserve()
+template <class T>
+void ObjectPool<T>::clearAll(std::function<void(T*)> reservedHandler)
 {
-    mutex.lock();
+    QMutexLocker locker(&mutex);
+    clearing = true;
+    forever
+    {
+        QList<T*> reserved;
+        for (typename QHash<T*, bool>::const_iterator it = pool.constBegin(); it != pool.constEnd(); ++it)
+        {
+            if (it.value())
+                reserved << it.key();
+        }
+
+        if (reserved.isEmpty() && creating == 0)
+            break;
+
+        if (reservedHandler)
+        {
+            for (T* obj : reserved)
+                reservedHandler(obj);
+        }
+
+        waitCond.wait(&mutex, CLEAR_ALL_WAIT_MS);
+    }
+
+    for (T* obj : pool.keys())
+        delete obj;
+
+    pool.clear();
+    clearing = false;
+    waitCond.wakeAll();
+}
 
+template <class T>
+T* ObjectPool<T>::reserveInternal(bool wait)
+{
+    QMutexLocker locker(&mutex);
     forever
     {
-        QHashIterator<T*, bool> i(pool);
-        while (i.hasNext())
+        if (clearing)
+            return nullptr;
+
+        for (typename QHash<T*, bool>::iterator it = pool.begin(); it != pool.end(); ++it)
         {
-            i.next();
-            if (!i.value())
+            if (!it.value())
             {
-                pool[i.key()] = true;
-                T* obj = i.key();
-                mutex.unlock();
-                return obj;
+                it.value() = true;
+                return it.key();
             }
         }
 
-        // Check if we can enlarge the pool
-        if (pool.size() < max)
+        // Check if we can enlarge the pool. Creating object may take a while, so it's done without the lock.
+        if (pool.size() + creating < max)
         {
-            T* obj = new T();
-            pool[i.key()] = true;
-            mutex.unlock();
+            creating++;
+            locker.unlock();
+            T* obj = creator();
+            locker.relock();
+            creating--;
+
+            if (clearing)
+            {
+                // Pool is being cleared in the meantime, so the new object is not needed anymore
+                delete obj;
+                waitCond.wakeAll();
+                return nullptr;
+            }
+
+            if (obj)
+                pool[obj] = true;
+            else
+                waitCond.wakeAll(); // the slot for a new object is free again
+
             return obj;
         }
 
+        if (!wait)
+            return nullptr;
+
         // Wait for release
         waitCond.wait(&mutex);
     }
-
-    // no need to unlock, because the loop will repeat
-    // until the free obj is found and then mutex is unlocked.
-}
-
-template <class T>
-void ObjectPool::release(T* obj)
-{
-    mutex.lock();
-    pool[obj] = false;
-    mutex.unlock();
-    waitCond.wakeOne();
 }
 
 #endif // OBJECTPOOL_H
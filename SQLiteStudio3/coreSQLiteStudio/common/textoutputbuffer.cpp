@@ -0,0 +1,170 @@
+#include "textoutputbuffer.h"
+#include <QIODevice>
+#include <QTextCodec>
+#include <QMutexLocker>
+
+TextOutputBuffer::TextOutputBuffer(QIODevice* output, QTextCodec* codec, int bufferSize) :
+    output(output), bufferSize(qMax(1, bufferSize))
+{
+    static const int UTF8_MIB = 106;
+
+    utf8 = !codec || codec->mibEnum() == UTF8_MIB;
+    if (!utf8)
+        encoder = codec->makeEncoder();
+
+    buffer.reserve(this->bufferSize + 1024);
+}
+
+TextOutputBuffer::~TextOutputBuffer()
+{
+    flush();
+    if (encoder)
+        delete encoder;
+}
+
+void TextOutputBuffer::write(const QString& str)
+{
+    buffer += str;
+    flushIfNeeded();
+}
+
+void TextOutputBuffer::write(QChar c)
+{
+    buffer += c;
+    flushIfNeeded();
+}
+
+bool TextOutputBuffer::flush()
+{
+    encodeBuffer(true);
+    waitForBackgroundWriter();
+    return !isError();
+}
+
+void TextOutputBuffer::setFlushPolicy(TextOutputBuffer::FlushPolicy value)
+{
+    flushPolicy = value;
+}
+
+void TextOutputBuffer::setBackgroundWriting(bool value)
+{
+    if (!value)
+        waitForBackgroundWriter();
+
+    backgroundWriting = value;
+}
+
+bool TextOutputBuffer::isError()
+{
+    QMutexLocker locker(&errorMutex);
+    return error;
+}
+
+QString TextOutputBuffer::getErrorText()
+{
+    QMutexLocker locker(&errorMutex);
+    return errorText;
+}
+
+void TextOutputBuffer::flushIfNeeded()
+{
+    if (flushPolicy == FlushPolicy::EVERY_WRITE || buffer.size() >= bufferSize)
+        encodeBuffer();
+}
+
+void TextOutputBuffer::encodeBuffer(bool all)
+{
+    if (buffer.isEmpty())
+        return;
+
+    QByteArray data;
+    if (utf8)
+    {
+        // High surrogate at the end has its pair in the next chunk, so it has to be encoded together with it.
+        // When flushing, there is no next chunk, so the unpaired surrogate is encoded as it is.
+        QChar lastChar = buffer[buffer.size() - 1];
+        if (lastChar.isHighSurrogate() && !all)
+        {
+            data = buffer.leftRef(buffer.size() - 1).toUtf8();
+            buffer.resize(0);
+            buffer += lastChar;
+        }
+        else
+        {
+            data = buffer.toUtf8();
+            buffer.resize(0);
+        }
+    }
+    else
+    {
+        data = encoder->fromUnicode(buffer);
+        buffer.resize(0);
+    }
+
+    if (data.isEmpty())
+        return;
+
+    if (backgroundWriting)
+        writeInBackground(data);
+    else
+        writeToDevice(data);
+}
+
+void TextOutputBuffer::writeToDevice(const QByteArray& data)
+{
+    if (output->write(data) != data.size())
+        setError(output->errorString());
+}
+
+void TextOutputBuffer::writeInBackground(const QByteArray& data)
+{
+    if (!writer)
+    {
+        writeQueue = new BoundedQueue<QByteArray>(WRITE_QUEUE_CAPACITY);
+        writer = new Writer(this);
+        writer->start();
+    }
+
+    writeQueue->push(data);
+}
+
+void TextOutputBuffer::waitForBackgroundWriter()
+{
+    if (!writer)
+        return;
+
+    writeQueue->close();
+    writer->wait();
+
+    delete writer;
+    delete writeQueue;
+    writer = nullptr;
+    writeQueue = nullptr;
+}
+
+void TextOutputBuffer::setError(const QString& text)
+{
+    QMutexLocker locker(&errorMutex);
+    error = true;
+    errorText = text;
+}
+
+TextOutputBuffer::Writer::Writer(TextOutputBuffer* buffer) :
+    buffer(buffer)
+{
+}
+
+void TextOutputBuffer::Writer::run()
+{
+    QByteArray data;
+    while (buffer->writeQueue->pop(data))
+    {
+        buffer->writeToDevice(data);
+        if (buffer->isError())
+        {
+            // Rest of data is useless anyway, so producer doesn't have to wait for space in the queue
+            buffer->writeQueue->abort();
+            return;
+        }
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef TEXTOUTPUTBUFFER_H
+#define TEXTOUTPUTBUFFER_H
+
+#include "coreSQLiteStudio_global.h"
+#include "common/boundedqueue.h"
+#include <QString>
+#include <QByteArray>
+#include <QThread>
+#include <QMutex>
+
+class QIODevice;
+class QTextCodec;
+class QTextEncoder;
+
+/**
+ * @brief Buffered writer of text into a device.
+ *
+ * Text written with write() is collected in a buffer and it's encoded and written to the output device
+ * in big chunks, instead of converting and writing every small piece of text separately.
+ * UTF-8 output is encoded directly (without going through QTextCodec), other encodings use a single
+ * QTextEncoder for the whole output, so the byte order mark (if any) is written only once
+ * and multi-character sequences are not broken at chunk boundaries.
+ *
+ * Optionally, encoded chunks can be written to the device in a background thread,
+ * so preparing the next chunk doesn't wait for the disk.
+ *
+ * Buffered text is written to the device only when the buffer is full (see FlushPolicy) and by flush().
+ * Remember to call flush() after all text is written.
+ */
+class API_EXPORT TextOutputBuffer
+{
+    public:
+        /**
+         * @brief Defines when the buffered text is written to the device (apart from explicit flush() calls).
+         */
+        enum class FlushPolicy
+        {
+            WHEN_FULL,     /**< When the buffer size is exceeded. This is the default. */
+            EVERY_WRITE    /**< After every write() call. Useful when the device is read at the same time. */
+        };
+
+        /**
+         * @brief Creates buffer.
+         * @param output Device to write to. It's not owned by the buffer.
+         * @param codec Encoding of the output. If null, the UTF-8 is used.
+         * @param bufferSize Number of characters to collect before writing them to the device.
+         */
+        TextOutputBuffer(QIODevice* output, QTextCodec* codec, int bufferSize = DEFAULT_BUFFER_SIZE);
+
+        /**
+         * @brief Writes any remaining text to the device.
+         */
+        ~TextOutputBuffer();
+
+        /**
+         * @brief Adds text to the output.
+         * @param str Text to add.
+         */
+        void write(const QString& str);
+
+        /**
+         * @brief Adds single character to the output.
+         * @param c Character to add.
+         */
+        void write(QChar c);
+
+        /**
+         * @brief Writes all buffered text to the device.
+         * @return true on success, false if any write to the device failed (since the buffer was created).
+         *
+         * When the background writing is enabled, it waits until all of data is written.
+         * It's meant to be called once all text is written, so a high surrogate left at the end of the text
+         * is written without waiting for its pair.
+         */
+        bool flush();
+
+        void setFlushPolicy(FlushPolicy value);
+
+        /**
+         * @brief Enables writing to the device in a background thread.
+         * @param value true to enable.
+         *
+         * It pays off only for large outputs written to a file. The device must not be used
+         * by anything else until flush() is called.
+         */
+        void setBackgroundWriting(bool value);
+
+        bool isError();
+        QString getErrorText();
+
+        static const int DEFAULT_BUFFER_SIZE = 262144;
+
+    private:
+        class Writer : public QThread
+        {
+            public:
+                explicit Writer(TextOutputBuffer* buffer);
+
+            protected:
+                void run();
+
+            private:
+                TextOutputBuffer* buffer = nullptr;
+        };
+
+        void flushIfNeeded();
+        void encodeBuffer(bool all = false);
+        void writeToDevice(const QByteArray& data);
+        void writeInBackground(const QByteArray& data);
+        void waitForBackgroundWriter();
+        void setError(const QString& text);
+
+        static const int WRITE_QUEUE_CAPACITY = 4;
+
+        QIODevice* output = nullptr;
+        QTextEncoder* encoder = nullptr;
+        bool utf8 = false;
+        QString buffer;
+        int bufferSize;
+        FlushPolicy flushPolicy = FlushPolicy::WHEN_FULL;
+        bool backgroundWriting = false;
+        Writer* writer = nullptr;
+        BoundedQueue<QByteArray>* writeQueue = nullptr;
+        bool error = false;
+        QString errorText;
+        QMutex errorMutex;
+};
+
+#endif // TEXTOUTPUTBUFFER_H
@@ -697,13 +697,17 @@ QString getBindTokenName(const TokenPtr& token)
 }
 
 QueryAccessMode getQueryAccessMode(const QString& query, Dialect dialect, bool* isSelect)
+{
+    return getQueryAccessMode(Lexer::tokenize(query, dialect), isSelect);
+}
+
+QueryAccessMode getQueryAccessMode(const TokenList& tokens, bool* isSelect)
 {
     static QStringList readOnlyCommands = {"ANALYZE", "EXPLAIN", "PRAGMA", "SELECT"};
 
     if (isSelect)
         *isSelect = false;
 
-    TokenList tokens = Lexer::tokenize(query, dialect);
     int keywordIdx = tokens.indexOf(Token::KEYWORD);
     if (keywordIdx < 0)
         return QueryAccessMode::WRITE;
@@ -767,43 +771,61 @@ QueryAccessMode getQueryAccessMode(const QString& query, Dialect dialect, bool*
     return QueryAccessMode::WRITE;
 }
 
-QStringList valueListToSqlList(const QVariantList& values, Dialect dialect)
+void appendValueAsSql(QString& output, const QVariant& value, Dialect dialect)
 {
-    QStringList argList;
-    for (const QVariant& value : values)
+    if (!value.isValid() || value.isNull())
     {
-        if (!value.isValid() || value.isNull())
-        {
-            argList << "NULL";
-            continue;
-        }
+        output += QLatin1String("NULL");
+        return;
+    }
 
-        switch (value.userType())
+    switch (value.userType())
+    {
+        case QVariant::Int:
+        case QVariant::UInt:
+        case QVariant::LongLong:
+        case QVariant::ULongLong:
+            output += value.toString();
+            return;
+        case QVariant::Double:
+            output += doubleToString(value);
+            return;
+        case QVariant::Bool:
+            output += QString::number(value.toInt());
+            return;
+        case QVariant::ByteArray:
         {
-            case QVariant::Int:
-            case QVariant::UInt:
-            case QVariant::LongLong:
-            case QVariant::ULongLong:
-                argList << value.toString();
-                break;
-            case QVariant::Double:
-                argList << doubleToString(value);
-                break;
-            case QVariant::Bool:
-                argList << QString::number(value.toInt());
-                break;
-            case QVariant::ByteArray:
+            if (dialect == Dialect::Sqlite3) // version 2 will go to the regular string processing
             {
-                if (dialect == Dialect::Sqlite3) // version 2 will go to the regular string processing
-                {
-                    argList << "X'" + value.toByteArray().toHex().toUpper() + "'";
-                    break;
-                }
+                output += QLatin1String("X'");
+                output += QLatin1String(value.toByteArray().toHex().toUpper());
+                output += QLatin1Char('\'');
+                return;
             }
-            default:
-                argList << wrapString(escapeString(value.toString()));
-                break;
         }
+        default:
+            break;
+    }
+
+    QString str = value.toString();
+    output += QLatin1Char('\'');
+    if (str.contains('\''))
+        output += escapeString(str);
+    else
+        output += str;
+
+    output += QLatin1Char('\'');
+}
+
+QStringList valueListToSqlList(const QVariantList& values, Dialect dialect)
+{
+    QStringList argList;
+    QString arg;
+    for (const QVariant& value : values)
+    {
+        arg.clear();
+        appendValueAsSql(arg, value, dialect);
+        argList << arg;
     }
     return argList;
 }
@@ -79,7 +79,9 @@ API_EXPORT QString trimBindParamPrefix(const QString& param);
 API_EXPORT QString commentAllSqlLines(const QString& sql);
 API_EXPORT QString getBindTokenName(const TokenPtr& token);
 API_EXPORT QueryAccessMode getQueryAccessMode(const QString& query, Dialect dialect, bool* isSelect = nullptr);
+API_EXPORT QueryAccessMode getQueryAccessMode(const TokenList& tokens, bool* isSelect = nullptr);
 API_EXPORT QStringList valueListToSqlList(const QList<QVariant>& values, Dialect dialect);
+API_EXPORT void appendValueAsSql(QString& output, const QVariant& value, Dialect dialect);
 API_EXPORT QString trimQueryEnd(const QString& query);
 
 
@@ -224,7 +224,15 @@ SOURCES += sqlitestudio.cpp \
     common/private/blockingsocketprivate.cpp \
     querygenerator.cpp \
     common/bistrhash.cpp \
-    plugins/dbpluginstdfilebase.cpp
+    plugins/dbpluginstdfilebase.cpp \
+    db/querymetadatacache.cpp \
+    db/sqlresultsblock.cpp \
+    db/rowcountcache.cpp \
+    db/busybackoff.cpp \
+    csvdeserializer.cpp \
+    db/bulkinserter.cpp \
+    common/textoutputbuffer.cpp \
+    tablecopier.cpp
 
 HEADERS += sqlitestudio.h\
         coreSQLiteStudio_global.h \
@@ -421,7 +429,16 @@ HEADERS += sqlitestudio.h\
     parser/ast/sqliteextendedindexedcolumn.h \
     querygenerator.h \
     common/sortedset.h \
-    plugins/dbpluginstdfilebase.h
+    plugins/dbpluginstdfilebase.h \
+    db/querymetadatacache.h \
+    db/sqlresultsblock.h \
+    db/rowcountcache.h \
+    db/busybackoff.h \
+    csvdeserializer.h \
+    db/bulkinserter.h \
+    common/boundedqueue.h \
+    common/textoutputbuffer.h \
+    tablecopier.h
 
 unix: {
     target.path = $$LIBDIR
@@ -0,0 +1,218 @@
+#include "csvdeserializer.h"
+#include <QTextStream>
+
+CsvDeserializer::CsvDeserializer(QTextStream* stream, const CsvFormat& format) :
+    stream(stream), format(format)
+{
+    init();
+}
+
+CsvDeserializer::CsvDeserializer(const QString& data, const CsvFormat& format) :
+    format(format), buffer(data)
+{
+    init();
+}
+
+void CsvDeserializer::init()
+{
+    if (format.strictColumnSeparator && format.multipleColumnSeparators)
+        columnSeparators = format.columnSeparators;
+    else
+        columnSeparators << format.columnSeparator;
+
+    if (format.strictRowSeparator && format.multipleRowSeparators)
+        rowSeparators = format.rowSeparators;
+    else
+        rowSeparators << format.rowSeparator;
+
+    // For strict separators only the first character can start the separator,
+    // while for non-strict ones each character is a separator on its own.
+    QString special = "\"";
+    for (const QString& sep : columnSeparators)
+        special += format.strictColumnSeparator ? sep.left(1) : sep;
+
+    for (const QString& sep : rowSeparators)
+        special += format.strictRowSeparator ? sep.left(1) : sep;
+
+    specialChars.resize(256);
+    for (const QChar& c : special)
+    {
+        if (c.unicode() < 256)
+            specialChars.setBit(c.unicode());
+        else if (!wideSpecialChars.contains(c))
+            wideSpecialChars += c;
+    }
+}
+
+QStringList CsvDeserializer::nextRow()
+{
+    QStringList cells;
+    QString field;
+    bool quotes = false;
+    bool sepAsLast = false;
+    bool quotedField = false;
+    int start;
+    int sepLength;
+    QChar c;
+
+    while (ensureAvailable(1))
+    {
+        // Copy runs of ordinary characters at once
+        start = pos;
+        if (quotes)
+        {
+            // QString::indexOf() for a single character is vectorized by Qt
+            pos = buffer.indexOf('"', pos);
+            if (pos < 0)
+                pos = buffer.size();
+        }
+        else
+        {
+            while (pos < buffer.size() && !isSpecial(buffer[pos]))
+                pos++;
+        }
+
+        if (pos > start)
+        {
+            field.append(buffer.constData() + start, pos - start);
+            sepAsLast = false;
+            continue;
+        }
+
+        c = buffer[pos];
+        sepAsLast = false;
+        if (!quotes && c == '"')
+        {
+            quotes = true;
+            pos++;
+        }
+        else if (quotes && c == '"')
+        {
+            pos++;
+            if (ensureAvailable(1) && buffer[pos] == '"')
+            {
+                field += c;
+                pos++;
+            }
+            else
+            {
+                quotes = false;
+                quotedField = true;
+            }
+        }
+        else if ((sepLength = matchSeparator(columnSeparators, format.strictColumnSeparator)) > 0)
+        {
+            pos += sepLength;
+            cells << field;
+            field.clear();
+            quotedField = false;
+            sepAsLast = true;
+        }
+        else if ((sepLength = matchSeparator(rowSeparators, format.strictRowSeparator)) > 0)
+        {
+            pos += sepLength;
+            cells << field;
+            return cells;
+        }
+        else
+        {
+            field += c;
+            pos++;
+        }
+    }
+
+    if (field.size() > 0 || sepAsLast || quotedField)
+        cells << field;
+
+    return cells;
+}
+
+QList<QStringList> CsvDeserializer::nextBatch(int maxRows)
+{
+    QList<QStringList> rows;
+    QStringList row;
+    while (rows.size() < maxRows && !atEnd())
+    {
+        row = nextRow();
+        if (row.isEmpty())
+            break;
+
+        rows << row;
+    }
+    return rows;
+}
+
+QList<QStringList> CsvDeserializer::readAll()
+{
+    QList<QStringList> rows;
+    QStringList row;
+    while (!atEnd())
+    {
+        row = nextRow();
+        if (row.isEmpty())
+            break;
+
+        rows << row;
+    }
+    return rows;
+}
+
+bool CsvDeserializer::atEnd()
+{
+    return !ensureAvailable(1);
+}
+
+void CsvDeserializer::rewind()
+{
+    pos = 0;
+    if (!stream)
+        return;
+
+    buffer.clear();
+    stream->seek(0);
+}
+
+bool CsvDeserializer::ensureAvailable(int length)
+{
+    if (buffer.size() - pos >= length)
+        return true;
+
+    if (!stream)
+        return false;
+
+    // Drop consumed part of the buffer and read next block(s)
+    buffer.remove(0, pos);
+    pos = 0;
+    while (buffer.size() < length && !stream->atEnd())
+        buffer += stream->read(BLOCK_SIZE);
+
+    return buffer.size() >= length;
+}
+
+int CsvDeserializer::matchSeparator(const QStringList& separators, bool strict)
+{
+    QChar c = buffer[pos];
+    if (!strict)
+        return separators.first().contains(c) ? 1 : 0;
+
+    for (const QString& sep : separators)
+    {
+        if (sep.isEmpty() || sep[0] != c)
+            continue;
+
+        if (!ensureAvailable(sep.size()))
+            continue;
+
+        if (buffer.midRef(pos, sep.size()) == sep)
+            return sep.size();
+    }
+    return 0;
+}
+
+bool CsvDeserializer::isSpecial(const QChar& c) const
+{
+    if (c.unicode() < 256)
+        return specialChars.testBit(c.unicode());
+
+    return !wideSpecialChars.isEmpty() && wideSpecialChars.contains(c);
+}
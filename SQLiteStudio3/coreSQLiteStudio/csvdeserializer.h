@@ -0,0 +1,107 @@
+#ifndef CSVDESERIALIZER_H
+#define CSVDESERIALIZER_H
+
+#include "coreSQLiteStudio_global.h"
+#include "csvformat.h"
+#include <QStringList>
+#include <QBitArray>
+
+class QTextStream;
+
+/**
+ * @brief Incremental CSV reader.
+ *
+ * It reads the input in blocks of decoded characters and parses it in a single pass,
+ * without ever seeking back in the stream. Multi-character separators are matched
+ * against the internal buffer, so it's safe to use it with any codec set on the stream.
+ *
+ * Parsing rules are the same as for CsvSerializer::deserialize(), so it can be used
+ * as a drop-in replacement for reading big inputs entry by entry (or batch by batch).
+ *
+ * Since the stream is read ahead, it must not be read by anything else while it's used by this class.
+ */
+class API_EXPORT CsvDeserializer
+{
+    public:
+        /**
+         * @brief Creates deserializer reading from the stream.
+         * @param stream Stream to read. It's not owned by the deserializer.
+         * @param format CSV format of the data.
+         */
+        CsvDeserializer(QTextStream* stream, const CsvFormat& format);
+
+        /**
+         * @brief Creates deserializer reading from the string.
+         * @param data CSV data.
+         * @param format CSV format of the data.
+         */
+        CsvDeserializer(const QString& data, const CsvFormat& format);
+
+        /**
+         * @brief Reads next entry (row) of the data.
+         * @return List of cells, or empty list if there is no more data.
+         */
+        QStringList nextRow();
+
+        /**
+         * @brief Reads many entries at once.
+         * @param maxRows Maximum number of entries to read.
+         * @return Entries read. There is less of them than requested only when the end of the data was reached.
+         */
+        QList<QStringList> nextBatch(int maxRows);
+
+        /**
+         * @brief Reads all remaining entries.
+         * @return Entries read.
+         */
+        QList<QStringList> readAll();
+
+        /**
+         * @brief Tells if there is any more data to read.
+         * @return true if all of the data was consumed.
+         */
+        bool atEnd();
+
+        /**
+         * @brief Goes back to the begining of the data.
+         *
+         * In case of reading from the stream, the stream is seeked to the position 0.
+         */
+        void rewind();
+
+    private:
+        void init();
+        bool ensureAvailable(int length);
+        int matchSeparator(const QStringList& separators, bool strict);
+        bool isSpecial(const QChar& c) const;
+
+        static const int BLOCK_SIZE = 65536;
+
+        QTextStream* stream = nullptr;
+        CsvFormat format;
+
+        /**
+         * @brief Separators to match, resolved from the format.
+         *
+         * For strict separators these are whole separator strings, for non-strict it's a single string
+         * of which any character is a separator.
+         */
+        QStringList columnSeparators;
+        QStringList rowSeparators;
+        QString buffer;
+        int pos = 0;
+
+        /**
+         * @brief Characters (up to code 255) that can start a separator or a quoted section.
+         *
+         * Any other characters are copied to the field in runs, without inspecting them one by one.
+         */
+        QBitArray specialChars;
+
+        /**
+         * @brief Special characters with codes above 255. Usually empty.
+         */
+        QString wideSpecialChars;
+};
+
+#endif // CSVDESERIALIZER_H
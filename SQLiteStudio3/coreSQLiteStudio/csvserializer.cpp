@@ -1,4 +1,5 @@
 #include "csvserializer.h"
+#include "csvdeserializer.h"
 #include <QStringList>
 
 // TODO write unit tests for CsvSerializer
@@ -200,7 +201,8 @@ QStringList CsvSerializer::deserializeOneEntry(QTextStream& data, const CsvForma
 
 QList<QStringList> CsvSerializer::deserialize(QTextStream& data, const CsvFormat& format)
 {
-    return CsvSerializer::deserialize(data, format, false);
+    CsvDeserializer deserializer(&data, format);
+    return deserializer.readAll();
 }
 
 QList<QList<QByteArray>> CsvSerializer::deserialize(const QByteArray& data, const CsvFormat& format)
@@ -222,8 +224,7 @@ QList<QStringList> CsvSerializer::deserialize(QTextStream& data, const CsvFormat
 
 QList<QStringList> CsvSerializer::deserialize(const QString& data, const CsvFormat& format)
 {
-    QString dataString = data;
-    QTextStream stream(&dataString, QIODevice::ReadWrite);
-    return deserialize(stream, format, false);
+    CsvDeserializer deserializer(data, format);
+    return deserializer.readAll();
 }
 
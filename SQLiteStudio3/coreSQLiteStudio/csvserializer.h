@@ -14,6 +14,17 @@ class API_EXPORT CsvSerializer
         static QList<QStringList> deserialize(const QString& data, const CsvFormat& format);
         static QList<QList<QByteArray>> deserialize(const QByteArray& data, const CsvFormat& format);
         static QList<QStringList> deserialize(QTextStream& data, const CsvFormat& format);
+
+        /**
+         * @brief Reads single entry from the stream.
+         * @param data Stream to read.
+         * @param format CSV format of the data.
+         * @return Cells of the entry.
+         *
+         * The stream is positioned right after the entry, but for that it has to be seeked back and forth
+         * for every character when the separators are strict, which is slow for big inputs.
+         * Use CsvDeserializer to read many entries from the same stream.
+         */
         static QStringList deserializeOneEntry(QTextStream& data, const CsvFormat& format);
 
     private:
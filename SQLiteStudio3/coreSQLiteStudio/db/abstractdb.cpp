@@ -1,6 +1,7 @@
 #include "abstractdb.h"
 #include "services/dbmanager.h"
 #include "common/utils.h"
+#include "common/global.h"
 #include "asyncqueryrunner.h"
 #include "sqlresultsrow.h"
 #include "common/utils_sql.h"
@@ -10,6 +11,11 @@
 #include "services/notifymanager.h"
 #include "log.h"
 #include "parser/lexer.h"
+#include "querymetadatacache.h"
+#include "schemaresolver.h"
+#include "rowcountcache.h"
+#include "services/pluginmanager.h"
+#include "plugins/dbplugin.h"
 #include <QDebug>
 #include <QTime>
 #include <QWriteLocker>
@@ -27,6 +33,10 @@ AbstractDb::AbstractDb(const QString& name, const QString& path, const QHash<QSt
 
 AbstractDb::~AbstractDb()
 {
+    closeReadConnections();
+    safe_delete(readConnections);
+    invalidateSchemaCache();
+    SchemaResolver::dropDependencyGraphs(this);
 }
 
 bool AbstractDb::open()
@@ -61,11 +71,18 @@ bool AbstractDb::openQuiet()
 
 bool AbstractDb::closeQuiet()
 {
+    closeReadConnections();
+
     QWriteLocker locker(&dbOperLock);
     QWriteLocker connectionLocker(&connectionStateLock);
     interruptExecution();
     bool res = closeInternal();
     clearAttaches();
+    if (readConnections)
+        readConnections->clear();
+
+    invalidateSchemaCache();
+    RowCountCache::clear(this);
     registeredFunctions.clear();
     registeredCollations.clear();
     if (FUNCTIONS) // FUNCTIONS is already null when closing db while closing entire app
@@ -103,6 +120,7 @@ void AbstractDb::registerAllFunctions()
         regFn.argCount = fnPtr->undefinedArgs ? -1 : fnPtr->arguments.count();
         regFn.name = fnPtr->name;
         regFn.type = fnPtr->type;
+        regFn.deterministic = fnPtr->deterministic;
         registerFunction(regFn);
     }
 
@@ -111,6 +129,7 @@ void AbstractDb::registerAllFunctions()
         regFn.argCount = fnPtr->undefinedArgs ? -1 : fnPtr->arguments.count();
         regFn.name = fnPtr->name;
         regFn.type = fnPtr->type;
+        regFn.deterministic = fnPtr->deterministic;
         registerFunction(regFn);
     }
 
@@ -174,7 +193,7 @@ QString AbstractDb::generateUniqueDbNameNoLock()
 
 ReadWriteLocker::Mode AbstractDb::getLockingMode(const QString &query, Flags flags)
 {
-    return ReadWriteLocker::getMode(query, getDialect(), flags.testFlag(Flag::NO_LOCK));
+    return QueryMetadataCache::get(query, getDialect()).getLockingMode(flags.testFlag(Flag::NO_LOCK));
 }
 
 QString AbstractDb::getName() const
@@ -344,6 +363,8 @@ bool AbstractDb::openAndSetup()
     if (connOptions.contains(DB_PURE_INIT))
         return true;
 
+    setBusyRetryDelays(CFG_CORE.General.BusyRetryInitialDelay.get(), CFG_CORE.General.BusyRetryMaxDelay.get());
+
     // Implementation specific initialization
     initAfterOpen();
 
@@ -415,6 +436,11 @@ void AbstractDb::checkForDroppedObject(const QString& query)
         qWarning() << "Unknown object type dropped:" << type;
 }
 
+void AbstractDb::invalidateSchemaCache()
+{
+    SchemaResolver::invalidateCache(this);
+}
+
 bool AbstractDb::registerCollation(const QString& name)
 {
     if (registeredCollations.contains(name))
@@ -706,6 +732,88 @@ bool AbstractDb::initAfterCreated()
     return true;
 }
 
+Db* AbstractDb::takeReadConnection()
+{
+    if (!isOpen() || isTransactionActive() || !isWalMode())
+        return nullptr;
+
+    QMutexLocker locker(&readConnectionsMutex);
+    if (!readConnections)
+        readConnections = new ObjectPool<Db>(0, MAX_READ_CONNECTIONS, [this]() {return createReadConnection();});
+
+    // Never waits for other connection, so the caller can fall back to this connection
+    return readConnections->tryReserve();
+}
+
+void AbstractDb::releaseReadConnection(Db* connection)
+{
+    QMutexLocker locker(&readConnectionsMutex);
+    if (readConnections)
+        readConnections->release(connection);
+}
+
+Db* AbstractDb::createReadConnection()
+{
+    DbPlugin* plugin = nullptr;
+    for (DbPlugin* dbPlugin : PLUGINS->getLoadedPlugins<DbPlugin>())
+    {
+        if (dbPlugin->checkIfDbServedByPlugin(this))
+        {
+            plugin = dbPlugin;
+            break;
+        }
+    }
+
+    if (!plugin)
+        return nullptr;
+
+    Db* connection = plugin->getInstance(name, path, connOptions);
+    if (!connection)
+        return nullptr;
+
+    // Opening registers custom functions and collations, the same way as for this connection
+    if (!connection->initAfterCreated() || !connection->openQuiet())
+    {
+        qWarning() << "Could not open read connection to database" << name;
+        delete connection;
+        return nullptr;
+    }
+
+    connection->exec("PRAGMA query_only = 1;");
+    return connection;
+}
+
+void AbstractDb::closeReadConnections()
+{
+    // Pool is never deleted before destructor, so it's safe to use it without the mutex,
+    // which has to stay unlocked for releaseReadConnection() calls made while waiting.
+    QMutexLocker locker(&readConnectionsMutex);
+    ObjectPool<Db>* pool = readConnections;
+    locker.unlock();
+
+    if (!pool)
+        return;
+
+    pool->clearAll([](Db* connection) {connection->interrupt();});
+}
+
+bool AbstractDb::isTransactionActive()
+{
+    return false;
+}
+
+bool AbstractDb::isWalMode()
+{
+    if (getDialect() != Dialect::Sqlite3)
+        return false;
+
+    SqlQueryPtr results = exec("PRAGMA journal_mode;");
+    if (results->isError())
+        return false;
+
+    return results->getSingleCell().toString().compare("wal", Qt::CaseInsensitive) == 0;
+}
+
 void AbstractDb::setTimeout(int secs)
 {
     timeout = secs;
@@ -716,6 +824,12 @@ int AbstractDb::getTimeout() const
     return timeout;
 }
 
+void AbstractDb::setBusyRetryDelays(int initialDelay, int maxDelay)
+{
+    busyRetryInitialDelay = qMax(1, initialDelay);
+    busyRetryMaxDelay = qMax(busyRetryInitialDelay, maxDelay);
+}
+
 bool AbstractDb::isValid() const
 {
     return true;
@@ -842,7 +956,7 @@ void AbstractDb::registerFunction(const AbstractDb::RegisteredFunction& function
     switch (function.type)
     {
         case FunctionManager::ScriptFunction::SCALAR:
-            successful = registerScalarFunction(function.name, function.argCount);
+            successful = registerScalarFunction(function.name, function.argCount, function.deterministic);
             break;
         case FunctionManager::ScriptFunction::AGGREGATE:
             successful = registerAggregateFunction(function.name, function.argCount);
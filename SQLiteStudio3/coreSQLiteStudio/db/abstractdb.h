@@ -8,6 +8,7 @@
 #include "common/bihash.h"
 #include "services/functionmanager.h"
 #include "common/readwritelocker.h"
+#include "common/objectpool.h"
 #include "coreSQLiteStudio_global.h"
 #include <QObject>
 #include <QVariant>
@@ -15,6 +16,7 @@
 #include <QHash>
 #include <QSet>
 #include <QReadWriteLock>
+#include <QMutex>
 #include <QRunnable>
 #include <QStringList>
 
@@ -83,11 +85,53 @@ class API_EXPORT AbstractDb : public Db
         QString getErrorText();
         int getErrorCode();
         bool initAfterCreated();
+        Db* takeReadConnection();
+        void releaseReadConnection(Db* connection);
         void setTimeout(int secs);
         int getTimeout() const;
         bool isValid() const;
 
+        /**
+         * @brief Defines delays used while waiting for the database locked by other connection.
+         * @param initialDelay Delay before the first retry, in microseconds.
+         * @param maxDelay Maximum delay between retries, in microseconds.
+         *
+         * The delay is doubled with every retry, until it reaches the \p maxDelay.
+         * Total time of waiting is limited by the timeout (see setTimeout()).
+         * By default values are taken from the configuration when the database is open.
+         *
+         * @see BusyBackoff
+         */
+        void setBusyRetryDelays(int initialDelay, int maxDelay);
+
     protected:
+        /**
+         * @brief Creates connection for the pool of read connections.
+         * @return Open connection, or null if it could not be created.
+         *
+         * Default implementation creates the connection with DbPlugin that serves this database
+         * and switches it into the read-only mode (PRAGMA query_only).
+         */
+        virtual Db* createReadConnection();
+
+        /**
+         * @brief Closes all read connections.
+         *
+         * Connections still reserved by background work (exporting, counting rows, etc) are interrupted
+         * and this method waits until they're given back, so none of them is deleted while in use.
+         * It must not be called with dbOperLock locked, as the background work might need it to finish.
+         */
+        void closeReadConnections();
+
+        /**
+         * @brief Tells if there is a transaction open in this connection.
+         * @return true if the transaction was started and not committed or rolled back yet.
+         *
+         * Read connections are not given while the transaction is open, as they would not see its changes.
+         * Default implementation always returns false.
+         */
+        virtual bool isTransactionActive();
+
         struct FunctionUserData
         {
             QString name;
@@ -205,6 +249,13 @@ class API_EXPORT AbstractDb : public Db
         virtual void initAfterOpen();
 
         void checkForDroppedObject(const QString& query);
+
+        /**
+         * @brief Marks all schema information cached by SchemaResolver for this database as outdated.
+         *
+         * Called after successful execution of a query that modifies the schema.
+         */
+        void invalidateSchemaCache();
         bool registerCollation(const QString& name);
         bool deregisterCollation(const QString& name);
         bool isCollationRegistered(const QString& name);
@@ -342,6 +393,11 @@ class API_EXPORT AbstractDb : public Db
              * @brief Function type.
              */
             FunctionManager::ScriptFunction::Type type;
+
+            /**
+             * @brief Whether the function is deterministic (applies only to scalar functions).
+             */
+            bool deterministic = false;
         };
 
         friend int qHash(const AbstractDb::RegisteredFunction& fn);
@@ -415,6 +471,12 @@ class API_EXPORT AbstractDb : public Db
          */
         void registerFunction(const RegisteredFunction& function);
 
+        /**
+         * @brief Tells if the database uses WAL journal mode.
+         * @return true for WAL mode, false for any other mode, or if it could not be determined.
+         */
+        bool isWalMode();
+
         /**
          * @brief Connection state lock.
          *
@@ -435,6 +497,20 @@ class API_EXPORT AbstractDb : public Db
          */
         int timeout = 60;
 
+        /**
+         * @brief Delay (in microseconds) before the first retry when the database is locked.
+         *
+         * See setBusyRetryDelays() for details.
+         */
+        int busyRetryInitialDelay = 50;
+
+        /**
+         * @brief Maximum delay (in microseconds) between retries when the database is locked.
+         *
+         * See setBusyRetryDelays() for details.
+         */
+        int busyRetryMaxDelay = 100000;
+
         /**
          * @brief List of all functions currently registered in this database.
          */
@@ -445,6 +521,24 @@ class API_EXPORT AbstractDb : public Db
          */
         QStringList registeredCollations;
 
+        /**
+         * @brief Pool of read connections (see takeReadConnection()).
+         *
+         * It's created when first connection is taken. Connections are closed when this database is closed
+         * (see closeReadConnections()).
+         */
+        ObjectPool<Db>* readConnections = nullptr;
+
+        /**
+         * @brief Protects creation of the readConnections.
+         */
+        QMutex readConnectionsMutex;
+
+        /**
+         * @brief Maximum number of read connections for single database.
+         */
+        static const int MAX_READ_CONNECTIONS = 4;
+
     private slots:
         /**
          * @brief Handles asynchronous execution results.
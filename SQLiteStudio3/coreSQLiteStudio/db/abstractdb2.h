@@ -7,6 +7,7 @@
 #include "common/unused.h"
 #include "db/sqlerrorcodes.h"
 #include "db/sqlerrorresults.h"
+#include "db/busybackoff.h"
 #include "log.h"
 #include <sqlite.h>
 #include <QThread>
@@ -57,10 +58,11 @@ class AbstractDb2 : public AbstractDb
         SqlQueryPtr prepare(const QString& query);
         QString getTypeLabel();
         bool deregisterFunction(const QString& name, int argCount);
-        bool registerScalarFunction(const QString& name, int argCount);
+        bool registerScalarFunction(const QString& name, int argCount, bool deterministic);
         bool registerAggregateFunction(const QString& name, int argCount);
         bool registerCollationInternal(const QString& name);
         bool deregisterCollationInternal(const QString& name);
+        QIODevice* openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, QIODevice::OpenMode mode);
 
     private:
         class Query : public SqlQuery, public Sqlite2ColumnDataTypeHelper
@@ -69,7 +71,7 @@ class AbstractDb2 : public AbstractDb
                 class Row : public SqlResultsRow
                 {
                     public:
-                        void init(const QStringList& columns, const QList<QVariant>& resultValues);
+                        void init(const SqlResultsColumnIndex& index, const QList<QVariant>& resultValues);
                 };
 
                 Query(AbstractDb2<T>* db, const QString& query);
@@ -108,6 +110,7 @@ class AbstractDb2 : public AbstractDb
                 QString errorMessage;
                 int colCount = -1;
                 QStringList colNames;
+                SqlResultsColumnIndex columnIndex;
                 QList<QVariant> nextRowValues;
                 bool rowAvailable = false;
         };
@@ -125,6 +128,7 @@ class AbstractDb2 : public AbstractDb
         static QHash<QString,QVariant> getAggregateContext(sqlite_func* func);
         static void setAggregateContext(sqlite_func* func, const QHash<QString,QVariant>& aggregateContext);
         static void releaseAggregateContext(sqlite_func* func);
+        static int busyHandler(void* userData, const char* table, int attempt);
 
         sqlite* dbHandle = nullptr;
         QString dbErrorMessage;
@@ -202,6 +206,7 @@ bool AbstractDb2<T>::openInternal()
         return false;
     }
     dbHandle = handle;
+    sqlite_busy_handler(dbHandle, &AbstractDb2<T>::busyHandler, this);
     return true;
 }
 
@@ -262,8 +267,9 @@ bool AbstractDb2<T>::deregisterFunction(const QString& name, int argCount)
 }
 
 template <class T>
-bool AbstractDb2<T>::registerScalarFunction(const QString& name, int argCount)
+bool AbstractDb2<T>::registerScalarFunction(const QString& name, int argCount, bool deterministic)
 {
+    UNUSED(deterministic); // SQLite 2 has no such optimization
     if (!dbHandle)
         return false;
 
@@ -315,6 +321,18 @@ bool AbstractDb2<T>::deregisterCollationInternal(const QString& name)
     return false;
 }
 
+template <class T>
+QIODevice* AbstractDb2<T>::openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, QIODevice::OpenMode mode)
+{
+    // Not supported in SQLite 2
+    UNUSED(database);
+    UNUSED(table);
+    UNUSED(column);
+    UNUSED(rowId);
+    UNUSED(mode);
+    return nullptr;
+}
+
 template <class T>
 void AbstractDb2<T>::cleanUp()
 {
@@ -470,6 +488,14 @@ void AbstractDb2<T>::releaseAggregateContext(sqlite_func* func)
     AbstractDb::releaseAggregateContext(getContextMemPtr(func));
 }
 
+template <class T>
+int AbstractDb2<T>::busyHandler(void* userData, const char* table, int attempt)
+{
+    UNUSED(table);
+    AbstractDb2<T>* db = reinterpret_cast<AbstractDb2<T>*>(userData);
+    return BusyBackoff::handleBusy(attempt, db->getTimeout(), db->busyRetryInitialDelay, db->busyRetryMaxDelay) ? 1 : 0;
+}
+
 //------------------------------------------------------------------------------------
 // Query
 //------------------------------------------------------------------------------------
@@ -576,23 +602,21 @@ bool AbstractDb2<T>::Query::execInternal(const QList<QVariant>& args)
     if (!checkDbState())
         return false;
 
-    ReadWriteLocker locker(&(db->dbOperLock), query, Dialect::Sqlite2, flags.testFlag(Db::Flag::NO_LOCK));
+    const QueryMetadata& queryMetadata = getMetadata(Dialect::Sqlite2);
+    ReadWriteLocker locker(&(db->dbOperLock), queryMetadata.getLockingMode(flags.testFlag(Db::Flag::NO_LOCK)));
 
     logSql(db.data(), query, args, flags);
 
-    QueryWithParamCount queryWithParams = getQueryWithParamCount(query, Dialect::Sqlite2);
-    QString singleStr = replaceNamedParams(queryWithParams.first);
-
     int res;
     if (stmt)
         res = resetStmt();
     else
-        res = prepareStmt(singleStr);
+        res = prepareStmt(replaceNamedParams(query));
 
     if (res != SQLITE_OK)
         return false;
 
-    for (int paramIdx = 1; paramIdx <= queryWithParams.second; paramIdx++)
+    for (int paramIdx = 1, paramCount = queryMetadata.paramNames.size(); paramIdx <= paramCount; paramIdx++)
     {
         res = bindParam(paramIdx, args[paramIdx-1]);
         if (res != SQLITE_OK)
@@ -600,9 +624,12 @@ bool AbstractDb2<T>::Query::execInternal(const QList<QVariant>& args)
     }
 
     bool ok = (fetchFirst() == SQLITE_OK);
-    if (ok && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
+    if (ok && queryMetadata.drop && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
         db->checkForDroppedObject(query);
 
+    if (ok && queryMetadata.schemaChange)
+        db->invalidateSchemaCache();
+
     return ok;
 }
 
@@ -612,24 +639,22 @@ bool AbstractDb2<T>::Query::execInternal(const QHash<QString, QVariant>& args)
     if (!checkDbState())
         return false;
 
-    ReadWriteLocker locker(&(db->dbOperLock), query, Dialect::Sqlite2, flags.testFlag(Db::Flag::NO_LOCK));
+    const QueryMetadata& queryMetadata = getMetadata(Dialect::Sqlite2);
+    ReadWriteLocker locker(&(db->dbOperLock), queryMetadata.getLockingMode(flags.testFlag(Db::Flag::NO_LOCK)));
 
     logSql(db.data(), query, args, flags);
 
-    QueryWithParamNames queryWithParams = getQueryWithParamNames(query, Dialect::Sqlite2);
-    QString singleStr = replaceNamedParams(queryWithParams.first);
-
     int res;
     if (stmt)
         res = resetStmt();
     else
-        res = prepareStmt(singleStr);
+        res = prepareStmt(replaceNamedParams(query));
 
     if (res != SQLITE_OK)
         return false;
 
     int paramIdx = 1;
-    foreach (const QString& paramName, queryWithParams.second)
+    foreach (const QString& paramName, queryMetadata.paramNames)
     {
         if (!args.contains(paramName))
         {
@@ -643,9 +668,12 @@ bool AbstractDb2<T>::Query::execInternal(const QHash<QString, QVariant>& args)
     }
 
     bool ok = (fetchFirst() == SQLITE_OK);
-    if (ok && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
+    if (ok && queryMetadata.drop && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
         db->checkForDroppedObject(query);
 
+    if (ok && queryMetadata.schemaChange)
+        db->invalidateSchemaCache();
+
     return ok;
 }
 
@@ -724,10 +752,10 @@ SqlResultsRowPtr AbstractDb2<T>::Query::nextInternal()
     if (!rowAvailable || db.isNull())
         return SqlResultsRowPtr();
 
-    ReadWriteLocker locker(&(db->dbOperLock), query, Dialect::Sqlite2, flags.testFlag(Db::Flag::NO_LOCK));
+    ReadWriteLocker locker(&(db->dbOperLock), getMetadata(Dialect::Sqlite2).getLockingMode(flags.testFlag(Db::Flag::NO_LOCK)));
 
     Row* row = new Row;
-    row->init(colNames, nextRowValues);
+    row->init(columnIndex, nextRowValues);
 
     int res = fetchNext();
     if (res != SQLITE_OK)
@@ -813,12 +841,19 @@ int AbstractDb2<T>::Query::fetchNext()
     int columnsCount;
 
     int res;
-    int secondsSpent = 0;
-    while ((res = sqlite_step(stmt, &columnsCount, &values, &columns)) == SQLITE_BUSY && secondsSpent < db->getTimeout())
+    BusyBackoff backoff(db->getTimeout(), db->busyRetryInitialDelay, db->busyRetryMaxDelay);
+    {
+        // Busy handler called from within the step will wait using this backoff
+        BusyBackoff::Scope busyScope(&backoff);
+        while ((res = sqlite_step(stmt, &columnsCount, &values, &columns)) == SQLITE_BUSY && backoff.wait())
+            continue;
+    }
+
+    if (backoff.getRetries() > 0)
     {
-        QThread::sleep(1);
-        if (db->getTimeout() >= 0)
-            secondsSpent++;
+        busyRetries += backoff.getRetries();
+        busyWaitTime += backoff.getWaitTime();
+        logSqlBusy(db.data(), query, backoff.getRetries(), backoff.getWaitTime());
     }
 
     switch (res)
@@ -877,6 +912,8 @@ void AbstractDb2<T>::Query::init(int columnsCount, const char** columns)
         else
             colNames << "";
     }
+
+    columnIndex = SqlResultsRow::createColumnIndex(colNames);
 }
 
 //------------------------------------------------------------------------------------
@@ -884,13 +921,10 @@ void AbstractDb2<T>::Query::init(int columnsCount, const char** columns)
 //------------------------------------------------------------------------------------
 
 template <class T>
-void AbstractDb2<T>::Query::Row::init(const QStringList& columns, const QList<QVariant>& resultValues)
+void AbstractDb2<T>::Query::Row::init(const SqlResultsColumnIndex& index, const QList<QVariant>& resultValues)
 {
-    for (int i = 0; i < columns.size(); i++)
-    {
-        values << resultValues[i];
-        valuesMap[columns[i]] = resultValues[i];
-    }
+    columnIndex = index;
+    values = resultValues;
 }
 
 #endif // ABSTRACTDB2_H
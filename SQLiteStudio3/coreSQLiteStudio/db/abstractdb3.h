@@ -8,6 +8,7 @@
 #include "services/collationmanager.h"
 #include "sqlitestudio.h"
 #include "db/sqlerrorcodes.h"
+#include "db/busybackoff.h"
 #include "log.h"
 #include <QThread>
 #include <QPointer>
@@ -53,25 +54,61 @@ class AbstractDb3 : public AbstractDb
         bool closeInternal();
         bool initAfterCreated();
         void initAfterOpen();
+        bool isTransactionActive();
         SqlQueryPtr prepare(const QString& query);
         QString getTypeLabel();
         bool deregisterFunction(const QString& name, int argCount);
-        bool registerScalarFunction(const QString& name, int argCount);
+        bool registerScalarFunction(const QString& name, int argCount, bool deterministic);
         bool registerAggregateFunction(const QString& name, int argCount);
         bool registerCollationInternal(const QString& name);
         bool deregisterCollationInternal(const QString& name);
+        QIODevice* openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, QIODevice::OpenMode mode);
 
     private:
+        /**
+         * @brief Device reading and writing single value with SQLite incremental BLOB I/O.
+         *
+         * Each read and write goes directly to the sqlite3_blob_read() and sqlite3_blob_write(),
+         * so the device is opened unbuffered and nothing but the handle is kept in memory.
+         */
+        class Blob : public QIODevice
+        {
+            public:
+                Blob(AbstractDb3<T>* db, typename T::blob* handle);
+                ~Blob();
+
+                bool isSequential() const;
+                qint64 size() const;
+
+                /**
+                 * @brief Closes the SQLite handle.
+                 *
+                 * Called when the device is deleted, or when the database is being closed.
+                 * After that all reads and writes fail.
+                 */
+                void release();
+
+            protected:
+                qint64 readData(char* data, qint64 maxSize);
+                qint64 writeData(const char* data, qint64 maxSize);
+
+            private:
+                bool checkHandle();
+                void setErrorFromDb(int code);
+
+                QPointer<AbstractDb3<T>> db;
+                typename T::blob* handle = nullptr;
+                qint64 blobSize = 0;
+        };
+
         class Query : public SqlQuery
         {
             public:
                 class Row : public SqlResultsRow
                 {
                     public:
-                        int init(const QStringList& columns, typename T::stmt* stmt, Db::Flags flags);
-
-                    private:
-                        int getValue(typename T::stmt* stmt, int col, QVariant& value, Db::Flags flags);
+                        int init(const SqlResultsColumnIndex& index, int colCount, typename T::stmt* stmt, Db::Flags flags);
+                        static int getValue(typename T::stmt* stmt, int col, QVariant& value, Db::Flags flags);
                 };
 
                 Query(AbstractDb3<T>* db, const QString& query);
@@ -86,6 +123,7 @@ class AbstractDb3 : public AbstractDb
 
             protected:
                 SqlResultsRowPtr nextInternal();
+                void nextBatchInternal(SqlResultsBlock& block, int maxRows);
                 bool hasNextInternal();
                 bool execInternal(const QList<QVariant>& args);
                 bool execInternal(const QHash<QString, QVariant>& args);
@@ -96,6 +134,7 @@ class AbstractDb3 : public AbstractDb
                 int bindParam(int paramIdx, const QVariant& value);
                 int fetchFirst();
                 int fetchNext();
+                bool retryBusy(BusyBackoff& backoff);
                 bool checkDbState();
                 void copyErrorFromDb();
                 void copyErrorToDb();
@@ -107,7 +146,9 @@ class AbstractDb3 : public AbstractDb
                 QString errorMessage;
                 int colCount = 0;
                 QStringList colNames;
+                SqlResultsColumnIndex columnIndex;
                 bool rowAvailable = false;
+                bool firstRowFetched = false;
         };
 
         struct CollationUserData
@@ -273,6 +314,18 @@ class AbstractDb3 : public AbstractDb
          */
         static void registerDefaultCollation(void* fnUserData, typename T::handle* fnDbHandle, int eTextRep, const char* collationName);
 
+        /**
+         * @brief Handles the database being locked by another connection.
+         * @param userData Pointer to the AbstractDb3 object.
+         * @param attempt Number of times that this handler was called for the same locking event.
+         * @return Non-zero if SQLite should try to get the lock again, or zero to give up and return SQLITE_BUSY.
+         *
+         * It's registered with sqlite3_busy_handler() when the database is open. SQLite calls it from within
+         * the sqlite3_step() (or other call requiring the lock), so waiting happens exactly as long as needed,
+         * with exponentially growing delays (see BusyBackoff).
+         */
+        static int busyHandler(void* userData, int attempt);
+
         /**
          * @brief Called as a default collation implementation.
          * @param userData Collation user data, not used.
@@ -288,6 +341,7 @@ class AbstractDb3 : public AbstractDb
         QString dbErrorMessage;
         int dbErrorCode = T::OK;
         QList<Query*> queries;
+        QList<Blob*> blobs;
 
         /**
          * @brief User data for default collation request handling function.
@@ -321,6 +375,12 @@ bool AbstractDb3<T>::isOpenInternal()
     return dbHandle != nullptr;
 }
 
+template <class T>
+bool AbstractDb3<T>::isTransactionActive()
+{
+    return isOpenInternal() && !T::get_autocommit(dbHandle);
+}
+
 template <class T>
 void AbstractDb3<T>::interruptExecution()
 {
@@ -358,6 +418,7 @@ bool AbstractDb3<T>::openInternal()
         return false;
     }
     dbHandle = handle;
+    T::busy_handler(dbHandle, &AbstractDb3<T>::busyHandler, this);
     return true;
 }
 
@@ -421,7 +482,7 @@ bool AbstractDb3<T>::deregisterFunction(const QString& name, int argCount)
 }
 
 template <class T>
-bool AbstractDb3<T>::registerScalarFunction(const QString& name, int argCount)
+bool AbstractDb3<T>::registerScalarFunction(const QString& name, int argCount, bool deterministic)
 {
     if (!dbHandle)
         return false;
@@ -431,7 +492,11 @@ bool AbstractDb3<T>::registerScalarFunction(const QString& name, int argCount)
     userData->name = name;
     userData->argCount = argCount;
 
-    int res = T::create_function_v2(dbHandle, name.toUtf8().constData(), argCount, T::UTF8, userData,
+    int textRep = T::UTF8;
+    if (deterministic)
+        textRep |= T::DETERMINISTIC;
+
+    int res = T::create_function_v2(dbHandle, name.toUtf8().constData(), argCount, textRep, userData,
                                          &AbstractDb3<T>::evaluateScalar,
                                          nullptr,
                                          nullptr,
@@ -485,6 +550,40 @@ bool AbstractDb3<T>::deregisterCollationInternal(const QString& name)
     return true;
 }
 
+template <class T>
+QIODevice* AbstractDb3<T>::openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, QIODevice::OpenMode mode)
+{
+    resetError();
+    if (!dbHandle)
+    {
+        dbErrorMessage = QObject::tr("Could not open value for incremental input/output, because the database is not open.");
+        dbErrorCode = SqlErrorCode::DB_NOT_OPEN;
+        return nullptr;
+    }
+
+    bool writable = mode.testFlag(QIODevice::WriteOnly);
+    QByteArray dbName = (database.isNull() ? QString("main") : database).toUtf8();
+    typename T::blob* handle = nullptr;
+    int res;
+    {
+        ReadWriteLocker locker(&dbOperLock, writable ? ReadWriteLocker::WRITE : ReadWriteLocker::READ);
+        res = T::blob_open(dbHandle, dbName.constData(), table.toUtf8().constData(), column.toUtf8().constData(), rowId, writable ? 1 : 0, &handle);
+        if (res != T::OK)
+            extractLastError();
+    }
+
+    if (res != T::OK)
+    {
+        dbErrorMessage = QObject::tr("Could not open value for incremental input/output: %1").arg(dbErrorMessage);
+        return nullptr;
+    }
+
+    Blob* blob = new Blob(this, handle);
+    blob->open(mode | QIODevice::Unbuffered);
+    blobs << blob;
+    return blob;
+}
+
 template <class T>
 QString AbstractDb3<T>::extractLastError()
 {
@@ -499,6 +598,9 @@ void AbstractDb3<T>::cleanUp()
     for (Query* q : queries)
         q->finalize();
 
+    for (Blob* blob : blobs)
+        blob->release();
+
     safe_delete(defaultCollationUserData);
 }
 
@@ -765,6 +867,116 @@ void AbstractDb3<T>::registerDefaultCollationRequestHandler()
         qWarning() << "Could not register default collation request handler. Unknown collations will cause errors.";
 }
 
+template <class T>
+int AbstractDb3<T>::busyHandler(void* userData, int attempt)
+{
+    AbstractDb3<T>* db = reinterpret_cast<AbstractDb3<T>*>(userData);
+    return BusyBackoff::handleBusy(attempt, db->getTimeout(), db->busyRetryInitialDelay, db->busyRetryMaxDelay) ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------------
+// Blob
+//------------------------------------------------------------------------------------
+
+template <class T>
+AbstractDb3<T>::Blob::Blob(AbstractDb3<T>* db, typename T::blob* handle) :
+    db(db), handle(handle)
+{
+    blobSize = T::blob_bytes(handle);
+}
+
+template <class T>
+AbstractDb3<T>::Blob::~Blob()
+{
+    release();
+    if (!db.isNull())
+        db->blobs.removeOne(this);
+}
+
+template <class T>
+bool AbstractDb3<T>::Blob::isSequential() const
+{
+    return false;
+}
+
+template <class T>
+qint64 AbstractDb3<T>::Blob::size() const
+{
+    return blobSize;
+}
+
+template <class T>
+void AbstractDb3<T>::Blob::release()
+{
+    if (!handle)
+        return;
+
+    T::blob_close(handle);
+    handle = nullptr;
+}
+
+template <class T>
+qint64 AbstractDb3<T>::Blob::readData(char* data, qint64 maxSize)
+{
+    if (!checkHandle())
+        return -1;
+
+    qint64 offset = pos();
+    int count = static_cast<int>(qMin(maxSize, blobSize - offset));
+    if (count <= 0)
+        return 0;
+
+    ReadWriteLocker locker(&(db->dbOperLock), ReadWriteLocker::READ);
+    int res = T::blob_read(handle, data, count, static_cast<int>(offset));
+    if (res != T::OK)
+    {
+        setErrorFromDb(res);
+        return -1;
+    }
+    return count;
+}
+
+template <class T>
+qint64 AbstractDb3<T>::Blob::writeData(const char* data, qint64 maxSize)
+{
+    if (!checkHandle())
+        return -1;
+
+    qint64 offset = pos();
+    if (offset + maxSize > blobSize)
+    {
+        setErrorString(QObject::tr("Cannot write beyond the end of the value. Its size cannot be changed with incremental output."));
+        return -1;
+    }
+
+    ReadWriteLocker locker(&(db->dbOperLock), ReadWriteLocker::WRITE);
+    int res = T::blob_write(handle, data, static_cast<int>(maxSize), static_cast<int>(offset));
+    if (res != T::OK)
+    {
+        setErrorFromDb(res);
+        return -1;
+    }
+    return maxSize;
+}
+
+template <class T>
+bool AbstractDb3<T>::Blob::checkHandle()
+{
+    if (handle && !db.isNull())
+        return true;
+
+    setErrorString(QObject::tr("The value is no longer available, because the database was closed."));
+    return false;
+}
+
+template <class T>
+void AbstractDb3<T>::Blob::setErrorFromDb(int code)
+{
+    // SQLITE_ABORT means that the row was modified or deleted after the value was opened
+    QString msg = QString::fromUtf8(T::errmsg(db->dbHandle));
+    setErrorString(QObject::tr("Incremental input/output of the value failed (code %1): %2").arg(code).arg(msg));
+}
+
 //------------------------------------------------------------------------------------
 // Results
 //------------------------------------------------------------------------------------
@@ -861,11 +1073,10 @@ bool AbstractDb3<T>::Query::execInternal(const QList<QVariant>& args)
     if (!checkDbState())
         return false;
 
-    ReadWriteLocker locker(&(db->dbOperLock), query, Dialect::Sqlite3, flags.testFlag(Db::Flag::NO_LOCK));
+    const QueryMetadata& queryMetadata = getMetadata(Dialect::Sqlite3);
+    ReadWriteLocker locker(&(db->dbOperLock), queryMetadata.getLockingMode(flags.testFlag(Db::Flag::NO_LOCK)));
     logSql(db.data(), query, args, flags);
 
-    QueryWithParamCount queryWithParams = getQueryWithParamCount(query, Dialect::Sqlite3);
-
     int res;
     if (stmt)
         res = resetStmt();
@@ -876,7 +1087,8 @@ bool AbstractDb3<T>::Query::execInternal(const QList<QVariant>& args)
         return false;
 
 
-    for (int paramIdx = 1, argCount = args.size(); paramIdx <= queryWithParams.second && paramIdx <= argCount; paramIdx++)
+    int paramCount = queryMetadata.paramNames.size();
+    for (int paramIdx = 1, argCount = args.size(); paramIdx <= paramCount && paramIdx <= argCount; paramIdx++)
     {
         res = bindParam(paramIdx, args[paramIdx-1]);
         if (res != T::OK)
@@ -888,9 +1100,12 @@ bool AbstractDb3<T>::Query::execInternal(const QList<QVariant>& args)
     }
 
     bool ok = (fetchFirst() == T::OK);
-    if (ok && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
+    if (ok && queryMetadata.drop && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
         db->checkForDroppedObject(query);
 
+    if (ok && queryMetadata.schemaChange)
+        db->invalidateSchemaCache();
+
     return ok;
 }
 
@@ -900,11 +1115,10 @@ bool AbstractDb3<T>::Query::execInternal(const QHash<QString, QVariant>& args)
     if (!checkDbState())
         return false;
 
-    ReadWriteLocker locker(&(db->dbOperLock), query, Dialect::Sqlite3, flags.testFlag(Db::Flag::NO_LOCK));
+    const QueryMetadata& queryMetadata = getMetadata(Dialect::Sqlite3);
+    ReadWriteLocker locker(&(db->dbOperLock), queryMetadata.getLockingMode(flags.testFlag(Db::Flag::NO_LOCK)));
     logSql(db.data(), query, args, flags);
 
-    QueryWithParamNames queryWithParams = getQueryWithParamNames(query, Dialect::Sqlite3);
-
     int res;
     if (stmt)
         res = resetStmt();
@@ -915,7 +1129,7 @@ bool AbstractDb3<T>::Query::execInternal(const QHash<QString, QVariant>& args)
         return false;
 
     int paramIdx = -1;
-    for (const QString& paramName : queryWithParams.second)
+    for (const QString& paramName : queryMetadata.paramNames)
     {
         if (!args.contains(paramName))
         {
@@ -942,9 +1156,12 @@ bool AbstractDb3<T>::Query::execInternal(const QHash<QString, QVariant>& args)
     }
 
     bool ok = (fetchFirst() == T::OK);
-    if (ok && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
+    if (ok && queryMetadata.drop && !flags.testFlag(Db::Flag::SKIP_DROP_DETECTION))
         db->checkForDroppedObject(query);
 
+    if (ok && queryMetadata.schemaChange)
+        db->invalidateSchemaCache();
+
     return ok;
 }
 
@@ -1044,7 +1261,7 @@ template <class T>
 SqlResultsRowPtr AbstractDb3<T>::Query::nextInternal()
 {
     Row* row = new Row;
-    int res = row->init(colNames, stmt, flags);
+    int res = row->init(columnIndex, colCount, stmt, flags);
     if (res != T::OK)
     {
         delete row;
@@ -1062,6 +1279,31 @@ SqlResultsRowPtr AbstractDb3<T>::Query::nextInternal()
     return SqlResultsRowPtr(row);
 }
 
+template <class T>
+void AbstractDb3<T>::Query::nextBatchInternal(SqlResultsBlock& block, int maxRows)
+{
+    block.reset(colCount, maxRows, columnIndex);
+
+    int res;
+    for (int rowIdx = 0; rowIdx < maxRows && hasNextInternal(); rowIdx++)
+    {
+        for (int col = 0; col < colCount; col++)
+        {
+            res = Row::getValue(stmt, col, block.cell(rowIdx, col), flags);
+            if (res != T::OK)
+            {
+                setError(res, QString::fromUtf8(T::errmsg(db->dbHandle)));
+                return;
+            }
+        }
+
+        if (fetchNext() != T::OK)
+            return;
+
+        block.commitRow();
+    }
+}
+
 template <class T>
 bool AbstractDb3<T>::Query::hasNextInternal()
 {
@@ -1072,11 +1314,15 @@ template <class T>
 int AbstractDb3<T>::Query::fetchFirst()
 {
     colCount = T::column_count(stmt);
+    colNames.clear();
     for (int i = 0; i < colCount; i++)
         colNames << QString::fromUtf8(T::column_name(stmt, i));
 
+    columnIndex = SqlResultsRow::createColumnIndex(colNames);
+
     int changesBefore =  T::total_changes(db->dbHandle);
     rowAvailable = true;
+    firstRowFetched = false;
     int res = fetchNext();
 
     affected = 0;
@@ -1103,18 +1349,26 @@ int AbstractDb3<T>::Query::fetchNext()
 
     rowAvailable = false;
     int res;
-    int secondsSpent = 0;
-    while ((res = T::step(stmt)) == T::BUSY && secondsSpent < db->getTimeout())
+    BusyBackoff backoff(db->getTimeout(), db->busyRetryInitialDelay, db->busyRetryMaxDelay);
+    {
+        // Busy handler called from within the step will wait using this backoff
+        BusyBackoff::Scope busyScope(&backoff);
+        while ((res = T::step(stmt)) == T::BUSY && retryBusy(backoff))
+            continue;
+    }
+
+    if (backoff.getRetries() > 0)
     {
-        QThread::sleep(1);
-        if (db->getTimeout() >= 0)
-            secondsSpent++;
+        busyRetries += backoff.getRetries();
+        busyWaitTime += backoff.getWaitTime();
+        logSqlBusy(db.data(), query, backoff.getRetries(), backoff.getWaitTime());
     }
 
     switch (res)
     {
         case T::ROW:
             rowAvailable = true;
+            firstRowFetched = true;
             break;
         case T::DONE:
             // Empty pointer as no more results are available.
@@ -1126,23 +1380,44 @@ int AbstractDb3<T>::Query::fetchNext()
     return T::OK;
 }
 
+template <class T>
+bool AbstractDb3<T>::Query::retryBusy(BusyBackoff& backoff)
+{
+    // In WAL mode a read transaction working on an outdated snapshot cannot be upgraded to a write transaction.
+    // Waiting doesn't help here, the transaction has to be started over. It's possible only when the transaction
+    // belongs to this statement (autocommit mode) and no rows were returned yet.
+    if (T::extended_errcode(db->dbHandle) == T::BUSY_SNAPSHOT)
+    {
+        if (!T::get_autocommit(db->dbHandle) || firstRowFetched)
+            return false;
+
+        T::reset(stmt);
+    }
+
+    // Regular SQLITE_BUSY is returned after the busy handler gave up (so the backoff is exhausted),
+    // or when SQLite didn't call the handler to avoid a deadlock.
+    return backoff.wait();
+}
+
 //------------------------------------------------------------------------------------
 // Row
 //------------------------------------------------------------------------------------
 
 template <class T>
-int AbstractDb3<T>::Query::Row::init(const QStringList& columns, typename T::stmt* stmt, Db::Flags flags)
+int AbstractDb3<T>::Query::Row::init(const SqlResultsColumnIndex& index, int colCount, typename T::stmt* stmt, Db::Flags flags)
 {
+    columnIndex = index;
+    values.reserve(colCount);
+
     int res = T::OK;
     QVariant value;
-    for (int i = 0; i < columns.size(); i++)
+    for (int i = 0; i < colCount; i++)
     {
         res = getValue(stmt, i, value, flags);
         if (res != T::OK)
             return res;
 
         values << value;
-        valuesMap[columns[i]] = value;
     }
     return res;
 }
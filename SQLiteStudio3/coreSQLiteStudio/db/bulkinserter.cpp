@@ -0,0 +1,244 @@
+#include "bulkinserter.h"
+#include "db/sqlquery.h"
+#include "common/utils_sql.h"
+#include "common/global.h"
+#include "schemaresolver.h"
+#include "parser/ast/sqlitecreateindex.h"
+#include <QDebug>
+
+BulkInserter::BulkInserter(Db* db, const QString& table, const QStringList& columns) :
+    db(db), table(table), columns(columns)
+{
+    columnCount = columns.size();
+    if (db->getDialect() == Dialect::Sqlite3 && columnCount > 0)
+        rowsPerStatement = qBound(1, MAX_VARIABLES / columnCount, MAX_ROWS_PER_STATEMENT);
+
+    bindBuffer.reserve(rowsPerStatement * columnCount);
+    for (int i = 0, total = rowsPerStatement * columnCount; i < total; i++)
+        bindBuffer << QVariant();
+}
+
+void BulkInserter::setFlags(Db::Flags flags)
+{
+    this->flags = flags;
+}
+
+void BulkInserter::setRowErrorHandler(BulkInserter::RowErrorHandler handler)
+{
+    rowErrorHandler = handler;
+}
+
+void BulkInserter::setDeferIndexes(bool value)
+{
+    deferIndexes = value;
+}
+
+bool BulkInserter::begin()
+{
+    if (columnCount == 0)
+    {
+        errorText = QObject::tr("No columns to insert values to.");
+        return false;
+    }
+
+    if (deferIndexes)
+        return dropDeferredIndexes();
+
+    return true;
+}
+
+bool BulkInserter::insert(const QList<QVariant>& row)
+{
+    int offset = bufferedRows * columnCount;
+    int rowSize = row.size();
+    for (int i = 0; i < columnCount; i++)
+        bindBuffer[offset + i] = (i < rowSize) ? row[i] : QVariant();
+
+    bufferedRows++;
+    rowCount++;
+
+    if (bufferedRows < rowsPerStatement)
+        return true;
+
+    return flush();
+}
+
+bool BulkInserter::flush()
+{
+    if (bufferedRows == 0)
+        return true;
+
+    static_qstring(savepointSql, "SAVEPOINT bulk_inserter");
+    static_qstring(rollbackSql, "ROLLBACK TO bulk_inserter");
+    static_qstring(releaseSql, "RELEASE bulk_inserter");
+
+    // Rows of a failed multi-row statement are going to be inserted once again, one by one. Those that were inserted
+    // by the failed statement (see setRowErrorHandler()) have to be reverted first, hence the savepoint.
+    bool retryRowByRow = rowErrorHandler && bufferedRows > 1;
+    bool res = !retryRowByRow || executeCommand(savepointSql);
+    if (res)
+    {
+        res = executeBatch();
+        if (retryRowByRow)
+        {
+            QString batchErrorText = errorText;
+            if ((!res && !executeCommand(rollbackSql)) || !executeCommand(releaseSql))
+            {
+                bufferedRows = 0;
+                return false;
+            }
+            errorText = batchErrorText;
+        }
+
+        if (!res && rowErrorHandler)
+            res = retryRowByRow ? insertRowByRow() : rowErrorHandler(rowCount, errorText);
+    }
+
+    bufferedRows = 0;
+    return res;
+}
+
+bool BulkInserter::finish()
+{
+    if (!flush())
+        return false;
+
+    if (deferIndexes)
+        return createDeferredIndexes();
+
+    return true;
+}
+
+QString BulkInserter::getErrorText() const
+{
+    return errorText;
+}
+
+qint64 BulkInserter::getRowCount() const
+{
+    return rowCount;
+}
+
+int BulkInserter::getRowsPerStatement() const
+{
+    return rowsPerStatement;
+}
+
+SqlQueryPtr BulkInserter::prepareInsert(int rows)
+{
+    static_qstring(insertTpl, "INSERT INTO %1 (%2) VALUES %3");
+
+    Dialect dialect = db->getDialect();
+    QStringList wrappedColumns = wrapObjNamesIfNeeded(columns, dialect);
+
+    QStringList argList;
+    for (int i = 0; i < columnCount; i++)
+        argList << "?";
+
+    QString rowArgs = "(" + argList.join(", ") + ")";
+    QStringList rowArgsList;
+    for (int i = 0; i < rows; i++)
+        rowArgsList << rowArgs;
+
+    SqlQueryPtr query = db->prepare(insertTpl.arg(wrapObjIfNeeded(table, dialect), wrappedColumns.join(", "), rowArgsList.join(", ")));
+    query->setFlags(flags);
+    return query;
+}
+
+bool BulkInserter::execute(SqlQueryPtr query, const QList<QVariant>& args)
+{
+    query->setArgs(args);
+    bool res = query->execute();
+    if (!res)
+        errorText = query->getErrorText();
+
+    // Release reference to the bind buffer, so it's not copied when it's written to next time
+    query->setArgs(QList<QVariant>());
+    return res;
+}
+
+bool BulkInserter::executeBatch()
+{
+    if (bufferedRows < rowsPerStatement)
+    {
+        // Last, incomplete batch. Its statement is used only once, so it's not kept.
+        return execute(prepareInsert(bufferedRows), bindBuffer.mid(0, bufferedRows * columnCount));
+    }
+
+    if (!batchQuery)
+        batchQuery = prepareInsert(rowsPerStatement);
+
+    return execute(batchQuery, bindBuffer);
+}
+
+bool BulkInserter::executeCommand(const QString& sql)
+{
+    SqlQueryPtr results = db->exec(sql, flags);
+    if (results->isError())
+    {
+        errorText = results->getErrorText();
+        return false;
+    }
+    return true;
+}
+
+bool BulkInserter::insertRowByRow()
+{
+    if (!singleRowQuery)
+        singleRowQuery = prepareInsert(1);
+
+    qint64 firstRowNumber = rowCount - bufferedRows + 1;
+    for (int rowIdx = 0; rowIdx < bufferedRows; rowIdx++)
+    {
+        if (execute(singleRowQuery, bindBuffer.mid(rowIdx * columnCount, columnCount)))
+            continue;
+
+        if (!rowErrorHandler(firstRowNumber + rowIdx, errorText))
+            return false;
+    }
+    return true;
+}
+
+bool BulkInserter::dropDeferredIndexes()
+{
+    static_qstring(dropTpl, "DROP INDEX %1");
+
+    Dialect dialect = db->getDialect();
+    SchemaResolver resolver(db);
+    QString ddl;
+    SqlQueryPtr results;
+    for (SqliteCreateIndexPtr index : resolver.getParsedIndexesForTable(table))
+    {
+        if (index->uniqueKw)
+            continue;
+
+        ddl = resolver.getObjectDdl(index->index, SchemaResolver::INDEX);
+        if (ddl.isNull())
+            continue;
+
+        results = db->exec(dropTpl.arg(wrapObjIfNeeded(index->index, dialect)), flags);
+        if (results->isError())
+        {
+            errorText = results->getErrorText();
+            return false;
+        }
+        deferredIndexDdls << ddl;
+    }
+    return true;
+}
+
+bool BulkInserter::createDeferredIndexes()
+{
+    SqlQueryPtr results;
+    while (deferredIndexDdls.size() > 0)
+    {
+        results = db->exec(deferredIndexDdls.first(), flags);
+        if (results->isError())
+        {
+            errorText = results->getErrorText();
+            return false;
+        }
+        deferredIndexDdls.removeFirst();
+    }
+    return true;
+}
@@ -0,0 +1,184 @@
+#ifndef BULKINSERTER_H
+#define BULKINSERTER_H
+
+#include "db/db.h"
+#include "coreSQLiteStudio_global.h"
+#include <QStringList>
+#include <functional>
+
+/**
+ * @brief Inserts large amounts of rows into a single table.
+ *
+ * Rows are collected in a bind buffer and inserted with a multi-row <tt>INSERT ... VALUES (...), (...)</tt> statement,
+ * which is prepared once and binds as many rows as fit into the SQLite limit of bound parameters.
+ * This eliminates most of per-row overhead of the statement execution (locking, argument list copying, logging, etc).
+ *
+ * SQLite 2 doesn't support multi-row VALUES, so for SQLite 2 databases rows are inserted one by one.
+ *
+ * Typical usage:
+ * @code
+ * BulkInserter inserter(db, "table", {"col1", "col2"});
+ * if (!inserter.begin())
+ *     return false;
+ *
+ * while (hasMoreData())
+ * {
+ *     if (!inserter.insert(nextRow()))
+ *         return false;
+ * }
+ *
+ * return inserter.finish();
+ * @endcode
+ *
+ * The inserter doesn't manage transactions. It's up to the caller to execute it all in a transaction.
+ */
+class API_EXPORT BulkInserter
+{
+    public:
+        /**
+         * @brief Handler of a failed row insertion.
+         *
+         * Called with the number of the row (counted from 1, in order of insert() calls) and the error message.
+         * It should return true to skip the row and continue, or false to abort the insertion.
+         */
+        typedef std::function<bool(qint64 rowNumber, const QString& errorText)> RowErrorHandler;
+
+        /**
+         * @brief Creates inserter.
+         * @param db Database to insert to.
+         * @param table Table to insert to.
+         * @param columns Columns of the table to insert values of. Names are wrapped as needed by the inserter.
+         */
+        BulkInserter(Db* db, const QString& table, const QStringList& columns);
+
+        /**
+         * @brief Defines flags for executed statements.
+         * @param flags Execution flags, for example Db::Flag::NO_LOCK.
+         */
+        void setFlags(Db::Flags flags);
+
+        /**
+         * @brief Defines handler for failed rows.
+         * @param handler Error handler.
+         *
+         * When handler is defined and the multi-row statement fails, rows of the batch are inserted
+         * again one by one and the handler is called for each row that failed.
+         * Without the handler any error aborts the insertion.
+         *
+         * With the handler defined, each multi-row statement is executed within a savepoint, because a failed statement
+         * doesn't always revert its rows (the ON CONFLICT FAIL, or the RAISE(FAIL) in a trigger keep rows inserted
+         * before the failing one). The savepoint is rolled back before rows are inserted one by one.
+         */
+        void setRowErrorHandler(RowErrorHandler handler);
+
+        /**
+         * @brief Enables deferred creation of indexes.
+         * @param value true to drop non-unique indexes of the table in begin() and create them again in finish().
+         *
+         * Building an index once, after all rows are inserted, is much faster than updating it with every inserted row,
+         * but it also rebuilds index entries for rows that were already in the table, so it pays off only
+         * when the number of inserted rows is significant. Unique indexes are never deferred, as they have to reject
+         * duplicated rows as they are inserted.
+         *
+         * The inserter should be used within a transaction when this is enabled, so dropped indexes are restored
+         * if anything fails.
+         */
+        void setDeferIndexes(bool value);
+
+        /**
+         * @brief Prepares table for insertion.
+         * @return true on success, false on error (see getErrorText()).
+         */
+        bool begin();
+
+        /**
+         * @brief Adds row to insert.
+         * @param row Values of the row. Missing values are filled with nulls, excessive values are ignored.
+         * @return true on success, false on error (see getErrorText()).
+         *
+         * The row is buffered and inserted once the batch is full, so errors related to the row
+         * may be reported by any later call to insert() or by finish().
+         */
+        bool insert(const QList<QVariant>& row);
+
+        /**
+         * @brief Inserts all buffered rows.
+         * @return true on success, false on error (see getErrorText()).
+         */
+        bool flush();
+
+        /**
+         * @brief Inserts all buffered rows and restores deferred indexes.
+         * @return true on success, false on error (see getErrorText()).
+         */
+        bool finish();
+
+        /**
+         * @brief Provides error message of the most recent failure.
+         * @return Error message.
+         */
+        QString getErrorText() const;
+
+        /**
+         * @brief Provides number of rows passed to insert() so far.
+         * @return Number of rows, including rows that are still buffered.
+         */
+        qint64 getRowCount() const;
+
+        /**
+         * @brief Provides number of rows bound to a single multi-row statement.
+         * @return Number of rows per statement.
+         */
+        int getRowsPerStatement() const;
+
+        /**
+         * @brief Maximum number of parameters bound to a single statement.
+         *
+         * It's the default value of SQLITE_MAX_VARIABLE_NUMBER in SQLite versions older than 3.32.0,
+         * so it's safe to use with any SQLite 3 library.
+         */
+        static const int MAX_VARIABLES = 999;
+
+        /**
+         * @brief Maximum number of rows in a single INSERT.
+         *
+         * SQLite older than 3.8.8 limits VALUES to 500 rows (SQLITE_MAX_COMPOUND_SELECT),
+         * which is reached before MAX_VARIABLES for tables with a single column.
+         */
+        static const int MAX_ROWS_PER_STATEMENT = 500;
+
+    private:
+        SqlQueryPtr prepareInsert(int rows);
+        bool execute(SqlQueryPtr query, const QList<QVariant>& args);
+        bool executeBatch();
+        bool executeCommand(const QString& sql);
+        bool insertRowByRow();
+        bool dropDeferredIndexes();
+        bool createDeferredIndexes();
+
+        Db* db = nullptr;
+        QString table;
+        QStringList columns;
+        Db::Flags flags;
+        RowErrorHandler rowErrorHandler = nullptr;
+        bool deferIndexes = false;
+        QString errorText;
+        int columnCount = 0;
+        int rowsPerStatement = 1;
+        qint64 rowCount = 0;
+
+        /**
+         * @brief Values of buffered rows.
+         *
+         * It has a constant size of rowsPerStatement * columnCount, so it's allocated only once
+         * and values are just overwritten by consecutive batches.
+         */
+        QList<QVariant> bindBuffer;
+        int bufferedRows = 0;
+
+        SqlQueryPtr batchQuery;
+        SqlQueryPtr singleRowQuery;
+        QStringList deferredIndexDdls;
+};
+
+#endif // BULKINSERTER_H
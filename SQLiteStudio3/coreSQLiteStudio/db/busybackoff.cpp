@@ -0,0 +1,97 @@
+#include "busybackoff.h"
+#include <QThread>
+#include <QThreadStorage>
+#include <QElapsedTimer>
+
+namespace
+{
+    // Not stored as a pointer directly, because QThreadStorage would take ownership of it.
+    struct CurrentBackoff
+    {
+        BusyBackoff* backoff = nullptr;
+    };
+
+    QThreadStorage<CurrentBackoff> currentBackoff;
+}
+
+BusyBackoff::Scope::Scope(BusyBackoff* backoff)
+{
+    previous = currentBackoff.localData().backoff;
+    currentBackoff.localData().backoff = backoff;
+}
+
+BusyBackoff::Scope::~Scope()
+{
+    currentBackoff.localData().backoff = previous;
+}
+
+BusyBackoff::BusyBackoff(int timeoutSecs, int initialDelay, int maxDelay) :
+    initialDelay(qMax(1, initialDelay)), maxDelay(qMax(qMax(1, initialDelay), maxDelay))
+{
+    if (timeoutSecs >= 0)
+        timeout = static_cast<qint64>(timeoutSecs) * 1000000;
+}
+
+bool BusyBackoff::wait()
+{
+    if (timeout >= 0 && waitTime >= timeout)
+        return false;
+
+    qint64 delay = delayFor(retries, initialDelay, maxDelay);
+    if (timeout >= 0)
+        delay = qMin(delay, timeout - waitTime);
+
+    QElapsedTimer timer;
+    timer.start();
+    QThread::usleep(static_cast<unsigned long>(delay));
+
+    waitTime += timer.nsecsElapsed() / 1000;
+    retries++;
+    return true;
+}
+
+int BusyBackoff::getRetries() const
+{
+    return retries;
+}
+
+qint64 BusyBackoff::getWaitTime() const
+{
+    return waitTime;
+}
+
+BusyBackoff* BusyBackoff::current()
+{
+    return currentBackoff.localData().backoff;
+}
+
+bool BusyBackoff::handleBusy(int attempt, int timeoutSecs, int initialDelay, int maxDelay)
+{
+    BusyBackoff* backoff = current();
+    if (backoff)
+        return backoff->wait();
+
+    // No query step in progress. Total time spent is estimated as a sum of delays of previous attempts.
+    qint64 timeout = static_cast<qint64>(timeoutSecs) * 1000000;
+    qint64 spent = 0;
+    initialDelay = qMax(1, initialDelay);
+    maxDelay = qMax(initialDelay, maxDelay);
+    for (int i = 0; i < attempt && (timeoutSecs < 0 || spent < timeout); i++)
+        spent += delayFor(i, initialDelay, maxDelay);
+
+    if (timeoutSecs >= 0 && spent >= timeout)
+        return false;
+
+    QThread::usleep(static_cast<unsigned long>(delayFor(attempt, initialDelay, maxDelay)));
+    return true;
+}
+
+qint64 BusyBackoff::delayFor(int attempt, qint64 initialDelay, qint64 maxDelay)
+{
+    // Doubling the delay, but shifting no more than it's needed to reach the max (and to avoid overflow)
+    qint64 delay = initialDelay;
+    for (int i = 0; i < attempt && delay < maxDelay; i++)
+        delay *= 2;
+
+    return qMin(delay, maxDelay);
+}
@@ -0,0 +1,113 @@
+#ifndef BUSYBACKOFF_H
+#define BUSYBACKOFF_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QtGlobal>
+
+/**
+ * @brief Exponential backoff for waiting on a locked database.
+ *
+ * When SQLite cannot get a lock on the database, it returns SQLITE_BUSY, or (if a busy handler
+ * is registered) calls the busy handler to decide if it should try again. Other connections usually hold
+ * the lock for a very short time, so waiting for a fixed, long period of time makes queries stall much longer
+ * than necessary. This class starts with a very short delay (in the microseconds range) and doubles it
+ * with every attempt, up to the maximum delay, until the total timeout is exceeded.
+ *
+ * It also counts attempts and the time spent on waiting, so they can be reported per query.
+ *
+ * Every database query creates its own backoff object for each step of the statement and marks it
+ * as the current one for the thread (see Scope). The busy handler registered in the SQLite (which is called
+ * from within the step, in the same thread) picks it up with current().
+ *
+ * Initial and maximum delay are configurable with CFG_CORE.General.BusyRetryInitialDelay
+ * and CFG_CORE.General.BusyRetryMaxDelay (see AbstractDb::setBusyRetryDelays()).
+ */
+class API_EXPORT BusyBackoff
+{
+    public:
+        /**
+         * @brief Marks given backoff as the current one for the calling thread for the lifetime of the Scope.
+         */
+        class API_EXPORT Scope
+        {
+            public:
+                /**
+                 * @brief Marks given backoff as the current one.
+                 * @param backoff Backoff to mark.
+                 */
+                explicit Scope(BusyBackoff* backoff);
+
+                /**
+                 * @brief Restores the backoff that was the current one before this scope was created.
+                 */
+                ~Scope();
+
+            private:
+                BusyBackoff* previous = nullptr;
+        };
+
+        /**
+         * @brief Creates backoff with the total timeout.
+         * @param timeoutSecs Timeout in seconds. If it's negative, there is no timeout.
+         * @param initialDelay Delay before the first retry, in microseconds.
+         * @param maxDelay Maximum delay between retries, in microseconds.
+         *
+         * The Db::getTimeout() is usually passed as the timeout.
+         */
+        BusyBackoff(int timeoutSecs, int initialDelay, int maxDelay);
+
+        /**
+         * @brief Waits for the next attempt.
+         * @return true if the operation should be retried, or false if the timeout was exceeded.
+         */
+        bool wait();
+
+        /**
+         * @brief Provides number of waits made so far.
+         * @return Number of retries.
+         */
+        int getRetries() const;
+
+        /**
+         * @brief Provides total time spent on waiting.
+         * @return Time in microseconds.
+         */
+        qint64 getWaitTime() const;
+
+        /**
+         * @brief Provides backoff marked as the current one for the calling thread.
+         * @return Current backoff, or null if there is none.
+         */
+        static BusyBackoff* current();
+
+        /**
+         * @brief Handles busy handler call made by the SQLite.
+         * @param attempt Number of times that the busy handler was called for the same locking event.
+         * @param timeoutSecs Timeout in seconds, used only if there is no current backoff.
+         * @param initialDelay Delay before the first retry, used only if there is no current backoff.
+         * @param maxDelay Maximum delay between retries, used only if there is no current backoff.
+         * @return true if SQLite should try again, false if it should give up and return SQLITE_BUSY.
+         *
+         * Uses current() backoff if there is any. Otherwise (the lock is requested out of any query step,
+         * like while preparing a statement) calculates the delay basing on the \p attempt number.
+         */
+        static bool handleBusy(int attempt, int timeoutSecs, int initialDelay, int maxDelay);
+
+    private:
+        /**
+         * @brief Calculates delay for given attempt.
+         * @param attempt Attempt number, starting from 0.
+         * @param initialDelay Delay for the first attempt.
+         * @param maxDelay Maximum delay.
+         * @return Delay in microseconds.
+         */
+        static qint64 delayFor(int attempt, qint64 initialDelay, qint64 maxDelay);
+
+        qint64 timeout = -1;
+        qint64 initialDelay = 1;
+        qint64 maxDelay = 1;
+        int retries = 0;
+        qint64 waitTime = 0;
+};
+
+#endif // BUSYBACKOFF_H
@@ -17,6 +17,7 @@
 #include <QRunnable>
 #include <QStringList>
 #include <QSet>
+#include <QIODevice>
 
 /** @file */
 
@@ -601,6 +602,50 @@ class API_EXPORT Db : public QObject, public Interruptable
          */
         virtual bool initAfterCreated() = 0;
 
+        /**
+         * @brief Takes additional, read-only connection to the same database.
+         * @return Opened connection, or null if it's not available.
+         *
+         * Read connections are kept in a pool, separate for each database. They are available only for databases
+         * in the WAL journal mode, where readers don't block the writer, so long lasting reads done in background
+         * (exporting, counting rows, etc) don't block this connection. Read connection sees only committed data,
+         * without any attaches, temporary objects, or uncommitted changes made by this connection,
+         * so everything depending on those has to use this connection. For the same reason no read connection
+         * is given while this connection has an open transaction.
+         *
+         * Custom SQL functions and collations are registered in read connections just like in this connection.
+         * Each connection taken has to be given back with releaseReadConnection().
+         */
+        virtual Db* takeReadConnection() = 0;
+
+        /**
+         * @brief Gives back connection taken with takeReadConnection().
+         * @param connection Connection to give back.
+         */
+        virtual void releaseReadConnection(Db* connection) = 0;
+
+        /**
+         * @brief Opens single value in the database for incremental reading and writing.
+         * @param database Name of the database containing the table ("main", "temp", or name of attached database). Null means "main".
+         * @param table Name of the table.
+         * @param column Name of the column.
+         * @param rowId ROWID of the row.
+         * @param mode Either QIODevice::ReadOnly, or QIODevice::ReadWrite.
+         * @return Opened device, or null if the value could not be opened (see getErrorText() for details).
+         *
+         * The device reads and writes the value directly in the database, in portions requested by the caller,
+         * so even very large BLOBs can be processed without loading them entirely into the memory.
+         * The size of the value cannot be changed through the device. To store value of a different size,
+         * update it to <tt>zeroblob(size)</tt> first and then write contents with the device.
+         *
+         * The value has to be of BLOB or TEXT type. Tables without ROWID and views are not supported.
+         * Once the row is modified or deleted by other statement, or the database is closed,
+         * all further reads and writes of the device fail.
+         *
+         * The caller takes ownership of the device. It's not supported by SQLite 2 databases, which always return null.
+         */
+        virtual QIODevice* openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, QIODevice::OpenMode mode) = 0;
+
         /**
          * @brief Deregisters custom SQL function from this database.
          * @param name Name of the function.
@@ -615,6 +660,8 @@ class API_EXPORT Db : public QObject, public Interruptable
          * @brief Registers scalar custom SQL function.
          * @param name Name of the function.
          * @param argCount Number of arguments accepted by the function (-1 for undefined).
+         * @param deterministic If true, the function always returns the same result for the same arguments,
+         * so SQLite can optimize its calls (i.e. evaluate it once for constant arguments). Ignored by databases that don't support it.
          * @return true on success, false on failure.
          *
          * Scalar functions are evaluated for each row and their result is used in place of function invokation.
@@ -627,7 +674,7 @@ class API_EXPORT Db : public QObject, public Interruptable
          *
          * @see FunctionManager
          */
-        virtual bool registerScalarFunction(const QString& name, int argCount) = 0;
+        virtual bool registerScalarFunction(const QString& name, int argCount, bool deterministic) = 0;
 
         /**
          * @brief Registers aggregate custom SQL function.
@@ -250,6 +250,26 @@ bool InvalidDb::initAfterCreated()
     return false;
 }
 
+Db* InvalidDb::takeReadConnection()
+{
+    return nullptr;
+}
+
+void InvalidDb::releaseReadConnection(Db* connection)
+{
+    UNUSED(connection);
+}
+
+QIODevice* InvalidDb::openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, QIODevice::OpenMode mode)
+{
+    UNUSED(database);
+    UNUSED(table);
+    UNUSED(column);
+    UNUSED(rowId);
+    UNUSED(mode);
+    return nullptr;
+}
+
 bool InvalidDb::deregisterFunction(const QString& name, int argCount)
 {
     UNUSED(name);
@@ -257,10 +277,11 @@ bool InvalidDb::deregisterFunction(const QString& name, int argCount)
     return false;
 }
 
-bool InvalidDb::registerScalarFunction(const QString& name, int argCount)
+bool InvalidDb::registerScalarFunction(const QString& name, int argCount, bool deterministic)
 {
     UNUSED(name);
     UNUSED(argCount);
+    UNUSED(deterministic);
     return false;
 }
 
@@ -50,8 +50,11 @@ class API_EXPORT InvalidDb : public Db
         int getErrorCode();
         QString getTypeLabel();
         bool initAfterCreated();
+        Db* takeReadConnection();
+        void releaseReadConnection(Db* connection);
+        QIODevice* openBlob(const QString& database, const QString& table, const QString& column, qint64 rowId, QIODevice::OpenMode mode);
         bool deregisterFunction(const QString& name, int argCount);
-        bool registerScalarFunction(const QString& name, int argCount);
+        bool registerScalarFunction(const QString& name, int argCount, bool deterministic);
         bool registerAggregateFunction(const QString& name, int argCount);
         bool registerCollation(const QString& name);
         bool deregisterCollation(const QString& name);
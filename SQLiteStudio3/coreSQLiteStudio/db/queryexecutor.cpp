@@ -19,12 +19,17 @@
 #include "queryexecutorsteps/queryexecutorreplaceviews.h"
 #include "queryexecutorsteps/queryexecutordetectschemaalter.h"
 #include "queryexecutorsteps/queryexecutorvaluesmode.h"
+#include "db/rowcountcache.h"
 #include "common/unused.h"
+#include "common/utils_sql.h"
 #include "chainexecutor.h"
 #include "log.h"
 #include <QMutexLocker>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QThreadPool>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QDebug>
 #include <schemaresolver.h>
 #include <parser/lexer.h>
@@ -33,12 +38,36 @@
 
 // TODO modify all executor steps to use rebuildTokensFromContents() method, instead of replacing tokens manually.
 
+QCache<QString,QueryExecutor::Plan> QueryExecutor::planCache(PLAN_CACHE_SIZE);
+QMutex QueryExecutor::planCacheMutex;
+
+template <class T>
+static QSharedPointer<T> copyShared(const QSharedPointer<T>& ptr)
+{
+    if (!ptr)
+        return ptr;
+
+    return QSharedPointer<T>::create(*ptr);
+}
+
+template <class C>
+static C copySharedAll(const C& container)
+{
+    C result;
+    for (const auto& ptr : container)
+        result << copyShared(ptr);
+
+    return result;
+}
+
 QueryExecutor::QueryExecutor(Db* db, const QString& query, QObject *parent) :
     QObject(parent)
 {
     context = new Context();
     simpleExecutor = new ChainExecutor(this);
     simpleExecutor->setTransaction(false);
+    countingWatcher = new QFutureWatcher<CountingResults>(this);
+    connect(countingWatcher, SIGNAL(finished()), this, SLOT(countingInReadConnectionFinished()));
     originalQuery = query;
     setDb(db);
     setAutoDelete(false);
@@ -52,27 +81,53 @@ QueryExecutor::QueryExecutor(Db* db, const QString& query, QObject *parent) :
 
 QueryExecutor::~QueryExecutor()
 {
+    stopCountingInReadConnection();
     delete context;
     context = nullptr;
+
+    if (pendingPlan)
+        delete pendingPlan;
 }
 
 void QueryExecutor::setupExecutionChain()
 {
-    executionChain << new QueryExecutorParseQuery("initial")
-                   << new QueryExecutorDetectSchemaAlter()
-                   << new QueryExecutorExplainMode()
-                   << new QueryExecutorValuesMode()
-                   << new QueryExecutorAttaches() // needs to be at the begining, because columns needs to know real databases
-                   << new QueryExecutorParseQuery("after Attaches")
-                   << new QueryExecutorDataSources()
-                   << new QueryExecutorReplaceViews()
-                   << new QueryExecutorParseQuery("after ReplaceViews")
-                   << new QueryExecutorAddRowIds()
-                   << new QueryExecutorParseQuery("after AddRowIds")
-                   << new QueryExecutorColumns()
-                   << new QueryExecutorParseQuery("after Columns")
-                   //<< new QueryExecutorColumnAliases()
-                   << new QueryExecutorOrder()
+    planFromCache = false;
+    if (!planCacheKey.isNull())
+    {
+        QMutexLocker locker(&planCacheMutex);
+        Plan* plan = planCache.object(planCacheKey);
+        if (plan)
+        {
+            applyPlan(*plan);
+            planFromCache = true;
+        }
+    }
+
+    // Steps up to the Order are defined by the query and the schema only, so they can be replaced with the cached plan.
+    if (planFromCache)
+    {
+        executionChain << new QueryExecutorParseQuery("cached plan");
+    }
+    else
+    {
+        executionChain << new QueryExecutorParseQuery("initial")
+                       << new QueryExecutorDetectSchemaAlter()
+                       << new QueryExecutorExplainMode()
+                       << new QueryExecutorValuesMode()
+                       << new QueryExecutorAttaches() // needs to be at the begining, because columns needs to know real databases
+                       << new QueryExecutorParseQuery("after Attaches")
+                       << new QueryExecutorDataSources()
+                       << new QueryExecutorReplaceViews()
+                       << new QueryExecutorParseQuery("after ReplaceViews")
+                       << new QueryExecutorAddRowIds()
+                       << new QueryExecutorParseQuery("after AddRowIds")
+                       << new QueryExecutorColumns()
+                       //<< new QueryExecutorColumnAliases()
+                       << new QueryExecutorParseQuery("after Columns");
+    }
+    planStepCount = executionChain.size();
+
+    executionChain << new QueryExecutorOrder()
                    << new QueryExecutorWrapDistinctResults()
                    << new QueryExecutorParseQuery("after WrapDistinctResults")
                    << new QueryExecutorCellSize()
@@ -98,6 +153,9 @@ void QueryExecutor::executeChain()
 {
     // Go through all remaining steps
     bool result;
+    int stepIndex = 0;
+    QElapsedTimer timer;
+    StepTiming timing;
     foreach (QueryExecutorStep* currentStep, executionChain)
     {
         if (isInterrupted())
@@ -107,17 +165,33 @@ void QueryExecutor::executeChain()
         }
 
         logExecutorStep(currentStep);
+        timer.start();
         result = currentStep->exec();
+        timing.time = timer.nsecsElapsed() / 1000;
         logExecutorAfterStep(context->processedQuery);
 
+        timing.step = currentStep->metaObject()->className();
+        if (!currentStep->objectName().isEmpty())
+            timing.step += " (" + currentStep->objectName() + ")";
+
+        stepTimings << timing;
+
         if (!result)
         {
             stepFailed(currentStep);
             return;
         }
+
+        // Plan is valid only if it didn't require attaching anything and the query doesn't change the schema it depends on.
+        if (++stepIndex == planStepCount && !planFromCache && !planCacheKey.isNull() &&
+                context->dbNameToAttach.isEmpty() && !context->schemaModified)
+        {
+            pendingPlan = createPlan();
+        }
     }
 
     requiredDbAttaches = context->dbNameToAttach.leftValues();
+    storePendingPlan();
 
     // We're done.
     clearChain();
@@ -136,6 +210,12 @@ void QueryExecutor::stepFailed(QueryExecutorStep* currentStep)
 
     clearChain();
 
+    if (pendingPlan)
+    {
+        delete pendingPlan;
+        pendingPlan = nullptr;
+    }
+
     if (isInterrupted())
     {
         executionInProgress = false;
@@ -145,6 +225,7 @@ void QueryExecutor::stepFailed(QueryExecutorStep* currentStep)
 
     // Clear anything meaningful set up for smart execution - it's not valid anymore and misleads results for simple method
     context->rowIdColumns.clear();
+    context->keysetColumn.clear();
 
     executeSimpleMethod();
 }
@@ -167,6 +248,9 @@ void QueryExecutor::cleanupBeforeDbDestroy(Db* dbToBeUnloaded)
 
 void QueryExecutor::setQuery(const QString& query)
 {
+    if (originalQuery != query)
+        pageBoundaries.clear();
+
     originalQuery = query;
 }
 
@@ -211,6 +295,8 @@ void QueryExecutor::run()
 void QueryExecutor::execInternal()
 {
     queriesForSimpleExecution.clear();
+    stepTimings.clear();
+    planFromCache = false;
     if (forceSimpleMode)
     {
         executeSimpleMethod();
@@ -233,13 +319,17 @@ void QueryExecutor::execInternal()
     simpleExecution = false;
     interrupted = false;
 
+    bool countingInProgress = isResultsCountingInProgress();
+    stopCountingInReadConnection();
     if (resultsCountingAsyncId != 0)
     {
         resultsCountingAsyncId = 0;
         db->interrupt();
-        releaseResultsAndCleanup();
     }
 
+    if (countingInProgress)
+        releaseResultsAndCleanup();
+
     // Reset context
     delete context;
     context = new Context();
@@ -249,6 +339,7 @@ void QueryExecutor::execInternal()
     context->noMetaColumns = noMetaColumns;
     context->resultsHandler = resultsHandler;
     context->preloadResults = preloadResults;
+    planCacheKey = getPlanCacheKey();
 
     // Start the execution
     setupExecutionChain();
@@ -276,26 +367,126 @@ bool QueryExecutor::countResults()
     if (context->countingQuery.isEmpty()) // simple method doesn't provide that
         return false;
 
+    // Attached databases are not covered by the data version, so their counts can't be cached
+    if (context->dbNameToAttach.isEmpty())
+        context->countingDataVersion = RowCountCache::getDataVersion(db);
+
+    qint64 count = 0;
+    if (RowCountCache::get(db, context->countingQuery, context->queryParameters, context->countingDataVersion, count))
+    {
+        setResultsCount(count, false);
+        return true;
+    }
+
     if (asyncMode)
     {
-        // Start asynchronous results counting query
-        resultsCountingAsyncId = db->asyncExec(context->countingQuery, context->queryParameters, Db::Flag::NO_LOCK);
+        // Estimation has to be read before counting starts, as it would wait for the counting query otherwise
+        bool estimationAvailable = estimateResultsCount(count);
+
+        // Start asynchronous results counting query. If possible, it's done in a read connection, so it doesn't block the main one.
+        Db* readDb = takeReadConnection();
+        if (readDb)
+        {
+            countingDbMutex.lock();
+            countingDb = readDb;
+            countingDbMutex.unlock();
+            countingWatcher->setFuture(QtConcurrent::run(this, &QueryExecutor::countInReadConnection, readDb,
+                                                         context->countingQuery, context->queryParameters));
+        }
+        else
+        {
+            resultsCountingAsyncId = db->asyncExec(context->countingQuery, context->queryParameters, Db::Flag::NO_LOCK);
+        }
+
+        // Exact count will come later, until then provide estimation
+        if (estimationAvailable && isResultsCountingInProgress())
+            setResultsCount(count, true);
     }
     else
     {
         SqlQueryPtr results = db->exec(context->countingQuery, context->queryParameters, Db::Flag::NO_LOCK);
-        context->totalRowsReturned = results->getSingleCell().toLongLong();
-        context->totalPages = (int)qCeil(((double)(context->totalRowsReturned)) / ((double)getResultsPerPage()));
+        if (!handleCountingQueryResults(readCountingResults(results)))
+            return false;
+    }
+    return true;
+}
 
-        emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages);
+void QueryExecutor::interruptResultsCounting()
+{
+    // Results of the interrupted counting will be delivered to countingInReadConnectionFinished() as usual.
+    if (countingWatcher->isRunning())
+    {
+        interruptCountingDb();
+        return;
+    }
 
-        if (results->isError())
-        {
-            notifyError(tr("An error occured while executing the count(*) query, thus data paging will be disabled. Error details from the database: %1")
-                        .arg(results->getErrorText()));
-            return false;
-        }
+    // Results of the interrupted counting will be delivered to handleRowCountingResults() as usual.
+    if (resultsCountingAsyncId == 0)
+        return;
+
+    // Counting is executed after the data was loaded, so interrupting the database doesn't affect data fetching.
+    if (!isExecutionInProgress())
+        db->asyncInterrupt();
+}
+
+bool QueryExecutor::isResultsCountingInProgress() const
+{
+    return resultsCountingAsyncId != 0 || countingWatcher->isRunning();
+}
+
+bool QueryExecutor::estimateResultsCount(qint64& count)
+{
+    if (!context->plainScanTable)
+        return false;
+
+    SchemaResolver resolver(db);
+    resolver.setNoDbLocking(true);
+    return resolver.getRowCountEstimate(context->plainScanTable->database, context->plainScanTable->table, count);
+}
+
+void QueryExecutor::setResultsCount(qint64 count, bool estimated)
+{
+    context->totalRowsReturned = count;
+    context->totalPages = (int)qCeil(((double)(context->totalRowsReturned)) / ((double)getResultsPerPage()));
+    context->totalRowsEstimated = estimated;
+    context->totalRowsUnknown = false;
+
+    emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages, estimated);
+}
+
+void QueryExecutor::setResultsCountUnknown()
+{
+    context->totalRowsReturned = 0;
+    context->totalPages = qMax(page, 0) + 1;
+    context->totalRowsEstimated = false;
+    context->totalRowsUnknown = true;
+
+    emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages, false);
+}
+
+bool QueryExecutor::handleCountingQueryResults(const CountingResults& results)
+{
+    if (results.interrupted)
+    {
+        // Counting was cancelled. If there was an estimation, it stays valid, otherwise we don't know the number.
+        if (context->totalRowsEstimated)
+            setResultsCount(context->totalRowsReturned, true);
+        else
+            setResultsCountUnknown();
+
+        return false;
     }
+
+    setResultsCount(results.count, false);
+
+    if (results.error)
+    {
+        notifyError(tr("An error occured while executing the count(*) query, thus data paging will be disabled. Error details from the database: %1")
+                    .arg(results.errorText));
+        return false;
+    }
+
+    RowCountCache::put(db, context->countingQuery, context->queryParameters, context->countingDataVersion, context->totalRowsReturned);
     return true;
 }
 
@@ -307,6 +498,14 @@ void QueryExecutor::dbAsyncExecFinished(quint32 asyncId, SqlQueryPtr results)
     // If this was raised by any other asyncExec, handle it here.
 }
 
+void QueryExecutor::countingInReadConnectionFinished()
+{
+    if (isExecutionInProgress()) // shouldn't be true, but just in case
+        return;
+
+    handleCountingQueryResults(countingWatcher->result());
+}
+
 qint64 QueryExecutor::getLastExecutionTime() const
 {
     return context->executionTime;
@@ -322,6 +521,16 @@ qint64 QueryExecutor::getTotalRowsReturned() const
     return context->totalRowsReturned;
 }
 
+bool QueryExecutor::isTotalRowsEstimated() const
+{
+    return context->totalRowsEstimated;
+}
+
+bool QueryExecutor::isTotalRowsKnown() const
+{
+    return !context->totalRowsUnknown;
+}
+
 SqliteQueryType QueryExecutor::getExecutedQueryType(int index)
 {
     if (context->parsedQueries.size() == 0)
@@ -377,6 +586,7 @@ void QueryExecutor::setParam(const QString& name, const QVariant& value)
 
 void QueryExecutor::arg(const QVariant& value)
 {
+    pageBoundaries.clear();
     QVariant::Type type = value.type();
     switch (type)
     {
@@ -422,6 +632,8 @@ void QueryExecutor::executeSimpleMethod()
 {
     simpleExecution = true;
     context->editionForbiddenReasons << EditionForbiddenReason::SMART_EXECUTION_FAILED;
+    context->resultsQuery.clear();
+    context->resultsQueryParameters.clear();
     if (queriesForSimpleExecution.isEmpty())
         queriesForSimpleExecution = quickSplitQueries(originalQuery, false, true);
 
@@ -557,19 +769,80 @@ bool QueryExecutor::handleRowCountingResults(quint32 asyncId, SqlQueryPtr result
         return false;
 
     resultsCountingAsyncId = 0;
+    handleCountingQueryResults(readCountingResults(results));
+    return true;
+}
 
-    context->totalRowsReturned = results->getSingleCell().toLongLong();
-    context->totalPages = (int)qCeil(((double)(context->totalRowsReturned)) / ((double)getResultsPerPage()));
+Db* QueryExecutor::takeReadConnection()
+{
+    // Read connection sees neither attached databases, nor temporary objects. Source tables are not enough
+    // to tell if the query uses them, as they're not resolved for subqueries, nor for compound selects,
+    // and unqualified names are looked up in the "temp" database first.
+    if (!context->dbNameToAttach.isEmpty() || !hasOnlyMainDatabaseObjects())
+        return nullptr;
 
-    emit resultsCountingFinished(context->rowsAffected, context->totalRowsReturned, context->totalPages);
+    return db->takeReadConnection();
+}
 
+bool QueryExecutor::hasOnlyMainDatabaseObjects()
+{
+    SqlQueryPtr results = db->exec("PRAGMA database_list;", Db::Flag::NO_LOCK);
     if (results->isError())
+        return false;
+
+    QString dbName;
+    while (results->hasNext())
     {
-        notifyError(tr("An error occured while executing the count(*) query, thus data paging will be disabled. Error details from the database: %1")
-                    .arg(results->getErrorText()));
+        dbName = results->next()->value("name").toString();
+        if (dbName.compare("main", Qt::CaseInsensitive) != 0 && dbName.compare("temp", Qt::CaseInsensitive) != 0)
+            return false;
     }
 
-    return true;
+    results = db->exec("SELECT count(*) FROM temp.sqlite_master;", Db::Flag::NO_LOCK);
+    return !results->isError() && results->getSingleCell().toLongLong() == 0;
+}
+
+QueryExecutor::CountingResults QueryExecutor::countInReadConnection(Db* readDb, const QString& query, const QHash<QString, QVariant>& args)
+{
+    CountingResults results = readCountingResults(readDb->exec(query, args, Db::Flag::NO_LOCK));
+
+    // Connection is given back in this thread, so closing the database can wait for it while blocking the GUI thread
+    QMutexLocker locker(&countingDbMutex);
+    db->releaseReadConnection(readDb);
+    countingDb = nullptr;
+    return results;
+}
+
+void QueryExecutor::interruptCountingDb()
+{
+    QMutexLocker locker(&countingDbMutex);
+    if (countingDb)
+        countingDb->interrupt();
+}
+
+void QueryExecutor::stopCountingInReadConnection()
+{
+    // Interruption is repeated, in case it came before the counting query has started
+    while (countingWatcher->isRunning())
+    {
+        interruptCountingDb();
+        QThread::msleep(10);
+    }
+
+    countingWatcher->waitForFinished();
+    countingWatcher->setFuture(QFuture<CountingResults>()); // results of the stopped counting are not delivered
+}
+
+QueryExecutor::CountingResults QueryExecutor::readCountingResults(SqlQueryPtr results)
+{
+    CountingResults countingResults;
+    countingResults.interrupted = results->isInterrupted();
+    countingResults.error = results->isError();
+    countingResults.errorText = results->getErrorText();
+    if (!countingResults.interrupted)
+        countingResults.count = results->getSingleCell().toLongLong();
+
+    return countingResults;
 }
 
 QStringList QueryExecutor::applyLimitForSimpleMethod(const QStringList &queries)
@@ -584,7 +857,8 @@ QStringList QueryExecutor::applyLimitForSimpleMethod(const QStringList &queries)
     if (isSelect)
     {
         result.removeLast();
-        result << tpl.arg(trimQueryEnd(lastQuery), QString::number(resultsPerPage), QString::number(page * resultsPerPage));
+        QString limit = streamResults ? "-1" : QString::number(resultsPerPage);
+        result << tpl.arg(trimQueryEnd(lastQuery), limit, QString::number(page * resultsPerPage));
     }
     return result;
 }
@@ -599,6 +873,77 @@ void QueryExecutor::setQueryCountLimitForSmartMode(int value)
     queryCountLimitForSmartMode = value;
 }
 
+QList<QueryExecutor::StepTiming> QueryExecutor::getStepTimings() const
+{
+    return stepTimings;
+}
+
+bool QueryExecutor::isPlanFromCache() const
+{
+    return planFromCache;
+}
+
+void QueryExecutor::clearPlanCache()
+{
+    QMutexLocker locker(&planCacheMutex);
+    planCache.clear();
+}
+
+QString QueryExecutor::getPlanCacheKey()
+{
+    if (db->getDialect() != Dialect::Sqlite3)
+        return QString();
+
+    SchemaResolver resolver(db);
+    QString schemaState = resolver.getSchemaState();
+    if (schemaState.isNull())
+        return QString();
+
+    // Schema state covers attached databases too
+    static const QChar sep = QChar(0x1F);
+    QStringList keyParts = {db->getName(), db->getPath(), schemaState,
+                            QString::number(explainMode), QString::number(noMetaColumns), originalQuery};
+    return keyParts.join(sep);
+}
+
+QueryExecutor::Plan* QueryExecutor::createPlan() const
+{
+    Plan* plan = new Plan();
+    plan->processedQuery = context->processedQuery;
+    plan->resultColumns = copySharedAll(context->resultColumns);
+    plan->rowIdColumns = copySharedAll(context->rowIdColumns);
+    plan->sourceTables = copySharedAll(context->sourceTables);
+    plan->editionForbiddenReasons = context->editionForbiddenReasons;
+    plan->keysetColumn = context->keysetColumn;
+    plan->plainScanTable = copyShared(context->plainScanTable);
+    plan->colNameSeq = context->colNameSeq;
+    plan->dataModifyingQuery = context->dataModifyingQuery;
+    return plan;
+}
+
+void QueryExecutor::applyPlan(const Plan& plan)
+{
+    context->processedQuery = plan.processedQuery;
+    context->resultColumns = copySharedAll(plan.resultColumns);
+    context->rowIdColumns = copySharedAll(plan.rowIdColumns);
+    context->sourceTables = copySharedAll(plan.sourceTables);
+    context->editionForbiddenReasons = plan.editionForbiddenReasons;
+    context->keysetColumn = plan.keysetColumn;
+    context->plainScanTable = copyShared(plan.plainScanTable);
+    context->colNameSeq = plan.colNameSeq;
+    context->dataModifyingQuery = plan.dataModifyingQuery;
+}
+
+void QueryExecutor::storePendingPlan()
+{
+    if (!pendingPlan)
+        return;
+
+    QMutexLocker locker(&planCacheMutex);
+    planCache.insert(planCacheKey, pendingPlan);
+    pendingPlan = nullptr;
+}
+
 bool QueryExecutor::getForceSimpleMode() const
 {
     return forceSimpleMode;
@@ -776,6 +1121,8 @@ Db* QueryExecutor::getDb() const
 
 void QueryExecutor::setDb(Db* value)
 {
+    stopCountingInReadConnection();
+
     if (db)
         disconnect(db, SIGNAL(asyncExecFinished(quint32,SqlQueryPtr)), this, SLOT(dbAsyncExecFinished(quint32,SqlQueryPtr)));
 
@@ -830,6 +1177,16 @@ QString QueryExecutor::getCountingQuery() const
     return context->countingQuery;
 }
 
+QString QueryExecutor::getResultsQuery() const
+{
+    return context->resultsQuery;
+}
+
+QHash<QString, QVariant> QueryExecutor::getResultsQueryParameters() const
+{
+    return context->resultsQueryParameters;
+}
+
 int QueryExecutor::getResultsPerPage() const
 {
     return resultsPerPage;
@@ -837,6 +1194,9 @@ int QueryExecutor::getResultsPerPage() const
 
 void QueryExecutor::setResultsPerPage(int value)
 {
+    if (resultsPerPage != value)
+        pageBoundaries.clear();
+
     resultsPerPage = value;
 }
 
@@ -850,6 +1210,40 @@ void QueryExecutor::setPage(int value)
     page = value;
 }
 
+bool QueryExecutor::getStreamResults() const
+{
+    return streamResults;
+}
+
+void QueryExecutor::setStreamResults(bool value)
+{
+    streamResults = value;
+}
+
+void QueryExecutor::registerPageBoundaries(int page, SqlResultsRowPtr firstRow, SqlResultsRowPtr lastRow)
+{
+    if (simpleExecution || context->keysetColumn.isNull() || sortOrder.size() > 0 || !firstRow || !lastRow)
+        return;
+
+    PageBoundary boundary;
+    boundary.firstKey = firstRow->value(context->keysetColumn);
+    boundary.lastKey = lastRow->value(context->keysetColumn);
+    if (boundary.firstKey.isNull() || boundary.lastKey.isNull())
+        return;
+
+    pageBoundaries[page] = boundary;
+}
+
+void QueryExecutor::clearPageBoundaries()
+{
+    pageBoundaries.clear();
+}
+
+QHash<int, QueryExecutor::PageBoundary> QueryExecutor::getPageBoundaries() const
+{
+    return pageBoundaries;
+}
+
 bool QueryExecutor::isExecutionInProgress()
 {
     QMutexLocker executionLock(&executionMutex);
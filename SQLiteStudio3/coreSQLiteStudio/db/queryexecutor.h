@@ -10,6 +10,8 @@
 #include <QObject>
 #include <QHash>
 #include <QMutex>
+#include <QFutureWatcher>
+#include <QCache>
 #include <QRunnable>
 
 /** @file */
@@ -413,6 +415,40 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         typedef QSharedPointer<SourceTable> SourceTablePtr;
 
+        /**
+         * @brief Key values at boundaries of a results page.
+         *
+         * Used for keyset (seek) pagination. See Context::keysetColumn for details.
+         */
+        struct API_EXPORT PageBoundary
+        {
+            /**
+             * @brief Key value of the first row on the page.
+             */
+            QVariant firstKey;
+
+            /**
+             * @brief Key value of the last row on the page.
+             */
+            QVariant lastKey;
+        };
+
+        /**
+         * @brief Time spent in a single step of the smart execution.
+         */
+        struct API_EXPORT StepTiming
+        {
+            /**
+             * @brief Step class name, followed by the step object name (if any).
+             */
+            QString step;
+
+            /**
+             * @brief Time of the step execution in microseconds.
+             */
+            qint64 time = 0;
+        };
+
         /**
          * @brief Query execution context.
          *
@@ -465,6 +501,21 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             qint64 totalRowsReturned = 0;
 
+            /**
+             * @brief Tells if totalRowsReturned is just an estimation.
+             *
+             * See QueryExecutor::countResults() for details.
+             */
+            bool totalRowsEstimated = false;
+
+            /**
+             * @brief Tells if number of rows is unknown.
+             *
+             * It happens when counting was interrupted before any number (even estimated) was available.
+             * The totalRowsReturned is meaningless then.
+             */
+            bool totalRowsUnknown = false;
+
             /**
              * @brief Total number of pages.
              *
@@ -574,6 +625,38 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             QList<ResultRowIdColumnPtr> rowIdColumns;
 
+            /**
+             * @brief Result column that can be used for keyset (seek) pagination.
+             *
+             * QueryExecutorAddRowIds step defines it when the query is a plain scan of a single table
+             * (no joins, no ORDER BY, no LIMIT) and the table has a single-column key (ROWID,
+             * or single-column PRIMARY KEY of a WITHOUT ROWID table). It's the query executor alias
+             * of that key column. Otherwise it's null.
+             *
+             * When defined, QueryExecutorLimit orders results by this column and uses page boundaries
+             * registered with QueryExecutor::registerPageBoundaries() to seek directly to the requested page,
+             * instead of skipping all preceding rows with OFFSET.
+             */
+            QString keysetColumn;
+
+            /**
+             * @brief Table which all rows are returned by the query.
+             *
+             * QueryExecutorAddRowIds step defines it when the query returns all rows of a single table,
+             * without any filtering and aggregation. In that case the number of result rows
+             * is the number of rows in the table, so QueryExecutorCountResults uses a direct
+             * count(*) on the table and QueryExecutor::countResults() can provide an estimated count
+             * from the sqlite_stat1 before the exact count is known. Otherwise it's null.
+             */
+            SourceTablePtr plainScanTable;
+
+            /**
+             * @brief Data version of the database at the moment when counting of rows started.
+             *
+             * Used to store the exact count in the RowCountCache.
+             */
+            QString countingDataVersion;
+
             /**
              * @brief Result columns from the query.
              *
@@ -598,6 +681,19 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
              */
             QString countingQuery;
 
+            /**
+             * @brief Query that provided execution results, as it was executed.
+             *
+             * It's the last of processed queries. It's empty if results were provided by the simple execution method.
+             * @see QueryExecutor::getResultsQuery()
+             */
+            QString resultsQuery;
+
+            /**
+             * @brief Parameters bound to the resultsQuery.
+             */
+            QHash<QString,QVariant> resultsQueryParameters;
+
             /**
              * @brief Flag indicating results preloading.
              *
@@ -698,10 +794,30 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          *
          * It is executed after the main query execution has finished.
          *
+         * If the same counting query was already executed and the database data did not change since then,
+         * the count is taken from the RowCountCache and the signal is emitted immediately.
+         *
+         * If the query returns all rows of a single table and the database was analyzed (there is sqlite_stat1),
+         * the estimated count is emitted immediately (with the estimated flag), before exact counting is started.
+         *
          * If query is being executed in async mode, the true result (sucess/fail) will be known from later, not from this method.
          */
         bool countResults();
 
+        /**
+         * @brief Interrupts counting query started with countResults().
+         *
+         * It doesn't affect the main query execution. The resultsCountingFinished() is emitted
+         * with the estimated flag and the estimated count (if there was any), or zero.
+         */
+        void interruptResultsCounting();
+
+        /**
+         * @brief Tells if asynchronous counting of results is currently in progress.
+         * @return true if counting query was started and has not finished yet.
+         */
+        bool isResultsCountingInProgress() const;
+
         /**
          * @brief Gets time of how long it took to execute query.
          * @return Execution time in milliseconds.
@@ -732,6 +848,18 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         qint64 getTotalRowsReturned() const;
 
+        /**
+         * @brief Tells if number of rows returned by getTotalRowsReturned() is just an estimation.
+         * @return true for estimated count, false for exact count.
+         */
+        bool isTotalRowsEstimated() const;
+
+        /**
+         * @brief Tells if number of rows returned by getTotalRowsReturned() is known at all.
+         * @return false if counting was interrupted and no estimation was available, true otherwise.
+         */
+        bool isTotalRowsKnown() const;
+
         /**
          * @brief Gets type of the SQL statement in the defined query.
          * @param index Index of the SQL statement in the query (statements are separated by semicolon character), or -1 to get the last one.
@@ -893,6 +1021,33 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         QString getCountingQuery() const;
 
+        /**
+         * @brief Gets SQL query that provided results of the recent execution.
+         * @return SQL query, or null string if it's not available (simple execution method was used).
+         *
+         * Executing this query again (with getResultsQueryParameters()) gives the same results,
+         * so they can be read in other connection (see takeReadConnection()).
+         */
+        QString getResultsQuery() const;
+
+        /**
+         * @brief Gets parameters bound to the query returned from getResultsQuery().
+         * @return Parameter values by names.
+         */
+        QHash<QString,QVariant> getResultsQueryParameters() const;
+
+        /**
+         * @brief Takes read connection that queries of the recent execution can be executed in.
+         * @return Read connection, or null if queries have to be executed in the main connection.
+         *
+         * Read connection is used only if the main connection has neither attached databases, nor temporary
+         * objects, as any part of the query (including subqueries and compound selects) might refer to them,
+         * while the read connection doesn't see them. See Db::takeReadConnection() for other conditions.
+         *
+         * Taken connection has to be given back with Db::releaseReadConnection().
+         */
+        Db* takeReadConnection();
+
         /**
          * @brief Gets number of rows per page.
          * @return Number of rows.
@@ -936,6 +1091,53 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         void setPage(int value);
 
+        /**
+         * @brief Tells if results are streamed, instead of being limited to a single page.
+         * @return true if streaming is enabled.
+         */
+        bool getStreamResults() const;
+
+        /**
+         * @brief Enables streaming of results.
+         * @param value true to stream results.
+         *
+         * When streaming is enabled, the page (see setPage()) only defines the row from which the results start.
+         * Rows are not limited to the page size, so all remaining rows can be read from the results one after another,
+         * without executing the query again for next pages. Results should not be preloaded in this mode,
+         * as it would read all of them at once.
+         *
+         * When seeking to the starting page by key (see registerPageBoundaries()), only preceding pages are taken into account.
+         */
+        void setStreamResults(bool value);
+
+        /**
+         * @brief Remembers key values at boundaries of the loaded results page.
+         * @param page Page index that the rows come from.
+         * @param firstRow First row of the page.
+         * @param lastRow Last row of the page.
+         *
+         * If recently executed query qualified for keyset pagination (see Context::keysetColumn),
+         * then key values of given rows are remembered and subsequent execution of the same query
+         * for neighbouring pages will seek to the page by the key, instead of using OFFSET.
+         * Otherwise this method does nothing.
+         *
+         * Boundaries are forgotten when the query or the page size changes, or when clearPageBoundaries() is called.
+         */
+        void registerPageBoundaries(int page, SqlResultsRowPtr firstRow, SqlResultsRowPtr lastRow);
+
+        /**
+         * @brief Forgets all page boundaries registered with registerPageBoundaries().
+         *
+         * Should be called when rows were added or deleted, as it shifts pages.
+         */
+        void clearPageBoundaries();
+
+        /**
+         * @brief Provides page boundaries registered with registerPageBoundaries().
+         * @return Map of page index to its boundary key values.
+         */
+        QHash<int,PageBoundary> getPageBoundaries() const;
+
         /**
          * @brief Tests if there's any execution in progress at the moment.
          * @return true if the execution is in progress, or false otherwise.
@@ -1038,6 +1240,27 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
         int getQueryCountLimitForSmartMode() const;
         void setQueryCountLimitForSmartMode(int value);
 
+        /**
+         * @brief Provides execution times of steps from the most recent smart execution.
+         * @return Steps in order of execution, with time spent in each of them.
+         *
+         * The list is empty if the simple method was used for the execution.
+         * If the query plan was taken from the plan cache (see isPlanFromCache()),
+         * the list contains only steps that actually were executed.
+         */
+        QList<StepTiming> getStepTimings() const;
+
+        /**
+         * @brief Tells if the most recent smart execution used a cached query plan.
+         * @return true if rewriting steps were skipped thanks to the plan cache.
+         */
+        bool isPlanFromCache() const;
+
+        /**
+         * @brief Removes all query plans from the plan cache.
+         */
+        static void clearPlanCache();
+
     private:
         /**
          * @brief Executes query.
@@ -1047,6 +1270,67 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         void execInternal();
 
+        /**
+         * @brief Results of the counting query.
+         *
+         * Counting query executed in a read connection is read completely in the counting thread,
+         * so the connection can be given back to the pool before results get to this executor.
+         */
+        struct CountingResults
+        {
+            qint64 count = 0;
+            bool interrupted = false;
+            bool error = false;
+            QString errorText;
+        };
+
+        /**
+         * @brief Query rewritten by the schema dependent steps of the smart execution.
+         *
+         * It's the state of the Context after all steps preceding QueryExecutorOrder, that is the query
+         * with data sources resolved, ROWID and result columns added, together with meta information
+         * collected by those steps. Sorting, cell size limits, counting and paging are applied on top of it
+         * with every execution, so changing the page or the sort order doesn't invalidate the plan.
+         */
+        struct Plan
+        {
+            QString processedQuery;
+            QList<ResultColumnPtr> resultColumns;
+            QList<ResultRowIdColumnPtr> rowIdColumns;
+            QSet<SourceTablePtr> sourceTables;
+            QSet<EditionForbiddenReason> editionForbiddenReasons;
+            QString keysetColumn;
+            SourceTablePtr plainScanTable;
+            int colNameSeq = 0;
+            bool dataModifyingQuery = false;
+        };
+
+        /**
+         * @brief Builds key for the plan cache.
+         * @return Key, or null string if the plan for current query cannot be cached.
+         *
+         * The key is made of the query, the database, schema state of the database and all attached databases
+         * (see SchemaResolver::getSchemaState()) and executor settings affecting the rewriting steps.
+         */
+        QString getPlanCacheKey();
+
+        /**
+         * @brief Creates plan from current state of the context.
+         * @return Plan with its own copies of context data, so they are not affected by further steps.
+         */
+        Plan* createPlan() const;
+
+        /**
+         * @brief Applies cached plan to the context.
+         * @param plan Plan to apply. It's copied, so the cached plan is not affected by further steps.
+         */
+        void applyPlan(const Plan& plan);
+
+        /**
+         * @brief Stores plan created during the most recent execution in the plan cache.
+         */
+        void storePendingPlan();
+
         /**
          * @brief Raises execution error.
          * @param code Error code. Can be either from SQLite error codes, or from SqlErrorCode.
@@ -1123,6 +1407,76 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         bool handleRowCountingResults(quint32 asyncId, SqlQueryPtr results);
 
+        /**
+         * @brief Tells if all objects visible for the main connection are visible for read connections too.
+         * @return true if there are no attached databases and no temporary objects in the main connection.
+         */
+        bool hasOnlyMainDatabaseObjects();
+
+        /**
+         * @brief Executes counting query in the read connection.
+         * @param readDb Read connection taken with takeReadConnection().
+         * @param query Counting query.
+         * @param args Query parameters.
+         * @return Counting results.
+         *
+         * It's executed in a separate thread. The read connection is given back to the pool before it returns.
+         */
+        CountingResults countInReadConnection(Db* readDb, const QString& query, const QHash<QString, QVariant>& args);
+
+        /**
+         * @brief Interrupts counting query executed in the read connection, if any.
+         */
+        void interruptCountingDb();
+
+        /**
+         * @brief Stops counting query executed in the read connection and waits for its thread to finish.
+         *
+         * Results of the stopped counting are not delivered. It has to be called before the context,
+         * or the database of this executor is changed or deleted.
+         */
+        void stopCountingInReadConnection();
+
+        /**
+         * @brief Extracts counting results from executed counting query.
+         * @param results Executed counting query.
+         * @return Counting results.
+         */
+        static CountingResults readCountingResults(SqlQueryPtr results);
+
+        /**
+         * @brief Stores results of the counting query and emits resultsCountingFinished().
+         * @param results Results of the counting query.
+         * @return true on success, false if counting failed or was interrupted.
+         *
+         * Successful count is also stored in the RowCountCache.
+         */
+        bool handleCountingQueryResults(const CountingResults& results);
+
+        /**
+         * @brief Provides estimated number of result rows.
+         * @param count[out] Estimated count.
+         * @return true if the estimation was available, false otherwise.
+         *
+         * Estimation is available only for queries returning all rows of a single table
+         * (see Context::plainScanTable) and only if the sqlite_stat1 has an entry for the table.
+         */
+        bool estimateResultsCount(qint64& count);
+
+        /**
+         * @brief Stores number of result rows in the context and emits resultsCountingFinished().
+         * @param count Number of rows.
+         * @param estimated True if the number is just an estimation.
+         */
+        void setResultsCount(qint64 count, bool estimated);
+
+        /**
+         * @brief Marks number of result rows as unknown and emits resultsCountingFinished().
+         *
+         * Number of pages is limited to pages up to the current one, as further pages cannot be determined.
+         */
+        void setResultsCountUnknown();
+
         QStringList applyLimitForSimpleMethod(const QStringList &queries);
 
         /**
@@ -1184,6 +1538,13 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         int page = -1;
 
+        /**
+         * @brief Flag indicating results streaming.
+         *
+         * See setStreamResults() for details.
+         */
+        bool streamResults = false;
+
         /**
          * @brief Predefined sorting order.
          *
@@ -1191,6 +1552,13 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         SortList sortOrder;
 
+        /**
+         * @brief Key values at boundaries of pages loaded so far.
+         *
+         * See registerPageBoundaries() for details.
+         */
+        QHash<int,PageBoundary> pageBoundaries;
+
         /**
          * @brief Flag indicating that the execution is currently in progress.
          *
@@ -1265,6 +1633,26 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          */
         quint32 resultsCountingAsyncId = 0;
 
+        /**
+         * @brief Read connection used by the asynchronous counting query.
+         *
+         * Counting query is executed in a read connection (see Db::takeReadConnection()) if it's available
+         * and the query doesn't depend on anything that only the main connection sees. Otherwise it's null
+         * and the counting query is executed in the main connection. It's set back to null by the counting
+         * thread, once it gives the connection back to the pool.
+         */
+        Db* countingDb = nullptr;
+
+        /**
+         * @brief Protects countingDb, so it's not interrupted after it was given back to the pool.
+         */
+        QMutex countingDbMutex;
+
+        /**
+         * @brief Watches counting query executed in the read connection.
+         */
+        QFutureWatcher<CountingResults>* countingWatcher = nullptr;
+
         /**
          * @brief Flag indicating results preloading.
          *
@@ -1330,6 +1718,36 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
         bool forceSimpleMode = false;
         ChainExecutor* simpleExecutor = nullptr;
 
+        /**
+         * @brief Key of current query in the plan cache.
+         *
+         * Null if the plan for current query cannot be cached.
+         */
+        QString planCacheKey;
+
+        /**
+         * @brief Plan created during current execution.
+         *
+         * It's stored in the plan cache once the whole execution succeeds.
+         */
+        Plan* pendingPlan = nullptr;
+
+        /**
+         * @brief Number of steps at the begining of executionChain that build the plan.
+         */
+        int planStepCount = 0;
+
+        bool planFromCache = false;
+        QList<StepTiming> stepTimings;
+
+        static const int PLAN_CACHE_SIZE = 100;
+
+        /**
+         * @brief Query plans shared by all executors.
+         */
+        static QCache<QString,Plan> planCache;
+        static QMutex planCacheMutex;
+
     signals:
         /**
          * @brief Emitted on successful query execution.
@@ -1355,6 +1773,8 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          * @param rowsAffected Rows affected by the original query.
          * @param rowsReturned Rows returned by the original query.
          * @param totalPages Number of pages needed to represent all rows given the value defined with setResultsPerPage().
+         * @param estimated True if \p rowsReturned is just an estimation. Exact count will follow with another emission
+         * of this signal, unless counting gets interrupted.
          *
          * This signal is emitted only when setSkipRowCounting() was set to false (it is by default)
          * and the counting query execution was successful.
@@ -1362,7 +1782,7 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          * The counting query actually counts only \p rowsReturned, while \p rowsAffected and \p totalPages
          * are extracted from original query execution.
          */
-        void resultsCountingFinished(quint64 rowsAffected, quint64 rowsReturned, int totalPages);
+        void resultsCountingFinished(quint64 rowsAffected, quint64 rowsReturned, int totalPages, bool estimated);
 
     public slots:
         /**
@@ -1427,6 +1847,11 @@ class API_EXPORT QueryExecutor : public QObject, public QRunnable
          * Dispatches query results to a proper handler method.
          */
         void dbAsyncExecFinished(quint32 asyncId, SqlQueryPtr results);
+
+        /**
+         * @brief Handles results of the counting query executed in the read connection.
+         */
+        void countingInReadConnectionFinished();
 };
 
 int qHash(QueryExecutor::EditionForbiddenReason reason);
@@ -30,6 +30,9 @@ bool QueryExecutorAddRowIds::exec()
         return false;
     }
 
+    context->keysetColumn = findKeysetColumn(select->coreSelects.first());
+    context->plainScanTable = findPlainScanTable(select->coreSelects.first());
+
     // ...and putting it into parsed query, then update processed query
 //    qDebug() << "before addrowid: " << context->processedQuery;
     select->rebuildTokens();
@@ -100,6 +103,54 @@ QList<SqliteSelect*> QueryExecutorAddRowIds::getSubSelects(SqliteSelect::Core* c
     return selects;
 }
 
+QString QueryExecutorAddRowIds::findKeysetColumn(SqliteSelect::Core* core)
+{
+    if (context->rowIdColumns.size() != 1 || context->rowIdColumns.first()->queryExecutorAliasToColumn.size() != 1)
+        return QString();
+
+    if (!isSingleTableScan(core))
+        return QString();
+
+    return context->rowIdColumns.first()->queryExecutorAliasToColumn.keys().first();
+}
+
+QueryExecutor::SourceTablePtr QueryExecutorAddRowIds::findPlainScanTable(SqliteSelect::Core* core)
+{
+    if (context->rowIdColumns.size() != 1 || core->where || core->having || !isSingleTableScan(core))
+        return QueryExecutor::SourceTablePtr();
+
+    for (SqliteSelect::Core::ResultColumn* resCol : core->resultColumns)
+    {
+        if (resCol->star)
+            continue;
+
+        if (!resCol->expr || (resCol->expr->mode != SqliteExpr::Mode::ID && resCol->expr->mode != SqliteExpr::Mode::LITERAL_VALUE))
+            return QueryExecutor::SourceTablePtr();
+    }
+
+    QueryExecutor::ResultRowIdColumnPtr rowIdCol = context->rowIdColumns.first();
+    QueryExecutor::SourceTablePtr table = QueryExecutor::SourceTablePtr::create();
+    table->database = rowIdCol->database;
+    table->table = rowIdCol->table;
+    table->alias = rowIdCol->tableAlias;
+    return table;
+}
+
+bool QueryExecutorAddRowIds::isSingleTableScan(SqliteSelect::Core* core)
+{
+    if (!core->from || !core->from->singleSource || core->from->otherSources.size() > 0)
+        return false;
+
+    SqliteSelect::Core::SingleSource* source = core->from->singleSource;
+    if (source->table.isNull() || source->select || source->joinSource)
+        return false;
+
+    if (core->orderBy.size() > 0 || core->limit)
+        return false;
+
+    return true;
+}
+
 QHash<QString,QString> QueryExecutorAddRowIds::getNextColNames(const SelectResolver::Table& table)
 {
     QHash<QString,QString> colNames;
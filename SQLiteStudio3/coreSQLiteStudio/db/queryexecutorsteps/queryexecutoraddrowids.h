@@ -11,6 +11,10 @@
  * For WITHOUT ROWID tables there might be several columns per table.
  *
  * It also provides list of added columns in QueryExecutor::Context::rowIdColumns.
+ * If the query is a plain scan of a single table with a single-column key, it also defines
+ * QueryExecutor::Context::keysetColumn, so the results can be paged by the key.
+ * If the query simply returns all rows of a single table, it defines QueryExecutor::Context::plainScanTable,
+ * so the rows can be counted (or estimated) without executing the query.
  */
 class QueryExecutorAddRowIds : public QueryExecutorStep
 {
@@ -76,6 +80,35 @@ class QueryExecutorAddRowIds : public QueryExecutorStep
          * @return Map of query executor alias to real database column name.
          */
         QHash<QString, QString> getNextColNames(const SelectResolver::Table& table);
+
+        /**
+         * @brief Finds result column suitable for keyset pagination.
+         * @param core SELECT's core of the top-most select.
+         * @return Query executor alias of the key column, or null string if the query doesn't qualify.
+         *
+         * The query qualifies if it reads directly from a single table (no joins, no subselects),
+         * has no ORDER BY and no LIMIT of its own, and the table's key is a single column.
+         * Multi-column keys of WITHOUT ROWID tables would require row value comparisons,
+         * which are not available in all supported SQLite versions, so they don't qualify.
+         */
+        QString findKeysetColumn(SqliteSelect::Core* core);
+
+        /**
+         * @brief Finds table which all rows are returned by the query.
+         * @param core SELECT's core of the top-most select.
+         * @return Table description, or null pointer if the query doesn't qualify.
+         *
+         * The query qualifies if it qualifies for keyset pagination (regardless of the key size),
+         * has no WHERE clause and all its result columns are plain columns, so there are no aggregate functions.
+         */
+        QueryExecutor::SourceTablePtr findPlainScanTable(SqliteSelect::Core* core);
+
+        /**
+         * @brief Tests if SELECT's core reads directly from a single table.
+         * @param core SELECT's core to test.
+         * @return true if the core has no joins, no subselects as a source, no ORDER BY and no LIMIT.
+         */
+        bool isSingleTableScan(SqliteSelect::Core* core);
 };
 
 #endif // QUERYEXECUTORADDROWIDS_H
@@ -1,6 +1,7 @@
 #include "queryexecutorcountresults.h"
 #include "parser/ast/sqlitequery.h"
 #include "db/queryexecutor.h"
+#include "common/utils_sql.h"
 #include <math.h>
 #include <QDebug>
 
@@ -14,7 +15,20 @@ bool QueryExecutorCountResults::exec()
         return true;
     }
 
-    QString countSql = "SELECT count(*) AS cnt FROM ("+select->detokenize()+");";
+    QString countSql;
+    if (context->plainScanTable)
+    {
+        // Query returns all rows of the table, no need to execute it just to count them.
+        // This lets SQLite use its optimized table count.
+        QString table = wrapObjIfNeeded(context->plainScanTable->table, dialect);
+        if (!context->plainScanTable->database.isNull())
+            table.prepend(wrapObjIfNeeded(context->plainScanTable->database, dialect) + ".");
+
+        countSql = "SELECT count(*) AS cnt FROM " + table + ";";
+    }
+    else
+        countSql = "SELECT count(*) AS cnt FROM ("+select->detokenize()+");";
+
     context->countingQuery = countSql;
 
     // qDebug() << "count sql:" << countSql;
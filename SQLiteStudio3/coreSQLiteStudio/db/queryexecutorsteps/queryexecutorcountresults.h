@@ -6,6 +6,9 @@
 /**
  * @brief Defines counting query string.
  *
+ * Usually it's the query wrapped with "SELECT count(*) FROM (...)". If the query returns
+ * all rows of a single table (see QueryExecutor::Context::plainScanTable), then the table is counted directly.
+ *
  * @see QueryExecutor::countResults()
  */
 class QueryExecutorCountResults : public QueryExecutorStep
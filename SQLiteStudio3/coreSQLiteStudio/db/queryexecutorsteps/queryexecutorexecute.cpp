@@ -54,7 +54,11 @@ bool QueryExecutorExecute::executeQueries()
 
         queryCount--;
         if (queryCount == 0) // last query?
+        {
             setupSqlite2ColumnDataTypes(results);
+            context->resultsQuery = queryStr;
+            context->resultsQueryParameters = bindParamsForQuery;
+        }
 
         if (isBeginTransaction(query->queryType))
             rowsAffectedBeforeTransaction.push(context->rowsAffected);
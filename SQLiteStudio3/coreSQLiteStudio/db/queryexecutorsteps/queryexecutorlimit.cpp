@@ -1,5 +1,6 @@
 #include "queryexecutorlimit.h"
 #include "parser/ast/sqlitelimit.h"
+#include "common/utils_sql.h"
 #include <QDebug>
 
 bool QueryExecutorLimit::exec()
@@ -17,14 +18,72 @@ bool QueryExecutorLimit::exec()
 
     quint64 limit = queryExecutor->getResultsPerPage();
     quint64 offset = limit * page;
+    bool stream = queryExecutor->getStreamResults();
 
     // The original query is last, so if it contained any %N strings,
     // they won't be replaced.
-    static_qstring(selectTpl, "SELECT * FROM (%1) LIMIT %2 OFFSET %3");
-    QString newSelect = selectTpl.arg(select->detokenize(), QString::number(limit), QString::number(offset));
+    QString newSelect;
+    bool keyset = !context->keysetColumn.isNull() && queryExecutor->getSortOrder().size() == 0 && dialect == Dialect::Sqlite3;
+    if (keyset)
+    {
+        newSelect = getKeysetSelect(select->detokenize(), page, limit, stream);
+    }
+    else
+    {
+        static_qstring(selectTpl, "SELECT * FROM (%1) LIMIT %2 OFFSET %3");
+        newSelect = selectTpl.arg(select->detokenize(), stream ? "-1" : QString::number(limit), QString::number(offset));
+    }
 
     int begin = select->tokens.first()->start;
     int length = select->tokens.last()->end - select->tokens.first()->start + 1;
     context->processedQuery = context->processedQuery.replace(begin, length, newSelect);
     return true;
 }
+
+QString QueryExecutorLimit::getKeysetSelect(const QString& query, int page, quint64 limit, bool stream)
+{
+    static_qstring(offsetTpl, "SELECT * FROM (%1) ORDER BY %2 LIMIT %3 OFFSET %4");
+    static_qstring(forwardTpl, "SELECT * FROM (%1) WHERE %2 > %3 ORDER BY %2 LIMIT %4 OFFSET %5");
+    static_qstring(backwardTpl, "SELECT * FROM (SELECT * FROM (%1) WHERE %2 < %3 ORDER BY %2 DESC LIMIT %4 OFFSET %5) ORDER BY %2");
+
+    QString keyCol = wrapObjIfNeeded(context->keysetColumn, dialect);
+
+    // Rows to skip when reading from the begining
+    quint64 bestSkip = limit * page;
+    int bestPage = -1;
+
+    QHash<int,QueryExecutor::PageBoundary> boundaries = queryExecutor->getPageBoundaries();
+    QHashIterator<int,QueryExecutor::PageBoundary> it(boundaries);
+    quint64 skip;
+    int knownPage;
+    while (it.hasNext())
+    {
+        knownPage = it.next().key();
+        if (knownPage == page)
+            continue; // reloading same page, its boundaries might be outdated, use neighbours
+
+        if (stream && knownPage > page)
+            continue;
+
+        skip = limit * (qAbs(page - knownPage) - 1);
+        if (skip < bestSkip)
+        {
+            bestSkip = skip;
+            bestPage = knownPage;
+        }
+    }
+
+    QString limitStr = stream ? "-1" : QString::number(limit);
+    if (bestPage < 0)
+        return offsetTpl.arg(query, keyCol, limitStr, QString::number(bestSkip));
+
+    QString param = QString::fromLatin1(KEYSET_PARAM);
+    if (bestPage < page)
+    {
+        context->queryParameters[param] = boundaries[bestPage].lastKey;
+        return forwardTpl.arg(query, keyCol, param, limitStr, QString::number(bestSkip));
+    }
+
+    context->queryParameters[param] = boundaries[bestPage].firstKey;
+    return backwardTpl.arg(query, keyCol, param, limitStr, QString::number(bestSkip));
+}
@@ -10,6 +10,14 @@
  * and QueryExecutor::Context::setResultsPerPage), then the SELECT query
  * is wrapped with another SELECT which defines it's own LIMIT and OFFSET
  * basing on the page and the results per page parameters.
+ *
+ * If the query qualifies for keyset pagination (see QueryExecutor::Context::keysetColumn),
+ * then results are ordered by the key column and the page is looked up by the key value
+ * from the nearest page with known boundaries (see QueryExecutor::registerPageBoundaries()),
+ * so SQLite doesn't need to walk through all rows preceding the page.
+ *
+ * When results are streamed (see QueryExecutor::setStreamResults()), the page defines only the first row
+ * and the number of rows is not limited.
  */
 class QueryExecutorLimit : public QueryExecutorStep
 {
@@ -17,6 +25,31 @@ class QueryExecutorLimit : public QueryExecutorStep
 
     public:
         bool exec();
+
+    private:
+        /**
+         * @brief Wraps the query with keyset pagination clauses.
+         * @param query Query to wrap.
+         * @param page Requested page.
+         * @param limit Number of rows per page.
+         * @param stream true if rows following the page are also requested (no limit is applied).
+         * @return Wrapped query.
+         *
+         * Finds the page with known boundaries which is the nearest one to the requested page.
+         * If seeking from that page skips less rows than reading from the begining,
+         * then the key of that page's boundary is used in WHERE clause (it's passed as a bind parameter)
+         * and only pages between the two are skipped with OFFSET. Otherwise regular OFFSET is used,
+         * but rows are still ordered by the key, so pages are consistent with each other.
+         *
+         * When streaming, only pages preceding the requested one can be used, as seeking backward
+         * reads rows in the reversed order, which works only for a limited number of rows.
+         */
+        QString getKeysetSelect(const QString& query, int page, quint64 limit, bool stream);
+
+        /**
+         * @brief Name of bind parameter used to pass boundary key value.
+         */
+        static_char* KEYSET_PARAM = ":sqlitestudio_keyset_boundary";
 };
 
 #endif // QUERYEXECUTORLIMIT_H
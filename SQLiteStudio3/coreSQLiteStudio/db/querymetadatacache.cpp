@@ -0,0 +1,124 @@
+#include "querymetadatacache.h"
+#include "parser/lexer.h"
+#include <QMutexLocker>
+
+QCache<QString,QueryMetadata> QueryMetadataCache::cache(DEFAULT_MAX_BYTES);
+QMutex QueryMetadataCache::mutex;
+QueryMetadataCache::Statistics QueryMetadataCache::statistics;
+
+QueryMetadata QueryMetadata::analyze(const QString& query, Dialect dialect)
+{
+    QueryMetadata metadata;
+
+    TokenList tokens = Lexer::tokenize(query, dialect);
+    metadata.accessMode = getQueryAccessMode(tokens, &metadata.select);
+
+    for (const TokenPtr& token : tokens.filter(Token::BIND_PARAM))
+        metadata.paramNames << token->value;
+
+    for (const TokenPtr& token : tokens)
+    {
+        if (token->isWhitespace())
+            continue;
+
+        if (token->type != Token::KEYWORD)
+            break;
+
+        QString keyword = token->value.toUpper();
+        metadata.drop = (keyword == "DROP");
+        metadata.schemaChange = (metadata.drop || keyword == "CREATE" || keyword == "ALTER" || keyword == "ATTACH" || keyword == "DETACH" ||
+                                 keyword == "ROLLBACK");
+        break;
+    }
+
+    return metadata;
+}
+
+ReadWriteLocker::Mode QueryMetadata::getLockingMode(bool noLock) const
+{
+    if (noLock)
+        return ReadWriteLocker::NONE;
+
+    switch (accessMode)
+    {
+        case QueryAccessMode::READ:
+            return ReadWriteLocker::READ;
+        case QueryAccessMode::WRITE:
+            return ReadWriteLocker::WRITE;
+    }
+
+    return ReadWriteLocker::WRITE;
+}
+
+QueryMetadata QueryMetadataCache::get(const QString& query, Dialect dialect)
+{
+    if (query.size() > MAX_QUERY_LENGTH)
+    {
+        QMutexLocker locker(&mutex);
+        statistics.misses++;
+        locker.unlock();
+        return QueryMetadata::analyze(query, dialect);
+    }
+
+    QString key = cacheKey(query, dialect);
+    {
+        QMutexLocker locker(&mutex);
+        QueryMetadata* cached = cache.object(key);
+        if (cached)
+        {
+            statistics.hits++;
+            return *cached;
+        }
+        statistics.misses++;
+    }
+
+    // Analyzing outside of the lock, so other threads are not blocked by tokenizing of a big query.
+    QueryMetadata metadata = QueryMetadata::analyze(query, dialect);
+
+    QMutexLocker locker(&mutex);
+    cache.insert(key, new QueryMetadata(metadata), cost(key));
+    return metadata;
+}
+
+QueryMetadataCache::Statistics QueryMetadataCache::getStatistics()
+{
+    QMutexLocker locker(&mutex);
+    return statistics;
+}
+
+void QueryMetadataCache::resetStatistics()
+{
+    QMutexLocker locker(&mutex);
+    statistics = Statistics();
+}
+
+void QueryMetadataCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    cache.clear();
+}
+
+void QueryMetadataCache::setMaxBytes(int maxBytes)
+{
+    QMutexLocker locker(&mutex);
+    cache.setMaxCost(maxBytes);
+}
+
+QString QueryMetadataCache::cacheKey(const QString& query, Dialect dialect)
+{
+    return QString::number(static_cast<int>(dialect)) + ":" + query;
+}
+
+int QueryMetadataCache::cost(const QString& key)
+{
+    return key.size() * sizeof(QChar) + sizeof(QueryMetadata);
+}
+
+double QueryMetadataCache::Statistics::hitRatio() const
+{
+    quint64 total = hits + misses;
+    if (total == 0)
+        return 0.0;
+
+    return static_cast<double>(hits) / total;
+}
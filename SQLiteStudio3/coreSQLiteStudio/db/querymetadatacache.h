@@ -0,0 +1,160 @@
+#ifndef QUERYMETADATACACHE_H
+#define QUERYMETADATACACHE_H
+
+#include "coreSQLiteStudio_global.h"
+#include "common/utils_sql.h"
+#include "common/readwritelocker.h"
+#include "dialect.h"
+#include <QString>
+#include <QStringList>
+#include <QCache>
+#include <QMutex>
+
+/**
+ * @brief Results of the query analysis made before its execution.
+ *
+ * Db implementations need to know few things about the query before they execute it:
+ * what kind of lock to apply, how many bind parameters there are (and what are their names)
+ * and whether the query drops some database object. All of these can be found out
+ * from a single tokenizing pass over the query, so they are collected in this structure.
+ *
+ * The metadata depends only on the query text and the dialect, therefore it can be reused
+ * for every execution of the same query.
+ *
+ * @see QueryMetadataCache
+ */
+struct API_EXPORT QueryMetadata
+{
+    /**
+     * @brief Analyzes query and collects its metadata.
+     * @param query Query to analyze.
+     * @param dialect SQLite dialect of the query.
+     * @return Collected metadata.
+     *
+     * This method always tokenizes the query. Use QueryMetadataCache::get() to reuse results
+     * of previous analysis of the same query.
+     */
+    static QueryMetadata analyze(const QString& query, Dialect dialect);
+
+    /**
+     * @brief Provides locking mode required for the query.
+     * @param noLock If true, then the ReadWriteLocker::NONE is returned.
+     * @return Locking mode to be used with ReadWriteLocker.
+     */
+    ReadWriteLocker::Mode getLockingMode(bool noLock) const;
+
+    /**
+     * @brief Access mode of the query, as returned from getQueryAccessMode().
+     */
+    QueryAccessMode accessMode = QueryAccessMode::WRITE;
+
+    /**
+     * @brief Tells whether the query is a SELECT (including the WITH ... SELECT).
+     */
+    bool select = false;
+
+    /**
+     * @brief Tells whether the query starts with the DROP keyword.
+     *
+     * Only those queries need to be passed to AbstractDb::checkForDroppedObject().
+     */
+    bool drop = false;
+
+    /**
+     * @brief Tells whether the query starts with CREATE, DROP, ALTER, ATTACH, DETACH or ROLLBACK keyword.
+     *
+     * Successful execution of such query may make the cached schema information outdated.
+     * The ROLLBACK is here, because it can revert schema changes made in the transaction.
+     */
+    bool schemaChange = false;
+
+    /**
+     * @brief Bind parameter names, in order of their occurrence in the query.
+     *
+     * Names are as they appear in the query, including the prefix character.
+     * Number of elements in this list is the number of bind parameters.
+     */
+    QStringList paramNames;
+};
+
+/**
+ * @brief Shared LRU cache of QueryMetadata, keyed by the query text.
+ *
+ * Every query executed by Db needs its QueryMetadata. Prepared statements keep their metadata
+ * on their own, but ad-hoc queries (executed with Db::exec()) are prepared from the scratch each time,
+ * so this cache makes sure they don't get tokenized over and over again.
+ *
+ * Since the key is the whole query text, the cache is limited by the memory taken by the keys,
+ * not by the number of entries. Queries longer than MAX_QUERY_LENGTH (usually big scripts executed once)
+ * are analyzed every time and never cached.
+ *
+ * The cache is thread-safe. It also counts hits and misses, so its efficiency can be monitored.
+ */
+class API_EXPORT QueryMetadataCache
+{
+    public:
+        /**
+         * @brief Cache usage counters.
+         */
+        struct API_EXPORT Statistics
+        {
+            /**
+             * @brief Calculates hit ratio.
+             * @return Ratio of hits to all lookups, between 0.0 and 1.0.
+             */
+            double hitRatio() const;
+
+            quint64 hits = 0;
+            quint64 misses = 0;
+        };
+
+        /**
+         * @brief Provides metadata for given query.
+         * @param query Query to get metadata for.
+         * @param dialect SQLite dialect of the query.
+         * @return Cached metadata, or metadata of newly analyzed query, if it was not in the cache yet.
+         */
+        static QueryMetadata get(const QString& query, Dialect dialect);
+
+        /**
+         * @brief Provides cache usage counters.
+         * @return Counters accumulated since the application start, or since last resetStatistics().
+         */
+        static Statistics getStatistics();
+
+        /**
+         * @brief Resets cache usage counters.
+         */
+        static void resetStatistics();
+
+        /**
+         * @brief Removes all entries from the cache.
+         */
+        static void clear();
+
+        /**
+         * @brief Sets maximum memory taken by queries remembered by the cache.
+         * @param maxBytes Limit in bytes. Default is DEFAULT_MAX_BYTES.
+         */
+        static void setMaxBytes(int maxBytes);
+
+        /**
+         * @brief Default limit of memory taken by cached queries.
+         */
+        static const int DEFAULT_MAX_BYTES = 8 * 1024 * 1024;
+
+        /**
+         * @brief Length (in characters) of the longest query that gets cached.
+         */
+        static const int MAX_QUERY_LENGTH = 64 * 1024;
+
+    private:
+        static QString cacheKey(const QString& query, Dialect dialect);
+        static int cost(const QString& key);
+
+        static QCache<QString,QueryMetadata> cache;
+        static QMutex mutex;
+        static Statistics statistics;
+};
+
+#endif // QUERYMETADATACACHE_H
@@ -0,0 +1,101 @@
+#include "rowcountcache.h"
+#include "db/db.h"
+#include "db/sqlquery.h"
+#include "common/global.h"
+#include <QMutexLocker>
+#include <QStringList>
+
+QCache<QString,qint64> RowCountCache::cache(200);
+QMutex RowCountCache::mutex;
+
+QString RowCountCache::getDataVersion(Db* db)
+{
+    if (!db || !db->isOpen() || db->getDialect() != Dialect::Sqlite3)
+        return QString();
+
+    static_qstring(versionTpl, "%1:%2:%3");
+
+    SqlQueryPtr results = db->exec("PRAGMA schema_version;", Db::Flag::NO_LOCK);
+    if (results->isError())
+        return QString();
+
+    QString schemaVersion = results->getSingleCell().toString();
+
+    results = db->exec("PRAGMA data_version;", Db::Flag::NO_LOCK);
+    if (results->isError() || results->getSingleCell().isNull()) // data_version was introduced in SQLite 3.8.8
+        return QString();
+
+    QString dataVersion = results->getSingleCell().toString();
+
+    results = db->exec("SELECT total_changes();", Db::Flag::NO_LOCK);
+    if (results->isError())
+        return QString();
+
+    return versionTpl.arg(schemaVersion, dataVersion, results->getSingleCell().toString());
+}
+
+bool RowCountCache::get(Db* db, const QString& query, const QHash<QString,QVariant>& params, const QString& dataVersion, qint64& count)
+{
+    if (dataVersion.isNull())
+        return false;
+
+    QString key = cacheKey(db, query, params, dataVersion);
+
+    QMutexLocker locker(&mutex);
+    qint64* cached = cache.object(key);
+    if (!cached)
+        return false;
+
+    count = *cached;
+    return true;
+}
+
+void RowCountCache::put(Db* db, const QString& query, const QHash<QString,QVariant>& params, const QString& dataVersion, qint64 count)
+{
+    if (dataVersion.isNull())
+        return;
+
+    QString key = cacheKey(db, query, params, dataVersion);
+
+    QMutexLocker locker(&mutex);
+    cache.insert(key, new qint64(count));
+}
+
+void RowCountCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    cache.clear();
+}
+
+void RowCountCache::clear(Db* db)
+{
+    QString prefix = dbKeyPrefix(db);
+
+    QMutexLocker locker(&mutex);
+    for (const QString& key : cache.keys())
+    {
+        if (key.startsWith(prefix))
+            cache.remove(key);
+    }
+}
+
+QString RowCountCache::cacheKey(Db* db, const QString& query, const QHash<QString,QVariant>& params, const QString& dataVersion)
+{
+    // Parameters not used by the counting query (like the ones used for paging) must not affect the key.
+    QStringList usedParams;
+    QHashIterator<QString,QVariant> it(params);
+    while (it.hasNext())
+    {
+        it.next();
+        if (query.contains(it.key()))
+            usedParams << it.key() + "=" + it.value().toString();
+    }
+    usedParams.sort();
+
+    return dbKeyPrefix(db) + dataVersion + "\n" + usedParams.join("\n") + "\n" + query;
+}
+
+QString RowCountCache::dbKeyPrefix(Db* db)
+{
+    return db->getPath() + "\n" + db->getName() + "\n";
+}
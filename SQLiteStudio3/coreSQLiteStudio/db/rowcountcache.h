@@ -0,0 +1,84 @@
+#ifndef ROWCOUNTCACHE_H
+#define ROWCOUNTCACHE_H
+
+#include "coreSQLiteStudio_global.h"
+#include <QString>
+#include <QHash>
+#include <QVariant>
+#include <QCache>
+#include <QMutex>
+
+class Db;
+
+/**
+ * @brief Shared cache of exact row counts of queries.
+ *
+ * Counting rows of query results (see QueryExecutor::countResults()) executes the whole query
+ * for the second time. When the same query is executed again (for example when browsing pages
+ * of results, or when reopening table data), the count can be reused, as long as data
+ * in the database was not modified in the meantime.
+ *
+ * Entries are keyed by the database, the counting query, its parameters and the data version
+ * of the database, as provided by getDataVersion(). Entries for older data versions are never hit
+ * again and are eventually evicted.
+ *
+ * The cache is thread-safe.
+ */
+class API_EXPORT RowCountCache
+{
+    public:
+        /**
+         * @brief Provides current version of data and schema in the database.
+         * @param db Database to check.
+         * @return Version string, or null string if the version cannot be determined.
+         *
+         * The version is a combination of PRAGMA schema_version, PRAGMA data_version (changes made by other connections)
+         * and total_changes() (changes made by this connection). It's supported only for SQLite 3 databases.
+         */
+        static QString getDataVersion(Db* db);
+
+        /**
+         * @brief Looks up the cached row count.
+         * @param db Database that the query is executed on.
+         * @param query Counting query.
+         * @param params Parameters of the query. Only parameters used in the query are taken into account.
+         * @param dataVersion Data version as returned by getDataVersion(). If it's null, the cache is not used.
+         * @param count[out] Cached count, if found.
+         * @return true if the count was found, false otherwise.
+         */
+        static bool get(Db* db, const QString& query, const QHash<QString,QVariant>& params, const QString& dataVersion, qint64& count);
+
+        /**
+         * @brief Stores the row count in the cache.
+         * @param db Database that the query was executed on.
+         * @param query Counting query.
+         * @param params Parameters of the query.
+         * @param dataVersion Data version as returned by getDataVersion() before the counting started.
+         * If it's null, nothing is stored.
+         * @param count Counted number of rows.
+         */
+        static void put(Db* db, const QString& query, const QHash<QString,QVariant>& params, const QString& dataVersion, qint64 count);
+
+        /**
+         * @brief Removes all entries from the cache.
+         */
+        static void clear();
+
+        /**
+         * @brief Removes all entries of given database from the cache.
+         * @param db Database to forget counts for.
+         *
+         * Data versions are tracked per connection and start over when the database is reopened,
+         * so entries must be dropped when the database gets closed.
+         */
+        static void clear(Db* db);
+
+    private:
+        static QString cacheKey(Db* db, const QString& query, const QHash<QString,QVariant>& params, const QString& dataVersion);
+        static QString dbKeyPrefix(Db* db);
+
+        static QCache<QString,qint64> cache;
+        static QMutex mutex;
+};
+
+#endif // ROWCOUNTCACHE_H
@@ -25,6 +25,40 @@ SqlResultsRowPtr SqlQuery::next()
     return nextInternal();
 }
 
+const SqlResultsBlock& SqlQuery::nextBatch(int maxRows)
+{
+    if (preloaded)
+        fillBatchFromRows(batchBlock, maxRows);
+    else
+        nextBatchInternal(batchBlock, maxRows);
+
+    return batchBlock;
+}
+
+void SqlQuery::nextBatchInternal(SqlResultsBlock& block, int maxRows)
+{
+    fillBatchFromRows(block, maxRows);
+}
+
+void SqlQuery::fillBatchFromRows(SqlResultsBlock& block, int maxRows)
+{
+    int colCount = columnCount();
+    block.reset(colCount, maxRows, SqlResultsRow::createColumnIndex(getColumnNames()));
+
+    SqlResultsRowPtr row;
+    for (int rowIdx = 0; rowIdx < maxRows && hasNext(); rowIdx++)
+    {
+        row = next();
+        if (!row)
+            break;
+
+        for (int col = 0; col < colCount; col++)
+            block.cell(rowIdx, col) = row->value(col);
+
+        block.commitRow();
+    }
+}
+
 bool SqlQuery::hasNext()
 {
     if (preloaded)
@@ -79,6 +113,16 @@ bool SqlQuery::isInterrupted()
     return SqlErrorCode::isInterrupted(getErrorCode());
 }
 
+int SqlQuery::getBusyRetries() const
+{
+    return busyRetries;
+}
+
+qint64 SqlQuery::getBusyWaitTime() const
+{
+    return busyWaitTime;
+}
+
 RowId SqlQuery::getInsertRowId()
 {
     return insertRowId;
@@ -94,6 +138,16 @@ QString SqlQuery::getQuery() const
     return query;
 }
 
+const QueryMetadata& SqlQuery::getMetadata(Dialect dialect)
+{
+    if (!metadataResolved)
+    {
+        metadata = QueryMetadataCache::get(query, dialect);
+        metadataResolved = true;
+    }
+    return metadata;
+}
+
 void SqlQuery::setFlags(Db::Flags flags)
 {
     this->flags = flags;
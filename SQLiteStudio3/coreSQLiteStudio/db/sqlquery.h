@@ -4,6 +4,8 @@
 #include "coreSQLiteStudio_global.h"
 #include "db/db.h"
 #include "db/sqlresultsrow.h"
+#include "db/sqlresultsblock.h"
+#include "db/querymetadatacache.h"
 #include <QList>
 #include <QSharedPointer>
 
@@ -84,6 +86,21 @@ class API_EXPORT SqlQuery
          */
         SqlResultsRowPtr next();
 
+        /**
+         * @brief Reads next rows of results into a columnar block.
+         * @param maxRows Maximum number of rows to read.
+         * @return Block of rows. If it's empty, then there are no more rows available.
+         *
+         * This is an alternative to next(), which doesn't allocate SqlResultsRow for every row.
+         * The returned block is owned by this query and it's reused (overwritten) by the next call
+         * to this method, so copy the values you need to keep before calling it again.
+         *
+         * It's meant for code that streams large results, like exporting or printing results.
+         *
+         * @see SqlResultsBlock
+         */
+        const SqlResultsBlock& nextBatch(int maxRows);
+
         /**
          * @brief Tells if there is next row available.
          * @return true if there's next row, of false if there's not.
@@ -202,6 +219,18 @@ class API_EXPORT SqlQuery
          */
         virtual qint64 getRegularInsertRowId();
 
+        /**
+         * @brief Provides number of retries made because the database was locked by other connection.
+         * @return Number of retries made during execution and reading results of this query.
+         */
+        int getBusyRetries() const;
+
+        /**
+         * @brief Provides time spent on waiting for the database locked by other connection.
+         * @return Time in microseconds.
+         */
+        qint64 getBusyWaitTime() const;
+
         /**
          * @brief columnAsList
          * @tparam T Data type to use for the result list.
@@ -259,6 +288,17 @@ class API_EXPORT SqlQuery
          */
         virtual SqlResultsRowPtr nextInternal() = 0;
 
+        /**
+         * @brief Reads next rows of results into the block.
+         * @param block Block to fill. Implementation should call SqlResultsBlock::reset() first.
+         * @param maxRows Maximum number of rows to read.
+         *
+         * Default implementation reads rows with next() and copies their values into the block.
+         * Implementations should override it to read values directly into the block,
+         * without creating intermediate row objects.
+         */
+        virtual void nextBatchInternal(SqlResultsBlock& block, int maxRows);
+
         /**
          * @brief Tells if there is next row available.
          * @return true if there's next row, of false if there's not.
@@ -271,6 +311,23 @@ class API_EXPORT SqlQuery
         virtual bool execInternal(const QList<QVariant>& args) = 0;
         virtual bool execInternal(const QHash<QString, QVariant>& args) = 0;
 
+        /**
+         * @brief Provides metadata of the query.
+         * @param dialect SQLite dialect of the query.
+         * @return Query metadata.
+         *
+         * Metadata is resolved at the first call (with QueryMetadataCache) and then it's kept with this query object,
+         * so all following executions of the same (prepared) query don't need to analyze the query again.
+         */
+        const QueryMetadata& getMetadata(Dialect dialect);
+
+        /**
+         * @brief Fills the block with rows provided by next().
+         * @param block Block to fill.
+         * @param maxRows Maximum number of rows to read.
+         */
+        void fillBatchFromRows(SqlResultsBlock& block, int maxRows);
+
         /**
          * @brief Row ID of the most recently inserted row.
          */
@@ -294,8 +351,37 @@ class API_EXPORT SqlQuery
          */
         QList<SqlResultsRowPtr> preloadedData;
 
+        /**
+         * @brief Block reused by every call to nextBatch().
+         */
+        SqlResultsBlock batchBlock;
+
         int affected = 0;
 
+        /**
+         * @brief Number of retries made because the database was busy.
+         *
+         * Db implementations should accumulate it from BusyBackoff used for the query.
+         */
+        int busyRetries = 0;
+
+        /**
+         * @brief Time (in microseconds) spent on waiting for the busy database.
+         *
+         * Db implementations should accumulate it from BusyBackoff used for the query.
+         */
+        qint64 busyWaitTime = 0;
+
+        /**
+         * @brief Metadata of the query, resolved by getMetadata().
+         */
+        QueryMetadata metadata;
+
+        /**
+         * @brief Flag indicating if the metadata was already resolved.
+         */
+        bool metadataResolved = false;
+
         QString query;
         QVariant queryArgs;
         Db::Flags flags;
@@ -0,0 +1,74 @@
+#include "sqlresultsblock.h"
+
+int SqlResultsBlock::rowCount() const
+{
+    return rows;
+}
+
+int SqlResultsBlock::columnCount() const
+{
+    return colCount;
+}
+
+bool SqlResultsBlock::isEmpty() const
+{
+    return rows == 0;
+}
+
+QVariant SqlResultsBlock::value(int row, int column) const
+{
+    if (row < 0 || row >= rows || column < 0 || column >= colCount)
+        return QVariant();
+
+    return cells[cellIndex(row, column)];
+}
+
+QVariant SqlResultsBlock::value(int row, const QString& column) const
+{
+    if (!columnIndex)
+        return QVariant();
+
+    return value(row, columnIndex->value(column, -1));
+}
+
+QList<QVariant> SqlResultsBlock::rowValues(int row) const
+{
+    QList<QVariant> results;
+    if (row < 0 || row >= rows)
+        return results;
+
+    results.reserve(colCount);
+    for (int col = 0; col < colCount; col++)
+        results << cells[cellIndex(row, col)];
+
+    return results;
+}
+
+void SqlResultsBlock::reset(int colCount, int capacity, const SqlResultsColumnIndex& index)
+{
+    this->colCount = qMax(0, colCount);
+    this->capacity = qMax(0, capacity);
+    rows = 0;
+    columnIndex = index;
+
+    // Growing only. Values left from previous batch are overwritten while filling in the block,
+    // so QVariants (and their private data buffers) are reused where possible.
+    int requiredSize = this->colCount * this->capacity;
+    if (cells.size() < requiredSize)
+        cells.resize(requiredSize);
+}
+
+QVariant& SqlResultsBlock::cell(int row, int column)
+{
+    return cells[cellIndex(row, column)];
+}
+
+void SqlResultsBlock::commitRow()
+{
+    rows++;
+}
+
+int SqlResultsBlock::cellIndex(int row, int column) const
+{
+    return column * capacity + row;
+}
@@ -0,0 +1,121 @@
+#ifndef SQLRESULTSBLOCK_H
+#define SQLRESULTSBLOCK_H
+
+#include "coreSQLiteStudio_global.h"
+#include "db/sqlresultsrow.h"
+#include <QVariant>
+#include <QVector>
+#include <QStringList>
+
+/**
+ * @brief Block of multiple query results rows stored in columns.
+ *
+ * It's filled by SqlQuery::nextBatch(). Unlike SqlResultsRow, which is allocated separately for every row,
+ * the block is a single, flat array of values, organized by columns. It's reused by consecutive calls
+ * to SqlQuery::nextBatch(), so reading results in batches doesn't allocate any memory per row
+ * (except for values that need it, like strings or blobs).
+ *
+ * Column names are resolved through the column index shared with rows of the same results.
+ *
+ * Typical workflow looks like this:
+ * @code
+ * SqlQueryPtr results = db->exec("SELECT * FROM table");
+ * while (true)
+ * {
+ *     const SqlResultsBlock& block = results->nextBatch(1000);
+ *     if (block.isEmpty())
+ *         break;
+ *
+ *     for (int row = 0; row < block.rowCount(); row++)
+ *         qDebug() << block.value(row, 0) << block.value(row, "name");
+ * }
+ * @endcode
+ */
+class API_EXPORT SqlResultsBlock
+{
+    public:
+        /**
+         * @brief Gets number of rows in the block.
+         * @return Number of rows filled by the most recent SqlQuery::nextBatch().
+         */
+        int rowCount() const;
+
+        /**
+         * @brief Gets number of columns in the block.
+         * @return Columns count.
+         */
+        int columnCount() const;
+
+        /**
+         * @brief Tells whether the block has no rows.
+         * @return true if there are no rows in the block.
+         */
+        bool isEmpty() const;
+
+        /**
+         * @brief Gets value of the cell.
+         * @param row 0-based index of row in this block.
+         * @param column 0-based index of column.
+         * @return Value of the cell, or invalid QVariant if indexes are out of range.
+         */
+        QVariant value(int row, int column) const;
+
+        /**
+         * @brief Gets value of the cell.
+         * @param row 0-based index of row in this block.
+         * @param column Column name.
+         * @return Value of the cell, or invalid QVariant if there's no such row or column.
+         */
+        QVariant value(int row, const QString& column) const;
+
+        /**
+         * @brief Gets all values from given row.
+         * @param row 0-based index of row in this block.
+         * @return Ordered list of values.
+         */
+        QList<QVariant> rowValues(int row) const;
+
+        /**
+         * @brief Prepares block to be filled with new rows.
+         * @param colCount Number of columns in results.
+         * @param capacity Maximum number of rows to be put into the block.
+         * @param index Column index of the results.
+         *
+         * Memory allocated by the block is reused when capacity and number of columns doesn't grow.
+         * It's meant to be called only by SqlQuery implementations.
+         */
+        void reset(int colCount, int capacity, const SqlResultsColumnIndex& index);
+
+        /**
+         * @brief Gives access to the cell for filling it in.
+         * @param row 0-based index of row, must be less than capacity given to reset().
+         * @param column 0-based index of column.
+         * @return Reference to the cell value.
+         *
+         * It's meant to be called only by SqlQuery implementations, which then should call commitRow().
+         */
+        QVariant& cell(int row, int column);
+
+        /**
+         * @brief Marks next row as filled in.
+         *
+         * It's meant to be called only by SqlQuery implementations, after all cells of the row were set with cell().
+         */
+        void commitRow();
+
+    private:
+        int cellIndex(int row, int column) const;
+
+        /**
+         * @brief Values of cells, organized by columns.
+         *
+         * Values of column N are stored at indexes from <tt>N * capacity</tt> to <tt>N * capacity + rows - 1</tt>.
+         */
+        QVector<QVariant> cells;
+        SqlResultsColumnIndex columnIndex;
+        int colCount = 0;
+        int rows = 0;
+        int capacity = 0;
+};
+
+#endif // SQLRESULTSBLOCK_H
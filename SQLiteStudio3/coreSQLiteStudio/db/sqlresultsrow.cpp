@@ -10,11 +10,23 @@ SqlResultsRow::~SqlResultsRow()
 
 const QVariant SqlResultsRow::value(const QString &key) const
 {
+    if (columnIndex)
+        return value(columnIndex->value(key, -1));
+
     return valuesMap[key];
 }
 
 const QHash<QString, QVariant> &SqlResultsRow::valueMap() const
 {
+    if (columnIndex && valuesMap.isEmpty())
+    {
+        QHashIterator<QString,int> it(*columnIndex);
+        while (it.hasNext())
+        {
+            it.next();
+            valuesMap[it.key()] = value(it.value());
+        }
+    }
     return valuesMap;
 }
 
@@ -33,6 +45,9 @@ const QVariant SqlResultsRow::value(int idx) const
 
 bool SqlResultsRow::contains(const QString &key) const
 {
+    if (columnIndex)
+        return columnIndex->contains(key);
+
     return valuesMap.contains(key);
 }
 
@@ -40,3 +55,13 @@ bool SqlResultsRow::contains(int idx) const
 {
     return idx >= 0 && idx < values.size();
 }
+
+SqlResultsColumnIndex SqlResultsRow::createColumnIndex(const QStringList& columns)
+{
+    QHash<QString,int>* index = new QHash<QString,int>();
+    index->reserve(columns.size());
+    for (int i = 0; i < columns.size(); i++)
+        (*index)[columns[i]] = i;
+
+    return SqlResultsColumnIndex(index);
+}
@@ -5,10 +5,19 @@
 #include <QVariant>
 #include <QList>
 #include <QHash>
+#include <QStringList>
 #include <QSharedPointer>
 
 /** @file */
 
+/**
+ * @brief Shared index of result columns.
+ *
+ * Maps column name to its 0-based index in the results row. It's created once per query results
+ * and shared by all rows of these results, so rows don't need to keep their own copy of column names.
+ */
+typedef QSharedPointer<const QHash<QString,int>> SqlResultsColumnIndex;
+
 /**
  * @brief SQL query results row.
  *
@@ -76,13 +85,25 @@ class API_EXPORT SqlResultsRow
          */
         bool contains(int idx) const;
 
+        /**
+         * @brief Creates column index to be shared by rows.
+         * @param columns Column names, in order of results.
+         * @return Index of columns.
+         *
+         * If the same column name occurs more than once, the last occurrence is indexed.
+         */
+        static SqlResultsColumnIndex createColumnIndex(const QStringList& columns);
+
     protected:
         SqlResultsRow();
 
         /**
          * @brief Columns and their values in the row.
+         *
+         * If the columnIndex is defined, then this table is not populated by the implementation,
+         * but it's built on demand by valueMap() (that's why it's mutable).
          */
-        QHash<QString,QVariant> valuesMap;
+        mutable QHash<QString,QVariant> valuesMap;
         /**
          * @brief Ordered list of values in the row.
          *
@@ -92,6 +113,15 @@ class API_EXPORT SqlResultsRow
          * use smart pointers to keep their data internally, so here we actually keep only reference objects.
          */
         QList<QVariant> values;
+
+        /**
+         * @brief Column index shared with other rows of the same results.
+         *
+         * If it's defined, the implementation populates only the values list and values for column names
+         * are looked up through this index. This saves building hash table of column names for every single row.
+         * If it's null, then the valuesMap has to be populated by the implementation.
+         */
+        SqlResultsColumnIndex columnIndex;
 };
 
 /**
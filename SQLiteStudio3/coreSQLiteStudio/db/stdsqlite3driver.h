@@ -11,12 +11,14 @@
         static const int OPEN_READWRITE = UppercasePrefix##SQLITE_OPEN_READWRITE; \
         static const int OPEN_CREATE = UppercasePrefix##SQLITE_OPEN_CREATE; \
         static const int UTF8 = UppercasePrefix##SQLITE_UTF8; \
+        static const int DETERMINISTIC = UppercasePrefix##SQLITE_DETERMINISTIC; \
         static const int INTEGER = UppercasePrefix##SQLITE_INTEGER; \
         static const int FLOAT = UppercasePrefix##SQLITE_FLOAT; \
         static const int NULL_TYPE = UppercasePrefix##SQLITE_NULL; \
         static const int BLOB = UppercasePrefix##SQLITE_BLOB; \
         static const int MISUSE = UppercasePrefix##SQLITE_MISUSE; \
         static const int BUSY = UppercasePrefix##SQLITE_BUSY; \
+        static const int BUSY_SNAPSHOT = (UppercasePrefix##SQLITE_BUSY | (2<<8)); \
         static const int ROW = UppercasePrefix##SQLITE_ROW; \
         static const int DONE = UppercasePrefix##SQLITE_DONE; \
         \
@@ -26,6 +28,7 @@
         typedef Prefix##sqlite3_value value; \
         typedef Prefix##sqlite3_int64 int64; \
         typedef Prefix##sqlite3_destructor_type destructor_type; \
+        typedef Prefix##sqlite3_blob blob; \
         \
         static destructor_type TRANSIENT() {return UppercasePrefix##SQLITE_TRANSIENT;} \
         static void interrupt(handle* arg) {Prefix##sqlite3_interrupt(arg);} \
@@ -67,11 +70,19 @@
         static int total_changes(handle* arg) {return Prefix##sqlite3_total_changes(arg);} \
         static int last_insert_rowid(handle* arg) {return Prefix##sqlite3_last_insert_rowid(arg);} \
         static int step(stmt* arg) {return Prefix##sqlite3_step(arg);} \
+        static int get_autocommit(handle* arg) {return Prefix##sqlite3_get_autocommit(arg);} \
+        static int busy_handler(handle* a1, int(*a2)(void*,int), void* a3) {return Prefix##sqlite3_busy_handler(a1, a2, a3);} \
         static int reset(stmt* arg) {return Prefix##sqlite3_reset(arg);} \
         static int close(handle* arg) {return Prefix##sqlite3_close(arg);} \
         static int enable_load_extension(handle* arg1, int arg2) {return Prefix##sqlite3_enable_load_extension(arg1, arg2);} \
         static void* user_data(context* arg) {return Prefix##sqlite3_user_data(arg);} \
         static void* aggregate_context(context* arg1, int arg2) {return Prefix##sqlite3_aggregate_context(arg1, arg2);} \
+        static int blob_open(handle* a1, const char* a2, const char* a3, const char* a4, int64 a5, int a6, blob** a7) \
+            {return Prefix##sqlite3_blob_open(a1, a2, a3, a4, a5, a6, a7);} \
+        static int blob_close(blob* arg) {return Prefix##sqlite3_blob_close(arg);} \
+        static int blob_bytes(blob* arg) {return Prefix##sqlite3_blob_bytes(arg);} \
+        static int blob_read(blob* a1, void* a2, int a3, int a4) {return Prefix##sqlite3_blob_read(a1, a2, a3, a4);} \
+        static int blob_write(blob* a1, const void* a2, int a3, int a4) {return Prefix##sqlite3_blob_write(a1, a2, a3, a4);} \
         static int collation_needed(handle* a1, void* a2, void(*a3)(void*,handle*,int eTextRep,const char*)) {return Prefix##sqlite3_collation_needed(a1, a2, a3);} \
         static int prepare_v2(handle *a1, const char *a2, int a3, stmt **a4, const char **a5) {return Prefix##sqlite3_prepare_v2(a1, a2, a3, a4, a5);} \
         static int create_function(handle *a1, const char *a2, int a3, int a4, void *a5, void (*a6)(context*,int,value**), void (*a7)(context*,int,value**), void (*a8)(context*)) \
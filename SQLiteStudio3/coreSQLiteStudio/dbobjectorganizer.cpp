@@ -5,6 +5,7 @@
 #include "services/notifymanager.h"
 #include "db/attachguard.h"
 #include "dbversionconverter.h"
+#include "tablecopier.h"
 #include <QDebug>
 #include <QThreadPool>
 
@@ -156,7 +157,7 @@ void DbObjectOrganizer::processPreparation()
             case SchemaResolver::TABLE:
                 srcTables << srcName;
                 findBinaryColumns(srcName, allParsedObjects);
-                collectReferencedTables(srcName, allParsedObjects);
+                collectReferencedTables(srcName);
                 collectReferencedIndexes(srcName);
                 collectReferencedTriggersForTable(srcName);
                 break;
@@ -439,49 +440,22 @@ bool DbObjectOrganizer::copyTableToDb(const QString& table)
 bool DbObjectOrganizer::copyDataAsMiddleware(const QString& table)
 {
     QStringList srcColumns = srcResolver->getTableColumns(srcTable);
-    QString wrappedSrcTable = wrapObjIfNeeded(srcTable, srcDb->getDialect());
-    SqlQueryPtr results = srcDb->prepare("SELECT * FROM " + wrappedSrcTable);
-    setupSqlite2Helper(results, table, srcColumns);
-    if (!results->execute())
-    {
-        notifyError(tr("Error while copying data for table %1: %2").arg(table).arg(results->getErrorText()));
-        return false;
-    }
-
-    QStringList argPlaceholderList;
-    for (int i = 0, total = srcColumns.size(); i < total; ++i)
-        argPlaceholderList << "?";
-
-    QString wrappedDstTable = wrapObjIfNeeded(table, dstDb->getDialect());
-    QString sql = "INSERT INTO " + wrappedDstTable + " VALUES (" + argPlaceholderList.join(", ") + ")";
-    SqlQueryPtr insertQuery = dstDb->prepare(sql);
 
-    SqlResultsRowPtr row;
-    int i = 0;
-    while (results->hasNext())
+    // The whole operation is done in a single transaction, so it can be rolled back, therefore no commit interval here.
+    TableCopier copier(srcDb, dstDb);
+    copier.setInterruptCheck([this]() -> bool {return isInterrupted();});
+    copier.setSourceQueryHandler([this, table, srcColumns](SqlQueryPtr query)
     {
-        row = results->next();
-        if (!row)
-        {
-            notifyError(tr("Error while copying data to table %1: %2").arg(table).arg(results->getErrorText()));
-            return false;
-        }
-
-        insertQuery->setArgs(row->valueList());
-        if (!insertQuery->execute())
-        {
-            notifyError(tr("Error while copying data to table %1: %2").arg(table).arg(insertQuery->getErrorText()));
-            return false;
-        }
-
-        if ((i % 1000) == 0 && isInterrupted())
-            return false;
+        setupSqlite2Helper(query, table, srcColumns);
+    });
 
-        i++;
-    }
+    if (!copier.copy(srcTable, table))
+    {
+        if (!isInterrupted())
+            notifyError(tr("Error while copying data to table %1: %2").arg(table).arg(copier.getErrorText()));
 
-    if (isInterrupted())
         return false;
+    }
 
     return true;
 }
@@ -584,11 +558,11 @@ bool DbObjectOrganizer::copySimpleObjectToDb(const QString& name, const QString&
     return true;
 }
 
-QSet<QString> DbObjectOrganizer::resolveReferencedTables(const QString& table, const QList<SqliteCreateTablePtr>& parsedTables)
+QSet<QString> DbObjectOrganizer::resolveReferencedTables(const QString& table)
 {
-    QSet<QString> tables = SchemaResolver::getFkReferencingTables(table, parsedTables).toSet();
-    for (const QString& fkTable : tables)
-        tables += SchemaResolver::getFkReferencingTables(fkTable, parsedTables).toSet();
+    QSet<QString> tables = srcResolver->getFkReferencingTables(table).toSet();
+    for (const QString& fkTable : tables.toList())
+        tables += srcResolver->getFkReferencingTables(fkTable).toSet();
 
     tables.remove(table); // if it appeared somewhere in the references - we still don't need it here, it's the table we asked by in the first place
     return tables;
@@ -633,18 +607,9 @@ QString DbObjectOrganizer::convertDdlToDstVersion(const QString& ddl)
         return versionConverter->convert3To2(ddl);
 }
 
-void DbObjectOrganizer::collectReferencedTables(const QString& table, const StrHash<SqliteQueryPtr>& allParsedObjects)
+void DbObjectOrganizer::collectReferencedTables(const QString& table)
 {
-    QList<SqliteCreateTablePtr> parsedTables;
-    SqliteCreateTablePtr parsedTable;
-    for (SqliteQueryPtr query : allParsedObjects.values())
-    {
-        parsedTable = query.dynamicCast<SqliteCreateTable>();
-        if (parsedTable)
-            parsedTables << parsedTable;
-    }
-
-    QSet<QString> tables = resolveReferencedTables(table, parsedTables);
+    QSet<QString> tables = resolveReferencedTables(table);
     for (const QString& refTable : tables)
     {
         if (!referencedTables.contains(refTable) && !srcTables.contains(refTable))
@@ -1,5 +1,6 @@
 #include "dbversionconverter.h"
 #include "schemaresolver.h"
+#include "tablecopier.h"
 #include "common/global.h"
 #include "parser/ast/sqlitealtertable.h"
 #include "parser/ast/sqliteanalyze.h"
@@ -1027,55 +1028,19 @@ bool DbVersionConverter::fullConvertCreateObjectsStep2(Db* db)
 
 bool DbVersionConverter::fullConvertCopyData(Db* db, const QStringList& tables)
 {
-    static const QString selectSql = QStringLiteral("SELECT * FROM %1;");
-    static const QString insertSql = QStringLiteral("INSERT INTO %1 VALUES (%2);");
-
-    Dialect srcDialect = fullConversionConfig->srcDb->getDialect();
-    Dialect trgDialect = db->getDialect();
-    QString srcTable;
-    QString trgTable;
-    SqlQueryPtr result;
-    SqlQueryPtr dataResult;
-    SqlResultsRowPtr resultsRow;
-    int i = 1;
+    // Target is a new file, removed in case of failure, so there's no need to keep all data in a single transaction.
+    TableCopier copier(fullConversionConfig->srcDb, db);
+    copier.setCommitInterval(COPY_COMMIT_INTERVAL);
+    copier.setInterruptCheck([this]() -> bool {return isInterrupted();});
     for (const QString& table : tables)
     {
-        // Select data
-        srcTable = wrapObjIfNeeded(table, srcDialect);
-        trgTable = wrapObjIfNeeded(table, trgDialect);
-        dataResult = fullConversionConfig->srcDb->exec(selectSql.arg(srcTable));
-        if (dataResult->isError())
-        {
-            conversionError(db, dataResult->getErrorText());
-            return false;
-        }
-
-        if (checkForInterrupted(db, true))
-            return false;
-
-        // Copy row by row
-        i = 1;
-        while (dataResult->hasNext())
-        {
-            // Get row
-            resultsRow = dataResult->next();
-            if (dataResult->isError())
-            {
-                conversionError(db, dataResult->getErrorText());
-                return false;
-            }
+        if (copier.copy(table, table))
+            continue;
 
-            // Insert row
-            result = db->exec(insertSql.arg(trgTable, generateQueryPlaceholders(resultsRow->valueList().size())), resultsRow->valueList());
-            if (result->isError())
-            {
-                conversionError(db, result->getErrorText());
-                return false;
-            }
+        if (!checkForInterrupted(db, true))
+            conversionError(db, copier.getErrorText());
 
-            if (i++ % 100 == 0 && checkForInterrupted(db, true))
-                return false;
-        }
+        return false;
     }
 
     return true;
@@ -1106,15 +1071,6 @@ QList<Db*> DbVersionConverter::getAllPossibleDbInstances() const
     return dbList;
 }
 
-QString DbVersionConverter::generateQueryPlaceholders(int argCount)
-{
-    QStringList args;
-    for (int i = 0; i < argCount; i++)
-        args << "?";
-
-    return args.join(", ");
-}
-
 void DbVersionConverter::sortConverted()
 {
     qSort(newQueries.begin(), newQueries.end(), [](const SqliteQueryPtr& q1, const SqliteQueryPtr& q2) -> bool
@@ -93,7 +93,6 @@ class API_EXPORT DbVersionConverter : public QObject
         void storeDiff(const QString& sql1, SqliteStatement* stmt);
         void storeErrorDiff(SqliteStatement* stmt);
         QList<Db*> getAllPossibleDbInstances() const;
-        QString generateQueryPlaceholders(int argCount);
         void sortConverted();
         void setInterrupted(bool value);
         bool isInterrupted();
@@ -127,6 +126,11 @@ class API_EXPORT DbVersionConverter : public QObject
         bool interrupted = false;
         QMutex interruptMutex;
 
+        /**
+         * @brief Number of rows copied to the target database in a single transaction during full conversion.
+         */
+        static const int COPY_COMMIT_INTERVAL = 100000;
+
     private slots:
         void conversionError(Db* db, const QString& errMsg);
         void confirmConversion();
@@ -52,6 +52,9 @@ void ExportWorker::run()
             break;
     }
 
+    if (!plugin->flushOutput())
+        res = false;
+
     plugin->cleanupAfterExport();
 
     emit finished(res, output);
@@ -94,6 +97,9 @@ void ExportWorker::interrupt()
     interrupted = true;
     if (executor->isExecutionInProgress())
         executor->interrupt();
+
+    for (TableReader* reader : tableReaders)
+        reader->abort();
 }
 
 bool ExportWorker::exportQueryResults()
@@ -108,7 +114,6 @@ bool ExportWorker::exportQueryResults()
     }
 
     QList<QueryExecutor::ResultColumnPtr> resultColumns = executor->getResultColumns();
-    QHash<ExportManager::ExportProviderFlag,QVariant> providerData = getProviderDataForQueryResults();
 
     if (results->isInterrupted())
     {
@@ -123,6 +128,9 @@ bool ExportWorker::exportQueryResults()
         return false;
     }
 
+    QList<SqlResultsRowPtr> firstRows;
+    QHash<ExportManager::ExportProviderFlag,QVariant> providerData = getProviderDataForQueryResults(results, firstRows);
+
     if (!plugin->initBeforeExport(db, output, *config))
     {
         logExportFail("initBeforeExport()");
@@ -141,6 +149,15 @@ bool ExportWorker::exportQueryResults()
         return false;
     }
 
+    for (const SqlResultsRowPtr& row : firstRows)
+    {
+        if (!plugin->exportQueryResultsRow(row))
+        {
+            logExportFail("exportQueryResultsRow()");
+            return false;
+        }
+    }
+
     SqlResultsRowPtr row;
     while (results->hasNext())
     {
@@ -173,38 +190,56 @@ bool ExportWorker::exportQueryResults()
     return true;
 }
 
-QHash<ExportManager::ExportProviderFlag, QVariant> ExportWorker::getProviderDataForQueryResults()
+QHash<ExportManager::ExportProviderFlag, QVariant> ExportWorker::getProviderDataForQueryResults(SqlQueryPtr results, QList<SqlResultsRowPtr>& firstRows)
 {
     static const QString colLengthSql = QStringLiteral("SELECT %1 FROM (%2)");
     static const QString colLengthTpl = QStringLiteral("max(length(%1))");
     QHash<ExportManager::ExportProviderFlag, QVariant> providerData;
 
-    if (plugin->getProviderFlags().testFlag(ExportManager::ROW_COUNT))
+    ExportManager::ExportProviderFlags flags = plugin->getProviderFlags();
+    if (!flags.testFlag(ExportManager::ROW_COUNT) && !flags.testFlag(ExportManager::DATA_LENGTHS))
+        return providerData;
+
+    bool allRowsRead = readFirstRows(results, firstRows);
+    bool exact = flags.testFlag(ExportManager::EXACT_DATA);
+
+    if (flags.testFlag(ExportManager::ROW_COUNT))
     {
-        executor->countResults();
-        providerData[ExportManager::ROW_COUNT] = executor->getTotalRowsReturned();
+        if (allRowsRead)
+        {
+            providerData[ExportManager::ROW_COUNT] = firstRows.size();
+        }
+        else
+        {
+            executor->countResults();
+            providerData[ExportManager::ROW_COUNT] = executor->getTotalRowsReturned();
+        }
     }
 
-    if (plugin->getProviderFlags().testFlag(ExportManager::DATA_LENGTHS))
+    if (flags.testFlag(ExportManager::DATA_LENGTHS) && (allRowsRead || !exact))
+    {
+        providerData[ExportManager::DATA_LENGTHS] = QVariant::fromValue(getDataLengths(firstRows, results->columnCount()));
+    }
+    else if (flags.testFlag(ExportManager::DATA_LENGTHS))
     {
         QStringList wrappedCols;
         for (const QueryExecutor::ResultColumnPtr& col : executor->getResultColumns())
             wrappedCols << colLengthTpl.arg(wrapObjIfNeeded(col->displayName, db->getDialect()));
 
         executor->exec(colLengthSql.arg(wrappedCols.join(", "), query));
-        SqlQueryPtr results = executor->getResults();
-        if (!results)
+        SqlQueryPtr lengthResults = executor->getResults();
+        if (!lengthResults)
         {
             qCritical() << "Null results from executor in ExportWorker.";
         }
-        else if (results->isError())
+        else if (lengthResults->isError())
         {
-            notifyError(tr("Error while counting data column width to export from query results: %1").arg(results->getErrorText()));
+            notifyError(tr("Error while counting data column width to export from query results: %1").arg(lengthResults->getErrorText()));
         }
         else
         {
             QList<int> colWidths;
-            SqlResultsRowPtr row = results->next();
+            SqlResultsRowPtr row = lengthResults->next();
             for (const QVariant& value : row->valueList())
                 colWidths << value.toInt();
 
@@ -216,14 +251,7 @@ QHash<ExportManager::ExportProviderFlag, QVariant> ExportWorker::getProviderData
 
 bool ExportWorker::exportDatabase()
 {
-    QString err;
-    QList<ExportManager::ExportObjectPtr> dbObjects = collectDbObjects(&err);
-    if (!err.isNull())
-    {
-        logExportFail("exportDatabase() -> dbObjects");
-        notifyError(err);
-        return false;
-    }
+    QList<ExportManager::ExportObjectPtr> dbObjects = collectDbObjects();
 
     if (!plugin->initBeforeExport(db, output, *config))
     {
@@ -243,13 +271,24 @@ bool ExportWorker::exportDatabase()
         return false;
     }
 
+    if (config->parallelTableExport && config->exportData && !startTableReaders(dbObjects))
+        qDebug() << "Parallel reading of tables is not available for this database. Tables will be read one after another.";
+
+    if (config->exportData && tableReaders.isEmpty())
+        beginTableSnapshot();
+
     if (!plugin->beforeExportTables())
     {
         logExportFail("beforeExportTables()");
+        stopTableReaders();
+        endTableSnapshot();
         return false;
     }
 
-    if (!exportDatabaseObjects(dbObjects, ExportManager::ExportObject::TABLE))
+    bool tablesExported = exportDatabaseObjects(dbObjects, ExportManager::ExportObject::TABLE);
+    stopTableReaders();
+    endTableSnapshot();
+    if (!tablesExported)
     {
         logExportFail("exportDatabaseObjects()");
         return false;
@@ -333,17 +372,28 @@ bool ExportWorker::exportDatabase()
 bool ExportWorker::exportDatabaseObjects(const QList<ExportManager::ExportObjectPtr>& dbObjects, ExportManager::ExportObject::Type type)
 {
     SqliteQueryPtr parsedQuery;
+    TableReader* tableReader = nullptr;
+    int tableIdx = 0;
+    QList<SqlResultsRowPtr> firstRows;
+    QString errorMessage;
     bool res = true;
     for (const ExportManager::ExportObjectPtr& obj : dbObjects)
     {
         if (obj->type != type)
             continue;
 
+        // Readers have tables assigned in the same order, so each table has to take its reader, even if it's not exported
+        if (obj->type == ExportManager::ExportObject::TABLE && !tableReaders.isEmpty())
+            tableReader = tableReaders[tableIdx++ % tableReaders.size()];
+
         res = parser->parse(obj->ddl);
         if (!res || parser->getQueries().size() < 1)
         {
             qCritical() << "Could not parse" << obj->name << ", the DDL was:" << obj->ddl << ", error is:" << parser->getErrorString();
             notifyWarn(tr("Could not parse %1 in order to export it. It will be excluded from the export output.").arg(obj->name));
+            if (tableReader)
+                skipTableChunks(tableReader);
+
             continue;
         }
         parsedQuery = parser->getQueries().first();
@@ -351,8 +401,28 @@ bool ExportWorker::exportDatabaseObjects(const QList<ExportManager::ExportObject
         switch (obj->type)
         {
             case ExportManager::ExportObject::TABLE:
-                res = exportTableInternal(obj->database, obj->name, obj->ddl, parsedQuery, obj->data, obj->providerData);
+            {
+                if (tableReader)
+                {
+                    res = exportTableFromReader(obj, parsedQuery, tableReader);
+                    break;
+                }
+
+                // Table data is queried just before it's exported, so there is only one cursor open at the time
+                firstRows.clear();
+                queryTableDataToExport(snapshotDb ? snapshotDb : db, obj->name, obj->data, firstRows, obj->providerData, &errorMessage);
+                if (!errorMessage.isNull())
+                {
+                    notifyError(errorMessage);
+                    res = false;
+                    break;
+                }
+
+                res = exportTableInternal(obj->database, obj->name, obj->ddl, parsedQuery, obj->data, firstRows, obj->providerData);
+                obj->data.clear();
+                firstRows.clear();
                 break;
+            }
             case ExportManager::ExportObject::INDEX:
                 res = plugin->exportIndex(obj->database, obj->name, obj->ddl, parsedQuery.dynamicCast<SqliteCreateIndex>());
                 break;
@@ -385,9 +455,10 @@ bool ExportWorker::exportDatabaseObjects(const QList<ExportManager::ExportObject
 bool ExportWorker::exportTable()
 {
     SqlQueryPtr results;
+    QList<SqlResultsRowPtr> firstRows;
     QString errorMessage;
     QHash<ExportManager::ExportProviderFlag,QVariant> providerData;
-    queryTableDataToExport(db, table, results, providerData, &errorMessage);
+    queryTableDataToExport(db, table, results, firstRows, providerData, &errorMessage);
     if (!errorMessage.isNull())
     {
         logExportFail("fetching table data");
@@ -412,7 +483,7 @@ bool ExportWorker::exportTable()
         return false;
     }
 
-    if (!exportTableInternal(database, table, ddl, createTable, results, providerData))
+    if (!exportTableInternal(database, table, ddl, createTable, results, firstRows, providerData))
     {
         logExportFail("exportTableInternal()");
         return false;
@@ -478,41 +549,24 @@ bool ExportWorker::exportTable()
 }
 
 bool ExportWorker::exportTableInternal(const QString& database, const QString& table, const QString& ddl, SqliteQueryPtr parsedDdl, SqlQueryPtr results,
-                                       const QHash<ExportManager::ExportProviderFlag,QVariant>& providerData)
+                                       const QList<SqlResultsRowPtr>& firstRows, const QHash<ExportManager::ExportProviderFlag,QVariant>& providerData)
 {
-    SqliteCreateTablePtr createTable = parsedDdl.dynamicCast<SqliteCreateTable>();
-    SqliteCreateVirtualTablePtr createVirtualTable = parsedDdl.dynamicCast<SqliteCreateVirtualTable>();
-
     QStringList colNames;
     if (results)
         colNames = results->getColumnNames();
 
-    if (createTable)
-    {
-        if (!results)
-            colNames = createTable->getColumnNames();
+    if (!beginTableExport(database, table, ddl, parsedDdl, colNames, providerData))
+        return false;
 
-        if (!plugin->exportTable(database, table, colNames, ddl, createTable, providerData))
-        {
-            logExportFail("exportTable()");
-            return false;
-        }
-    }
-    else
+    for (const SqlResultsRowPtr& firstRow : firstRows)
     {
-        if (!plugin->exportVirtualTable(database, table, colNames, ddl, createVirtualTable, providerData))
+        if (!plugin->exportTableRow(firstRow))
         {
-            logExportFail("exportVirtualTable()");
+            logExportFail("exportTableRow()");
             return false;
         }
     }
 
-    if (isInterrupted())
-    {
-        logExportFail("internal table export interruption");
-        return false;
-    }
-
     SqlResultsRowPtr row;
     if (results)
     {
@@ -542,7 +596,102 @@ bool ExportWorker::exportTableInternal(const QString& database, const QString& t
     return true;
 }
 
-QList<ExportManager::ExportObjectPtr> ExportWorker::collectDbObjects(QString* errorMessage)
+bool ExportWorker::exportTableFromReader(const ExportManager::ExportObjectPtr& obj, SqliteQueryPtr parsedDdl, ExportWorker::TableReader* reader)
+{
+    TableChunk chunk;
+    if (!reader->nextChunk(chunk))
+    {
+        logExportFail("reading table data (interrupted)");
+        return false;
+    }
+
+    if (!chunk.errorText.isNull())
+    {
+        notifyError(chunk.errorText);
+        return false;
+    }
+
+    if (!beginTableExport(obj->database, obj->name, obj->ddl, parsedDdl, chunk.columnNames, chunk.providerData))
+        return false;
+
+    forever
+    {
+        for (const SqlResultsRowPtr& row : chunk.rows)
+        {
+            if (!plugin->exportTableRow(row))
+            {
+                logExportFail("exportTableRow()");
+                return false;
+            }
+        }
+
+        if (isInterrupted())
+        {
+            logExportFail("internal table export interruption (2)");
+            return false;
+        }
+
+        if (chunk.last)
+            break;
+
+        if (!reader->nextChunk(chunk))
+        {
+            logExportFail("reading table data (interrupted)");
+            return false;
+        }
+
+        if (!chunk.errorText.isNull())
+        {
+            notifyError(chunk.errorText);
+            return false;
+        }
+    }
+
+    if (!plugin->afterExportTable())
+    {
+        logExportFail("afterExportTable()");
+        return false;
+    }
+
+    return true;
+}
+
+bool ExportWorker::beginTableExport(const QString& database, const QString& table, const QString& ddl, SqliteQueryPtr parsedDdl, QStringList colNames,
+                                    const QHash<ExportManager::ExportProviderFlag, QVariant>& providerData)
+{
+    SqliteCreateTablePtr createTable = parsedDdl.dynamicCast<SqliteCreateTable>();
+    SqliteCreateVirtualTablePtr createVirtualTable = parsedDdl.dynamicCast<SqliteCreateVirtualTable>();
+
+    if (createTable)
+    {
+        if (colNames.isEmpty())
+            colNames = createTable->getColumnNames();
+
+        if (!plugin->exportTable(database, table, colNames, ddl, createTable, providerData))
+        {
+            logExportFail("exportTable()");
+            return false;
+        }
+    }
+    else
+    {
+        if (!plugin->exportVirtualTable(database, table, colNames, ddl, createVirtualTable, providerData))
+        {
+            logExportFail("exportVirtualTable()");
+            return false;
+        }
+    }
+
+    if (isInterrupted())
+    {
+        logExportFail("internal table export interruption");
+        return false;
+    }
+
+    return true;
+}
+
+QList<ExportManager::ExportObjectPtr> ExportWorker::collectDbObjects()
 {
     SchemaResolver resolver(db);
     StrHash<SchemaResolver::ObjectDetails> allDetails = resolver.getAllObjectDetails();
@@ -561,12 +710,7 @@ QList<ExportManager::ExportObjectPtr> ExportWorker::collectDbObjects(QString* er
 
         exportObj = ExportManager::ExportObjectPtr::create();
         if (details.type == SchemaResolver::TABLE)
-        {
             exportObj->type = ExportManager::ExportObject::TABLE;
-            queryTableDataToExport(db, objName, exportObj->data, exportObj->providerData, errorMessage);
-            if (!errorMessage->isNull())
-                return objectsToExport;
-        }
         else if (details.type == SchemaResolver::INDEX)
             exportObj->type = ExportManager::ExportObject::INDEX;
         else if (details.type == SchemaResolver::TRIGGER)
@@ -592,56 +736,118 @@ QList<ExportManager::ExportObjectPtr> ExportWorker::collectDbObjects(QString* er
     return objectsToExport;
 }
 
-void ExportWorker::queryTableDataToExport(Db* db, const QString& table, SqlQueryPtr& dataPtr, QHash<ExportManager::ExportProviderFlag,QVariant>& providerData,
-                                          QString* errorMessage) const
+void ExportWorker::queryTableDataToExport(Db* db, const QString& table, SqlQueryPtr& dataPtr, QList<SqlResultsRowPtr>& firstRows,
+                                          QHash<ExportManager::ExportProviderFlag,QVariant>& providerData, QString* errorMessage) const
 {
     static const QString sql = QStringLiteral("SELECT * FROM %1");
     static const QString countSql = QStringLiteral("SELECT count(*) FROM %1");
     static const QString colLengthSql = QStringLiteral("SELECT %1 FROM %2");
     static const QString colLengthTpl = QStringLiteral("max(length(%1))");
 
-    if (config->exportData)
+    if (!config->exportData)
+        return;
+
+    QString wrappedTable = wrapObjIfNeeded(table, db->getDialect());
+    dataPtr = db->exec(sql.arg(wrappedTable));
+    if (dataPtr->isError())
     {
-        QString wrappedTable = wrapObjIfNeeded(table, db->getDialect());
-        dataPtr = db->exec(sql.arg(wrappedTable));
-        if (dataPtr->isError() && !errorMessage->isNull())
-            *errorMessage = tr("Error while reading data to export from table %1: %2").arg(table, dataPtr->getErrorText());
+        *errorMessage = tr("Error while reading data to export from table %1: %2").arg(table, dataPtr->getErrorText());
+        return;
+    }
 
-        if (plugin->getProviderFlags().testFlag(ExportManager::ROW_COUNT))
+    ExportManager::ExportProviderFlags flags = plugin->getProviderFlags();
+    if (!flags.testFlag(ExportManager::ROW_COUNT) && !flags.testFlag(ExportManager::DATA_LENGTHS))
+        return;
+
+    // Provider data is calculated from first rows, unless exact values are requested
+    bool allRowsRead = readFirstRows(dataPtr, firstRows);
+    bool exact = flags.testFlag(ExportManager::EXACT_DATA);
+
+    if (flags.testFlag(ExportManager::ROW_COUNT))
+    {
+        qint64 rowCount = firstRows.size();
+        if (!allRowsRead && !exact && SchemaResolver(db).getRowCountEstimate("main", table, rowCount))
+        {
+            // Statistics may be outdated
+            rowCount = qMax(rowCount, static_cast<qint64>(firstRows.size()));
+        }
+        else if (!allRowsRead)
         {
             SqlQueryPtr countQuery = db->exec(countSql.arg(wrappedTable));
             if (countQuery->isError())
             {
-                if (!errorMessage->isNull())
-                    *errorMessage = tr("Error while counting data to export from table %1: %2").arg(table, countQuery->getErrorText());
+                *errorMessage = tr("Error while counting data to export from table %1: %2").arg(table, countQuery->getErrorText());
+                return;
             }
-            else
-                providerData[ExportManager::ROW_COUNT] = countQuery->getSingleCell().toInt();
+            rowCount = countQuery->getSingleCell().toLongLong();
         }
+        providerData[ExportManager::ROW_COUNT] = rowCount;
+    }
+
+    if (flags.testFlag(ExportManager::DATA_LENGTHS) && (allRowsRead || !exact))
+    {
+        providerData[ExportManager::DATA_LENGTHS] = QVariant::fromValue(getDataLengths(firstRows, dataPtr->columnCount()));
+    }
+    else if (flags.testFlag(ExportManager::DATA_LENGTHS))
+    {
+        QStringList wrappedCols;
+        for (const QString& col : dataPtr->getColumnNames())
+            wrappedCols << colLengthTpl.arg(wrapObjIfNeeded(col, db->getDialect()));
 
-        if (plugin->getProviderFlags().testFlag(ExportManager::DATA_LENGTHS))
+        SqlQueryPtr colLengthQuery = db->exec(colLengthSql.arg(wrappedCols.join(", "), wrappedTable));
+        if (colLengthQuery->isError())
         {
-            QStringList wrappedCols;
-            for (const QString& col : dataPtr->getColumnNames())
-                wrappedCols << colLengthTpl.arg(wrapObjIfNeeded(col, db->getDialect()));
+            *errorMessage = tr("Error while counting data column width to export from table %1: %2").arg(table, colLengthQuery->getErrorText());
+            return;
+        }
 
-            SqlQueryPtr colLengthQuery = db->exec(colLengthSql.arg(wrappedCols.join(", "), wrappedTable));
-            if (colLengthQuery->isError())
-            {
-                if (!errorMessage->isNull())
-                    *errorMessage = tr("Error while counting data column width to export from table %1: %2").arg(table, colLengthQuery->getErrorText());
-            }
+        QList<int> colWidths;
+        SqlResultsRowPtr row = colLengthQuery->next();
+        for (const QVariant& value : row->valueList())
+            colWidths << value.toInt();
+
+        providerData[ExportManager::DATA_LENGTHS] = QVariant::fromValue(colWidths);
+    }
+}
+
+bool ExportWorker::readFirstRows(SqlQueryPtr results, QList<SqlResultsRowPtr>& rows) const
+{
+    while (rows.size() < PROVIDER_DATA_SAMPLE_SIZE)
+    {
+        if (!results->hasNext())
+            return true;
+
+        rows << results->next();
+    }
+    return !results->hasNext();
+}
+
+QList<int> ExportWorker::getDataLengths(const QList<SqlResultsRowPtr>& rows, int columnCount)
+{
+    QList<int> lengths;
+    for (int i = 0; i < columnCount; i++)
+        lengths << 0;
+
+    // Same as the length() SQL function - number of bytes for blobs and number of characters for anything else
+    int length;
+    for (const SqlResultsRowPtr& row : rows)
+    {
+        const QList<QVariant>& values = row->valueList();
+        for (int i = 0, total = qMin(columnCount, values.size()); i < total; i++)
+        {
+            if (values[i].isNull())
+                continue;
+
+            if (values[i].type() == QVariant::ByteArray)
+                length = values[i].toByteArray().size();
             else
-            {
-                QList<int> colWidths;
-                SqlResultsRowPtr row = colLengthQuery->next();
-                for (const QVariant& value : row->valueList())
-                    colWidths << value.toInt();
+                length = values[i].toString().size();
 
-                providerData[ExportManager::DATA_LENGTHS] = QVariant::fromValue(colWidths);
-            }
+            if (length > lengths[i])
+                lengths[i] = length;
         }
     }
+    return lengths;
 }
 
 bool ExportWorker::isInterrupted()
@@ -655,3 +861,179 @@ void ExportWorker::logExportFail(const QString &stageName)
     qWarning() << "Export has faild at" << stageName << "stage.";
 }
 
+
+bool ExportWorker::startTableReaders(const QList<ExportManager::ExportObjectPtr>& dbObjects)
+{
+    QStringList tables;
+    for (const ExportManager::ExportObjectPtr& obj : dbObjects)
+    {
+        if (obj->type == ExportManager::ExportObject::TABLE)
+            tables << obj->name;
+    }
+
+    // Nothing to do in parallel
+    if (tables.size() < 2)
+        return true;
+
+    int readerCount = qMin(tables.size(), qBound(2, QThread::idealThreadCount(), MAX_TABLE_READERS));
+    QList<Db*> connections;
+    Db* readDb = nullptr;
+    for (int i = 0; i < readerCount; i++)
+    {
+        readDb = db->takeReadConnection();
+        if (!readDb)
+            break;
+
+        connections << readDb;
+    }
+
+    if (connections.size() < 2)
+    {
+        for (Db* connection : connections)
+            db->releaseReadConnection(connection);
+
+        return false;
+    }
+
+    QMutexLocker locker(&interruptMutex);
+    for (Db* connection : connections)
+        tableReaders << new TableReader(this, connection);
+
+    int tableIdx = 0;
+    for (const QString& table : tables)
+        tableReaders[tableIdx++ % tableReaders.size()]->addTable(table);
+
+    for (TableReader* reader : tableReaders)
+        reader->start();
+
+    return true;
+}
+
+void ExportWorker::stopTableReaders()
+{
+    QList<TableReader*> readers;
+    {
+        QMutexLocker locker(&interruptMutex);
+        readers = tableReaders;
+        tableReaders.clear();
+    }
+
+    for (TableReader* reader : readers)
+    {
+        reader->abort();
+        reader->wait();
+        delete reader;
+    }
+}
+
+void ExportWorker::beginTableSnapshot()
+{
+    // Cursors of tables are opened one at the time, just before each table is exported. All tables have to come
+    // from the same state of the database, even if other connections commit changes in the meantime, hence the read transaction.
+    snapshotDb = db->takeReadConnection();
+    if (snapshotDb)
+    {
+        SqlQueryPtr results = snapshotDb->exec("BEGIN;");
+        if (!results->isError())
+            return;
+
+        qWarning() << "Could not start read transaction for exported tables:" << results->getErrorText();
+        db->releaseReadConnection(snapshotDb);
+        snapshotDb = nullptr;
+    }
+
+    // The main connection may be used by others in the meantime, so it cannot have a transaction started by the export.
+    // Instead, it stays in the read transaction (started implicitly by SQLite) for as long as this statement is not finished.
+    snapshotGuard = db->exec("SELECT count(*) FROM sqlite_master;");
+    if (snapshotGuard->isError())
+    {
+        qWarning() << "Could not start read transaction for exported tables:" << snapshotGuard->getErrorText();
+        snapshotGuard.clear();
+    }
+}
+
+void ExportWorker::endTableSnapshot()
+{
+    snapshotGuard.clear();
+    if (!snapshotDb)
+        return;
+
+    // Nothing was modified, so it doesn't matter how it's finished
+    snapshotDb->exec("ROLLBACK;");
+    db->releaseReadConnection(snapshotDb);
+    snapshotDb = nullptr;
+}
+
+void ExportWorker::skipTableChunks(ExportWorker::TableReader* reader)
+{
+    TableChunk chunk;
+    while (reader->nextChunk(chunk) && !chunk.last)
+        continue;
+}
+
+ExportWorker::TableReader::TableReader(ExportWorker* worker, Db* db) :
+    worker(worker), db(db), queue(TABLE_CHUNK_QUEUE_CAPACITY)
+{
+}
+
+ExportWorker::TableReader::~TableReader()
+{
+    worker->db->releaseReadConnection(db);
+}
+
+void ExportWorker::TableReader::addTable(const QString& table)
+{
+    tables << table;
+}
+
+bool ExportWorker::TableReader::nextChunk(ExportWorker::TableChunk& chunk)
+{
+    return queue.pop(chunk);
+}
+
+void ExportWorker::TableReader::abort()
+{
+    queue.abort();
+}
+
+void ExportWorker::TableReader::run()
+{
+    for (const QString& table : tables)
+    {
+        if (!readTable(table))
+            break;
+    }
+    queue.close();
+}
+
+bool ExportWorker::TableReader::readTable(const QString& table)
+{
+    TableChunk chunk;
+    SqlQueryPtr results;
+    worker->queryTableDataToExport(db, table, results, chunk.rows, chunk.providerData, &chunk.errorText);
+    if (!chunk.errorText.isNull())
+    {
+        chunk.last = true;
+        queue.push(chunk);
+        return false;
+    }
+
+    chunk.columnNames = results->getColumnNames();
+    while (results->hasNext())
+    {
+        if (chunk.rows.size() >= TABLE_CHUNK_SIZE)
+        {
+            if (!queue.push(chunk))
+                return false;
+
+            chunk = TableChunk();
+        }
+        chunk.rows << results->next();
+    }
+
+    if (results->isError())
+        chunk.errorText = ExportWorker::tr("Error while reading data to export from table %1: %2").arg(table, results->getErrorText());
+
+    chunk.last = true;
+    return queue.push(chunk) && chunk.errorText.isNull();
+}
@@ -4,9 +4,11 @@
 #include "services/exportmanager.h"
 #include "db/queryexecutor.h"
 #include "parser/ast/sqlitecreatetable.h"
+#include "common/boundedqueue.h"
 #include <QObject>
 #include <QRunnable>
 #include <QMutex>
+#include <QThread>
 
 class Db;
 
@@ -23,17 +25,73 @@ class API_EXPORT ExportWorker : public QObject, public QRunnable
         void prepareExportTable(Db* db, const QString& database, const QString& table);
 
     private:
+        /**
+         * @brief Portion of table data read by the TableReader.
+         *
+         * First chunk of each table carries also column names and provider data for that table.
+         * The last chunk of the table has the "last" flag set. If reading the table failed,
+         * the errorText is set and the chunk is the last one.
+         */
+        struct TableChunk
+        {
+            QList<SqlResultsRowPtr> rows;
+            QStringList columnNames;
+            QHash<ExportManager::ExportProviderFlag,QVariant> providerData;
+            QString errorText;
+            bool last = false;
+        };
+
+        /**
+         * @brief Thread reading table data for the parallel database export.
+         *
+         * Each reader has its own read connection (see Db::takeReadConnection()). It reads tables assigned to it one after another
+         * and passes their rows in chunks through a bounded queue, so it keeps at most one cursor open
+         * and only few chunks in memory, no matter how many tables are exported.
+         * The reader gives back the connection when it's deleted.
+         */
+        class TableReader : public QThread
+        {
+            public:
+                TableReader(ExportWorker* worker, Db* db);
+                ~TableReader();
+
+                void addTable(const QString& table);
+                bool nextChunk(TableChunk& chunk);
+                void abort();
+
+            protected:
+                void run();
+
+            private:
+                bool readTable(const QString& table);
+
+                ExportWorker* worker = nullptr;
+                Db* db = nullptr;
+                QStringList tables;
+                BoundedQueue<TableChunk> queue;
+        };
+
         void prepareParser();
         bool exportQueryResults();
-        QHash<ExportManager::ExportProviderFlag, QVariant> getProviderDataForQueryResults();
+        QHash<ExportManager::ExportProviderFlag, QVariant> getProviderDataForQueryResults(SqlQueryPtr results, QList<SqlResultsRowPtr>& firstRows);
         bool exportDatabase();
         bool exportDatabaseObjects(const QList<ExportManager::ExportObjectPtr>& dbObjects, ExportManager::ExportObject::Type type);
         bool exportTable();
         bool exportTableInternal(const QString& database, const QString& table, const QString& ddl, SqliteQueryPtr parsedDdl, SqlQueryPtr results,
-                                 const QHash<ExportManager::ExportProviderFlag, QVariant>& providerData);
-        QList<ExportManager::ExportObjectPtr> collectDbObjects(QString* errorMessage);
-        void queryTableDataToExport(Db* db, const QString& table, SqlQueryPtr& dataPtr, QHash<ExportManager::ExportProviderFlag, QVariant>& providerData,
-                                    QString* errorMessage) const;
+                                 const QList<SqlResultsRowPtr>& firstRows, const QHash<ExportManager::ExportProviderFlag, QVariant>& providerData);
+        bool exportTableFromReader(const ExportManager::ExportObjectPtr& obj, SqliteQueryPtr parsedDdl, TableReader* reader);
+        bool beginTableExport(const QString& database, const QString& table, const QString& ddl, SqliteQueryPtr parsedDdl, QStringList colNames,
+                              const QHash<ExportManager::ExportProviderFlag, QVariant>& providerData);
+        bool startTableReaders(const QList<ExportManager::ExportObjectPtr>& dbObjects);
+        void stopTableReaders();
+        void skipTableChunks(TableReader* reader);
+        void beginTableSnapshot();
+        void endTableSnapshot();
+        QList<ExportManager::ExportObjectPtr> collectDbObjects();
+        void queryTableDataToExport(Db* db, const QString& table, SqlQueryPtr& dataPtr, QList<SqlResultsRowPtr>& firstRows,
+                                    QHash<ExportManager::ExportProviderFlag, QVariant>& providerData, QString* errorMessage) const;
+        bool readFirstRows(SqlQueryPtr results, QList<SqlResultsRowPtr>& rows) const;
+        static QList<int> getDataLengths(const QList<SqlResultsRowPtr>& rows, int columnCount);
         bool isInterrupted();
         void logExportFail(const QString& stageName);
 
@@ -51,6 +109,50 @@ class API_EXPORT ExportWorker : public QObject, public QRunnable
         QMutex interruptMutex;
         Parser* parser = nullptr;
 
+        /**
+         * @brief Readers of table data used for the parallel database export.
+         *
+         * Table number N (in order of export) is read by the reader number N % tableReaders.size().
+         * The list is empty if tables are read by the ExportWorker itself. Changes of the list are protected with interruptMutex.
+         */
+        QList<TableReader*> tableReaders;
+
+        /**
+         * @brief Read connection with a transaction open for reading tables one after another.
+         *
+         * See beginTableSnapshot(). It's null if tables are read by TableReaders, or through the main connection.
+         */
+        Db* snapshotDb = nullptr;
+
+        /**
+         * @brief Unfinished statement keeping the main connection in a read transaction while tables are read one after another.
+         *
+         * Used when no read connection is available for the snapshotDb.
+         */
+        SqlQueryPtr snapshotGuard;
+
+        /**
+         * @brief Number of first rows used to calculate provider data (see ExportManager::ExportProviderFlag).
+         *
+         * These rows are kept in memory and exported before the rest of the data, so the data is read only once.
+         */
+        static const int PROVIDER_DATA_SAMPLE_SIZE = 1000;
+
+        /**
+         * @brief Maximum number of TableReader threads (and database connections) for the parallel database export.
+         */
+        static const int MAX_TABLE_READERS = 4;
+
+        /**
+         * @brief Number of rows in single TableChunk.
+         */
+        static const int TABLE_CHUNK_SIZE = 1000;
+
+        /**
+         * @brief Maximum number of chunks read ahead by a single TableReader.
+         */
+        static const int TABLE_CHUNK_QUEUE_CAPACITY = 4;
+
     public slots:
         void interrupt();
 
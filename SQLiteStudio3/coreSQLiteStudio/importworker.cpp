@@ -2,6 +2,7 @@
 #include "schemaresolver.h"
 #include "services/notifymanager.h"
 #include "db/db.h"
+#include "db/bulkinserter.h"
 #include "plugins/importplugin.h"
 #include "common/utils.h"
 
@@ -67,6 +68,8 @@ void ImportWorker::interrupt()
 {
     QMutexLocker locker(&interruptMutex);
     interrupted = true;
+    if (rowQueue)
+        rowQueue->abort();
 }
 
 void ImportWorker::readPluginColumns()
@@ -134,65 +137,124 @@ bool ImportWorker::prepareTable()
         return false;
     }
 
-    targetColumns = wrapObjNamesIfNeeded(finalColumns, dialect);
+    targetColumns = finalColumns;
     return true;
 }
 
 bool ImportWorker::importData()
 {
-    static const QString insertTemplate = QStringLiteral("INSERT INTO %1 VALUES (%2)");
+    BulkInserter inserter(db, table, targetColumns);
+    inserter.setDeferIndexes(config->deferIndexes && !tableCreated);
 
-    int colCount = targetColumns.size();
-    QStringList valList;
-    for (int i = 0; i < colCount; i++)
-        valList << "?";
+    // No transactions = already in transaction, skip locking
+    if (config->skipTransaction)
+        inserter.setFlags(Db::Flag::NO_LOCK);
 
-    QString theInsert = insertTemplate.arg(wrapObjIfNeeded(table, db->getDialect()), valList.join(", "));
-    SqlQueryPtr query = db->prepare(theInsert);
+    if (config->ignoreErrors)
+    {
+        inserter.setRowErrorHandler([this](qint64 rowNumber, const QString& errorText) -> bool
+        {
+            qDebug() << "Could not import data row number" << rowNumber << ". The row was ignored. Problem details:" << errorText;
+            notifyWarn(tr("Could not import data row number %1. The row was ignored. Problem details: %2")
+                       .arg(QString::number(rowNumber), errorText));
+            return true;
+        });
+    }
 
-    int rowCnt = 0;
-    QList<QVariant> row;
-    while ((row = plugin->next()).size() > 0)
+    if (!inserter.begin())
     {
-        // Fill up missing values in the line
-        for (int i = row.size(); i < colCount; i++)
-            row << QVariant(QVariant::String);
+        error(tr("Error while importing data: %1").arg(inserter.getErrorText()));
+        return false;
+    }
 
-        // Assign argument values
-        query->setArgs(row.mid(0, colCount));
+    BoundedQueue<RowBatch> queue(QUEUE_CAPACITY);
+    {
+        QMutexLocker locker(&interruptMutex);
+        rowQueue = &queue;
+        if (interrupted)
+            queue.abort();
+    }
 
-        // No transactions = already in transaction, skip locking
-        if (config->skipTransaction)
-            query->setFlags(Db::Flag::NO_LOCK);
+    Reader reader(this);
+    reader.start();
 
-        if (!query->execute())
+    bool result = true;
+    RowBatch batch;
+    while (queue.pop(batch))
+    {
+        for (const QList<QVariant>& row : batch)
         {
-            if (config->ignoreErrors)
-            {
-                qDebug() << "Could not import data row number" << (rowCnt+1) << ". The row was ignored. Problem details:"
-                         << query->getErrorText();
-
-                notifyWarn(tr("Could not import data row number %1. The row was ignored. Problem details: %2")
-                           .arg(QString::number(rowCnt + 1), query->getErrorText()));
-            }
-            else
+            if (!inserter.insert(row))
             {
-                error(tr("Error while importing data: %1").arg(query->getErrorText()));
-                return false;
+                result = false;
+                break;
             }
         }
 
-        if ((rowCnt % 100) == 0 && isInterrupted())
-        {
-            error(tr("Error while importing data: %1").arg(tr("Interrupted.", "import process status update")));
-            return false;
-        }
-        rowCnt++;
+        if (!result)
+            break;
+    }
+
+    // In case of an error the reader may be waiting for free space in the queue
+    if (!result)
+        queue.abort();
+
+    reader.wait();
+    {
+        QMutexLocker locker(&interruptMutex);
+        rowQueue = nullptr;
+    }
+
+    if (result && isInterrupted())
+    {
+        error(tr("Error while importing data: %1").arg(tr("Interrupted.", "import process status update")));
+        return false;
+    }
+
+    if (!result || !inserter.finish())
+    {
+        error(tr("Error while importing data: %1").arg(inserter.getErrorText()));
+        return false;
     }
 
     return true;
 }
 
+void ImportWorker::readData()
+{
+    RowBatch batch;
+    batch.reserve(BATCH_SIZE);
+
+    QList<QVariant> row;
+    while ((row = plugin->next()).size() > 0)
+    {
+        batch << row;
+        if (batch.size() < BATCH_SIZE)
+            continue;
+
+        if (!rowQueue->push(batch))
+            return; // aborted
+
+        batch.clear();
+        batch.reserve(BATCH_SIZE);
+    }
+
+    if (batch.size() > 0)
+        rowQueue->push(batch);
+
+    rowQueue->close();
+}
+
+ImportWorker::Reader::Reader(ImportWorker* worker) :
+    worker(worker)
+{
+}
+
+void ImportWorker::Reader::run()
+{
+    worker->readData();
+}
+
 bool ImportWorker::isInterrupted()
 {
     QMutexLocker locker(&interruptMutex);
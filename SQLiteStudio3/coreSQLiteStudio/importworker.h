@@ -2,9 +2,11 @@
 #define IMPORTWORKER_H
 
 #include "services/importmanager.h"
+#include "common/boundedqueue.h"
 #include <QObject>
 #include <QRunnable>
 #include <QMutex>
+#include <QThread>
 
 class ImportWorker : public QObject, public QRunnable
 {
@@ -15,10 +17,31 @@ class ImportWorker : public QObject, public QRunnable
         void run();
 
     private:
+        typedef QList<QList<QVariant>> RowBatch;
+
+        /**
+         * @brief Thread reading data from the import plugin.
+         *
+         * It passes rows in batches to the rowQueue, while the ImportWorker thread inserts them into the database,
+         * so parsing the input and writing to the database are done at the same time.
+         */
+        class Reader : public QThread
+        {
+            public:
+                explicit Reader(ImportWorker* worker);
+
+            protected:
+                void run();
+
+            private:
+                ImportWorker* worker = nullptr;
+        };
+
         void readPluginColumns();
         void error(const QString& err);
         bool prepareTable();
         bool importData();
+        void readData();
         bool isInterrupted();
 
         ImportPlugin* plugin = nullptr;
@@ -33,6 +56,20 @@ class ImportWorker : public QObject, public QRunnable
         QMutex interruptMutex;
         bool tableCreated = false;
 
+        /**
+         * @brief Batches of rows read by the Reader, waiting to be inserted.
+         *
+         * It exists only during importData(). Access to the pointer is protected with interruptMutex.
+         */
+        BoundedQueue<RowBatch>* rowQueue = nullptr;
+
+        static const int BATCH_SIZE = 1000;
+
+        /**
+         * @brief Maximum number of batches read ahead of the database writing.
+         */
+        static const int QUEUE_CAPACITY = 8;
+
     public slots:
         void interrupt();
 
@@ -54,6 +54,18 @@ void logSql(Db* db, const QString& str, const QList<QVariant>& args, Db::Flags f
         qDebug() << "    SQL arg>" << i++ << "=" << arg;
 }
 
+void logSqlBusy(Db* db, const QString& str, int retries, qint64 waitTime)
+{
+    if (!SQL_DEBUG)
+        return;
+
+    if (!SQL_DEBUG_FILTER.isEmpty() && SQL_DEBUG_FILTER != db->getName())
+        return;
+
+    qDebug() << QString("SQL %1> %2").arg(db->getName()).arg(str) << "(database busy, retries:" << retries
+             << ", waited:" << QString::number(waitTime / 1000.0, 'f', 3) << "ms)";
+}
+
 void setExecutorLoggingEnabled(bool enabled)
 {
     EXECUTOR_DEBUG = enabled;
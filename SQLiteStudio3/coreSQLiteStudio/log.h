@@ -13,6 +13,7 @@ class QueryExecutorStep;
 API_EXPORT QString getLogDateTime();
 API_EXPORT void logSql(Db* db, const QString& str, const QHash<QString,QVariant>& args, Db::Flags flags);
 API_EXPORT void logSql(Db* db, const QString& str, const QList<QVariant>& args, Db::Flags flags);
+API_EXPORT void logSqlBusy(Db* db, const QString& str, int retries, qint64 waitTime);
 API_EXPORT void logExecutorStep(QueryExecutorStep* step);
 API_EXPORT void logExecutorAfterStep(const QString& str);
 API_EXPORT void setSqlLoggingEnabled(bool enabled);
@@ -110,6 +110,56 @@ void SqliteStatement::processPostParsing()
         stmt->processPostParsing();
 }
 
+void SqliteStatement::detachTokens()
+{
+    QHash<Token*,TokenPtr> copies;
+    detachTokens(copies);
+}
+
+void SqliteStatement::detachTokens(QHash<Token*,TokenPtr>& copies)
+{
+    tokens = copyTokens(tokens, copies);
+
+    QMutableHashIterator<QString,TokenList> it(tokensMap);
+    while (it.hasNext())
+    {
+        it.next();
+        it.setValue(copyTokens(it.value(), copies));
+    }
+
+    dbTokenForFullObjects = copyToken(dbTokenForFullObjects, copies);
+
+    foreach (SqliteStatement* stmt, childStatements())
+        stmt->detachTokens(copies);
+}
+
+TokenPtr SqliteStatement::copyToken(const TokenPtr& token, QHash<Token*,TokenPtr>& copies)
+{
+    if (!token)
+        return token;
+
+    TokenPtr& copy = copies[token.data()];
+    if (!copy)
+    {
+        TolerantToken* tolerantToken = dynamic_cast<TolerantToken*>(token.data());
+        if (tolerantToken)
+            copy = TokenPtr(new TolerantToken(*tolerantToken));
+        else
+            copy = TokenPtr(new Token(*token));
+    }
+
+    return copy;
+}
+
+TokenList SqliteStatement::copyTokens(const TokenList& tokens, QHash<Token*,TokenPtr>& copies)
+{
+    TokenList result;
+    for (const TokenPtr& token : tokens)
+        result << copyToken(token, copies);
+
+    return result;
+}
+
 QStringList SqliteStatement::getContextColumns(SqliteStatement *caller, bool checkParent, bool checkChilds)
 {
     QStringList results = getColumnsInStatement();
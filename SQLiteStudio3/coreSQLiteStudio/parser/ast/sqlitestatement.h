@@ -230,6 +230,15 @@ class API_EXPORT SqliteStatement : public QObject
         void processPostParsing();
         virtual SqliteStatement* clone() = 0;
 
+        /**
+         * @brief Replaces tokens of this statement and all its children with their copies.
+         *
+         * Cloned statement shares tokens with the original one, so modifying token values in one of them
+         * is visible in the other one. After this call they're independent. Tokens shared between statements
+         * of this tree stay shared (by the copies), so the tree is consistent as before.
+         */
+        void detachTokens();
+
         template <class T>
         void attach(QList<T*>& listMemberForChild, T* childStatementToAttach)
         {
@@ -334,6 +343,9 @@ class API_EXPORT SqliteStatement : public QObject
 
     private:
         QList<SqliteStatement*> getContextStatements(SqliteStatement* caller, bool checkParent, bool checkChilds);
+        void detachTokens(QHash<Token*,TokenPtr>& copies);
+        static TokenPtr copyToken(const TokenPtr& token, QHash<Token*,TokenPtr>& copies);
+        static TokenList copyTokens(const TokenList& tokens, QHash<Token*,TokenPtr>& copies);
 };
 
 #endif // SQLITESTATEMENT_H
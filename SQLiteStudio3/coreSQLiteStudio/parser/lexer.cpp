@@ -30,26 +30,61 @@ TokenList Lexer::tokenize(const QString &sql)
     TokenList resultList;
     int lgt;
     TokenPtr token;
-    QString str = sql;
+    int ver = getSqliteVersion();
 
-    quint64 pos = 0;
-    for (;str.size() > 0;)
+    int pos = 0;
+    int size = sql.size();
+    while (pos < size)
     {
         if (tolerant)
             token = TolerantTokenPtr::create();
         else
             token = TokenPtr::create();
 
-        lgt = lexerGetToken(str, token, dialect == Dialect::Sqlite2 ? 2 : 3, tolerant);
+        lgt = lexerGetToken(sql, pos, token.data(), ver, tolerant);
         if (lgt == 0)
             break;
 
-        token->value = str.mid(0, lgt);
+        token->value = sql.mid(pos, lgt);
         token->start = pos;
         token->end = pos + lgt - 1;
 
         resultList << token;
-        str = str.mid(lgt);
+        pos += lgt;
+    }
+
+    return resultList;
+}
+
+QVector<Lexer::TokenView> Lexer::tokenizeToViews(const QString& sql)
+{
+    QVector<TokenView> resultList;
+    int ver = getSqliteVersion();
+
+    // Regular token is enough for non-tolerant mode, but the low-level routine requires TolerantToken for tolerant mode.
+    // It's reused for all tokens, as only lemonType, type and invalid flag are taken from it.
+    TolerantToken token;
+
+    TokenView view;
+    view.tolerant = tolerant;
+
+    int lgt;
+    int pos = 0;
+    int size = sql.size();
+    while (pos < size)
+    {
+        token.invalid = false;
+        lgt = lexerGetToken(sql, pos, &token, ver, tolerant);
+        if (lgt == 0)
+            break;
+
+        view.lemonType = token.lemonType;
+        view.type = token.type;
+        view.start = pos;
+        view.length = lgt;
+        view.invalid = token.invalid;
+        resultList << view;
+
         pos += lgt;
     }
 
@@ -64,7 +99,7 @@ void Lexer::prepare(const QString &sql)
 
 TokenPtr Lexer::getToken()
 {
-    if (sqlToTokenize.isEmpty())
+    if (isEnd())
         return TokenPtr();
 
     TokenPtr token;
@@ -73,15 +108,15 @@ TokenPtr Lexer::getToken()
     else
         token = TokenPtr::create();
 
-    int lgt = lexerGetToken(sqlToTokenize, token, dialect == Dialect::Sqlite2 ? 2 : 3, tolerant);
+    int pos = static_cast<int>(tokenPosition);
+    int lgt = lexerGetToken(sqlToTokenize, pos, token.data(), getSqliteVersion(), tolerant);
     if (lgt == 0)
         return TokenPtr();
 
-    token->value = sqlToTokenize.mid(0, lgt);
+    token->value = sqlToTokenize.mid(pos, lgt);
     token->start = tokenPosition;
     token->end = tokenPosition + lgt - 1;
 
-    sqlToTokenize = sqlToTokenize.mid(lgt);
     tokenPosition += lgt;
 
     return token;
@@ -127,7 +162,7 @@ QSet<TokenPtr> Lexer::getEveryTokenType(QSet<Token::Type> types)
 
 bool Lexer::isEnd() const
 {
-    return sqlToTokenize.isEmpty();
+    return tokenPosition >= static_cast<quint64>(sqlToTokenize.size());
 }
 
 TokenPtr Lexer::getSemicolonToken(Dialect dialect)
@@ -333,6 +368,11 @@ TokenPtr Lexer::getEveryTokenTypePtr(Token *token)
     return TokenPtr();
 }
 
+int Lexer::getSqliteVersion() const
+{
+    return dialect == Dialect::Sqlite2 ? 2 : 3;
+}
+
 TokenPtr Lexer::createTokenType(Dialect dialect, int lemonType, Token::Type type, const QString &value)
 {
     TokenPtr tokenPtr = TokenPtr::create(lemonType, type, value, -100, -100);
@@ -344,3 +384,35 @@ TokenPtr Lexer::createTokenType(Dialect dialect, int lemonType, Token::Type type
     everyTokenTypePtrMap[tokenPtr.data()] = tokenPtr;
     return tokenPtr;
 }
+
+QStringRef Lexer::TokenView::valueRef(const QString& sql) const
+{
+    return sql.midRef(start, length);
+}
+
+QString Lexer::TokenView::value(const QString& sql) const
+{
+    return sql.mid(start, length);
+}
+
+TokenPtr Lexer::TokenView::toToken(const QString& sql) const
+{
+    TokenPtr token;
+    if (tolerant)
+    {
+        TolerantTokenPtr tolerantToken = TolerantTokenPtr::create();
+        tolerantToken->invalid = invalid;
+        token = tolerantToken;
+    }
+    else
+    {
+        token = TokenPtr::create();
+    }
+
+    token->lemonType = lemonType;
+    token->type = type;
+    token->value = value(sql);
+    token->start = start;
+    token->end = start + length - 1;
+    return token;
+}
@@ -6,6 +6,8 @@
 
 #include <QList>
 #include <QString>
+#include <QStringRef>
+#include <QVector>
 #include <QSet>
 
 /**
@@ -23,6 +25,72 @@
 class API_EXPORT Lexer
 {
     public:
+        /**
+         * @brief Lightweight token described by its position in the tokenized query.
+         *
+         * It's produced by tokenizeToViews(). It doesn't carry a copy of the token value.
+         * The value is a range of characters in the query that was tokenized, so it can be extracted
+         * (or just referenced) only when it's really needed. This makes tokenizing of large scripts
+         * much cheaper, when only some of tokens are interesting to the caller.
+         *
+         * Views are valid only as long as the query string they were created from.
+         */
+        struct API_EXPORT TokenView
+        {
+            /**
+             * @brief Provides reference to the token value in the query, without copying it.
+             * @param sql The same query that was passed to tokenizeToViews().
+             * @return Reference to the token characters.
+             */
+            QStringRef valueRef(const QString& sql) const;
+
+            /**
+             * @brief Extracts token value from the query.
+             * @param sql The same query that was passed to tokenizeToViews().
+             * @return Copy of the token characters.
+             */
+            QString value(const QString& sql) const;
+
+            /**
+             * @brief Converts view into the regular token.
+             * @param sql The same query that was passed to tokenizeToViews().
+             * @return Token with value, type and positions equal to the view.
+             *
+             * If the view was created in tolerant mode, then TolerantToken is returned.
+             */
+            TokenPtr toToken(const QString& sql) const;
+
+            /**
+             * @brief Lemon token ID.
+             */
+            int lemonType = 0;
+
+            /**
+             * @brief Token type, as in Token::type.
+             */
+            Token::Type type = Token::INVALID;
+
+            /**
+             * @brief Index of the first token character in the query.
+             */
+            int start = 0;
+
+            /**
+             * @brief Number of characters in the token.
+             */
+            int length = 0;
+
+            /**
+             * @brief Invalid flag, as in TolerantToken::invalid. Set only in tolerant mode.
+             */
+            bool invalid = false;
+
+            /**
+             * @brief Tells whether the view was created in tolerant mode.
+             */
+            bool tolerant = false;
+        };
+
         /**
          * @brief Creates lexer for given dialect.
          * @param dialect SQLite dialect.
@@ -41,6 +109,19 @@ class API_EXPORT Lexer
          */
         TokenList tokenize(const QString& sql);
 
+        /**
+         * @brief Tokenizes given SQL query into lightweight token views.
+         * @param sql SQL query to tokenize.
+         * @return List of token views, in order of occurrence in the query.
+         *
+         * This is a zero-copy variant of tokenize(). It walks through the query once
+         * and it doesn't allocate any token objects, nor token values. Use TokenView::value()
+         * or TokenView::valueRef() with the same \p sql to get values of tokens that you need.
+         * It's a good choice for large scripts (like database dumps), where only some tokens
+         * (like semicolons, or keywords) are interesting.
+         */
+        QVector<TokenView> tokenizeToViews(const QString& sql);
+
         /**
          * @brief Stores given SQL query internally for further processing by the lexer.
          * @param sql Query to remember.
@@ -106,7 +187,7 @@ class API_EXPORT Lexer
          * @return true if there is no more tokens to be read, or false otherwise.
          *
          * This method simply checks whether there's any characters in the query to be tokenized.
-         * The query is the one defined with prepare(). Query shrinks with very call to getToken()
+         * The query is the one defined with prepare(). Tokenizing position moves forward with every call to getToken()
          * and once there's no more characters to consume by getToken(), this method will return false.
          *
          * If you call getToken() after isEnd() returned false, the getToken() will return Token::INVALID token.
@@ -193,6 +274,12 @@ class API_EXPORT Lexer
          */
         static TokenPtr createTokenType(Dialect dialect, int lemonType, Token::Type type, const QString& value);
 
+        /**
+         * @brief Provides SQLite version number for lexerGetToken().
+         * @return 2 or 3, depending on the lexer dialect.
+         */
+        int getSqliteVersion() const;
+
         /**
          * @brief Current "tolerant mode" flag.
          *
@@ -208,7 +295,7 @@ class API_EXPORT Lexer
         /**
          * @brief SQL query to be tokenized with getToken().
          *
-         * It's defined with prepare().
+         * It's defined with prepare(). It's not modified by getToken(), which only moves the tokenPosition.
          */
         QString sqlToTokenize;
 
@@ -220,7 +307,7 @@ class API_EXPORT Lexer
          *
          * It's reset to 0 by prepare() and cleanUp().
          */
-        quint64 tokenPosition;
+        quint64 tokenPosition = 0;
 
         /**
          * @brief Internal table of every token type for SQLite 2.
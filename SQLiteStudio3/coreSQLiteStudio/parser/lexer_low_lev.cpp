@@ -20,6 +20,11 @@ bool isIdChar(const QChar& c)
 }
 
 int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tolerant)
+{
+    return lexerGetToken(z, 0, token.data(), sqliteVersion, tolerant);
+}
+
+int lexerGetToken(const QString& z, int offset, Token* token, int sqliteVersion, bool tolerant)
 {
     if (sqliteVersion < 2 || sqliteVersion > 3)
     {
@@ -27,7 +32,7 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
         return 0;
     }
 
-    if (tolerant && !token.dynamicCast<TolerantToken>())
+    if (tolerant && !dynamic_cast<TolerantToken*>(token))
     {
         qCritical() << "lexerGetToken() called with tolerant=true, but not a TolerantToken entity!";
         return 0;
@@ -36,22 +41,22 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
     bool v3 = sqliteVersion == 3;
     int i;
     QChar c;
-    QChar z0 = charAt(z, 0);
+    QChar z0 = charAt(z, offset);
 
     for (;;)
     {
         if (z0.isSpace())
         {
-            for(i=1; charAt(z, i).isSpace(); i++) {}
+            for(i=1; charAt(z, offset + i).isSpace(); i++) {}
             token->lemonType = v3 ? TK3_SPACE : TK2_SPACE;
             token->type = Token::SPACE;
             return i;
         }
         if (z0 == '-')
         {
-            if (charAt(z, 1) == '-')
+            if (charAt(z, offset + 1) == '-')
             {
-                for (i=2; (c = charAt(z, i)) != 0 && c != '\n'; i++) {}
+                for (i=2; (c = charAt(z, offset + i)) != 0 && c != '\n'; i++) {}
                 token->lemonType = v3 ? TK3_COMMENT : TK2_COMMENT;
                 token->type = Token::COMMENT;
                 return i;
@@ -92,26 +97,26 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
         }
         if (z0 == '/')
         {
-            if ( charAt(z, 1) != '*' )
+            if ( charAt(z, offset + 1) != '*' )
             {
                 token->lemonType = v3 ? TK3_SLASH : TK2_SLASH;
                 token->type = Token::OPERATOR;
                 return 1;
             }
 
-            if ( charAt(z, 2) == 0 )
+            if ( charAt(z, offset + 2) == 0 )
             {
                 token->lemonType = v3 ? TK3_COMMENT : TK2_COMMENT;
                 token->type = Token::COMMENT;
                 if (tolerant)
-                    token.dynamicCast<TolerantToken>()->invalid = true;
+                    static_cast<TolerantToken*>(token)->invalid = true;
 
                 return 2;
             }
-            for (i = 3, c = charAt(z, 2); (c != '*' || charAt(z, i) != '/') && (c = charAt(z, i)) != 0; i++) {}
+            for (i = 3, c = charAt(z, offset + 2); (c != '*' || charAt(z, offset + i) != '/') && (c = charAt(z, offset + i)) != 0; i++) {}
 
-            if (tolerant && (c != '*' || charAt(z, i) != '/'))
-                token.dynamicCast<TolerantToken>()->invalid = true;
+            if (tolerant && (c != '*' || charAt(z, offset + i) != '/'))
+                static_cast<TolerantToken*>(token)->invalid = true;
 
             if ( c > 0 )
                 i++;
@@ -129,11 +134,11 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
         {
             token->lemonType = v3 ? TK3_EQ : TK2_EQ;
             token->type = Token::OPERATOR;
-            return 1 + (charAt(z, 1) == '=');
+            return 1 + (charAt(z, offset + 1) == '=');
         }
         if (z0 == '<')
         {
-            if ( (c = charAt(z, 1)) == '=' )
+            if ( (c = charAt(z, offset + 1)) == '=' )
             {
                 token->lemonType = v3 ? TK3_LE : TK2_LE;
                 token->type = Token::OPERATOR;
@@ -160,7 +165,7 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
         }
         if (z0 == '>')
         {
-            if ( (c = charAt(z, 1)) == '=' )
+            if ( (c = charAt(z, offset + 1)) == '=' )
             {
                 token->lemonType = v3 ? TK3_GE : TK2_GE;
                 token->type = Token::OPERATOR;
@@ -181,7 +186,7 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
         }
         if (z0 == '!')
         {
-            if ( charAt(z, 1) != '=' )
+            if ( charAt(z, offset + 1) != '=' )
             {
                 token->lemonType = v3 ? TK3_ILLEGAL : TK2_ILLEGAL;
                 token->type = Token::INVALID;
@@ -196,7 +201,7 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
         }
         if (z0 == '|')
         {
-            if( charAt(z, 1) != '|' )
+            if( charAt(z, offset + 1) != '|' )
             {
                 token->lemonType = v3 ? TK3_BITOR : TK2_BITOR;
                 token->type = Token::OPERATOR;
@@ -232,11 +237,11 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
             z0 == '"')
         {
             QChar delim = z0;
-            for (i = 1; (c = charAt(z, i)) != 0; i++)
+            for (i = 1; (c = charAt(z, offset + i)) != 0; i++)
             {
                 if ( c == delim )
                 {
-                    if( charAt(z, i+1) == delim )
+                    if( charAt(z, offset + i+1) == delim )
                         i++;
                     else
                         break;
@@ -266,7 +271,7 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
                     token->lemonType = v3 ? TK3_ID : TK2_ID;
                     token->type = Token::OTHER;
                 }
-                token.dynamicCast<TolerantToken>()->invalid = true;
+                static_cast<TolerantToken*>(token)->invalid = true;
                 return i;
             }
             else
@@ -278,7 +283,7 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
         }
         if (z0 == '.')
         {
-            if( !charAt(z, 1).isDigit() )
+            if( !charAt(z, offset + 1).isDigit() )
             {
                 token->lemonType = v3 ? TK3_DOT : TK2_DOT;
                 token->type = Token::OPERATOR;
@@ -293,35 +298,35 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
         {
             token->lemonType = v3 ? TK3_INTEGER : TK2_INTEGER;
             token->type = Token::INTEGER;
-            if (v3 && charAt(z, 0) == '0' && (charAt(z, 1) == 'x' || charAt(z, 1) == 'X') && isHex(charAt(z, 2)))
+            if (v3 && charAt(z, offset) == '0' && (charAt(z, offset + 1) == 'x' || charAt(z, offset + 1) == 'X') && isHex(charAt(z, offset + 2)))
             {
-                for (i=3; isHex(charAt(z, i)); i++) {}
+                for (i=3; isHex(charAt(z, offset + i)); i++) {}
                 return i;
             }
-            for (i=0; charAt(z, i).isDigit(); i++) {}
-            if ( charAt(z, i) == '.' )
+            for (i=0; charAt(z, offset + i).isDigit(); i++) {}
+            if ( charAt(z, offset + i) == '.' )
             {
                 i++;
-                while ( charAt(z, i).isDigit() )
+                while ( charAt(z, offset + i).isDigit() )
                     i++;
 
                 token->lemonType = v3 ? TK3_FLOAT : TK2_FLOAT;
                 token->type = Token::FLOAT;
             }
-            if ( (charAt(z, i) == 'e' || charAt(z, i) == 'E') &&
-                 ( charAt(z, i+1).isDigit()
-                   || ((charAt(z, i+1) == '+' || charAt(z, i+1) == '-') && charAt(z, i+2).isDigit())
+            if ( (charAt(z, offset + i) == 'e' || charAt(z, offset + i) == 'E') &&
+                 ( charAt(z, offset + i+1).isDigit()
+                   || ((charAt(z, offset + i+1) == '+' || charAt(z, offset + i+1) == '-') && charAt(z, offset + i+2).isDigit())
                  )
                )
             {
                 i += 2;
-                while ( charAt(z, i).isDigit() )
+                while ( charAt(z, offset + i).isDigit() )
                     i++;
 
                 token->lemonType = v3 ? TK3_FLOAT : TK2_FLOAT;
                 token->type = Token::FLOAT;
             }
-            while ( isIdChar(charAt(z, i)) )
+            while ( isIdChar(charAt(z, offset + i)) )
             {
                 token->lemonType = v3 ? TK3_ILLEGAL : TK2_ILLEGAL;
                 token->type = Token::INVALID;
@@ -331,7 +336,7 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
         }
         if (z0 == '[')
         {
-            for (i = 1, c = z0; c!=']' && (c = charAt(z, i)) != 0; i++) {}
+            for (i = 1, c = z0; c!=']' && (c = charAt(z, offset + i)) != 0; i++) {}
             if (c == ']')
             {
                 token->lemonType = v3 ? TK3_ID : TK2_ID;
@@ -341,7 +346,7 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
             {
                 token->lemonType = v3 ? TK3_ID : TK2_ID;
                 token->type = Token::OTHER;
-                token.dynamicCast<TolerantToken>()->invalid = true;
+                static_cast<TolerantToken*>(token)->invalid = true;
             }
             else
             {
@@ -354,7 +359,7 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
         {
             token->lemonType = v3 ? TK3_VARIABLE : TK2_VARIABLE;
             token->type = Token::BIND_PARAM;
-            for (i=1; charAt(z, i+2).isDigit(); i++) {}
+            for (i=1; charAt(z, offset + i+2).isDigit(); i++) {}
             return i;
         }
         if (z0 == '$' ||
@@ -364,7 +369,7 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
             int n = 0;
             token->lemonType = v3 ? TK3_VARIABLE : TK2_VARIABLE;
             token->type = Token::BIND_PARAM;
-            for (i = 1; (c = charAt(z, i)) != 0; i++)
+            for (i = 1; (c = charAt(z, offset + i)) != 0; i++)
             {
                 if ( isIdChar(c) )
                 {
@@ -376,7 +381,7 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
                     {
                         i++;
                     }
-                    while ( (c = charAt(z, i)) != 0 && !c.isSpace() && c != ')' );
+                    while ( (c = charAt(z, offset + i)) != 0 && !c.isSpace() && c != ')' );
 
                     if ( c==')' )
                     {
@@ -389,7 +394,7 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
                     }
                     break;
                 }
-                else if ( c == ':' && charAt(z, i+1) == ':' )
+                else if ( c == ':' && charAt(z, offset + i+1) == ':' )
                 {
                     i++;
                 }
@@ -410,28 +415,28 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
              z0 == 'X') &&
              v3)
         {
-            if ( charAt(z, 1) == '\'' )
+            if ( charAt(z, offset + 1) == '\'' )
             {
                 token->lemonType = TK3_BLOB;
                 token->type = Token::BLOB;
-                for (i = 2; isXDigit(charAt(z, i)); i++) {}
-                if (charAt(z, i) != '\'' || i%2)
+                for (i = 2; isXDigit(charAt(z, offset + i)); i++) {}
+                if (charAt(z, offset + i) != '\'' || i%2)
                 {
                     if (tolerant)
                     {
                         token->lemonType = TK3_BLOB;
                         token->type = Token::BLOB;
-                        token.dynamicCast<TolerantToken>()->invalid = true;
+                        static_cast<TolerantToken*>(token)->invalid = true;
                     }
                     else
                     {
                         token->lemonType = TK3_ILLEGAL;
                         token->type = Token::INVALID;
                     }
-                    while (charAt(z, i) > 0 && charAt(z, i) != '\'')
+                    while (charAt(z, offset + i) > 0 && charAt(z, offset + i) != '\'')
                         i++;
                 }
-                if ( charAt(z, i) > 0 )
+                if ( charAt(z, offset + i) > 0 )
                     i++;
 
                 return i;
@@ -443,12 +448,12 @@ int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tole
             if (!isIdChar(z0))
                 break;
 
-            for (i = 1; isIdChar(charAt(z, i)); i++) {}
+            for (i = 1; isIdChar(charAt(z, offset + i)); i++) {}
 
             if (v3)
-                token->lemonType = getKeywordId3(z.mid(0, i));
+                token->lemonType = getKeywordId3(z.mid(offset, i));
             else
-                token->lemonType = getKeywordId2(z.mid(0, i));
+                token->lemonType = getKeywordId2(z.mid(offset, i));
 
             if (token->lemonType == TK3_ID || token->lemonType == TK2_ID)
                 token->type = Token::OTHER;
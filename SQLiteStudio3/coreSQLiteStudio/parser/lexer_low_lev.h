@@ -24,4 +24,20 @@
  */
 int lexerGetToken(const QString& z, TokenPtr token, int sqliteVersion, bool tolerant = false);
 
+/**
+ * @brief Low level tokenizer function working on the offset in the query.
+ * @param z Query to tokenize.
+ * @param offset Index of the first character in \p z to start tokenizing from.
+ * @param[out] token Token container to fill with values. Can be also a TolerantToken.
+ * @param sqliteVersion SQLite version, for which the tokenizer should work (2 or 3).
+ * @param tolerant If true, then all multi-line and unfinished tokens (strings, comments)
+ * will be reported with invalid=true in TolerantToken.
+ * @return Length of the token in characters, counting from the \p offset.
+ *
+ * This is the same as the other lexerGetToken(), except it doesn't require the query to be cut
+ * to the beginning of the token. It lets the Lexer to walk through the single, original query string
+ * without copying the rest of the query after every token. The \p token value is not filled by this method.
+ */
+int lexerGetToken(const QString& z, int offset, Token* token, int sqliteVersion, bool tolerant = false);
+
 #endif // LEXER_LOW_LEV_H
@@ -1,29 +1,5 @@
 #include "dbpluginsqlite3.h"
 #include "db/dbsqlite3.h"
-#include "common/unused.h"
-#include <QFileInfo>
-
-Db* DbPluginSqlite3::getInstance(const QString& name, const QString& path, const QHash<QString, QVariant>& options, QString* errorMessage)
-{
-    UNUSED(errorMessage);
-    Db* db = new DbSqlite3(name, path, options);
-
-    if (!db->openForProbing())
-    {
-        delete db;
-        return nullptr;
-    }
-
-    SqlQueryPtr results = db->exec("SELECT * FROM sqlite_master");
-    if (results->isError())
-    {
-        delete db;
-        return nullptr;
-    }
-
-    db->closeQuiet();
-    return db;
-}
 
 QString DbPluginSqlite3::getLabel() const
 {
@@ -35,13 +11,28 @@ QList<DbPluginOption> DbPluginSqlite3::getOptionsList() const
     return QList<DbPluginOption>();
 }
 
-QString DbPluginSqlite3::generateDbName(const QVariant& baseValue)
+bool DbPluginSqlite3::checkIfDbServedByPlugin(Db* db) const
 {
-    QFileInfo file(baseValue.toString());
-    return file.completeBaseName();
+    return (db && dynamic_cast<DbSqlite3*>(db));
 }
 
-bool DbPluginSqlite3::checkIfDbServedByPlugin(Db* db) const
+Db* DbPluginSqlite3::newInstance(const QString& name, const QString& path, const QHash<QString, QVariant>& options)
 {
-    return (db && dynamic_cast<DbSqlite3*>(db));
+    return new DbSqlite3(name, path, options);
+}
+
+DbPluginStdFileBase::FormatSupport DbPluginSqlite3::getFormatSupport(DbPluginStdFileBase::FileFormat format) const
+{
+    switch (format)
+    {
+        case FileFormat::SQLITE3:
+            return FormatSupport::YES;
+        case FileFormat::SQLITE2:
+        case FileFormat::OTHER:
+            return FormatSupport::NO;
+        case FileFormat::UNKNOWN:
+        case FileFormat::EMPTY:
+            break;
+    }
+    return FormatSupport::PROBE;
 }
@@ -1,10 +1,10 @@
 #ifndef DBPLUGINSQLITE3_H
 #define DBPLUGINSQLITE3_H
 
-#include "dbplugin.h"
+#include "dbpluginstdfilebase.h"
 #include "builtinplugin.h"
 
-class DbPluginSqlite3 : public BuiltInPlugin, public DbPlugin
+class DbPluginSqlite3 : public BuiltInPlugin, public DbPluginStdFileBase
 {
     Q_OBJECT
 
@@ -14,11 +14,13 @@ class DbPluginSqlite3 : public BuiltInPlugin, public DbPlugin
     SQLITESTUDIO_PLUGIN_AUTHOR("sqlitestudio.pl")
 
     public:
-        Db* getInstance(const QString& name, const QString& path, const QHash<QString, QVariant>& options, QString* errorMessage);
         QString getLabel() const;
         QList<DbPluginOption> getOptionsList() const;
-        QString generateDbName(const QVariant& baseValue);
         bool checkIfDbServedByPlugin(Db* db) const;
+
+    protected:
+        Db* newInstance(const QString& name, const QString& path, const QHash<QString, QVariant>& options);
+        FormatSupport getFormatSupport(FileFormat format) const;
 };
 
 #endif // DBPLUGINSQLITE3_H
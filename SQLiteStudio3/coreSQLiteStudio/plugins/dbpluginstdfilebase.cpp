@@ -2,6 +2,8 @@
 #include "common/unused.h"
 #include "db/sqlquery.h"
 #include <QFileInfo>
+#include <QFile>
+#include <QMutexLocker>
 
 Db *DbPluginStdFileBase::getInstance(const QString &name, const QString &path, const QHash<QString, QVariant> &options, QString *errorMessage)
 {
@@ -9,20 +11,61 @@ Db *DbPluginStdFileBase::getInstance(const QString &name, const QString &path, c
 
     Db* db = newInstance(name, path, options);
 
-    if (!db->openForProbing())
+    QFileInfo file(path);
+    if (!file.exists() || file.isDir())
     {
-        delete db;
-        return nullptr;
+        // Not a local file, the header can't be checked
+        if (!probe(db))
+        {
+            delete db;
+            return nullptr;
+        }
+        return db;
     }
 
-    SqlQueryPtr results = db->exec("SELECT * FROM sqlite_master");
-    if (results->isError())
+    QString cacheKey = getProbeCacheKey(file.absoluteFilePath(), options);
+    QDateTime modified = file.lastModified();
+    qint64 size = file.size();
+    {
+        QMutexLocker locker(&probeCacheMutex);
+        if (probeCache.contains(cacheKey))
+        {
+            const ProbeResult& cached = probeCache[cacheKey];
+            if (cached.modified == modified && cached.size == size)
+            {
+                if (cached.accepted)
+                    return db;
+
+                delete db;
+                return nullptr;
+            }
+        }
+    }
+
+    bool accepted = false;
+    switch (getFormatSupport(detectFileFormat(path)))
+    {
+        case FormatSupport::YES:
+            accepted = true;
+            break;
+        case FormatSupport::NO:
+            accepted = false;
+            break;
+        case FormatSupport::PROBE:
+            accepted = probe(db);
+            break;
+    }
+
+    {
+        QMutexLocker locker(&probeCacheMutex);
+        probeCache[cacheKey] = ProbeResult{modified, size, accepted};
+    }
+
+    if (!accepted)
     {
         delete db;
         return nullptr;
     }
-
-    db->closeQuiet();
     return db;
 }
 
@@ -31,3 +74,58 @@ QString DbPluginStdFileBase::generateDbName(const QVariant &baseValue)
     QFileInfo file(baseValue.toString());
     return file.completeBaseName();
 }
+
+DbPluginStdFileBase::FormatSupport DbPluginStdFileBase::getFormatSupport(DbPluginStdFileBase::FileFormat format) const
+{
+    UNUSED(format);
+    return FormatSupport::PROBE;
+}
+
+bool DbPluginStdFileBase::probe(Db* db)
+{
+    if (!db->openForProbing())
+        return false;
+
+    SqlQueryPtr results = db->exec("SELECT * FROM sqlite_master");
+    if (results->isError())
+        return false;
+
+    db->closeQuiet();
+    return true;
+}
+
+DbPluginStdFileBase::FileFormat DbPluginStdFileBase::detectFileFormat(const QString& path)
+{
+    static const QByteArray sqlite3Header = QByteArray("SQLite format 3", 16); // including terminating null
+    static const QByteArray sqlite2Header = QByteArrayLiteral("** This file contains an SQLite 2.1 database **");
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return FileFormat::UNKNOWN;
+
+    QByteArray header = file.read(HEADER_SIZE);
+    file.close();
+
+    if (header.isEmpty())
+        return FileFormat::EMPTY;
+
+    if (header.startsWith(sqlite3Header))
+        return FileFormat::SQLITE3;
+
+    if (header.startsWith(sqlite2Header))
+        return FileFormat::SQLITE2;
+
+    return FileFormat::OTHER;
+}
+
+QString DbPluginStdFileBase::getProbeCacheKey(const QString& path, const QHash<QString, QVariant>& options)
+{
+    QStringList keys = options.keys();
+    keys.sort();
+
+    QStringList parts = {path};
+    for (const QString& key : keys)
+        parts << key + "=" + options[key].toString();
+
+    return parts.join(QChar('\n'));
+}
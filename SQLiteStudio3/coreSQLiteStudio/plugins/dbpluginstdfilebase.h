@@ -2,7 +2,18 @@
 #define DBPLUGINSTDFILEBASE_H
 
 #include "dbplugin.h"
+#include <QDateTime>
+#include <QMutex>
 
+/**
+ * @brief Base for plugins of databases stored in a single local file.
+ *
+ * Decides whether the file is handled by the plugin by looking at the file header first (see getFormatSupport()),
+ * and opens the database only when the header is not conclusive. Decisions are cached per file path and connection
+ * options, until the file is modified.
+ *
+ * This class is thread-safe, so databases can be probed from multiple threads at once.
+ */
 class API_EXPORT DbPluginStdFileBase : public DbPlugin
 {
     public:
@@ -10,7 +21,56 @@ class API_EXPORT DbPluginStdFileBase : public DbPlugin
         QString generateDbName(const QVariant &baseValue);
 
     protected:
+        /**
+         * @brief Format of the database file, as recognized by its header.
+         */
+        enum class FileFormat
+        {
+            UNKNOWN, /**< File could not be read. */
+            EMPTY,   /**< File has no contents, so any SQLite version can use it. */
+            SQLITE3, /**< File starts with the SQLite 3 header. */
+            SQLITE2, /**< File starts with the SQLite 2 header. */
+            OTHER    /**< File has some other contents, for example it's encrypted. */
+        };
+
+        /**
+         * @brief Decision made upon the file format.
+         */
+        enum class FormatSupport
+        {
+            YES,  /**< File is handled by the plugin, no need to open it. */
+            NO,   /**< File is not handled by the plugin, no need to open it. */
+            PROBE /**< File has to be opened to find out. */
+        };
+
         virtual Db *newInstance(const QString &name, const QString &path, const QHash<QString, QVariant> &options) = 0;
+
+        /**
+         * @brief Tells if the plugin handles files of given format.
+         * @param format Format detected from the file header.
+         * @return Decision for the format.
+         *
+         * Default implementation always returns FormatSupport::PROBE.
+         */
+        virtual FormatSupport getFormatSupport(FileFormat format) const;
+
+    private:
+        struct ProbeResult
+        {
+            QDateTime modified;
+            qint64 size;
+            bool accepted;
+        };
+
+        bool probe(Db* db);
+
+        static FileFormat detectFileFormat(const QString& path);
+        static QString getProbeCacheKey(const QString& path, const QHash<QString, QVariant>& options);
+
+        QHash<QString, ProbeResult> probeCache;
+        QMutex probeCacheMutex;
+
+        static const int HEADER_SIZE = 100;
 };
 
 #endif // DBPLUGINSTDFILEBASE_H
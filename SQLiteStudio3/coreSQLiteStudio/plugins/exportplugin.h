@@ -361,6 +361,15 @@ class ExportPlugin : virtual public Plugin
          */
         virtual bool afterExport() = 0;
 
+        /**
+         * @brief Writes all remaining output to the output device.
+         * @return true for success, or false if writing to the output device failed.
+         *
+         * Called after every export (even failed one), before cleanupAfterExport(). After this call the output device
+         * can be closed. Plugins that buffer their output must write it all to the device here.
+         */
+        virtual bool flushOutput() = 0;
+
         /**
          * @brief Called after every export, even failed one.
          *
@@ -3,7 +3,9 @@
 #include "services/notifymanager.h"
 #include "common/unused.h"
 #include "config_builder.h"
+#include "common/textoutputbuffer.h"
 #include <QTextCodec>
+#include <QFile>
 
 bool GenericExportPlugin::initBeforeExport(Db* db, QIODevice* output, const ExportManager::StandardExportConfig& config)
 {
@@ -21,6 +23,13 @@ bool GenericExportPlugin::initBeforeExport(Db* db, QIODevice* output, const Expo
         }
     }
 
+    safe_delete(outputBuffer);
+    outputBuffer = new TextOutputBuffer(output, codec);
+
+    // Writing to a file may take a while, so it's done in parallel with preparing next portions of the output
+    if (qobject_cast<QFile*>(output))
+        outputBuffer->setBackgroundWriting(true);
+
     return beforeExport();
 }
 
@@ -87,12 +96,13 @@ bool GenericExportPlugin::initBeforeExport()
 
 void GenericExportPlugin::write(const QString& str)
 {
-    output->write(codec->fromUnicode(str));
+    outputBuffer->write(str);
 }
 
 void GenericExportPlugin::writeln(const QString& str)
 {
-    write(str + "\n");
+    outputBuffer->write(str);
+    outputBuffer->write(QChar('\n'));
 }
 
 bool GenericExportPlugin::isTableExport() const
@@ -150,6 +160,19 @@ bool GenericExportPlugin::afterExport()
     return true;
 }
 
+bool GenericExportPlugin::flushOutput()
+{
+    if (!outputBuffer)
+        return true;
+
+    bool result = outputBuffer->flush();
+    if (!result)
+        notifyError(tr("Could not write the export output: %1").arg(outputBuffer->getErrorText()));
+
+    safe_delete(outputBuffer);
+    return result;
+}
+
 void GenericExportPlugin::cleanupAfterExport()
 {
 }
@@ -4,6 +4,8 @@
 #include "exportplugin.h"
 #include "genericplugin.h"
 
+class TextOutputBuffer;
+
 class API_EXPORT GenericExportPlugin : virtual public GenericPlugin, public ExportPlugin
 {
         Q_OBJECT
@@ -31,6 +33,7 @@ class API_EXPORT GenericExportPlugin : virtual public GenericPlugin, public Expo
         bool afterExportViews();
         bool afterExportDatabase();
         bool afterExport();
+        bool flushOutput();
         void cleanupAfterExport();
 
         /**
@@ -53,6 +56,14 @@ class API_EXPORT GenericExportPlugin : virtual public GenericPlugin, public Expo
         const ExportManager::StandardExportConfig* config = nullptr;
         QTextCodec* codec = nullptr;
         ExportManager::ExportMode exportMode = ExportManager::UNDEFINED;
+
+    private:
+        /**
+         * @brief Buffer for the text written with write() and writeln().
+         *
+         * It's created for each export in initBeforeExport() and it's written to the output in flushOutput().
+         */
+        TextOutputBuffer* outputBuffer = nullptr;
 };
 
 #endif // GENERICEXPORTPLUGIN_H
@@ -5,6 +5,7 @@
 #include <QScriptEngine>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QThread>
 #include <QDebug>
 
 static QScriptValue scriptingQtDebug(QScriptContext *context, QScriptEngine *engine)
@@ -20,12 +21,12 @@ static QScriptValue scriptingQtDebug(QScriptContext *context, QScriptEngine *eng
 
 ScriptingQt::ScriptingQt()
 {
-    mainEngineMutex = new QMutex();
+    contextsMutex = new QMutex();
 }
 
 ScriptingQt::~ScriptingQt()
 {
-    safe_delete(mainEngineMutex);
+    safe_delete(contextsMutex);
 }
 
 QString ScriptingQt::getLanguage() const
@@ -37,6 +38,8 @@ ScriptingPlugin::Context* ScriptingQt::createContext()
 {
     ContextQt* ctx = new ContextQt;
     ctx->engine->pushContext();
+
+    QMutexLocker locker(contextsMutex);
     contexts << ctx;
     return ctx;
 }
@@ -47,6 +50,7 @@ void ScriptingQt::releaseContext(ScriptingPlugin::Context* context)
     if (!ctx)
         return;
 
+    QMutexLocker locker(contextsMutex);
     contexts.removeOne(ctx);
     delete ctx;
 }
@@ -59,24 +63,27 @@ void ScriptingQt::resetContext(ScriptingPlugin::Context* context)
 
     ctx->engine->popContext();
     ctx->engine->pushContext();
+
+    // Compiled functions keep the scope they were created in, which is the context that was just dropped
+    ctx->scriptCache.clear();
 }
 
 QVariant ScriptingQt::evaluate(const QString& code, const QList<QVariant>& args, Db* db, bool locking, QString* errorMessage)
 {
-    QMutexLocker locker(mainEngineMutex);
+    ContextQt* threadContext = getThreadContext();
 
     // Enter a new context
-    QScriptContext* engineContext = mainContext->engine->pushContext();
+    QScriptContext* engineContext = threadContext->engine->pushContext();
 
     // Call the function
-    QVariant result = evaluate(mainContext, engineContext, code, args, db, locking);
+    QVariant result = evaluate(threadContext, engineContext, code, args, db, locking);
 
     // Handle errors
-    if (!mainContext->error.isEmpty())
-        *errorMessage = mainContext->error;
+    if (!threadContext->error.isEmpty() && errorMessage)
+        *errorMessage = threadContext->error;
 
     // Leave the context to reset "this".
-    mainContext->engine->popContext();
+    threadContext->engine->popContext();
 
     return result;
 }
@@ -214,20 +221,24 @@ QString ScriptingQt::getIconPath() const
 
 bool ScriptingQt::init()
 {
-    QMutexLocker locker(mainEngineMutex);
-    mainContext = new ContextQt;
     return true;
 }
 
 void ScriptingQt::deinit()
 {
+    QMutexLocker locker(contextsMutex);
     foreach (Context* ctx, contexts)
         delete ctx;
 
     contexts.clear();
 
-    QMutexLocker locker(mainEngineMutex);
-    safe_delete(mainContext);
+    for (QThread* thread : threadContexts.keys())
+        disconnect(thread, SIGNAL(finished()), this, nullptr);
+
+    for (ContextQt* ctx : threadContexts.values())
+        delete ctx;
+
+    threadContexts.clear();
 }
 
 ScriptingQt::ContextQt* ScriptingQt::getContext(ScriptingPlugin::Context* context) const
@@ -239,21 +250,50 @@ ScriptingQt::ContextQt* ScriptingQt::getContext(ScriptingPlugin::Context* contex
     return ctx;
 }
 
+ScriptingQt::ContextQt* ScriptingQt::getThreadContext()
+{
+    QThread* thread = QThread::currentThread();
+
+    QMutexLocker locker(contextsMutex);
+    ContextQt* ctx = threadContexts.value(thread);
+    if (ctx)
+        return ctx;
+
+    ctx = new ContextQt;
+    threadContexts[thread] = ctx;
+
+    // Direct connection, so the engine is deleted by the same thread that created it, before the thread ends.
+    connect(thread, &QThread::finished, this, [this, thread]()
+    {
+        releaseThreadContext(thread);
+    }, Qt::DirectConnection);
+
+    return ctx;
+}
+
+void ScriptingQt::releaseThreadContext(QThread* thread)
+{
+    QMutexLocker locker(contextsMutex);
+    ContextQt* ctx = threadContexts.take(thread);
+    if (ctx)
+        delete ctx;
+}
+
 QScriptValue ScriptingQt::getFunctionValue(ContextQt* ctx, const QString& code)
 {
     static const QString fnDef = QStringLiteral("(function () {%1\n})");
 
-    QScriptProgram* prog = nullptr;
-    if (!ctx->scriptCache.contains(code))
-    {
-        prog = new QScriptProgram(fnDef.arg(code));
-        ctx->scriptCache.insert(code, prog);
-    }
-    else
-    {
-        prog = ctx->scriptCache[code];
-    }
-    return ctx->engine->evaluate(*prog);
+    QScriptValue* cachedFunction = ctx->scriptCache.object(code);
+    if (cachedFunction)
+        return *cachedFunction;
+
+    QScriptValue functionValue = ctx->engine->evaluate(fnDef.arg(code));
+
+    // Code with errors is not cached, so the error is reported again with the next call
+    if (functionValue.isFunction())
+        ctx->scriptCache.insert(code, new QScriptValue(functionValue));
+
+    return functionValue;
 }
 
 ScriptingQt::ContextQt::ContextQt()
@@ -271,6 +311,7 @@ ScriptingQt::ContextQt::ContextQt()
 
 ScriptingQt::ContextQt::~ContextQt()
 {
+    scriptCache.clear();
     safe_delete(engine);
     safe_delete(dbProxy);
 }
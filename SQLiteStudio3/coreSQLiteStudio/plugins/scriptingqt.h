@@ -7,10 +7,10 @@
 #include <QVariant>
 #include <QCache>
 #include <QScriptValue>
-#include <QScriptProgram>
 
 class QScriptEngine;
 class QMutex;
+class QThread;
 class QScriptContext;
 class ScriptingQtDbProxy;
 
@@ -51,22 +51,38 @@ class ScriptingQt : public BuiltInPlugin, public DbAwareScriptingPlugin
                 ~ContextQt();
 
                 QScriptEngine* engine = nullptr;
-                QCache<QString,QScriptProgram> scriptCache;
+
+                /**
+                 * @brief Compiled function objects, keyed by their code.
+                 *
+                 * Function object can be called many times (i.e. once per row), so code is compiled
+                 * only when it's not in this cache yet.
+                 */
+                QCache<QString,QScriptValue> scriptCache;
                 QString error;
                 ScriptingQtDbProxy* dbProxy = nullptr;
                 QScriptValue dbProxyScriptValue;
         };
 
         ContextQt* getContext(ScriptingPlugin::Context* context) const;
+        ContextQt* getThreadContext();
+        void releaseThreadContext(QThread* thread);
         QScriptValue getFunctionValue(ContextQt* ctx, const QString& code);
         QVariant evaluate(ContextQt* ctx, QScriptContext* engineContext, const QString& code, const QList<QVariant>& args, Db* db, bool locking);
         QVariant convertVariant(const QVariant& value, bool wrapStrings = false);
 
-        static const constexpr int cacheSize = 5;
+        static const constexpr int cacheSize = 50;
 
-        ContextQt* mainContext = nullptr;
+        /**
+         * @brief Contexts used by evaluations that don't provide their own context.
+         *
+         * QScriptEngine can be used only by one thread at the time, so each thread gets its own engine.
+         * This way SQL functions evaluated by different connections, or by workers (export, import, populate)
+         * don't need to wait for each other. Context is deleted when its thread finishes.
+         */
+        QHash<QThread*,ContextQt*> threadContexts;
         QList<Context*> contexts;
-        QMutex* mainEngineMutex = nullptr;
+        QMutex* contextsMutex = nullptr;
 };
 
 #endif // SCRIPTINGQT_H
@@ -2,8 +2,10 @@
 #include "common/utils_sql.h"
 #include "db/db.h"
 #include "db/sqlquery.h"
+#include "db/bulkinserter.h"
 #include "plugins/populateplugin.h"
 #include "services/notifymanager.h"
+#include <QElapsedTimer>
 
 PopulateWorker::PopulateWorker(Db* db, const QString& table, const QStringList& columns, const QList<PopulateEngine*>& engines, qint64 rows, QObject* parent) :
     QObject(parent), db(db), table(table), columns(columns), engines(engines), rows(rows)
@@ -16,8 +18,6 @@ PopulateWorker::~PopulateWorker()
 
 void PopulateWorker::run()
 {
-    static const QString insertSql = QStringLiteral("INSERT INTO %1 (%2) VALUES (%3);");
-
     if (!db->begin())
     {
         notifyError(tr("Could not start transaction in order to perform table populating. Error details: %1").arg(db->getErrorText()));
@@ -25,19 +25,17 @@ void PopulateWorker::run()
         return;
     }
 
-    Dialect dialect = db->getDialect();
-    QString wrappedTable = wrapObjIfNeeded(table, dialect);
-
-    QStringList cols;
-    QStringList argList;
-    for (const QString& column : columns)
+    BulkInserter inserter(db, table, columns);
+    if (!inserter.begin())
     {
-        cols << wrapObjIfNeeded(column, dialect);
-        argList << "?";
+        notifyError(tr("Error while populating table: %1").arg(inserter.getErrorText()));
+        db->rollback();
+        emit finished(false);
+        return;
     }
 
-    QString finalSql = insertSql.arg(wrappedTable, cols.join(", "), argList.join(", "));
-    SqlQueryPtr query = db->prepare(finalSql);
+    QElapsedTimer progressTimer;
+    progressTimer.start();
 
     QList<QVariant> args;
     bool nextValueError = false;
@@ -57,18 +55,32 @@ void PopulateWorker::run()
         for (PopulateEngine* engine : engines)
             args << engine->nextValue(nextValueError);
 
-        query->setArgs(args);
-        if (!query->execute())
+        if (!inserter.insert(args))
         {
-            notifyError(tr("Error while populating table: %1").arg(query->getErrorText()));
+            notifyError(tr("Error while populating table: %1").arg(inserter.getErrorText()));
             db->rollback();
             emit finished(false);
             return;
         }
 
-        emit finishedStep(i + 1);
+        // Progress is reported to the UI thread in intervals, not for every single row
+        if (progressTimer.elapsed() >= PROGRESS_INTERVAL)
+        {
+            emit finishedStep(i + 1);
+            progressTimer.restart();
+        }
+    }
+
+    if (!inserter.finish())
+    {
+        notifyError(tr("Error while populating table: %1").arg(inserter.getErrorText()));
+        db->rollback();
+        emit finished(false);
+        return;
     }
 
+    emit finishedStep(rows);
+
     if (!db->commit())
     {
         notifyError(tr("Could not commit transaction after table populating. Error details: %1").arg(db->getErrorText()));
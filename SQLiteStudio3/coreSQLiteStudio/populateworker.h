@@ -31,6 +31,11 @@ class PopulateWorker : public QObject, public QRunnable
         bool interrupted = false;
         QMutex interruptMutex;
 
+        /**
+         * @brief Minimal period (in milliseconds) between consecutive finishedStep() signals.
+         */
+        static const int PROGRESS_INTERVAL = 100;
+
     public slots:
         void interrupt();
 
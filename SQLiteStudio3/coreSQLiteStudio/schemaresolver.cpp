@@ -9,13 +9,22 @@
 #include "parser/ast/sqlitecreatevirtualtable.h"
 #include "parser/ast/sqlitetablerelatedddl.h"
 #include <QDebug>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <algorithm>
 
 const char* sqliteMasterDdl =
     "CREATE TABLE sqlite_master (type text, name text, tbl_name text, rootpage integer, sql text)";
 const char* sqliteTempMasterDdl =
     "CREATE TABLE sqlite_temp_master (type text, name text, tbl_name text, rootpage integer, sql text)";
 
-ExpiringCache<SchemaResolver::ObjectCacheKey,QVariant> SchemaResolver::cache;
+QCache<SchemaResolver::ObjectCacheKey,SchemaResolver::CacheEntry> SchemaResolver::cache(SchemaResolver::CACHE_SIZE);
+QHash<QPair<Db*,QString>,SchemaResolver::SchemaVersion> SchemaResolver::schemaVersions;
+QHash<Db*,quint64> SchemaResolver::cacheGenerations;
+SchemaResolver::CacheStatistics SchemaResolver::cacheStatistics;
+QMutex SchemaResolver::cacheMutex;
+QHash<QPair<Db*,QString>,SchemaResolver::DependencyGraphPtr> SchemaResolver::dependencyGraphs;
+QMutex SchemaResolver::dependencyGraphMutex;
 
 SchemaResolver::SchemaResolver(Db *db)
     : db(db)
@@ -300,8 +309,14 @@ QString SchemaResolver::getObjectDdl(const QString &database, const QString &nam
     QString typeStr = objectTypeToString(type);
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_DDL, db, dbName, lowerName, typeStr);
-    if (useCache && cache.contains(key))
-        return cache.object(key, true)->toString();
+    CacheStamp stamp;
+    QVariant cachedValue;
+    if (useCache)
+    {
+        stamp = getCacheStamp(dbName);
+        if (getCachedValue(key, stamp, cachedValue))
+            return cachedValue.toString();
+    }
 
     // Get the DDL
     QString resStr = getObjectDdlWithSimpleName(dbName, lowerName, targetTable, type);
@@ -313,7 +328,7 @@ QString SchemaResolver::getObjectDdl(const QString &database, const QString &nam
         resStr += ";";
 
     if (useCache)
-        cache.insert(key, new QVariant(resStr));
+        putCachedValue(key, stamp, resStr);
 
     // Return the DDL
     return resStr;
@@ -552,6 +567,25 @@ StrHash< SqliteCreateViewPtr> SchemaResolver::getAllParsedViews(const QString& d
 
 SqliteQueryPtr SchemaResolver::getParsedDdl(const QString& ddl)
 {
+    // Parsed DDL depends only on its text and the dialect, so it never gets stale.
+    // Callers are free to modify returned object (including values of its tokens, like TableModifier does),
+    // therefore they get a deep copy of the cached one.
+    bool useCache = usesCache();
+    ObjectCacheKey key(ObjectCacheKey::PARSED_DDL, nullptr, ddl, QString::number(static_cast<int>(db->getDialect())));
+    if (useCache)
+    {
+        QMutexLocker locker(&cacheMutex);
+        CacheEntry* entry = cache.object(key);
+        if (entry)
+        {
+            cacheStatistics.hits++;
+            SqliteQueryPtr parsedQuery(dynamic_cast<SqliteQuery*>(entry->parsedQuery->clone()));
+            parsedQuery->detachTokens();
+            return parsedQuery;
+        }
+        cacheStatistics.misses++;
+    }
+
     if (!parser->parse(ddl))
     {
         qDebug() << "Could not parse DDL for parsing object by SchemaResolver. Errors are:";
@@ -569,6 +603,16 @@ SqliteQueryPtr SchemaResolver::getParsedDdl(const QString& ddl)
         return SqliteQueryPtr();
     }
 
+    if (useCache)
+    {
+        CacheEntry* entry = new CacheEntry();
+        entry->parsedQuery = SqliteQueryPtr(dynamic_cast<SqliteQuery*>(queries[0]->clone()));
+        entry->parsedQuery->detachTokens();
+
+        QMutexLocker locker(&cacheMutex);
+        cache.insert(key, entry);
+    }
+
     // Preparing results
     return queries[0];
 }
@@ -580,27 +624,38 @@ QStringList SchemaResolver::getObjects(const QString &type)
 
 QStringList SchemaResolver::getObjects(const QString &database, const QString &type)
 {
+    QStringList resList;
+    QString dbName = getPrefixDb(database, db->getDialect());
+
+    // Cached list is not filtered, because filtering depends on this resolver's settings
+    QStringList allNames;
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_NAMES, db, database, type);
-    if (useCache && cache.contains(key))
-        return cache.object(key, true)->toStringList();
+    CacheStamp stamp;
+    QVariant cachedValue;
+    if (useCache)
+        stamp = getCacheStamp(dbName);
 
-    QStringList resList;
-    QString dbName = getPrefixDb(database, db->getDialect());
+    if (useCache && getCachedValue(key, stamp, cachedValue))
+    {
+        allNames = cachedValue.toStringList();
+    }
+    else
+    {
+        SqlQueryPtr results = db->exec(QString("SELECT name FROM %1.sqlite_master WHERE type = ?;").arg(dbName), {type}, dbFlags);
+        for (SqlResultsRowPtr row : results->getAll())
+            allNames << row->value(0).toString();
 
-    SqlQueryPtr results = db->exec(QString("SELECT name FROM %1.sqlite_master WHERE type = ?;").arg(dbName), {type}, dbFlags);
+        if (useCache && !results->isError())
+            putCachedValue(key, stamp, allNames);
+    }
 
-    QString value;
-    foreach (SqlResultsRowPtr row, results->getAll())
+    for (const QString& value : allNames)
     {
-        value = row->value(0).toString();
         if (!isFilteredOut(value, type))
             resList << value;
     }
 
-    if (useCache)
-        cache.insert(key, new QVariant(resList));
-
     return resList;
 }
 
@@ -611,28 +666,37 @@ QStringList SchemaResolver::getAllObjects()
 
 QStringList SchemaResolver::getAllObjects(const QString& database)
 {
-    bool useCache = usesCache();
-    ObjectCacheKey key(ObjectCacheKey::OBJECT_NAMES, db, database);
-    if (useCache && cache.contains(key))
-        return cache.object(key, true)->toStringList();
-
     QStringList resList;
     QString dbName = getPrefixDb(database, db->getDialect());
 
-    SqlQueryPtr results = db->exec(QString("SELECT name, type FROM %1.sqlite_master;").arg(dbName), dbFlags);
+    // Names and types are cached as interleaved pairs, because filtering depends on this resolver's settings
+    QStringList namesAndTypes;
+    bool useCache = usesCache();
+    ObjectCacheKey key(ObjectCacheKey::OBJECT_NAMES, db, database);
+    CacheStamp stamp;
+    QVariant cachedValue;
+    if (useCache)
+        stamp = getCacheStamp(dbName);
 
-    QString value;
-    QString type;
-    foreach (SqlResultsRowPtr row, results->getAll())
+    if (useCache && getCachedValue(key, stamp, cachedValue))
     {
-        value = row->value("name").toString();
-        type = row->value("type").toString();
-        if (!isFilteredOut(value, type))
-            resList << value;
+        namesAndTypes = cachedValue.toStringList();
     }
+    else
+    {
+        SqlQueryPtr results = db->exec(QString("SELECT name, type FROM %1.sqlite_master;").arg(dbName), dbFlags);
+        for (SqlResultsRowPtr row : results->getAll())
+            namesAndTypes << row->value("name").toString() << row->value("type").toString();
 
-    if (useCache)
-        cache.insert(key, new QVariant(resList));
+        if (useCache && !results->isError())
+            putCachedValue(key, stamp, namesAndTypes);
+    }
+
+    for (int i = 0, total = namesAndTypes.size() - 1; i < total; i += 2)
+    {
+        if (!isFilteredOut(namesAndTypes[i], namesAndTypes[i + 1]))
+            resList << namesAndTypes[i];
+    }
 
     return resList;
 }
@@ -665,14 +729,16 @@ QStringList SchemaResolver::getFkReferencingTables(const QString& database, cons
     if (dialect == Dialect::Sqlite2)
         return QStringList();
 
-    // Get all tables
-    StrHash<SqliteCreateTablePtr> parsedTables = getAllParsedTables(database);
-
-    // Exclude queried table from the list
-    parsedTables.remove(table);
+    QStringList tables;
+    for (const GraphObject& object : getDependentObjects(database, table, Dependency::FK_REFERENCES))
+    {
+        // Queried table is not the referencing table, even if it references itself
+        if (object.name.compare(table, Qt::CaseInsensitive) == 0 || isFilteredOut(object.name, "table"))
+            continue;
 
-    // Resolve referencing tables
-    return getFkReferencingTables(table, parsedTables.values());
+        tables << object.name;
+    }
+    return tables;
 }
 
 QStringList SchemaResolver::getFkReferencingTables(const QString& table, const QList<SqliteCreateTablePtr>& allParsedTables)
@@ -720,9 +786,13 @@ QStringList SchemaResolver::getFkReferencingTables(const QString& table, const Q
 QStringList SchemaResolver::getIndexesForTable(const QString& database, const QString& table)
 {
     QStringList names;
-    foreach (SqliteCreateIndexPtr idx, getParsedIndexesForTable(database, table))
-        names << idx->index;
+    for (const GraphObject& object : getDependentObjects(database, table, Dependency::INDEXES))
+    {
+        if (object.name.startsWith("sqlite_", Qt::CaseInsensitive) || isFilteredOut(object.name, "index"))
+            continue;
 
+        names << object.name;
+    }
     return names;
 }
 
@@ -733,11 +803,7 @@ QStringList SchemaResolver::getIndexesForTable(const QString& table)
 
 QStringList SchemaResolver::getTriggersForTable(const QString& database, const QString& table)
 {
-    QStringList names;
-    foreach (SqliteCreateTriggerPtr trig, getParsedTriggersForTable(database, table))
-        names << trig->trigger;
-
-    return names;
+    return getTriggerNamesForTableOrView(database, table, false, true);
 }
 
 QStringList SchemaResolver::getTriggersForTable(const QString& table)
@@ -747,11 +813,7 @@ QStringList SchemaResolver::getTriggersForTable(const QString& table)
 
 QStringList SchemaResolver::getTriggersForView(const QString& database, const QString& view)
 {
-    QStringList names;
-    foreach (SqliteCreateTriggerPtr trig, getParsedTriggersForView(database, view))
-        names << trig->trigger;
-
-    return names;
+    return getTriggerNamesForTableOrView(database, view, false, false);
 }
 
 QStringList SchemaResolver::getTriggersForView(const QString& view)
@@ -762,8 +824,8 @@ QStringList SchemaResolver::getTriggersForView(const QString& view)
 QStringList SchemaResolver::getViewsForTable(const QString& database, const QString& table)
 {
     QStringList names;
-    foreach (SqliteCreateViewPtr view, getParsedViewsForTable(database, table))
-        names << view->view;
+    for (const GraphObject& object : getDependentObjects(database, table, Dependency::VIEWS))
+        names << object.name;
 
     return names;
 }
@@ -785,15 +847,21 @@ StrHash<SchemaResolver::ObjectDetails> SchemaResolver::getAllObjectDetails(const
     QString type;
 
     QList<QVariant> rows;
+    QString dbName = getPrefixDb(database, db->getDialect());
     bool useCache = usesCache();
     ObjectCacheKey key(ObjectCacheKey::OBJECT_DETAILS, db, database);
-    if (useCache && cache.contains(key))
+    CacheStamp stamp;
+    QVariant cachedValue;
+    if (useCache)
+        stamp = getCacheStamp(dbName);
+
+    if (useCache && getCachedValue(key, stamp, cachedValue))
     {
-        rows = cache.object(key, true)->toList();
+        rows = cachedValue.toList();
     }
     else
     {
-        SqlQueryPtr results = db->exec(QString("SELECT name, type, sql FROM %1.sqlite_master").arg(getPrefixDb(database, db->getDialect())), dbFlags);
+        SqlQueryPtr results = db->exec(QString("SELECT name, type, sql FROM %1.sqlite_master").arg(dbName), dbFlags);
         if (results->isError())
         {
             qCritical() << "Error while getting all object details in SchemaResolver:" << results->getErrorCode();
@@ -804,7 +872,7 @@ StrHash<SchemaResolver::ObjectDetails> SchemaResolver::getAllObjectDetails(const
             rows << row->valueMap();
 
         if (useCache)
-            cache.insert(key, new QVariant(rows));
+            putCachedValue(key, stamp, rows);
     }
 
     QHash<QString, QVariant> row;
@@ -827,14 +895,11 @@ QList<SqliteCreateIndexPtr> SchemaResolver::getParsedIndexesForTable(const QStri
 {
     QList<SqliteCreateIndexPtr> createIndexList;
 
-    QStringList indexes = getIndexes(database);
+    QStringList indexes = getIndexesForTable(database, table);
     SqliteQueryPtr query;
     SqliteCreateIndexPtr createIndex;
     for (const QString& index : indexes)
     {
-        if (index.startsWith("sqlite_", Qt::CaseInsensitive))
-            continue;
-
         query = getParsedObject(database, index, INDEX);
         if (!query)
             continue;
@@ -846,8 +911,7 @@ QList<SqliteCreateIndexPtr> SchemaResolver::getParsedIndexesForTable(const QStri
             continue;
         }
 
-        if (createIndex->table.compare(table, Qt::CaseInsensitive) == 0)
-            createIndexList << createIndex;
+        createIndexList << createIndex;
     }
     return createIndexList;
 }
@@ -882,7 +946,7 @@ QList<SqliteCreateTriggerPtr> SchemaResolver::getParsedTriggersForTableOrView(co
 {
     QList<SqliteCreateTriggerPtr> createTriggerList;
 
-    QStringList triggers = getTriggers(database);
+    QStringList triggers = getTriggerNamesForTableOrView(database, tableOrView, includeContentReferences, table);
     SqliteQueryPtr query;
     SqliteCreateTriggerPtr createTrigger;
     foreach (const QString& trig, triggers)
@@ -898,20 +962,35 @@ QList<SqliteCreateTriggerPtr> SchemaResolver::getParsedTriggersForTableOrView(co
             continue;
         }
 
+        createTriggerList << createTrigger;
+    }
+    return createTriggerList;
+}
+
+QStringList SchemaResolver::getTriggerNamesForTableOrView(const QString& database, const QString& tableOrView, bool includeContentReferences, bool table)
+{
+    QList<GraphObject> objects = getDependentObjects(database, tableOrView, Dependency::TRIGGERS);
+    if (includeContentReferences)
+    {
+        objects += getDependentObjects(database, tableOrView, Dependency::TRIGGER_REFERENCES);
+        std::stable_sort(objects.begin(), objects.end(), [](const GraphObject& o1, const GraphObject& o2) {return o1.order < o2.order;});
+    }
+
+    QStringList names;
+    for (const GraphObject& object : objects)
+    {
         // The condition below checks:
         // 1. if this is a call for table triggers and event time is INSTEAD_OF - skip this iteration
         // 2. if this is a call for view triggers and event time is _not_ INSTEAD_OF - skip this iteration
         // In other words, it's a logical XOR for "table" flag and "eventTime == INSTEAD_OF" condition.
-        if (table == (createTrigger->eventTime == SqliteCreateTrigger::Time::INSTEAD_OF))
+        if (table == object.insteadOf)
             continue;
 
-        if (createTrigger->table.compare(tableOrView, Qt::CaseInsensitive) == 0)
-            createTriggerList << createTrigger;
-        else if (includeContentReferences && indexOf(createTrigger->getContextTables(), tableOrView, Qt::CaseInsensitive) > -1)
-            createTriggerList << createTrigger;
-
+        // Trigger on the table, that also refers to it in the body, is found by both dependencies
+        if (names.isEmpty() || names.last() != object.name)
+            names << object.name;
     }
-    return createTriggerList;
+    return names;
 }
 
 QString SchemaResolver::objectTypeToString(SchemaResolver::ObjectType type)
@@ -948,19 +1027,473 @@ SchemaResolver::ObjectType SchemaResolver::stringToObjectType(const QString& typ
 
 void SchemaResolver::staticInit()
 {
-    cache.setExpireTime(3000);
+    clearCache();
+}
+
+void SchemaResolver::invalidateCache(Db* db)
+{
+    QMutexLocker locker(&cacheMutex);
+    cacheGenerations[db]++;
+
+    QMutableHashIterator<QPair<Db*,QString>,SchemaVersion> it(schemaVersions);
+    while (it.hasNext())
+    {
+        if (it.next().key().first == db)
+            it.remove();
+    }
+}
+
+void SchemaResolver::dropDependencyGraphs(Db* db)
+{
+    QMutexLocker locker(&dependencyGraphMutex);
+    QMutableHashIterator<QPair<Db*,QString>,DependencyGraphPtr> it(dependencyGraphs);
+    while (it.hasNext())
+    {
+        if (it.next().key().first == db)
+            it.remove();
+    }
+}
+
+void SchemaResolver::clearCache()
+{
+    {
+        QMutexLocker locker(&cacheMutex);
+        cache.clear();
+        schemaVersions.clear();
+    }
+
+    QMutexLocker locker(&dependencyGraphMutex);
+    dependencyGraphs.clear();
+}
+
+SchemaResolver::CacheStatistics SchemaResolver::getCacheStatistics()
+{
+    QMutexLocker locker(&cacheMutex);
+    return cacheStatistics;
+}
+
+void SchemaResolver::resetCacheStatistics()
+{
+    QMutexLocker locker(&cacheMutex);
+    cacheStatistics = CacheStatistics();
+}
+
+QString SchemaResolver::getSchemaState()
+{
+    CacheStamp mainStamp = getCacheStamp("main");
+    qint64 tempVersion = getSchemaVersion("temp");
+    if (mainStamp.schemaVersion == UNKNOWN_SCHEMA_VERSION || tempVersion == UNKNOWN_SCHEMA_VERSION)
+        return QString();
+
+    QStringList state = {QString("%1:%2:%3").arg(mainStamp.generation).arg(mainStamp.schemaVersion).arg(tempVersion)};
+
+    // Attached databases (including ones attached with ATTACH statement, which Db doesn't know about)
+    // can be modified by other connections independently of the main database.
+    SqlQueryPtr results = db->exec("PRAGMA database_list;", dbFlags);
+    if (results->isError())
+        return QString();
+
+    SqlResultsRowPtr row;
+    QString dbName;
+    qint64 version;
+    while (results->hasNext())
+    {
+        row = results->next();
+        dbName = row->value("name").toString();
+        if (dbName.compare("main", Qt::CaseInsensitive) == 0 || dbName.compare("temp", Qt::CaseInsensitive) == 0)
+            continue;
+
+        version = getSchemaVersion(wrapObjIfNeeded(dbName, Dialect::Sqlite3));
+        if (version == UNKNOWN_SCHEMA_VERSION)
+            return QString();
+
+        state << dbName << row->value("file").toString() << QString::number(version);
+    }
+
+    static const QChar sep = QChar(0x1F);
+    return state.join(sep);
+}
+
+bool SchemaResolver::getRowCountEstimate(const QString& database, const QString& table, qint64& count)
+{
+    if (db->getDialect() != Dialect::Sqlite3)
+        return false;
+
+    // The sqlite_stat1 is created by ANALYZE. First number of the "stat" column is the approximate number of rows in the table.
+    static_qstring(statTableTpl, "SELECT count(*) FROM %1.sqlite_master WHERE type = 'table' AND name = 'sqlite_stat1'");
+    static_qstring(statTpl, "SELECT CAST(stat AS INTEGER) FROM %1.sqlite_stat1 WHERE tbl = ? LIMIT 1");
+
+    QString dbName = wrapObjIfNeeded(database.isNull() ? "main" : database, Dialect::Sqlite3);
+
+    SqlQueryPtr results = db->exec(statTableTpl.arg(dbName), dbFlags);
+    if (results->isError() || results->getSingleCell().toInt() == 0)
+        return false;
+
+    results = db->exec(statTpl.arg(dbName), QList<QVariant>({table}), dbFlags);
+    if (results->isError() || results->getSingleCell().isNull())
+        return false;
+
+    count = results->getSingleCell().toLongLong();
+    return true;
 }
 
 bool SchemaResolver::usesCache()
 {
-    return db->getConnectionOptions().contains(USE_SCHEMA_CACHING) && db->getConnectionOptions()[USE_SCHEMA_CACHING].toBool();
+    const QHash<QString,QVariant>& options = db->getConnectionOptions();
+    if (options.contains(USE_SCHEMA_CACHING))
+        return options[USE_SCHEMA_CACHING].toBool();
+
+    return db->getDialect() == Dialect::Sqlite3;
+}
+
+SchemaResolver::CacheStamp SchemaResolver::getCacheStamp(const QString& dbName)
+{
+    // Generation has to be read before the schema version and before the actual data,
+    // so a concurrent invalidation makes the stored entry outdated rather than being lost.
+    CacheStamp stamp;
+    {
+        QMutexLocker locker(&cacheMutex);
+        stamp.generation = cacheGenerations.value(db);
+    }
+    stamp.schemaVersion = getSchemaVersion(dbName);
+    return stamp;
+}
+
+qint64 SchemaResolver::getSchemaVersion(const QString& dbName)
+{
+    if (db->getDialect() != Dialect::Sqlite3)
+        return UNKNOWN_SCHEMA_VERSION;
+
+    QPair<Db*,QString> versionKey(db, dbName.toLower());
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    {
+        QMutexLocker locker(&cacheMutex);
+        if (schemaVersions.contains(versionKey))
+        {
+            const SchemaVersion& schemaVersion = schemaVersions[versionKey];
+            if ((now - schemaVersion.checkTime) < SCHEMA_VERSION_CHECK_INTERVAL)
+                return schemaVersion.version;
+        }
+    }
+
+    SqlQueryPtr results = db->exec(QString("PRAGMA %1.schema_version;").arg(dbName), dbFlags);
+    if (results->isError())
+        return UNKNOWN_SCHEMA_VERSION;
+
+    SchemaVersion schemaVersion;
+    schemaVersion.version = results->getSingleCell().toLongLong();
+    schemaVersion.checkTime = now;
+
+    QMutexLocker locker(&cacheMutex);
+    schemaVersions[versionKey] = schemaVersion;
+    return schemaVersion.version;
+}
+
+bool SchemaResolver::getCachedValue(const ObjectCacheKey& key, const CacheStamp& stamp, QVariant& value)
+{
+    QMutexLocker locker(&cacheMutex);
+    CacheEntry* entry = cache.object(key);
+    if (!entry)
+    {
+        cacheStatistics.misses++;
+        return false;
+    }
+
+    bool stale = entry->stamp.generation != stamp.generation || entry->stamp.schemaVersion != stamp.schemaVersion;
+    if (!stale && stamp.schemaVersion == UNKNOWN_SCHEMA_VERSION)
+        stale = (QDateTime::currentMSecsSinceEpoch() - entry->createTime) > UNVERSIONED_EXPIRE_TIME;
+
+    if (stale)
+    {
+        cache.remove(key);
+        cacheStatistics.staleEntries++;
+        cacheStatistics.misses++;
+        return false;
+    }
+
+    cacheStatistics.hits++;
+    value = entry->value;
+    return true;
+}
+
+void SchemaResolver::putCachedValue(const ObjectCacheKey& key, const CacheStamp& stamp, const QVariant& value)
+{
+    CacheEntry* entry = new CacheEntry();
+    entry->value = value;
+    entry->stamp = stamp;
+    entry->createTime = QDateTime::currentMSecsSinceEpoch();
+
+    QMutexLocker locker(&cacheMutex);
+    cache.insert(key, entry);
+}
+
+QList<SchemaResolver::GraphObject> SchemaResolver::getDependentObjects(const QString& database, const QString& name, Dependency dependency)
+{
+    QString dbName = getPrefixDb(database, db->getDialect());
+    bool useCache = usesCache();
+    CacheStamp stamp;
+    if (useCache)
+        stamp = getCacheStamp(dbName);
+
+    QPair<Db*,QString> graphKey(db, dbName.toLower());
+    dependencyGraphMutex.lock();
+    DependencyGraphPtr graph = dependencyGraphs.value(graphKey);
+    dependencyGraphMutex.unlock();
+
+    // Without the schema version it's not known whether the schema has changed, so the graph is updated every time.
+    // It's still cheap, as only changed objects are parsed.
+    bool upToDate = graph && useCache && graph->built && stamp.schemaVersion != UNKNOWN_SCHEMA_VERSION &&
+            graph->stamp.generation == stamp.generation && graph->stamp.schemaVersion == stamp.schemaVersion;
+
+    if (upToDate)
+        return graph->get(dependency, name);
+
+    // Shared graph may be read by other threads, so the update is made on a copy
+    DependencyGraphPtr newGraph = graph ? DependencyGraphPtr::create(*graph) : DependencyGraphPtr::create();
+    if (!updateDependencyGraph(newGraph.data(), dbName))
+        return QList<GraphObject>();
+
+    newGraph->stamp = stamp;
+
+    // If other thread replaced the graph in the meantime, its graph is kept, as it's not older than this one
+    dependencyGraphMutex.lock();
+    if (dependencyGraphs.value(graphKey) == graph)
+        dependencyGraphs[graphKey] = newGraph;
+
+    dependencyGraphMutex.unlock();
+
+    return newGraph->get(dependency, name);
+}
+
+bool SchemaResolver::updateDependencyGraph(DependencyGraph* graph, const QString& dbName)
+{
+    SqlQueryPtr results = db->exec(QString("SELECT name, type, tbl_name, sql FROM %1.sqlite_master").arg(dbName), dbFlags);
+    if (results->isError())
+    {
+        qCritical() << "Error while reading schema for dependency graph in SchemaResolver:" << results->getErrorText();
+        return false;
+    }
+
+    QSet<QString> currentObjects;
+    QString name;
+    QString lowerName;
+    QString ddl;
+    ObjectType type;
+    int order = 0;
+    SqlResultsRowPtr row;
+    while (results->hasNext())
+    {
+        row = results->next();
+        name = row->value("name").toString();
+        lowerName = name.toLower();
+        type = stringToObjectType(row->value("type").toString());
+        ddl = row->value("sql").toString();
+        currentObjects << lowerName;
+
+        // Only new objects and objects with modified DDL are parsed
+        if (graph->objects.contains(lowerName))
+        {
+            GraphObject& object = graph->objects[lowerName];
+            if (object.type == type && object.ddl == ddl)
+            {
+                object.order = order++;
+                continue;
+            }
+
+            graph->remove(lowerName);
+        }
+
+        graph->add(createGraphObject(type, name, row->value("tbl_name").toString(), ddl, order++));
+    }
+
+    for (const QString& droppedObject : graph->objects.keys().toSet() - currentObjects)
+        graph->remove(droppedObject);
+
+    graph->built = true;
+    return true;
+}
+
+SchemaResolver::GraphObject SchemaResolver::createGraphObject(ObjectType type, const QString& name, const QString& tableName, const QString& ddl, int order)
+{
+    GraphObject object;
+    object.type = type;
+    object.name = name;
+    object.ddl = ddl;
+    object.order = order;
+
+    // Internal objects, like auto-indexes, have no DDL
+    if (ddl.isEmpty())
+        return object;
+
+    SqliteQueryPtr query = getParsedDdl(ddl);
+    if (!query)
+        return object;
+
+    switch (type)
+    {
+        case TABLE:
+        {
+            SqliteCreateTablePtr createTable = query.dynamicCast<SqliteCreateTable>();
+            if (!createTable) // virtual table
+                break;
+
+            for (SqliteCreateTable::Constraint* constr : createTable->getConstraints(SqliteCreateTable::Constraint::FOREIGN_KEY))
+                object.references << constr->foreignKey->foreignTable;
+
+            for (SqliteCreateTable::Column* column : createTable->columns)
+            {
+                for (SqliteCreateTable::Column::Constraint* constr : column->getConstraints(SqliteCreateTable::Column::Constraint::FOREIGN_KEY))
+                    object.references << constr->foreignKey->foreignTable;
+            }
+
+            object.valid = true;
+            break;
+        }
+        case INDEX:
+        {
+            if (!query.dynamicCast<SqliteCreateIndex>())
+                break;
+
+            object.target = tableName;
+            object.valid = true;
+            break;
+        }
+        case TRIGGER:
+        {
+            SqliteCreateTriggerPtr createTrigger = query.dynamicCast<SqliteCreateTrigger>();
+            if (!createTrigger)
+                break;
+
+            object.target = createTrigger->table;
+            object.insteadOf = (createTrigger->eventTime == SqliteCreateTrigger::Time::INSTEAD_OF);
+            object.references = createTrigger->getContextTables();
+            object.valid = true;
+            break;
+        }
+        case VIEW:
+        {
+            SqliteCreateViewPtr createView = query.dynamicCast<SqliteCreateView>();
+            if (!createView)
+                break;
+
+            object.references = createView->getContextTables();
+            object.valid = true;
+            break;
+        }
+        case ANY:
+            break;
+    }
+
+    return object;
+}
+
+void SchemaResolver::DependencyGraph::add(const GraphObject& object)
+{
+    QString lowerName = object.name.toLower();
+    objects[lowerName] = object;
+    if (!object.valid)
+        return;
+
+    switch (object.type)
+    {
+        case TABLE:
+            for (const QString& table : object.references)
+                fkReferences[table.toLower()] << lowerName;
+            break;
+        case INDEX:
+            indexes[object.target.toLower()] << lowerName;
+            break;
+        case TRIGGER:
+            triggers[object.target.toLower()] << lowerName;
+            for (const QString& table : object.references)
+                triggerReferences[table.toLower()] << lowerName;
+            break;
+        case VIEW:
+            for (const QString& table : object.references)
+                views[table.toLower()] << lowerName;
+            break;
+        case ANY:
+            break;
+    }
+}
+
+void SchemaResolver::DependencyGraph::remove(const QString& lowerName)
+{
+    if (!objects.contains(lowerName))
+        return;
+
+    GraphObject object = objects.take(lowerName);
+    if (!object.valid)
+        return;
+
+    auto removeEdge = [&lowerName](QHash<QString,QSet<QString>>& edgeMap, const QString& referencedName)
+    {
+        QString key = referencedName.toLower();
+        if (!edgeMap.contains(key))
+            return;
+
+        QSet<QString>& referencing = edgeMap[key];
+        referencing.remove(lowerName);
+        if (referencing.isEmpty())
+            edgeMap.remove(key);
+    };
+
+    switch (object.type)
+    {
+        case TABLE:
+            for (const QString& table : object.references)
+                removeEdge(fkReferences, table);
+            break;
+        case INDEX:
+            removeEdge(indexes, object.target);
+            break;
+        case TRIGGER:
+            removeEdge(triggers, object.target);
+            for (const QString& table : object.references)
+                removeEdge(triggerReferences, table);
+            break;
+        case VIEW:
+            for (const QString& table : object.references)
+                removeEdge(views, table);
+            break;
+        case ANY:
+            break;
+    }
+}
+
+QList<SchemaResolver::GraphObject> SchemaResolver::DependencyGraph::get(Dependency dependency, const QString& name) const
+{
+    QList<GraphObject> results;
+    for (const QString& lowerName : edges(dependency).value(name.toLower()))
+        results << objects[lowerName];
+
+    std::sort(results.begin(), results.end(), [](const GraphObject& o1, const GraphObject& o2) {return o1.order < o2.order;});
+    return results;
+}
+
+const QHash<QString,QSet<QString>>& SchemaResolver::DependencyGraph::edges(Dependency dependency) const
+{
+    switch (dependency)
+    {
+        case Dependency::FK_REFERENCES:
+            return fkReferences;
+        case Dependency::INDEXES:
+            return indexes;
+        case Dependency::TRIGGERS:
+            return triggers;
+        case Dependency::TRIGGER_REFERENCES:
+            return triggerReferences;
+        case Dependency::VIEWS:
+            break;
+    }
+    return views;
 }
 
 QList<SqliteCreateViewPtr> SchemaResolver::getParsedViewsForTable(const QString& database, const QString& table)
 {
     QList<SqliteCreateViewPtr> createViewList;
 
-    QStringList views = getViews(database);
+    QStringList views = getViewsForTable(database, table);
     SqliteQueryPtr query;
     SqliteCreateViewPtr createView;
     foreach (const QString& view, views)
@@ -976,8 +1509,7 @@ QList<SqliteCreateViewPtr> SchemaResolver::getParsedViewsForTable(const QString&
             continue;
         }
 
-        if (indexOf(createView->getContextTables(), table, Qt::CaseInsensitive) > -1)
-            createViewList << createView;
+        createViewList << createView;
     }
     return createViewList;
 }
@@ -1124,6 +1656,15 @@ SchemaResolver::ObjectCacheKey::ObjectCacheKey(Type type, Db* db, const QString&
 {
 }
 
+double SchemaResolver::CacheStatistics::hitRatio() const
+{
+    quint64 total = hits + misses;
+    if (total == 0)
+        return 0.0;
+
+    return static_cast<double>(hits) / total;
+}
+
 int qHash(const SchemaResolver::ObjectCacheKey& key)
 {
     return qHash(key.type) ^ qHash(key.db) ^ qHash(key.value1) ^ qHash(key.value2) ^ qHash(key.value3);
@@ -14,13 +14,12 @@
 #include "db/sqlquery.h"
 #include "db/db.h"
 #include "common/strhash.h"
-#include "common/expiringcache.h"
 #include <QStringList>
+#include <QCache>
+#include <QMutex>
 
 class SqliteCreateTable;
 
-// TODO add cache
-
 class API_EXPORT SchemaResolver
 {
     public:
@@ -45,7 +44,8 @@ class API_EXPORT SchemaResolver
             {
                 OBJECT_NAMES,
                 OBJECT_DETAILS,
-                OBJECT_DDL
+                OBJECT_DDL,
+                PARSED_DDL
             };
 
             ObjectCacheKey(Type type, Db* db, const QString& value1 = QString(), const QString& value2 = QString(), const QString& value3 = QString());
@@ -57,6 +57,28 @@ class API_EXPORT SchemaResolver
             QString value3;
         };
 
+        /**
+         * @brief Schema cache usage counters.
+         */
+        struct API_EXPORT CacheStatistics
+        {
+            /**
+             * @brief Calculates hit ratio.
+             * @return Ratio of hits to all lookups, between 0.0 and 1.0.
+             */
+            double hitRatio() const;
+
+            quint64 hits = 0;
+            quint64 misses = 0;
+
+            /**
+             * @brief Number of entries found in the cache, but rejected because the schema has changed since.
+             *
+             * Those are also counted as misses.
+             */
+            quint64 staleEntries = 0;
+        };
+
         explicit SchemaResolver(Db* db);
         virtual ~SchemaResolver();
 
@@ -190,10 +212,180 @@ class API_EXPORT SchemaResolver
         static ObjectType stringToObjectType(const QString& type);
         static void staticInit();
 
+        /**
+         * @brief Invalidates all cached schema information of given database.
+         * @param db Database that had its schema modified.
+         *
+         * This is called by Db implementations after they execute a query that modifies the schema
+         * (or the list of attached databases). Invalidation is O(1) - it just bumps the generation
+         * number of the database, so all entries stored for older generations are rejected
+         * (and dropped) when they are looked up next time.
+         *
+         * Changes made by other connections don't need to be reported here, because they are detected
+         * by the PRAGMA schema_version check.
+         */
+        static void invalidateCache(Db* db);
+
+        /**
+         * @brief Drops dependency graphs built for given database.
+         * @param db Database that is being deleted.
+         *
+         * Unlike invalidateCache(), it releases the memory, so it's meant to be called only when the database object is deleted.
+         */
+        static void dropDependencyGraphs(Db* db);
+
+        /**
+         * @brief Provides identifier of current schema state of the main, temp and all attached databases.
+         * @return String that changes every time the schema changes, or null string if the state cannot be determined (SQLite 2).
+         *
+         * It's made of PRAGMA schema_version values, the invalidation generation of the database and names and files
+         * of attached databases, so it can be used as a part of cache keys for any data derived from the schema.
+         */
+        QString getSchemaState();
+
+        /**
+         * @brief Reads approximate number of rows in the table from the sqlite_stat1 table.
+         * @param database Database that the table is in (the attach name of the database).
+         * @param table Table name.
+         * @param count Variable to store the number of rows in.
+         * @return true if the estimation was read, or false if sqlite_stat1 doesn't exist (ANALYZE was never executed), or it has no entry for the table.
+         *
+         * It's much faster than counting rows, but it's as old, as the last ANALYZE execution.
+         */
+        bool getRowCountEstimate(const QString& database, const QString& table, qint64& count);
+
+        /**
+         * @brief Removes all entries from the schema cache.
+         */
+        static void clearCache();
+
+        /**
+         * @brief Provides schema cache usage counters.
+         * @return Counters accumulated since the application start, or since last resetCacheStatistics().
+         */
+        static CacheStatistics getCacheStatistics();
+
+        /**
+         * @brief Resets schema cache usage counters.
+         */
+        static void resetCacheStatistics();
+
+        /**
+         * @brief Connection option that enables or disables the schema cache.
+         *
+         * If the option is not defined, the cache is enabled for SQLite 3 databases
+         * (as their schema version can be verified) and disabled for SQLite 2.
+         */
         static_char* USE_SCHEMA_CACHING = "useSchemaCaching";
 
     private:
+        /**
+         * @brief Schema state that the cached value was read at.
+         */
+        struct CacheStamp
+        {
+            qint64 schemaVersion = UNKNOWN_SCHEMA_VERSION;
+            quint64 generation = 0;
+        };
+
+        struct CacheEntry
+        {
+            QVariant value;
+            SqliteQueryPtr parsedQuery;
+            CacheStamp stamp;
+            qint64 createTime = 0;
+        };
+
+        struct SchemaVersion
+        {
+            qint64 version = UNKNOWN_SCHEMA_VERSION;
+            qint64 checkTime = 0;
+        };
+
+        /**
+         * @brief Kind of dependency stored in the DependencyGraph.
+         */
+        enum class Dependency
+        {
+            FK_REFERENCES,      /**< Tables referencing the table with foreign keys. */
+            INDEXES,            /**< Indexes on the table. */
+            TRIGGERS,           /**< Triggers on the table or view. */
+            TRIGGER_REFERENCES, /**< Triggers that use the table in their body. */
+            VIEWS               /**< Views selecting from the table. */
+        };
+
+        /**
+         * @brief Schema object with its references to other objects, as stored in the DependencyGraph.
+         */
+        struct GraphObject
+        {
+            ObjectType type = ANY;
+            QString name;
+            QString ddl;
+
+            /**
+             * @brief Position of the object in the sqlite_master, so results can be returned in the same order as before.
+             */
+            int order = 0;
+
+            /**
+             * @brief False if the DDL could not be parsed. Such object has no references.
+             */
+            bool valid = false;
+
+            /**
+             * @brief Table of the index, table or view of the trigger.
+             */
+            QString target;
+
+            /**
+             * @brief True for INSTEAD OF triggers (that is triggers on views).
+             */
+            bool insteadOf = false;
+
+            /**
+             * @brief Tables referenced with foreign keys by the table, tables used by the view or in the trigger body.
+             */
+            QStringList references;
+        };
+
+        /**
+         * @brief Dependencies between objects of a single database.
+         *
+         * Every object keeps its own references, while edge maps point the other way - from the referenced object
+         * to objects referencing it, so dependent objects are found in time proportional to their number.
+         * All keys are lower case names.
+         *
+         * The graph is built once from the sqlite_master and then updated when the schema changes - only new objects
+         * and objects with modified DDL are parsed again.
+         *
+         * Graph shared in dependencyGraphs is never modified. It's updated as a copy, outside of the dependencyGraphMutex,
+         * and the copy replaces the shared graph, so reading the schema of one database doesn't block other databases.
+         */
+        struct DependencyGraph
+        {
+            void add(const GraphObject& object);
+            void remove(const QString& lowerName);
+            QList<GraphObject> get(Dependency dependency, const QString& name) const;
+            const QHash<QString,QSet<QString>>& edges(Dependency dependency) const;
+
+            CacheStamp stamp;
+            bool built = false;
+            QHash<QString,GraphObject> objects;
+            QHash<QString,QSet<QString>> fkReferences;
+            QHash<QString,QSet<QString>> indexes;
+            QHash<QString,QSet<QString>> triggers;
+            QHash<QString,QSet<QString>> triggerReferences;
+            QHash<QString,QSet<QString>> views;
+        };
+
+        typedef QSharedPointer<DependencyGraph> DependencyGraphPtr;
+
         bool usesCache();
+        CacheStamp getCacheStamp(const QString& dbName);
+        qint64 getSchemaVersion(const QString& dbName);
+        bool getCachedValue(const ObjectCacheKey& key, const CacheStamp& stamp, QVariant& value);
+        void putCachedValue(const ObjectCacheKey& key, const CacheStamp& stamp, const QVariant& value);
         SqliteQueryPtr getParsedDdl(const QString& ddl);
         SqliteCreateTablePtr virtualTableAsRegularTable(const QString& database, const QString& table);
         StrHash< QStringList> getGroupedObjects(const QString &database, const QStringList& inputList, SqliteQueryType type);
@@ -202,6 +394,10 @@ class API_EXPORT SchemaResolver
         QList<SqliteCreateTriggerPtr> getParsedTriggersForTableOrView(const QString& database, const QString& tableOrView, bool includeContentReferences, bool table);
         QString getObjectDdlWithDifficultName(const QString& dbName, const QString& lowerName, QString targetTable, ObjectType type);
         QString getObjectDdlWithSimpleName(const QString& dbName, const QString& lowerName, QString targetTable, ObjectType type);
+        QList<GraphObject> getDependentObjects(const QString& database, const QString& name, Dependency dependency);
+        QStringList getTriggerNamesForTableOrView(const QString& database, const QString& tableOrView, bool includeContentReferences, bool table);
+        bool updateDependencyGraph(DependencyGraph* graph, const QString& dbName);
+        GraphObject createGraphObject(ObjectType type, const QString& name, const QString& tableName, const QString& ddl, int order);
 
         template <class T>
         StrHash<QSharedPointer<T>> getAllParsedObjectsForType(const QString& database, const QString& type);
@@ -211,7 +407,31 @@ class API_EXPORT SchemaResolver
         bool ignoreSystemObjects = false;
         Db::Flags dbFlags;
 
-        static ExpiringCache<ObjectCacheKey,QVariant> cache;
+        /**
+         * @brief Value returned from getSchemaVersion() when the version cannot be determined.
+         *
+         * Entries cached with unknown version expire after UNVERSIONED_EXPIRE_TIME.
+         */
+        static const qint64 UNKNOWN_SCHEMA_VERSION = -1;
+
+        /**
+         * @brief Period (in milliseconds) for which the PRAGMA schema_version result is reused.
+         *
+         * Schema changes made with the same connection invalidate the cache immediately,
+         * so this delay applies only to changes made by other processes.
+         */
+        static const int SCHEMA_VERSION_CHECK_INTERVAL = 1000;
+
+        static const int UNVERSIONED_EXPIRE_TIME = 3000;
+        static const int CACHE_SIZE = 10000;
+
+        static QCache<ObjectCacheKey,CacheEntry> cache;
+        static QHash<QPair<Db*,QString>,SchemaVersion> schemaVersions;
+        static QHash<Db*,quint64> cacheGenerations;
+        static CacheStatistics cacheStatistics;
+        static QMutex cacheMutex;
+        static QHash<QPair<Db*,QString>,DependencyGraphPtr> dependencyGraphs;
+        static QMutex dependencyGraphMutex;
 };
 
 int qHash(const SchemaResolver::ObjectCacheKey& key);
@@ -222,26 +442,24 @@ StrHash<QSharedPointer<T>> SchemaResolver::getAllParsedObjectsForType(const QStr
 {
      StrHash< QSharedPointer<T>> parsedObjects;
 
-     QString dbName = getPrefixDb(database, db->getDialect());
-
-     SqlQueryPtr results;
-
-     if (type.isNull())
-         results = db->exec(QString("SELECT name, type, sql FROM %1.sqlite_master;").arg(dbName));
-     else
-         results = db->exec(QString("SELECT name, type, sql FROM %1.sqlite_master WHERE type = '%2';").arg(dbName, type));
-
      QString name;
+     QString objectType;
      SqliteQueryPtr parsedObject;
      QSharedPointer<T> castedObject;
-     foreach (SqlResultsRowPtr row, results->getAll())
+     QHashIterator<QString,ObjectDetails> it = getAllObjectDetails(database).iterator();
+     while (it.hasNext())
      {
-         name = row->value("name").toString();
-         parsedObject = getParsedDdl(row->value("sql").toString());
-         if (!parsedObject)
+         it.next();
+         objectType = objectTypeToString(it.value().type);
+         if (!type.isNull() && objectType != type)
              continue;
 
-         if (isFilteredOut(name, row->value("type").toString()))
+         name = it.key();
+         if (isFilteredOut(name, objectType))
+             continue;
+
+         parsedObject = getParsedDdl(it.value().ddl);
+         if (!parsedObject)
              continue;
 
          castedObject = parsedObject.dynamicCast<T>();
@@ -24,6 +24,8 @@ CFG_CATEGORIES(Core,
         CFG_ENTRY(QVariantHash, ActiveCodeFormatter,     QVariantHash())
         CFG_ENTRY(bool,         CheckUpdatesOnStartup,   true)
         CFG_ENTRY(QString,      Language,                "en")
+        CFG_ENTRY(int,          BusyRetryInitialDelay,   50)     // microseconds
+        CFG_ENTRY(int,          BusyRetryMaxDelay,       100000) // microseconds
     )
     CFG_CATEGORY(Console,
         CFG_ENTRY(int,          HistorySize,             100)
@@ -58,11 +58,17 @@ class API_EXPORT ExportManager : public PluginServiceBase
             DATA_LENGTHS  = 0x01, /**<
                                     * Will provide maximum number of characters or bytes (depending on column type)
                                     * for each exported table or qurey result column. It will be a <tt>QList&lt;int&gt;</tt>.
+                                    * Unless EXACT_DATA is also requested, it's calculated from first rows of data only.
                                     */
-            ROW_COUNT     = 0x02  /**<
+            ROW_COUNT     = 0x02, /**<
                                     * Will provide total number of rows that will be exported for the table or query results.
                                     * It will be an integer value.
                                     */
+            EXACT_DATA    = 0x04  /**<
+                                    * By default DATA_LENGTHS are calculated from first rows of the data and ROW_COUNT of a table
+                                    * may be taken from the sqlite_stat1 table (if it exists), so no additional pass over the data is needed.
+                                    * This flag makes both values exact, at the cost of extra queries reading the entire table or query results.
+                                    */
         };
 
         Q_DECLARE_FLAGS(ExportProviderFlags, ExportProviderFlag)
@@ -144,6 +150,21 @@ class API_EXPORT ExportManager : public PluginServiceBase
              * Default is true.
              */
             bool exportTableTriggers = true;
+
+            /**
+             * @brief When exporting database with its data, this indicates if tables should be read in parallel.
+             *
+             * Tables are read by several threads, each using its own read connection to the database (see Db::takeReadConnection()),
+             * while the export plugin processes them in the usual order. Read connections are available only for databases
+             * in WAL journal mode. For other databases tables are read one after another.
+             *
+             * Each connection reads from its own snapshot of the database, so when other connections commit changes
+             * during the export, tables may come from different states of the database. Tables read one after another
+             * are always read within a single read transaction.
+             *
+             * Default is false.
+             */
+            bool parallelTableExport = false;
         };
 
         /**
@@ -36,6 +36,14 @@ class API_EXPORT FunctionManager : public QObject
             QStringList arguments;
             Type type = SCALAR;
             bool undefinedArgs = true;
+
+            /**
+             * @brief Tells that the function always returns the same result for the same arguments.
+             *
+             * Such function is registered in the database as deterministic, so SQLite can evaluate it
+             * only once when its arguments are constant, instead of calling it for every row.
+             */
+            bool deterministic = false;
         };
 
         struct API_EXPORT ScriptFunction : public FunctionBase
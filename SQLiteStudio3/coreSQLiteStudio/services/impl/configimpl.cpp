@@ -14,6 +14,8 @@
 #include <QDateTime>
 #include <QSysInfo>
 #include <QCoreApplication>
+#include <QTimer>
+#include <QThread>
 #include <QtConcurrent/QtConcurrentRun>
 
 static_qstring(DB_FILE_NAME, "settings3");
@@ -30,6 +32,12 @@ void ConfigImpl::init()
     initTables();
     updateConfigDb();
     mergeMasterConfig();
+    loadSettings();
+
+    settingsFlushTimer = new QTimer(this);
+    settingsFlushTimer->setSingleShot(true);
+    settingsFlushTimer->setInterval(SETTINGS_FLUSH_DELAY);
+    connect(settingsFlushTimer, SIGNAL(timeout()), this, SLOT(flushSettings()));
 
     sqlite3Version = db->exec("SELECT sqlite_version()")->getSingleCell().toString();
 
@@ -39,6 +47,14 @@ void ConfigImpl::init()
 
 void ConfigImpl::cleanUp()
 {
+    if (!db)
+        return;
+
+    if (settingsFlushTimer)
+        settingsFlushTimer->stop();
+
+    flushSettings();
+
     if (db->isOpen())
         db->close();
 
@@ -64,6 +80,9 @@ void ConfigImpl::beginMassSave()
         return;
 
     emit massSaveBegins();
+
+    // Earlier changes go in their own transaction, so rolling back the mass save doesn't affect them
+    flushSettings();
     db->exec("BEGIN;");
     massSaving = true;
 }
@@ -73,7 +92,12 @@ void ConfigImpl::commitMassSave()
     if (!isMassSaving())
         return;
 
+    flushSettings();
     db->exec("COMMIT;");
+    {
+        QMutexLocker locker(&settingsMutex);
+        transactionSettings.clear();
+    }
     emit massSaveCommitted();
     massSaving = false;
 }
@@ -85,6 +109,7 @@ void ConfigImpl::rollbackMassSave()
 
     db->exec("ROLLBACK;");
     massSaving = false;
+    discardTransactionSettings();
 }
 
 bool ConfigImpl::isMassSaving() const
@@ -94,33 +119,156 @@ bool ConfigImpl::isMassSaving() const
 
 void ConfigImpl::set(const QString &group, const QString &key, const QVariant &value)
 {
-    QByteArray bytes;
-    QDataStream stream(&bytes, QIODevice::WriteOnly);
-    stream << value;
+    SettingKey settingKey(group, key);
+    {
+        QMutexLocker locker(&settingsMutex);
+        settings[settingKey] = value;
+        pendingSettings[settingKey] = value;
+        if (massSaving || transactionActive)
+            transactionSettings << settingKey;
+    }
 
-    db->exec("INSERT OR REPLACE INTO settings VALUES (?, ?, ?)", {group, key, bytes});
+    // Within the transaction changes are written when it's committed
+    if (!massSaving && !transactionActive)
+        scheduleSettingsFlush();
 }
 
 QVariant ConfigImpl::get(const QString &group, const QString &key)
 {
-    SqlQueryPtr results = db->exec("SELECT value FROM settings WHERE [group] = ? AND [key] = ?", {group, key});
-    return deserializeValue(results->getSingleCell());
+    QMutexLocker locker(&settingsMutex);
+    return settings.value(SettingKey(group, key));
 }
 
 QHash<QString,QVariant> ConfigImpl::getAll()
+{
+    QMutexLocker locker(&settingsMutex);
+    QHash<QString,QVariant> cfg;
+    for (QHash<SettingKey,QVariant>::const_iterator it = settings.constBegin(); it != settings.constEnd(); ++it)
+        cfg[it.key().first + "." + it.key().second] = it.value();
+
+    return cfg;
+}
+
+void ConfigImpl::loadSettings()
 {
     SqlQueryPtr results = db->exec("SELECT [group], [key], value FROM settings");
+    if (results->isError())
+    {
+        qCritical() << "Could not read settings:" << results->getErrorText();
+        return;
+    }
 
-    QHash<QString,QVariant> cfg;
-    QString key;
+    QHash<SettingKey,QVariant> loadedSettings;
     SqlResultsRowPtr row;
     while (results->hasNext())
     {
         row = results->next();
-        key = row->value("group").toString() + "." + row->value("key").toString();
-        cfg[key] = deserializeValue(row->value("value"));
+        loadedSettings[SettingKey(row->value("group").toString(), row->value("key").toString())] = deserializeValue(row->value("value"));
+    }
+
+    QMutexLocker locker(&settingsMutex);
+    settings = loadedSettings;
+}
+
+void ConfigImpl::reloadSetting(const SettingKey& settingKey)
+{
+    SqlQueryPtr results = db->exec("SELECT value FROM settings WHERE [group] = ? AND [key] = ?", {settingKey.first, settingKey.second});
+    QVariant value = deserializeValue(results->getSingleCell());
+
+    QMutexLocker locker(&settingsMutex);
+    if (value.isValid())
+        settings[settingKey] = value;
+    else
+        settings.remove(settingKey);
+}
+
+void ConfigImpl::scheduleSettingsFlush()
+{
+    if (!settingsFlushTimer)
+        return;
+
+    // Timer is not restarted if it's already running, so constant changes don't postpone writing forever
+    if (QThread::currentThread() == thread())
+    {
+        if (!settingsFlushTimer->isActive())
+            settingsFlushTimer->start();
+    }
+    else
+    {
+        QMetaObject::invokeMethod(settingsFlushTimer, "start", Qt::QueuedConnection);
+    }
+}
+
+void ConfigImpl::flushSettings()
+{
+    QHash<SettingKey,QVariant> toWrite;
+    {
+        QMutexLocker locker(&settingsMutex);
+        if (pendingSettings.isEmpty())
+            return;
+
+        toWrite = pendingSettings;
+    }
+
+    bool ownTransaction = !massSaving && !transactionActive;
+    if (ownTransaction && !db->begin())
+    {
+        qCritical() << "Could not start transaction for writing settings:" << db->getErrorText();
+        scheduleSettingsFlush();
+        return;
+    }
+
+    static_qstring(insertSql, "INSERT OR REPLACE INTO settings VALUES (?, ?, ?)");
+    SqlQueryPtr results;
+    for (QHash<SettingKey,QVariant>::const_iterator it = toWrite.constBegin(); it != toWrite.constEnd(); ++it)
+    {
+        QByteArray bytes;
+        QDataStream stream(&bytes, QIODevice::WriteOnly);
+        stream << it.value();
+
+        results = db->exec(insertSql, {it.key().first, it.key().second, bytes});
+        if (results->isError())
+        {
+            printErrorIfSet(results);
+            if (ownTransaction)
+            {
+                db->rollback();
+                scheduleSettingsFlush();
+            }
+            return;
+        }
+    }
+
+    if (ownTransaction && !db->commit())
+    {
+        qCritical() << "Could not commit settings:" << db->getErrorText();
+        db->rollback();
+        scheduleSettingsFlush();
+        return;
+    }
+
+    // Settings changed again in the meantime (from other thread) stay pending
+    QMutexLocker locker(&settingsMutex);
+    for (QHash<SettingKey,QVariant>::const_iterator it = toWrite.constBegin(); it != toWrite.constEnd(); ++it)
+    {
+        if (pendingSettings.contains(it.key()) && pendingSettings[it.key()] == it.value())
+            pendingSettings.remove(it.key());
     }
-    return cfg;
+}
+
+void ConfigImpl::discardTransactionSettings()
+{
+    QSet<SettingKey> keys;
+    {
+        QMutexLocker locker(&settingsMutex);
+        keys = transactionSettings;
+        transactionSettings.clear();
+        for (const SettingKey& settingKey : keys)
+            pendingSettings.remove(settingKey);
+    }
+
+    for (const SettingKey& settingKey : keys)
+        reloadSetting(settingKey);
 }
 
 bool ConfigImpl::storeErrorAndReturn(SqlQueryPtr results)
@@ -450,17 +598,26 @@ void ConfigImpl::readGroupRecursively(ConfigImpl::DbGroupPtr group)
 
 void ConfigImpl::begin()
 {
+    flushSettings();
     db->begin();
+    transactionActive = true;
 }
 
 void ConfigImpl::commit()
 {
+    flushSettings();
     db->commit();
+    transactionActive = false;
+
+    QMutexLocker locker(&settingsMutex);
+    transactionSettings.clear();
 }
 
 void ConfigImpl::rollback()
 {
     db->rollback();
+    transactionActive = false;
+    discardTransactionSettings();
 }
 
 QString ConfigImpl::getConfigPath()
@@ -5,9 +5,12 @@
 #include "services/config.h"
 #include "db/sqlquery.h"
 #include <QMutex>
+#include <QPair>
+#include <QSet>
 
 class AsyncConfigHandler;
 class SqlHistoryModel;
+class QTimer;
 
 class API_EXPORT ConfigImpl : public Config
 {
@@ -78,6 +81,8 @@ class API_EXPORT ConfigImpl : public Config
         void rollback();
 
     private:
+        typedef QPair<QString,QString> SettingKey;
+
         /**
          * @brief Stores error from query in class member.
          * @param query Query to get error from.
@@ -96,6 +101,31 @@ class API_EXPORT ConfigImpl : public Config
         bool tryInitDbFile(const QPair<QString, bool>& dbPath);
         QVariant deserializeValue(const QVariant& value);
 
+        /**
+         * @brief Reads all settings into the memory with a single query.
+         *
+         * Settings are then served by get() and getAll() from the memory.
+         */
+        void loadSettings();
+
+        /**
+         * @brief Reads single setting from the database into the memory.
+         * @param settingKey Group and key of the setting.
+         */
+        void reloadSetting(const SettingKey& settingKey);
+
+        /**
+         * @brief Starts timer for flushSettings(), unless it's already running.
+         *
+         * Can be called from any thread.
+         */
+        void scheduleSettingsFlush();
+
+        /**
+         * @brief Drops changes made to settings since the transaction (or mass save) was started.
+         */
+        void discardTransactionSettings();
+
         void asyncAddSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected);
         void asyncUpdateSqlHistory(qint64 id, const QString& sql, const QString& dbName, int timeSpentMillis, int rowsAffected);
         void asyncClearSqlHistory();
@@ -126,6 +156,50 @@ class API_EXPORT ConfigImpl : public Config
         QMutex sqlHistoryMutex;
         QString sqlite3Version;
 
+        /**
+         * @brief All settings, as stored in the database, plus changes not written yet.
+         */
+        QHash<SettingKey,QVariant> settings;
+
+        /**
+         * @brief Changed settings waiting to be written by flushSettings().
+         *
+         * Multiple changes of the same setting are coalesced into the last value.
+         */
+        QHash<SettingKey,QVariant> pendingSettings;
+
+        /**
+         * @brief Settings changed since the transaction (or mass save) was started.
+         *
+         * They are restored from the database if the transaction is rolled back.
+         */
+        QSet<SettingKey> transactionSettings;
+
+        /**
+         * @brief Protects settings, pendingSettings and transactionSettings.
+         */
+        QMutex settingsMutex;
+
+        QTimer* settingsFlushTimer = nullptr;
+        bool transactionActive = false;
+
+        /**
+         * @brief Delay between the setting change and writing it to the database, in milliseconds.
+         *
+         * Changes made within this time are written together, in a single transaction.
+         */
+        static const int SETTINGS_FLUSH_DELAY = 1000;
+
+    private slots:
+        /**
+         * @brief Writes all pending changes of settings to the database.
+         *
+         * Changes are written in a single transaction (or in the transaction that is already open),
+         * so either all of them are stored, or none. Changes are dropped from the pending list only after
+         * they are successfully written, so they're retried with the next flush if writing failed.
+         */
+        void flushSettings();
+
     public slots:
         void refreshDdlHistory();
         void refreshSqlHistory();
@@ -5,6 +5,7 @@
 #include "services/pluginmanager.h"
 #include "services/notifymanager.h"
 #include "common/utils.h"
+#include "plugins/dbpluginstdfilebase.h"
 #include <QCoreApplication>
 #include <QFileInfo>
 #include <QHash>
@@ -13,6 +14,7 @@
 #include <QDebug>
 #include <QUrl>
 #include <QDir>
+#include <QtConcurrent/QtConcurrentRun>
 #include <db/invaliddb.h>
 
 DbManagerImpl::DbManagerImpl(QObject *parent) :
@@ -23,6 +25,7 @@ DbManagerImpl::DbManagerImpl(QObject *parent) :
 
 DbManagerImpl::~DbManagerImpl()
 {
+    discardDbProbes();
     foreach (Db* db, dbList)
     {
         disconnect(db, SIGNAL(disconnected()), this, SLOT(dbDisconnectedSlot()));
@@ -201,6 +204,7 @@ void DbManagerImpl::removeDbInternal(Db* db, bool alsoFromConfig)
     nameToDb.remove(name);
     pathToDb.remove(db->getPath());
     dbList.removeOne(db);
+    dbProbeQueues.remove(db);
     disconnect(db, SIGNAL(connected()), this, SLOT(dbConnectedSlot()));
     disconnect(db, SIGNAL(disconnected()), this, SLOT(dbDisconnectedSlot()));
     disconnect(db, SIGNAL(aboutToDisconnect(bool&)), this, SLOT(dbAboutToDisconnect(bool&)));
@@ -357,7 +361,23 @@ void DbManagerImpl::loadInitialDbList()
 
 void DbManagerImpl::notifyDatabasesAreLoaded()
 {
-    // Any databases were already loaded by loaded() slot, which is called when DbPlugin was loaded.
+    // Any databases were already loaded by loaded() slot, which is called when DbPlugin was loaded,
+    // unless they're still probed in the background. Then the signal is emitted once they're loaded.
+    if (!dbProbes.isEmpty())
+    {
+        dbListLoadedPending = true;
+        return;
+    }
+
+    emit dbListLoaded();
+}
+
+void DbManagerImpl::notifyDatabasesAreLoadedIfProbed()
+{
+    if (!dbListLoadedPending || !dbProbes.isEmpty())
+        return;
+
+    dbListLoadedPending = false;
     emit dbListLoaded();
 }
 
@@ -393,56 +413,178 @@ void DbManagerImpl::rescanInvalidDatabasesForPlugin(DbPlugin* dbPlugin)
         return;
     }
 
-    Db* db = nullptr;
-
+    // Probing opens every database file (unless the plugin can tell it by the file header), which may take a while,
+    // especially on network drives. Plugins based on DbPluginStdFileBase are thread-safe, so their databases are probed
+    // in the background, in parallel. Single database is probed with one plugin at a time though, in order of plugins
+    // loading, so the plugin that takes the database doesn't depend on which probing finished first.
     QUrl url;
-    QString errorMessages;
+    QString path;
+    QHash<QString, QVariant> options;
     for (Db* invalidDb : getInvalidDatabases())
     {
-        if (invalidDb->getConnectionOptions().contains(DB_PLUGIN) && invalidDb->getConnectionOptions()[DB_PLUGIN].toString() != dbPlugin->getName())
+        path = invalidDb->getPath();
+        options = invalidDb->getConnectionOptions();
+        if (options.contains(DB_PLUGIN) && options.value(DB_PLUGIN).toString() != dbPlugin->getName())
             continue;
 
-        url = QUrl::fromUserInput(invalidDb->getPath());
-        if (url.isLocalFile() && !QFile::exists(invalidDb->getPath()))
+        url = QUrl::fromUserInput(path);
+        if (url.isLocalFile() && !QFile::exists(path))
             continue;
 
-        errorMessages = QString();
-        db = createDb(invalidDb->getName(), invalidDb->getPath(), invalidDb->getConnectionOptions(), &errorMessages);
-        if (!db)
+        if (dbProbeQueues.contains(invalidDb))
         {
-            if (!errorMessages.isNull())
-            {
-                dynamic_cast<InvalidDb*>(invalidDb)->setError(errorMessages);
-            }
-            continue; // For this db driver was not loaded yet.
+            // Still probed with plugins loaded earlier, this one gets its turn if they don't accept the database
+            dbProbeQueues[invalidDb] << dbPlugin;
+            continue;
         }
 
-        if (!dbPlugin->checkIfDbServedByPlugin(db))
+        dbProbeQueues[invalidDb] << dbPlugin;
+        probeWithNextPlugin(invalidDb);
+    }
+}
+
+void DbManagerImpl::probeWithNextPlugin(Db* invalidDb)
+{
+    QThread* targetThread = thread();
+    QFutureWatcher<DbProbe>* watcher = nullptr;
+    DbPlugin* dbPlugin = nullptr;
+    QString name;
+    QString path;
+    QHash<QString, QVariant> options;
+    while (!dbProbeQueues.value(invalidDb).isEmpty())
+    {
+        // Probing threads get copies, as the invalid database may be modified, or deleted before they finish
+        dbPlugin = dbProbeQueues[invalidDb].first();
+        name = invalidDb->getName();
+        path = invalidDb->getPath();
+        options = invalidDb->getConnectionOptions();
+
+        if (dynamic_cast<DbPluginStdFileBase*>(dbPlugin))
         {
-            qDebug() << "Managed to load database" << db->getPath() << " (" << db->getName() << ")"
-                     << "but it doesn't use DbPlugin that was just loaded, so it will not be loaded to the db manager";
+            watcher = new QFutureWatcher<DbProbe>(this);
+            connect(watcher, SIGNAL(finished()), this, SLOT(dbProbeFinished()));
+            dbProbes[watcher] = dbPlugin;
+            watcher->setFuture(QtConcurrent::run([=]()
+            {
+                return probeDb(dbPlugin, invalidDb, name, path, options, targetThread);
+            }));
+            return; // continued in dbProbeFinished()
+        }
+
+        dbProbeQueues[invalidDb].removeFirst();
+        if (applyDbProbe(dbPlugin, probeDb(dbPlugin, invalidDb, name, path, options, targetThread)))
+            break;
+    }
+    dbProbeQueues.remove(invalidDb);
+}
+
+bool DbManagerImpl::applyDbProbe(DbPlugin* dbPlugin, const DbProbe& probe)
+{
+    Db* db = probe.db;
+    Db* invalidDb = probe.invalidDb;
+
+    // Invalid database could be removed, or replaced with a loaded one, while it was probed
+    listLock.lockForRead();
+    bool stillInvalid = dbList.contains(invalidDb) && !invalidDb->isValid();
+    listLock.unlock();
+    if (!stillInvalid)
+    {
+        safe_delete(db);
+        return true;
+    }
+
+    if (!db)
+    {
+        if (!probe.errorMessage.isNull())
+            dynamic_cast<InvalidDb*>(invalidDb)->setError(probe.errorMessage);
+
+        return false; // For this db driver was not loaded yet.
+    }
+
+    if (!db->initAfterCreated())
+    {
+        dynamic_cast<InvalidDb*>(invalidDb)->setError(tr("Database could not be initialized."));
+        delete db;
+        return false;
+    }
+
+    removeDbInternal(invalidDb, false);
+    delete invalidDb;
+
+    addDbInternal(db, false);
+
+    if (!db->getConnectionOptions().contains(DB_PLUGIN))
+    {
+        db->getConnectionOptions()[DB_PLUGIN] = dbPlugin->getName();
+        if (!CFG->updateDb(db->getName(), db->getName(), db->getPath(), db->getConnectionOptions()))
+            qWarning() << "Could not store handling plugin in options for database" << db->getName();
+    }
+
+    if (CFG->getDbGroup(db->getName())->open)
+        db->open();
+
+    emit dbLoaded(db);
+    return true;
+}
 
-            delete db;
+void DbManagerImpl::discardDbProbes(DbPlugin* dbPlugin)
+{
+    QList<Db*> interruptedDbs;
+    QFutureWatcher<DbProbe>* watcher = nullptr;
+    QMutableHashIterator<QFutureWatcher<DbProbe>*, DbPlugin*> it(dbProbes);
+    while (it.hasNext())
+    {
+        it.next();
+        if (dbPlugin && it.value() != dbPlugin)
             continue;
-        }
 
-        removeDbInternal(invalidDb, false);
-        delete invalidDb;
+        // Database objects are deleted while their plugin is still loaded
+        watcher = it.key();
+        watcher->waitForFinished();
+        delete watcher->result().db;
+        interruptedDbs << watcher->result().invalidDb;
+        delete watcher;
+        it.remove();
+    }
 
-        addDbInternal(db, false);
+    if (!dbPlugin)
+    {
+        dbProbeQueues.clear();
+        return;
+    }
 
-        if (!db->getConnectionOptions().contains(DB_PLUGIN))
-        {
-            db->getConnectionOptions()[DB_PLUGIN] = dbPlugin->getName();
-            if (!CFG->updateDb(db->getName(), db->getName(), db->getPath(), db->getConnectionOptions()))
-                qWarning() << "Could not store handling plugin in options for database" << db->getName();
-        }
+    for (QList<DbPlugin*>& queue : dbProbeQueues)
+        queue.removeAll(dbPlugin);
 
-        if (CFG->getDbGroup(db->getName())->open)
-            db->open();
+    // Databases that were probed with the plugin move on to the next plugin in their queue
+    for (Db* invalidDb : interruptedDbs)
+        probeWithNextPlugin(invalidDb);
+}
 
-        emit dbLoaded(db);
+void DbManagerImpl::dbProbeFinished()
+{
+    QFutureWatcher<DbProbe>* watcher = dynamic_cast<QFutureWatcher<DbProbe>*>(sender());
+    if (!watcher || !dbProbes.contains(watcher))
+    {
+        qWarning() << "Received finished() signal from unknown database probing!";
+        return;
     }
+
+    DbPlugin* dbPlugin = dbProbes.take(watcher);
+    DbProbe probe = watcher->result();
+    watcher->deleteLater();
+
+    if (applyDbProbe(dbPlugin, probe))
+    {
+        dbProbeQueues.remove(probe.invalidDb);
+    }
+    else if (dbProbeQueues.contains(probe.invalidDb))
+    {
+        dbProbeQueues[probe.invalidDb].removeFirst();
+        probeWithNextPlugin(probe.invalidDb);
+    }
+
+    notifyDatabasesAreLoadedIfProbed();
 }
 
 void DbManagerImpl::addDbInternal(Db* db, bool alsoToConfig)
@@ -497,13 +639,7 @@ Db* DbManagerImpl::createDb(const QString &name, const QString &path, const QHas
     QStringList messages;
     QString message;
 
-    QString normalizedPath;
-    QUrl url(path);
-    if (url.scheme().isEmpty() || url.scheme() == "file")
-        normalizedPath = QDir(path).absolutePath();
-    else
-        normalizedPath = path;
-
+    QString normalizedPath = normalizeDbPath(path);
     for (DbPlugin* dbPlugin : dbPlugins)
     {
         if (options.contains("plugin") && options["plugin"] != dbPlugin->getName())
@@ -537,6 +673,29 @@ Db* DbManagerImpl::createDb(const QString &name, const QString &path, const QHas
     return nullptr;
 }
 
+DbManagerImpl::DbProbe DbManagerImpl::probeDb(DbPlugin* dbPlugin, Db* invalidDb, const QString& name, const QString& path,
+                                              const QHash<QString, QVariant>& options, QThread* targetThread)
+{
+    DbProbe probe;
+    probe.invalidDb = invalidDb;
+    probe.db = dbPlugin->getInstance(name, normalizeDbPath(path), options, &probe.errorMessage);
+
+    // Object created in the thread pool has to be moved before it's used in the main thread
+    if (probe.db)
+        probe.db->moveToThread(targetThread);
+
+    return probe;
+}
+
+QString DbManagerImpl::normalizeDbPath(const QString& path)
+{
+    QUrl url(path);
+    if (url.scheme().isEmpty() || url.scheme() == "file")
+        return QDir(path).absolutePath();
+
+    return path;
+}
+
 
 void DbManagerImpl::dbConnectedSlot()
 {
@@ -582,6 +741,9 @@ void DbManagerImpl::aboutToUnload(Plugin* plugin, PluginType* type)
     InvalidDb* invalidDb = nullptr;
     DbPlugin* dbPlugin = dynamic_cast<DbPlugin*>(plugin);
     dbPlugins.removeOne(dbPlugin);
+    discardDbProbes(dbPlugin);
+    notifyDatabasesAreLoadedIfProbed();
+
     QList<Db*> toRemove;
     for (Db* db : dbList)
     {
@@ -11,6 +11,7 @@
 #include <QHash>
 #include <QReadWriteLock>
 #include <QSharedPointer>
+#include <QFutureWatcher>
 
 class InvalidDb;
 
@@ -113,6 +114,70 @@ class API_EXPORT DbManagerImpl : public DbManager
          */
         static Db* createDb(const QString &name, const QString &path, const QHash<QString, QVariant> &options, QString* errorMessages = nullptr);
 
+        /**
+         * @brief Result of probeDb().
+         */
+        struct DbProbe
+        {
+            Db* invalidDb = nullptr;
+            Db* db = nullptr;
+            QString errorMessage;
+        };
+
+        /**
+         * @brief Checks if the invalid database can be loaded with given plugin.
+         * @param dbPlugin Plugin to create database object with.
+         * @param invalidDb Invalid database to be replaced. It's only stored in the result, never accessed.
+         * @param name Name of the invalid database.
+         * @param path Path of the invalid database.
+         * @param options Connection options of the invalid database.
+         * @param targetThread Thread that the created database object is moved to.
+         * @return Probing result, with the database object if the plugin accepted the database.
+         *
+         * It can be called from any thread, as long as the plugin supports it (see DbPluginStdFileBase).
+         */
+        static DbProbe probeDb(DbPlugin* dbPlugin, Db* invalidDb, const QString& name, const QString& path,
+                               const QHash<QString, QVariant>& options, QThread* targetThread);
+
+        /**
+         * @brief Probes invalid database with the first plugin from its queue (see dbProbeQueues).
+         * @param invalidDb Invalid database to be probed.
+         *
+         * Plugins that can probe in the background (see DbPluginStdFileBase) start the probing and the queue is continued
+         * by dbProbeFinished(). Other plugins probe the database right away and if they don't accept it,
+         * the next plugin from the queue is used.
+         */
+        void probeWithNextPlugin(Db* invalidDb);
+
+        /**
+         * @brief Replaces invalid database with the database object created by probing.
+         * @param dbPlugin Plugin that the database was probed with.
+         * @param probe Probing result.
+         * @return true if the invalid database is no longer to be probed (it was loaded, or removed in the meantime),
+         * or false if the plugin didn't accept it.
+         *
+         * If the invalid database was removed, or loaded in the meantime, the probed database object is deleted.
+         */
+        bool applyDbProbe(DbPlugin* dbPlugin, const DbProbe& probe);
+
+        /**
+         * @brief Waits for databases being probed in the background and drops probing results.
+         * @param dbPlugin Plugin to drop probing results for, or null to drop all of them.
+         */
+        void discardDbProbes(DbPlugin* dbPlugin = nullptr);
+
+        /**
+         * @brief Emits dbListLoaded() if it was postponed until all databases are probed.
+         */
+        void notifyDatabasesAreLoadedIfProbed();
+
+        /**
+         * @brief Makes the local file path absolute.
+         * @param path Database file path, or URL.
+         * @return Absolute file path, or unchanged URL.
+         */
+        static QString normalizeDbPath(const QString& path);
+
         /**
          * @brief Registered databases list. Both permanent and transient databases.
          */
@@ -143,6 +208,27 @@ class API_EXPORT DbManagerImpl : public DbManager
 
         QList<DbPlugin*> dbPlugins;
 
+        /**
+         * @brief Databases being probed in the background, with plugins they're probed with.
+         *
+         * See rescanInvalidDatabasesForPlugin().
+         */
+        QHash<QFutureWatcher<DbProbe>*, DbPlugin*> dbProbes;
+
+        /**
+         * @brief Plugins that invalid databases are yet to be probed with, in order of plugins loading.
+         *
+         * The first plugin on the list is the one that the database is being probed with at the moment.
+         * Databases are probed with one plugin at a time, so the plugin loaded first gets the database,
+         * no matter which probing would finish first.
+         */
+        QHash<Db*, QList<DbPlugin*>> dbProbeQueues;
+
+        /**
+         * @brief Tells if the dbListLoaded() is postponed until databases being probed are loaded.
+         */
+        bool dbListLoadedPending = false;
+
     private slots:
         /**
          * @brief Slot called when connected to db.
@@ -180,6 +266,13 @@ class API_EXPORT DbManagerImpl : public DbManager
          */
         void loaded(Plugin* plugin, PluginType* type);
 
+        /**
+         * @brief Applies result of the database probing done in the background.
+         *
+         * The slot is connected to the QFutureWatcher of the probing.
+         */
+        void dbProbeFinished();
+
     public slots:
         void notifyDatabasesAreLoaded();
         void scanForNewDatabasesInConfig();
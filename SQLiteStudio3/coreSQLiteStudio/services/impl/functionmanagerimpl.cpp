@@ -16,8 +16,17 @@
 #include <QRegularExpression>
 #include <QFile>
 #include <QUrl>
+#include <QCache>
+#include <QThreadStorage>
 #include <plugins/importplugin.h>
 
+namespace
+{
+    // Per thread, so matching doesn't need any locking. Each connection executes its queries
+    // (and so the regexp() calls) in the thread that called the Db, so this is effectively per connection.
+    QThreadStorage<QCache<QString,QRegularExpression>*> regExpCache;
+}
+
 FunctionManagerImpl::FunctionManagerImpl()
 {
     init();
@@ -247,30 +256,30 @@ void FunctionManagerImpl::init()
 
 void FunctionManagerImpl::initNativeFunctions()
 {
-    registerNativeFunction("regexp", {"pattern", "arg"}, FunctionManagerImpl::nativeRegExp);
+    registerNativeFunction("regexp", {"pattern", "arg"}, FunctionManagerImpl::nativeRegExp, true);
     registerNativeFunction("sqlfile", {"file"}, FunctionManagerImpl::nativeSqlFile);
     registerNativeFunction("readfile", {"file"}, FunctionManagerImpl::nativeReadFile);
     registerNativeFunction("writefile", {"file", "data"}, FunctionManagerImpl::nativeWriteFile);
     registerNativeFunction("langs", {}, FunctionManagerImpl::nativeLangs);
     registerNativeFunction("script", {"language", "code"}, FunctionManagerImpl::nativeScript);
-    registerNativeFunction("html_escape", {"string"}, FunctionManagerImpl::nativeHtmlEscape);
-    registerNativeFunction("url_encode", {"string"}, FunctionManagerImpl::nativeUrlEncode);
-    registerNativeFunction("url_decode", {"string"}, FunctionManagerImpl::nativeUrlDecode);
-    registerNativeFunction("base64_encode", {"data"}, FunctionManagerImpl::nativeBase64Encode);
-    registerNativeFunction("base64_decode", {"data"}, FunctionManagerImpl::nativeBase64Decode);
-    registerNativeFunction("md4_bin", {"data"}, FunctionManagerImpl::nativeMd4);
-    registerNativeFunction("md4", {"data"}, FunctionManagerImpl::nativeMd4Hex);
-    registerNativeFunction("md5_bin", {"data"}, FunctionManagerImpl::nativeMd5);
-    registerNativeFunction("md5", {"data"}, FunctionManagerImpl::nativeMd5Hex);
-    registerNativeFunction("sha1", {"data"}, FunctionManagerImpl::nativeSha1);
-    registerNativeFunction("sha224", {"data"}, FunctionManagerImpl::nativeSha224);
-    registerNativeFunction("sha256", {"data"}, FunctionManagerImpl::nativeSha256);
-    registerNativeFunction("sha384", {"data"}, FunctionManagerImpl::nativeSha384);
-    registerNativeFunction("sha512", {"data"}, FunctionManagerImpl::nativeSha512);
-    registerNativeFunction("sha3_224", {"data"}, FunctionManagerImpl::nativeSha3_224);
-    registerNativeFunction("sha3_256", {"data"}, FunctionManagerImpl::nativeSha3_256);
-    registerNativeFunction("sha3_384", {"data"}, FunctionManagerImpl::nativeSha3_384);
-    registerNativeFunction("sha3_512", {"data"}, FunctionManagerImpl::nativeSha3_512);
+    registerNativeFunction("html_escape", {"string"}, FunctionManagerImpl::nativeHtmlEscape, true);
+    registerNativeFunction("url_encode", {"string"}, FunctionManagerImpl::nativeUrlEncode, true);
+    registerNativeFunction("url_decode", {"string"}, FunctionManagerImpl::nativeUrlDecode, true);
+    registerNativeFunction("base64_encode", {"data"}, FunctionManagerImpl::nativeBase64Encode, true);
+    registerNativeFunction("base64_decode", {"data"}, FunctionManagerImpl::nativeBase64Decode, true);
+    registerNativeFunction("md4_bin", {"data"}, FunctionManagerImpl::nativeMd4, true);
+    registerNativeFunction("md4", {"data"}, FunctionManagerImpl::nativeMd4Hex, true);
+    registerNativeFunction("md5_bin", {"data"}, FunctionManagerImpl::nativeMd5, true);
+    registerNativeFunction("md5", {"data"}, FunctionManagerImpl::nativeMd5Hex, true);
+    registerNativeFunction("sha1", {"data"}, FunctionManagerImpl::nativeSha1, true);
+    registerNativeFunction("sha224", {"data"}, FunctionManagerImpl::nativeSha224, true);
+    registerNativeFunction("sha256", {"data"}, FunctionManagerImpl::nativeSha256, true);
+    registerNativeFunction("sha384", {"data"}, FunctionManagerImpl::nativeSha384, true);
+    registerNativeFunction("sha512", {"data"}, FunctionManagerImpl::nativeSha512, true);
+    registerNativeFunction("sha3_224", {"data"}, FunctionManagerImpl::nativeSha3_224, true);
+    registerNativeFunction("sha3_256", {"data"}, FunctionManagerImpl::nativeSha3_256, true);
+    registerNativeFunction("sha3_384", {"data"}, FunctionManagerImpl::nativeSha3_384, true);
+    registerNativeFunction("sha3_512", {"data"}, FunctionManagerImpl::nativeSha3_512, true);
     registerNativeFunction("import", {"file", "format", "table", "charset", "options"}, FunctionManagerImpl::nativeImport);
     registerNativeFunction("import_formats", {}, FunctionManagerImpl::nativeImportFormats);
     registerNativeFunction("import_options", {"format"}, FunctionManagerImpl::nativeImportOptions);
@@ -302,6 +311,7 @@ void FunctionManagerImpl::storeInConfig()
         fnHash["arguments"] = func->arguments;
         fnHash["type"] = static_cast<int>(func->type);
         fnHash["undefinedArgs"] = func->undefinedArgs;
+        fnHash["deterministic"] = func->deterministic;
         fnHash["allDatabases"] = func->allDatabases;
         list << fnHash;
     }
@@ -328,6 +338,7 @@ void FunctionManagerImpl::loadFromConfig()
         func->arguments = fnHash["arguments"].toStringList();
         func->type = static_cast<ScriptFunction::Type>(fnHash["type"].toInt());
         func->undefinedArgs = fnHash["undefinedArgs"].toBool();
+        func->deterministic = fnHash["deterministic"].toBool();
         func->allDatabases = fnHash["allDatabases"].toBool();
         functions << func;
     }
@@ -364,7 +375,7 @@ QVariant FunctionManagerImpl::nativeRegExp(const QList<QVariant>& args, Db* db,
         return QVariant();
     }
 
-    QRegularExpression re(args[0].toString());
+    QRegularExpression re = getCompiledRegExp(args[0].toString());
     if (!re.isValid())
     {
         ok = false;
@@ -375,6 +386,25 @@ QVariant FunctionManagerImpl::nativeRegExp(const QList<QVariant>& args, Db* db,
     return match.hasMatch();
 }
 
+QRegularExpression FunctionManagerImpl::getCompiledRegExp(const QString& pattern)
+{
+    if (!regExpCache.hasLocalData())
+        regExpCache.setLocalData(new QCache<QString,QRegularExpression>(REGEXP_CACHE_SIZE));
+
+    QCache<QString,QRegularExpression>* cache = regExpCache.localData();
+    QRegularExpression* re = cache->object(pattern);
+    if (re)
+        return *re;
+
+    QRegularExpression compiled(pattern);
+    if (!compiled.isValid())
+        return compiled;
+
+    compiled.optimize();
+    cache->insert(pattern, new QRegularExpression(compiled));
+    return compiled;
+}
+
 QVariant FunctionManagerImpl::nativeSqlFile(const QList<QVariant>& args, Db* db, bool& ok)
 {
     if (args.size() != 1)
@@ -770,13 +800,15 @@ QStringList FunctionManagerImpl::getArgMarkers(int argCount)
     return argMarkers;
 }
 
-void FunctionManagerImpl::registerNativeFunction(const QString& name, const QStringList& args, FunctionManager::NativeFunction::ImplementationFunction funcPtr)
+void FunctionManagerImpl::registerNativeFunction(const QString& name, const QStringList& args, FunctionManager::NativeFunction::ImplementationFunction funcPtr,
+                                                 bool deterministic)
 {
     NativeFunction* nf = new NativeFunction();
     nf->name = name;
     nf->arguments = args;
     nf->type = FunctionBase::SCALAR;
     nf->undefinedArgs = false;
+    nf->deterministic = deterministic;
     nf->functionPtr = funcPtr;
     nativeFunctions << nf;
 }
@@ -5,6 +5,7 @@
 #include <QCryptographicHash>
 
 class SqlFunctionPlugin;
+class QRegularExpression;
 class Plugin;
 class PluginType;
 
@@ -32,6 +33,18 @@ class API_EXPORT FunctionManagerImpl : public FunctionManager
                                               QHash<QString, QVariant>& aggregateStorage);
         QVariant evaluateNativeScalar(NativeFunction* func, const QList<QVariant>& args, Db* db, bool& ok);
 
+        /**
+         * @brief Implementation of the regexp() SQL function (used by the REGEXP operator).
+         * @param args Pattern and the value to match.
+         * @param db Database that called the function.
+         * @param ok Set to false if the pattern is invalid, or number of arguments is incorrect.
+         * @return true if the value matches the pattern, false otherwise, or error message if ok was set to false.
+         *
+         * Compiled patterns are reused through getCompiledRegExp(), as the function is usually called
+         * with the same pattern for every row of the filtered table.
+         */
+        static QVariant nativeRegExp(const QList<QVariant>& args, Db* db, bool& ok);
+
     private:
         struct Key
         {
@@ -55,10 +68,10 @@ class API_EXPORT FunctionManagerImpl : public FunctionManager
         void clearFunctions();
         QString cannotFindFunctionError(const QString& name, int argCount);
         QString langUnsupportedError(const QString& name, int argCount, const QString& lang);
-        void registerNativeFunction(const QString& name, const QStringList& args, NativeFunction::ImplementationFunction funcPtr);
+        void registerNativeFunction(const QString& name, const QStringList& args, NativeFunction::ImplementationFunction funcPtr, bool deterministic = false);
 
         static QStringList getArgMarkers(int argCount);
-        static QVariant nativeRegExp(const QList<QVariant>& args, Db* db, bool& ok);
+        static QRegularExpression getCompiledRegExp(const QString& pattern);
         static QVariant nativeSqlFile(const QList<QVariant>& args, Db* db, bool& ok);
         static QVariant nativeReadFile(const QList<QVariant>& args, Db* db, bool& ok);
         static QVariant nativeWriteFile(const QList<QVariant>& args, Db* db, bool& ok);
@@ -88,6 +101,8 @@ class API_EXPORT FunctionManagerImpl : public FunctionManager
         static QVariant nativeImportOptions(const QList<QVariant>& args, Db* db, bool& ok);
         static QVariant nativeCharsets(const QList<QVariant>& args, Db* db, bool& ok);
 
+        static const int REGEXP_CACHE_SIZE = 100;
+
         QList<ScriptFunction*> functions;
         QHash<Key,ScriptFunction*> functionsByKey;
         QList<NativeFunction*> nativeFunctions;
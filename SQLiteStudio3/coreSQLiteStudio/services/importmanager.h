@@ -39,6 +39,13 @@ class API_EXPORT ImportManager : public PluginServiceBase
 
             bool ignoreErrors = false;
             bool skipTransaction = false;
+
+            /**
+             * @brief Creates non-unique indexes of the table after the data is imported.
+             *
+             * It speeds up importing big amounts of data to a table with indexes. See BulkInserter::setDeferIndexes().
+             */
+            bool deferIndexes = false;
         };
 
         enum StandardConfigFlag
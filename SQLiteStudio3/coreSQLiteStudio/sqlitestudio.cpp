@@ -35,6 +35,8 @@
 #include "translations.h"
 #include <QProcessEnvironment>
 #include <QThreadPool>
+#include <QElapsedTimer>
+#include <QDebug>
 #include <QCoreApplication>
 
 DEFINE_SINGLETON(SQLiteStudio)
@@ -255,7 +257,9 @@ void SQLiteStudio::setConfig(Config* value)
 
 void SQLiteStudio::init(const QStringList& cmdListArguments, bool guiAvailable)
 {
-    env = new QProcessEnvironment(QProcessEnvironment::systemEnvironment());
+    if (!env)
+        env = new QProcessEnvironment(QProcessEnvironment::systemEnvironment());
+
     this->guiAvailable = guiAvailable;
 
     QThreadPool::globalInstance()->setMaxThreadCount(10);
@@ -279,8 +283,11 @@ void SQLiteStudio::init(const QStringList& cmdListArguments, bool guiAvailable)
 
     dbAttacherFactory = new DbAttacherDefaultFactory();
 
+    QElapsedTimer configTimer;
+    configTimer.start();
     config = new ConfigImpl();
     config->init();
+    qDebug() << "Configuration loaded in" << configTimer.elapsed() << "ms.";
 
     currentLang = CFG_CORE.General.Language.get();
     loadTranslations(initialTranslationFiles);
@@ -336,7 +343,11 @@ void SQLiteStudio::init(const QStringList& cmdListArguments, bool guiAvailable)
 
 void SQLiteStudio::initPlugins()
 {
+    // Plugins read most of the configuration, so this shows the cost of settings lookups at startup
+    QElapsedTimer pluginsTimer;
+    pluginsTimer.start();
     pluginManager->init();
+    qDebug() << "Plugins initialized in" << pluginsTimer.elapsed() << "ms.";
 
     connect(pluginManager, SIGNAL(loaded(Plugin*,PluginType*)), this, SLOT(pluginLoaded(Plugin*,PluginType*)));
     connect(pluginManager, SIGNAL(aboutToUnload(Plugin*,PluginType*)), this, SLOT(pluginToBeUnloaded(Plugin*,PluginType*)));
@@ -369,6 +380,11 @@ void SQLiteStudio::cleanUp()
         safe_delete(env);
         NotifyManager::destroy();
     }
+    else if (config)
+    {
+        // Settings are written with a delay, so pending changes have to be stored even when quitting immediately
+        config->cleanUp();
+    }
     Q_CLEANUP_RESOURCE(coreSQLiteStudio);
 }
 
@@ -404,6 +420,10 @@ void SQLiteStudio::pluginUnloaded(const QString& pluginName, PluginType* pluginT
 
 QString SQLiteStudio::getEnv(const QString &name, const QString &defaultValue)
 {
+    // Environment can be queried before init(), for example by tests creating services on their own
+    if (!env)
+        env = new QProcessEnvironment(QProcessEnvironment::systemEnvironment());
+
     return env->value(name, defaultValue);
 }
 
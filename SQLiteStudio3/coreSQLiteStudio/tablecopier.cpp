@@ -0,0 +1,187 @@
+#include "tablecopier.h"
+#include "db/db.h"
+#include "db/sqlresultsblock.h"
+#include "db/bulkinserter.h"
+#include "common/utils_sql.h"
+#include "common/global.h"
+#include "schemaresolver.h"
+#include <QDebug>
+
+TableCopier::TableCopier(Db* srcDb, Db* dstDb) :
+    srcDb(srcDb), dstDb(dstDb)
+{
+}
+
+void TableCopier::setCommitInterval(int rows)
+{
+    commitInterval = qMax(0, rows);
+}
+
+void TableCopier::setDeferIndexes(bool defer)
+{
+    deferIndexes = defer;
+}
+
+void TableCopier::setInterruptCheck(TableCopier::InterruptCheck check)
+{
+    interruptCheck = check;
+}
+
+void TableCopier::setSourceQueryHandler(TableCopier::SourceQueryHandler handler)
+{
+    sourceQueryHandler = handler;
+}
+
+bool TableCopier::copy(const QString& srcTable, const QString& dstTable)
+{
+    errorText = QString();
+    copiedRows = 0;
+
+    BulkInserter inserter(dstDb, dstTable, SchemaResolver(dstDb).getTableColumns(dstTable));
+    inserter.setDeferIndexes(deferIndexes);
+    if (!inserter.begin())
+    {
+        errorText = inserter.getErrorText();
+        return false;
+    }
+
+    Reader reader(this, srcTable);
+    reader.start();
+    bool res = copyRows(&reader, inserter);
+    reader.abort();
+    reader.wait();
+
+    if (!res)
+        return false;
+
+    if (!inserter.finish())
+    {
+        errorText = inserter.getErrorText();
+        return false;
+    }
+
+    qDebug() << "Copied" << copiedRows << "rows from table" << srcTable << "to table" << dstTable;
+    return true;
+}
+
+QString TableCopier::getErrorText() const
+{
+    return errorText;
+}
+
+qint64 TableCopier::getCopiedRows() const
+{
+    return copiedRows;
+}
+
+bool TableCopier::copyRows(TableCopier::Reader* reader, BulkInserter& inserter)
+{
+    int rowsSinceCommit = 0;
+    Chunk chunk;
+    while (reader->nextChunk(chunk))
+    {
+        if (isInterrupted())
+            return false;
+
+        if (!chunk.errorText.isNull())
+        {
+            errorText = chunk.errorText;
+            return false;
+        }
+
+        for (const QList<QVariant>& row : chunk.rows)
+        {
+            if (!inserter.insert(row))
+            {
+                errorText = inserter.getErrorText();
+                return false;
+            }
+        }
+        copiedRows += chunk.rows.size();
+        rowsSinceCommit += chunk.rows.size();
+
+        if (commitInterval > 0 && rowsSinceCommit >= commitInterval)
+        {
+            if (!inserter.flush())
+            {
+                errorText = inserter.getErrorText();
+                return false;
+            }
+
+            if (!dstDb->commit() || !dstDb->begin())
+            {
+                errorText = dstDb->getErrorText();
+                return false;
+            }
+            rowsSinceCommit = 0;
+        }
+
+        if (chunk.last)
+            return true;
+    }
+
+    // Queue was closed without the last chunk, which means it was aborted.
+    return false;
+}
+
+bool TableCopier::isInterrupted()
+{
+    return interruptCheck && interruptCheck();
+}
+
+TableCopier::Reader::Reader(TableCopier* copier, const QString& table) :
+    copier(copier), table(table), queue(CHUNK_QUEUE_CAPACITY)
+{
+}
+
+bool TableCopier::Reader::nextChunk(TableCopier::Chunk& chunk)
+{
+    return queue.pop(chunk);
+}
+
+void TableCopier::Reader::abort()
+{
+    queue.abort();
+}
+
+void TableCopier::Reader::run()
+{
+    static_qstring(selectTpl, "SELECT * FROM %1;");
+
+    Chunk chunk;
+    SqlQueryPtr results = copier->srcDb->prepare(selectTpl.arg(wrapObjIfNeeded(table, copier->srcDb->getDialect())));
+    if (copier->sourceQueryHandler)
+        copier->sourceQueryHandler(results);
+
+    if (!results->execute())
+    {
+        chunk.errorText = results->getErrorText();
+        chunk.last = true;
+        queue.push(chunk);
+        queue.close();
+        return;
+    }
+
+    while (!queue.isAborted())
+    {
+        const SqlResultsBlock& block = results->nextBatch(CHUNK_SIZE);
+        if (block.isEmpty())
+            break;
+
+        chunk.rows.clear();
+        chunk.rows.reserve(block.rowCount());
+        for (int i = 0, total = block.rowCount(); i < total; i++)
+            chunk.rows << block.rowValues(i);
+
+        if (!queue.push(chunk))
+            break;
+    }
+
+    chunk.rows.clear();
+    if (results->isError())
+        chunk.errorText = results->getErrorText();
+
+    chunk.last = true;
+    queue.push(chunk);
+    queue.close();
+}
@@ -0,0 +1,136 @@
+#ifndef TABLECOPIER_H
+#define TABLECOPIER_H
+
+#include "coreSQLiteStudio_global.h"
+#include "db/sqlquery.h"
+#include "common/boundedqueue.h"
+#include <QThread>
+#include <QStringList>
+#include <functional>
+
+class Db;
+class BulkInserter;
+
+/**
+ * @brief Copies table data from one database to another.
+ *
+ * It's used when data cannot be copied with a single INSERT ... SELECT statement, because databases cannot be attached
+ * to each other (for example they are of different types, or of different SQLite versions).
+ *
+ * Rows are read from the source table by a separate thread and passed in chunks to the thread calling copy(),
+ * which inserts them into the target table with the BulkInserter (statement prepared once per table).
+ * This way reading and writing overlap and no SQL is built nor compiled per row.
+ *
+ * The copier doesn't start any transaction by itself. The caller should start it in the target database before copying,
+ * so rows are not inserted in separate implicit transactions.
+ */
+class API_EXPORT TableCopier
+{
+    public:
+        /**
+         * @brief Function checking if the copying should be interrupted.
+         *
+         * It's called from the thread calling copy(), once per chunk of rows.
+         */
+        typedef std::function<bool()> InterruptCheck;
+
+        /**
+         * @brief Function called with prepared source query before it's executed.
+         *
+         * It's called from the reading thread and can be used to configure the query (like data type hints for SQLite 2).
+         */
+        typedef std::function<void(SqlQueryPtr query)> SourceQueryHandler;
+
+        TableCopier(Db* srcDb, Db* dstDb);
+
+        /**
+         * @brief Sets number of rows inserted in a single transaction.
+         * @param rows Number of rows, or 0 to insert all rows in the transaction started by the caller.
+         *
+         * When it's greater than 0, the copier commits the target database transaction every given number of rows
+         * and immediately begins a new one. The last transaction is left for the caller to commit.
+         * Use it only if partially copied data is acceptable in case of failure (it will not be rolled back).
+         */
+        void setCommitInterval(int rows);
+
+        /**
+         * @brief Enables deferred creation of indexes of the target table.
+         * @param defer true to drop non-unique indexes before copying and to create them again afterwards.
+         * @see BulkInserter::setDeferIndexes()
+         */
+        void setDeferIndexes(bool defer);
+
+        void setInterruptCheck(InterruptCheck check);
+        void setSourceQueryHandler(SourceQueryHandler handler);
+
+        /**
+         * @brief Copies all rows from the source table to the target table.
+         * @param srcTable Table in the source database.
+         * @param dstTable Table in the target database. It has to exist. Values are inserted into its columns in order,
+         * the same as with <tt>INSERT INTO dstTable SELECT * FROM srcTable</tt>.
+         * @return true on success, false on error or when interrupted.
+         *
+         * In case of error the getErrorText() provides details. It's empty if the copying was interrupted.
+         */
+        bool copy(const QString& srcTable, const QString& dstTable);
+
+        QString getErrorText() const;
+        qint64 getCopiedRows() const;
+
+    private:
+        /**
+         * @brief Portion of rows read from the source table.
+         *
+         * The last chunk has the "last" flag set. If reading failed, the errorText is set and the chunk is the last one.
+         */
+        struct Chunk
+        {
+            QList<QList<QVariant>> rows;
+            QString errorText;
+            bool last = false;
+        };
+
+        /**
+         * @brief Thread reading the source table.
+         */
+        class Reader : public QThread
+        {
+            public:
+                Reader(TableCopier* copier, const QString& table);
+
+                bool nextChunk(Chunk& chunk);
+                void abort();
+
+            protected:
+                void run();
+
+            private:
+                TableCopier* copier = nullptr;
+                QString table;
+                BoundedQueue<Chunk> queue;
+        };
+
+        bool copyRows(Reader* reader, BulkInserter& inserter);
+        bool isInterrupted();
+
+        Db* srcDb = nullptr;
+        Db* dstDb = nullptr;
+        int commitInterval = 0;
+        bool deferIndexes = false;
+        InterruptCheck interruptCheck = nullptr;
+        SourceQueryHandler sourceQueryHandler = nullptr;
+        QString errorText;
+        qint64 copiedRows = 0;
+
+        /**
+         * @brief Number of rows in single Chunk.
+         */
+        static const int CHUNK_SIZE = 1000;
+
+        /**
+         * @brief Maximum number of chunks read ahead by the Reader.
+         */
+        static const int CHUNK_QUEUE_CAPACITY = 4;
+};
+
+#endif // TABLECOPIER_H
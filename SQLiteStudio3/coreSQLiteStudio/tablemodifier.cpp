@@ -10,6 +10,7 @@
 #include "parser/ast/sqliteinsert.h"
 #include "parser/ast/sqlitedelete.h"
 #include "common/unused.h"
+#include "common/global.h"
 #include <QDebug>
 
 // TODO no attach/temp db name support in this entire class
@@ -36,6 +37,9 @@ void TableModifier::alterTable(SqliteCreateTablePtr newCreateTable)
     existingColumns = newCreateTable->getColumnNames();
     newName = newCreateTable->table;
 
+    if (alterInPlace(newCreateTable))
+        return;
+
     if (db->getDialect() == Dialect::Sqlite3)
         sqls << "PRAGMA foreign_keys = 0;";
 
@@ -73,6 +77,8 @@ void TableModifier::renameTo(const QString& newName)
     sqls << QString("CREATE TABLE %1 AS SELECT * FROM %2;").arg(wrapObjIfNeeded(newName, dialect), wrapObjIfNeeded(table, dialect))
          << QString("DROP TABLE %1;").arg(wrapObjIfNeeded(table, dialect));
 
+    rebuildRequired = true;
+    addTableRewrite();
     table = newName;
     createTable->table = newName;
 }
@@ -139,6 +145,9 @@ void TableModifier::handleFks()
         modifiedTriggers += subModifier.getModifiedTriggers();
         modifiedViews += subModifier.getModifiedViews();
 
+        rebuildRequired |= subModifier.rebuildRequired;
+        addRowsToRewrite(subModifier.rowsToRewrite);
+
         warnings += subModifier.getWarnings();
         errors += subModifier.getErrors();
     }
@@ -872,6 +881,329 @@ void TableModifier::copyDataTo(const QString& targetTable, const QStringList& sr
 {
     sqls << QString("INSERT INTO %1 (%2) SELECT %3 FROM %4;").arg(wrapObjIfNeeded(targetTable, dialect), dstCols.join(", "), srcCols.join(", "),
                                                                  wrapObjIfNeeded(table, dialect));
+    rebuildRequired = true;
+    addTableRewrite();
+}
+
+bool TableModifier::alterInPlace(SqliteCreateTablePtr newCreateTable)
+{
+    if (dialect != Dialect::Sqlite3 || !createTable || createTable->select || newCreateTable->select)
+        return false;
+
+    if (createTable->withOutRowId.compare(newCreateTable->withOutRowId, Qt::CaseInsensitive) != 0)
+        return false;
+
+    if (createTable->constraints.size() != newCreateTable->constraints.size())
+        return false;
+
+    for (int i = 0; i < createTable->constraints.size(); i++)
+    {
+        if (!isSameDefinition(createTable->constraints[i], newCreateTable->constraints[i]))
+            return false;
+    }
+
+    // Columns that remain from the original table have to keep their order and definitions (except for names).
+    // New columns can only be appended at the end.
+    QStringList oldColumns = createTable->getColumnNames();
+    QList<SqliteCreateTable::Column*> droppedColumns;
+    QList<SqliteCreateTable::Column*> renamedColumns;
+    QList<SqliteCreateTable::Column*> addedColumns;
+    int oldIdx = 0;
+    int idx;
+    for (SqliteCreateTable::Column* column : newCreateTable->columns)
+    {
+        idx = indexOf(oldColumns, column->originalName, Qt::CaseInsensitive);
+        if (idx == -1)
+        {
+            addedColumns << column;
+            continue;
+        }
+
+        if (!addedColumns.isEmpty() || idx < oldIdx)
+            return false;
+
+        for (; oldIdx < idx; oldIdx++)
+            droppedColumns << createTable->columns[oldIdx];
+
+        SqliteCreateTable::Column* oldColumn = createTable->columns[oldIdx++];
+        if (!isSameDefinition(oldColumn, column))
+            return false;
+
+        if (column->name != oldColumn->name)
+            renamedColumns << column;
+    }
+
+    for (; oldIdx < oldColumns.size(); oldIdx++)
+        droppedColumns << createTable->columns[oldIdx];
+
+    bool renameTable = (table != newName);
+    if (!renameTable && renamedColumns.isEmpty() && droppedColumns.isEmpty() && addedColumns.isEmpty())
+        return false; // nothing to do in place, let the regular procedure handle it as it always did
+
+    int version = getSqliteVersion();
+    bool legacyAlter = db->exec("PRAGMA legacy_alter_table;")->getSingleCell().toBool();
+
+    // Names differing only by case are considered to be the same object by SQLite, so it would refuse to rename them.
+    if (renameTable && (legacyAlter || version < RENAME_TABLE_MIN_VERSION || table.compare(newName, Qt::CaseInsensitive) == 0))
+        return false;
+
+    if (!renamedColumns.isEmpty() && (legacyAlter || version < RENAME_COLUMN_MIN_VERSION))
+        return false;
+
+    if (!droppedColumns.isEmpty() && version < DROP_COLUMN_MIN_VERSION)
+        return false;
+
+    QStringList remainingColumns = oldColumns;
+    for (SqliteCreateTable::Column* column : droppedColumns)
+        remainingColumns.removeAt(indexOf(remainingColumns, column->name, Qt::CaseInsensitive));
+
+    // Renamed columns are processed one by one, so none of them can take name of any other column that still exists.
+    for (SqliteCreateTable::Column* column : renamedColumns)
+    {
+        if (indexOf(remainingColumns, column->name, Qt::CaseInsensitive) > -1)
+            return false;
+    }
+
+    for (SqliteCreateTable::Column* column : addedColumns)
+    {
+        if (!isAddColumnSupported(column))
+            return false;
+    }
+
+    SchemaResolver resolver(db);
+    if (!droppedColumns.isEmpty())
+    {
+        QList<SqliteQueryPtr> dependentObjects;
+        for (const SqliteCreateIndexPtr& index : resolver.getParsedIndexesForTable(originalTable))
+            dependentObjects << index;
+
+        for (const SqliteCreateTriggerPtr& trigger : resolver.getParsedTriggersForTable(originalTable, true))
+            dependentObjects << trigger;
+
+        for (const SqliteCreateViewPtr& view : resolver.getParsedViewsForTable(originalTable))
+            dependentObjects << view;
+
+        for (SqliteCreateTable::Column* column : droppedColumns)
+        {
+            if (!isDropColumnSupported(column, dependentObjects))
+                return false;
+        }
+    }
+
+    // All checks passed. From now on the modification is done in place.
+    static_qstring(renameTableTpl, "ALTER TABLE %1 RENAME TO %2;");
+    static_qstring(dropColumnTpl, "ALTER TABLE %1 DROP COLUMN %2;");
+    static_qstring(renameColumnTpl, "ALTER TABLE %1 RENAME COLUMN %2 TO %3;");
+    static_qstring(addColumnTpl, "ALTER TABLE %1 ADD COLUMN %2;");
+
+    if (renameTable || !renamedColumns.isEmpty())
+    {
+        // SQLite updates references in all these objects by itself
+        modifiedTables += resolver.getFkReferencingTables(originalTable);
+        modifiedIndexes += resolver.getIndexesForTable(originalTable);
+        modifiedTriggers += resolver.getTriggersForTable(originalTable);
+        modifiedViews += resolver.getViewsForTable(originalTable);
+    }
+
+    if (renameTable)
+    {
+        sqls << renameTableTpl.arg(getAlterTablePrefix(), wrapObjIfNeeded(newName, dialect));
+        table = newName;
+    }
+
+    for (SqliteCreateTable::Column* column : droppedColumns)
+    {
+        sqls << dropColumnTpl.arg(getAlterTablePrefix(), wrapObjIfNeeded(column->name, dialect));
+        addTableRewrite();
+    }
+
+    for (SqliteCreateTable::Column* column : renamedColumns)
+        sqls << renameColumnTpl.arg(getAlterTablePrefix(), wrapObjIfNeeded(column->originalName, dialect), wrapObjIfNeeded(column->name, dialect));
+
+    for (SqliteCreateTable::Column* column : addedColumns)
+    {
+        column->rebuildTokens();
+        sqls << addColumnTpl.arg(getAlterTablePrefix(), column->detokenize());
+    }
+
+    return true;
+}
+
+bool TableModifier::isAddColumnSupported(SqliteCreateTable::Column* column) const
+{
+    // Restrictions of ALTER TABLE ADD COLUMN, as listed in SQLite documentation
+    SqliteCreateTable::Column::Constraint* defaultConstr = column->getConstraint(SqliteCreateTable::Column::Constraint::DEFAULT);
+    if (defaultConstr && (!defaultConstr->ctime.isEmpty() || defaultConstr->expr))
+        return false;
+
+    bool nullDefault = (!defaultConstr || defaultConstr->literalNull);
+    for (SqliteCreateTable::Column::Constraint* constr : column->constraints)
+    {
+        switch (constr->type)
+        {
+            case SqliteCreateTable::Column::Constraint::PRIMARY_KEY:
+            case SqliteCreateTable::Column::Constraint::UNIQUE:
+                return false;
+            case SqliteCreateTable::Column::Constraint::NOT_NULL:
+            {
+                if (nullDefault)
+                    return false;
+
+                break;
+            }
+            case SqliteCreateTable::Column::Constraint::FOREIGN_KEY:
+            {
+                if (!nullDefault)
+                    return false;
+
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+bool TableModifier::isDropColumnSupported(SqliteCreateTable::Column* column, const QList<SqliteQueryPtr>& dependentObjects) const
+{
+    // Restrictions of ALTER TABLE DROP COLUMN, as listed in SQLite documentation
+    if (column->hasConstraint(SqliteCreateTable::Column::Constraint::PRIMARY_KEY) ||
+            column->hasConstraint(SqliteCreateTable::Column::Constraint::UNIQUE) ||
+            column->hasConstraint(SqliteCreateTable::Column::Constraint::FOREIGN_KEY))
+        return false;
+
+    for (SqliteCreateTable::Column* otherColumn : createTable->columns)
+    {
+        if (otherColumn == column)
+            continue;
+
+        for (SqliteCreateTable::Column::Constraint* constr : otherColumn->constraints)
+        {
+            if (isColumnMentioned(constr, column->name))
+                return false;
+        }
+    }
+
+    for (SqliteCreateTable::Constraint* constr : createTable->constraints)
+    {
+        if (isColumnMentioned(constr, column->name))
+            return false;
+    }
+
+    for (const SqliteQueryPtr& query : dependentObjects)
+    {
+        if (isColumnMentioned(query.data(), column->name))
+            return false;
+    }
+
+    // Foreign keys of other tables may point to the column implicitly, so any of them disqualifies dropping in place
+    return SchemaResolver(db).getFkReferencingTables(originalTable).isEmpty();
+}
+
+bool TableModifier::isColumnMentioned(SqliteStatement* stmt, const QString& column) const
+{
+    for (const TokenPtr& token : stmt->tokens)
+    {
+        if (token->isWhitespace() || token->type == Token::OPERATOR || token->type == Token::PAR_LEFT || token->type == Token::PAR_RIGHT)
+            continue;
+
+        if (stripObjName(token->value, dialect).compare(column, Qt::CaseInsensitive) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool TableModifier::isSameDefinition(SqliteStatement* oldStmt, SqliteStatement* newStmt) const
+{
+    oldStmt->rebuildTokens();
+    newStmt->rebuildTokens();
+    TokenList oldTokens = oldStmt->tokens.filterWhiteSpaces();
+    TokenList newTokens = newStmt->tokens.filterWhiteSpaces();
+    if (oldTokens.size() != newTokens.size())
+        return false;
+
+    // Column names in the old definition are compared as if they were already renamed
+    QString oldValue;
+    QString newValue;
+    for (int i = 0; i < oldTokens.size(); i++)
+    {
+        if (oldTokens[i]->type == Token::STRING || newTokens[i]->type == Token::STRING)
+        {
+            if (oldTokens[i]->type != newTokens[i]->type || oldTokens[i]->value != newTokens[i]->value)
+                return false;
+
+            continue;
+        }
+
+        oldValue = stripObjName(oldTokens[i]->value, dialect);
+        newValue = stripObjName(newTokens[i]->value, dialect);
+        oldValue = tableColMap.value(oldValue.toLower(), oldValue);
+        if (oldValue.compare(newValue, Qt::CaseInsensitive) != 0)
+            return false;
+    }
+    return true;
+}
+
+QString TableModifier::getAlterTablePrefix() const
+{
+    if (database.isEmpty())
+        return wrapObjIfNeeded(table, dialect);
+
+    return wrapObjIfNeeded(database, dialect) + "." + wrapObjIfNeeded(table, dialect);
+}
+
+int TableModifier::getSqliteVersion() const
+{
+    // Version string like "3.35.5" is converted into 3035005
+    QStringList parts = db->exec("SELECT sqlite_version();")->getSingleCell().toString().split(".");
+    int version = 0;
+    for (int i = 0; i < 3; i++)
+        version = version * 1000 + (i < parts.size() ? parts[i].toInt() : 0);
+
+    return version;
+}
+
+void TableModifier::addTableRewrite()
+{
+    addRowsToRewrite(getTableRowsEstimate());
+}
+
+void TableModifier::addRowsToRewrite(qint64 rows)
+{
+    if (rowsToRewrite < 0)
+        return;
+
+    if (rows < 0)
+        rowsToRewrite = -1;
+    else
+        rowsToRewrite += rows;
+}
+
+qint64 TableModifier::getTableRowsEstimate()
+{
+    if (tableRowsEstimated)
+        return tableRowsEstimate;
+
+    tableRowsEstimated = true;
+    tableRowsEstimate = -1;
+
+    qint64 count = 0;
+    if (SchemaResolver(db).getRowCountEstimate(database, originalTable, count))
+    {
+        tableRowsEstimate = count;
+        return tableRowsEstimate;
+    }
+
+    if (!createTable || !createTable->withOutRowId.isEmpty())
+        return tableRowsEstimate;
+
+    // The highest ROWID is read directly from the table's b-tree, without scanning it
+    SqlQueryPtr results = db->exec(QString("SELECT max(_rowid_) FROM %1;").arg(wrapObjIfNeeded(originalTable, dialect)));
+    if (!results->isError())
+        tableRowsEstimate = results->getSingleCell().toLongLong();
+
+    return tableRowsEstimate;
 }
 
 QStringList TableModifier::generateSqls() const
@@ -879,6 +1211,16 @@ QStringList TableModifier::generateSqls() const
     return sqls;
 }
 
+bool TableModifier::isRebuildRequired() const
+{
+    return rebuildRequired;
+}
+
+qint64 TableModifier::getEstimatedRowsToRewrite() const
+{
+    return rowsToRewrite;
+}
+
 bool TableModifier::isValid() const
 {
     return !createTable.isNull();
@@ -30,6 +30,22 @@ class API_EXPORT TableModifier
         QStringList getModifiedViews() const;
         bool hasMessages() const;
 
+        /**
+         * @brief Tells whether generated statements recreate any table by copying its contents.
+         * @return true if at least one table is rebuilt, or false if all changes are made in place with ALTER TABLE.
+         */
+        bool isRebuildRequired() const;
+
+        /**
+         * @brief Provides estimated number of table rows rewritten by generated statements.
+         * @return Number of rows, or -1 if it could not be estimated.
+         *
+         * It counts rows copied while rebuilding tables and rows rewritten by ALTER TABLE DROP COLUMN.
+         * The estimate comes from sqlite_stat1 (if the database was analyzed) or from the highest ROWID,
+         * so no table is scanned to get it.
+         */
+        qint64 getEstimatedRowsToRewrite() const;
+
     private:
         void init();
         void parseDdl();
@@ -64,6 +80,26 @@ class API_EXPORT TableModifier
         void simpleHandleTriggers(const QString& view = QString::null);
         SqliteQueryPtr parseQuery(const QString& ddl);
 
+        /**
+         * @brief Generates native ALTER TABLE statements for the modification, if possible.
+         * @param newCreateTable New table definition.
+         * @return true if statements were generated, or false if the table has to be rebuilt.
+         *
+         * SQLite can rename the table, rename, drop and append columns in place. It also updates all indexes,
+         * triggers, views and foreign keys referencing renamed objects, so none of them needs to be recreated.
+         * Any other change (or a change that the SQLite library in use cannot do in place) requires the full rebuild.
+         */
+        bool alterInPlace(SqliteCreateTablePtr newCreateTable);
+        bool isAddColumnSupported(SqliteCreateTable::Column* column) const;
+        bool isDropColumnSupported(SqliteCreateTable::Column* column, const QList<SqliteQueryPtr>& dependentObjects) const;
+        bool isColumnMentioned(SqliteStatement* stmt, const QString& column) const;
+        bool isSameDefinition(SqliteStatement* oldStmt, SqliteStatement* newStmt) const;
+        QString getAlterTablePrefix() const;
+        int getSqliteVersion() const;
+        void addTableRewrite();
+        void addRowsToRewrite(qint64 rows);
+        qint64 getTableRowsEstimate();
+
         /**
          * @brief alterTableHandleFks
          * @param newCreateTable
@@ -118,6 +154,20 @@ class API_EXPORT TableModifier
             return modified;
         }
 
+        static const int RENAME_COLUMN_MIN_VERSION = 3025000;
+
+        /**
+         * @brief Minimal SQLite version for ALTER TABLE RENAME TO.
+         * The 3.26.0 is the first one updating references in triggers and views (unless in legacy mode).
+         */
+        static const int RENAME_TABLE_MIN_VERSION = 3026000;
+
+        /**
+         * @brief Minimal SQLite version for ALTER TABLE DROP COLUMN.
+         * It was introduced in 3.35.0, but first releases had bugs corrupting databases in some cases.
+         */
+        static const int DROP_COLUMN_MIN_VERSION = 3035005;
+
         Db* db = nullptr;
         Dialect dialect;
 
@@ -160,6 +210,10 @@ class API_EXPORT TableModifier
         QStringList modifiedTriggers;
         QStringList modifiedViews;
         QStringList usedTempTableNames;
+        bool rebuildRequired = false;
+        qint64 rowsToRewrite = 0;
+        qint64 tableRowsEstimate = 0;
+        bool tableRowsEstimated = false;
 };
 
 
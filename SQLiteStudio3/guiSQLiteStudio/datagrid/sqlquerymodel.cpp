@@ -21,6 +21,7 @@
 #include <QtMath>
 #include <QMessageBox>
 #include <QThread>
+#include <QScrollBar>
 
 QSet<SqlQueryModel*> SqlQueryModel::existingModels;
 
@@ -31,7 +32,7 @@ SqlQueryModel::SqlQueryModel(QObject *parent) :
     queryExecutor->setDataLengthLimit(cellDataLengthLimit);
     connect(queryExecutor, SIGNAL(executionFinished(SqlQueryPtr)), this, SLOT(handleExecFinished(SqlQueryPtr)));
     connect(queryExecutor, SIGNAL(executionFailed(int,QString)), this, SLOT(handleExecFailed(int,QString)));
-    connect(queryExecutor, SIGNAL(resultsCountingFinished(quint64,quint64,int)), this, SLOT(resultsCountingFinished(quint64,quint64,int)));
+    connect(queryExecutor, SIGNAL(resultsCountingFinished(quint64,quint64,int,bool)), this, SLOT(resultsCountingFinished(quint64,quint64,int,bool)));
 
     NotifyManager* notifyManager = NotifyManager::getInstance();
     connect(notifyManager, SIGNAL(objectModified(Db*,QString,QString)), this, SLOT(handlePossibleTableModification(Db*,QString,QString)));
@@ -44,6 +45,7 @@ SqlQueryModel::SqlQueryModel(QObject *parent) :
 SqlQueryModel::~SqlQueryModel()
 {
     existingModels.remove(this);
+    stopStreaming();
 
     delete queryExecutor;
     queryExecutor = nullptr;
@@ -77,6 +79,7 @@ void SqlQueryModel::executeQuery()
     }
 
     sortOrder.clear();
+    queryExecutor->clearPageBoundaries(); // data might have changed since last execution
     queryExecutor->setSkipRowCounting(false);
     queryExecutor->setSortOrder(sortOrder);
     queryExecutor->setPage(0);
@@ -118,23 +121,34 @@ void SqlQueryModel::executeQueryInternal()
         rollback(uncommittedItems);
     }
 
+    stopStreaming();
+    continuousScrolling = isContinuousScrollingEnabled();
+
     emit executionStarted();
 
     queryExecutor->setQuery(query);
     queryExecutor->setResultsPerPage(getRowsPerPage());
     queryExecutor->setExplainMode(explain);
-    queryExecutor->setPreloadResults(true);
+    queryExecutor->setPreloadResults(!continuousScrolling); // streamed results are read by the Prefetcher
+    queryExecutor->setStreamResults(continuousScrolling);
     queryExecutor->exec();
 }
 
 void SqlQueryModel::internalExecutionStopped()
 {
     reloading = false;
+    scrollToEndAfterLoad = false;
     emit loadingEnded(false);
 }
 
 void SqlQueryModel::interrupt()
 {
+    if (!queryExecutor->isExecutionInProgress() && queryExecutor->isResultsCountingInProgress())
+    {
+        queryExecutor->interruptResultsCounting();
+        return;
+    }
+
     queryExecutor->interrupt();
 }
 
@@ -158,6 +172,16 @@ qint64 SqlQueryModel::getTotalPages()
     return totalPages;
 }
 
+bool SqlQueryModel::isTotalRowsEstimated() const
+{
+    return totalRowsEstimated;
+}
+
+bool SqlQueryModel::isTotalRowsKnown() const
+{
+    return totalRowsKnown;
+}
+
 QList<SqlQueryModelColumnPtr> SqlQueryModel::getColumns()
 {
     return columns;
@@ -305,22 +329,6 @@ void SqlQueryModel::commit(const QList<SqlQueryItem*>& items)
     commitInternal(filterOutCommittedItems(items));
 }
 
-bool SqlQueryModel::commitRow(const QList<SqlQueryItem*>& itemsInRow)
-{
-    const SqlQueryItem* item = itemsInRow.at(0);
-    if (!item)
-    {
-        qWarning() << "null item while call to commitRow() method. It shouldn't happen.";
-        return true;
-    }
-    if (item->isNewRow())
-        return commitAddedRow(getRow(item->row())); // we need to get all items again, in case of selective commit
-    else if (item->isDeletedRow())
-        return commitDeletedRow(getRow(item->row())); // we need to get all items again, in case of selective commit
-    else
-        return commitEditedRow(itemsInRow);
-}
-
 void SqlQueryModel::rollbackRow(const QList<SqlQueryItem*>& itemsInRow)
 {
     const SqlQueryItem* item = itemsInRow.at(0);
@@ -373,21 +381,62 @@ void SqlQueryModel::commitInternal(const QList<SqlQueryItem*>& items)
     for (SqlQueryItem* item : items)
         item->setCommittingError(false);
 
-    // Grouping by row and committing
+    // Grouping by row
     QList<QList<SqlQueryItem*>> groupedItems = groupItemsByRows(items);
-    emit aboutToCommit(groupedItems.size());
-
-    int step = 1;
-    rowsDeletedSuccessfullyInTheCommit.clear();
-    bool ok = true;
+    QList<QList<SqlQueryItem*>> addedRows;
+    QList<QList<SqlQueryItem*>> deletedRows;
+    QList<QList<SqlQueryItem*>> editedRows;
+    SqlQueryItem* firstItem = nullptr;
     for (const QList<SqlQueryItem*>& itemsInRow : groupedItems)
     {
-        if (!commitRow(itemsInRow))
+        firstItem = itemsInRow.at(0);
+        if (!firstItem)
         {
-            ok = false;
-            break;
+            qWarning() << "null item while grouping rows for commit. It shouldn't happen.";
+            continue;
         }
-        emit committingStepFinished(step++);
+
+        // For added and deleted rows we need to get all items again, in case of selective commit
+        if (firstItem->isNewRow())
+            addedRows << getRow(firstItem->row());
+        else if (firstItem->isDeletedRow())
+            deletedRows << getRow(firstItem->row());
+        else
+            editedRows << itemsInRow;
+    }
+
+    // Deleted rows go first, so new rows can reuse their keys. Deleting and updating is done with statements
+    // executed in a separate thread. New rows are inserted one by one, as each of them has to be read back afterwards.
+    QList<CommitStatement> statements;
+    bool ok = getDeletedRowsStatements(deletedRows, statements);
+    for (const QList<SqlQueryItem*>& itemsInRow : editedRows)
+    {
+        if (!ok)
+            break;
+
+        ok = getEditedRowStatements(itemsInRow, statements);
+    }
+
+    emit aboutToCommit(statements.size() + addedRows.size());
+
+    int step = 0;
+    rowsDeletedSuccessfullyInTheCommit.clear();
+    if (ok)
+        ok = execCommitStatements(statements, step);
+
+    if (ok)
+    {
+        for (const QList<SqlQueryItem*>& itemsInRow : deletedRows)
+            rowsDeletedSuccessfullyInTheCommit << itemsInRow[0]->index().row();
+    }
+
+    for (const QList<SqlQueryItem*>& itemsInRow : addedRows)
+    {
+        if (!ok)
+            break;
+
+        ok = commitAddedRow(itemsInRow);
+        emit committingStepFinished(++step);
     }
 
     // Getting current uncommitted list (after rows deletion it may be different)
@@ -571,11 +620,11 @@ bool SqlQueryModel::commitAddedRow(const QList<SqlQueryItem*>& itemsInRow)
     return false;
 }
 
-bool SqlQueryModel::commitEditedRow(const QList<SqlQueryItem*>& itemsInRow)
+bool SqlQueryModel::getEditedRowStatements(const QList<SqlQueryItem*>& itemsInRow, QList<CommitStatement>& statements)
 {
     if (itemsInRow.size() == 0)
     {
-        qWarning() << "SqlQueryModel::commitEditedRow() called with no items in the list.";
+        qWarning() << "SqlQueryModel::getEditedRowStatements() called with no items in the list.";
         return true;
     }
 
@@ -584,12 +633,9 @@ bool SqlQueryModel::commitEditedRow(const QList<SqlQueryItem*>& itemsInRow)
     QHash<AliasedTable,QList<SqlQueryItem*>> itemsByTable = groupItemsByTable(itemsInRow);
 
     // Values
-    QString query;
     SqlQueryModelColumn* col = nullptr;
-    QHash<QString,QVariant> queryArgs;
     QStringList assignmentArgs;
-    RowId rowId;
-    RowId newRowId;
+    CommitStatement statement;
     CommitUpdateQueryBuilder queryBuilder;
     QHashIterator<AliasedTable,QList<SqlQueryItem*>> it(itemsByTable);
     QList<SqlQueryItem*> items;
@@ -600,7 +646,7 @@ bool SqlQueryModel::commitEditedRow(const QList<SqlQueryItem*>& itemsInRow)
         table = it.key();
         if (table.getTable().isNull())
         {
-            qCritical() << "Tried to commit null table in SqlQueryModel::commitEditedRow().";
+            qCritical() << "Tried to commit null table in SqlQueryModel::getEditedRowStatements().";
             continue;
         }
 
@@ -610,9 +656,11 @@ bool SqlQueryModel::commitEditedRow(const QList<SqlQueryItem*>& itemsInRow)
 
         // RowId
         queryBuilder.clear();
-        rowId = items.first()->getRowId();
-        queryBuilder.setRowId(rowId);
-        newRowId = getNewRowId(rowId, items); // if any of item updates any of rowid columns, then this will be different than initial rowid
+        statement.table = table;
+        statement.items = items;
+        statement.rowId = items.first()->getRowId();
+        queryBuilder.setRowId(statement.rowId);
+        statement.newRowId = getNewRowId(statement.rowId, items); // if any of item updates any of rowid columns, then this will be different than initial rowid
 
         // Database and table
         queryBuilder.setTable(wrapObjIfNeeded(table.getTable(), dialect));
@@ -636,45 +684,60 @@ bool SqlQueryModel::commitEditedRow(const QList<SqlQueryItem*>& itemsInRow)
         }
 
         // Completing query
-        query = queryBuilder.build();
+        statement.query = queryBuilder.build();
 
         // RowId condition arguments
-        queryArgs = queryBuilder.getQueryArgs();
+        statement.args = queryBuilder.getQueryArgs();
 
         // Per-column arguments
         assignmentArgs = queryBuilder.getAssignmentArgs();
         for (int i = 0, total = items.size(); i < total; ++i)
-            queryArgs[assignmentArgs[i]] = items[i]->getValue();
-
-        // Get the data
-        SqlQueryPtr results = db->exec(query, queryArgs);
-        if (results->isError())
-        {
-            for (SqlQueryItem* item : items)
-                item->setCommittingError(true);
+            statement.args[assignmentArgs[i]] = items[i]->getValue();
 
-            notifyError(tr("An error occurred while committing the data: %1").arg(results->getErrorText()));
-            return false;
-        }
-
-        // After successful commit, check if RowId was modified and upadate it accordingly
-        if (rowId != newRowId)
-            updateRowIdForAllItems(table, rowId, newRowId);
+        statements << statement;
     }
 
     return true;
 }
 
-bool SqlQueryModel::commitDeletedRow(const QList<SqlQueryItem*>& itemsInRow)
+bool SqlQueryModel::getDeletedRowsStatements(const QList<QList<SqlQueryItem*>>& rows, QList<CommitStatement>& statements)
 {
-    if (itemsInRow.size() == 0)
+    UNUSED(rows);
+    UNUSED(statements);
+    return true;
+}
+
+bool SqlQueryModel::execCommitStatements(const QList<CommitStatement>& statements, int& step)
+{
+    if (statements.isEmpty())
+        return true;
+
+    // Executing in a separate thread keeps the progress updated
+    CommitWorker worker(db, statements);
+    worker.start();
+    while (!worker.wait(COMMIT_PROGRESS_INTERVAL))
+        emit committingStepFinished(step + worker.getExecutedStatements());
+
+    step += worker.getExecutedStatements();
+    emit committingStepFinished(step);
+
+    int failedStatement = worker.getFailedStatement();
+    if (failedStatement > -1)
     {
-        qCritical() << "No items passed to SqlQueryModel::commitDeletedRow().";
+        for (SqlQueryItem* item : statements[failedStatement].items)
+            item->setCommittingError(true);
+
+        notifyError(tr("An error occurred while committing the data: %1").arg(worker.getErrorText()));
         return false;
     }
 
-    int row = itemsInRow[0]->index().row();
-    rowsDeletedSuccessfullyInTheCommit << row;
+    // After successful commit, check if RowId was modified and upadate it accordingly
+    for (const CommitStatement& statement : statements)
+    {
+        if (statement.rowId != statement.newRowId)
+            updateRowIdForAllItems(statement.table, statement.rowId, statement.newRowId);
+    }
+
     return true;
 }
 
@@ -750,6 +813,7 @@ bool SqlQueryModel::loadData(SqlQueryPtr results)
 
     // Load data
     SqlResultsRowPtr row;
+    SqlResultsRowPtr firstRow;
     int rowIdx = 0;
     int rowsPerPage = getRowsPerPage();
     rowNumBase = getCurrentPage() * rowsPerPage + 1;
@@ -763,6 +827,8 @@ bool SqlQueryModel::loadData(SqlQueryPtr results)
             break;
 
         rowList << loadRow(row);
+        if (!firstRow)
+            firstRow = row;
 
         if ((rowIdx % 50) == 0)
         {
@@ -774,10 +840,16 @@ bool SqlQueryModel::loadData(SqlQueryPtr results)
         rowIdx++;
     }
 
+    // Lets the executor seek to neighbouring pages by key, instead of skipping rows with OFFSET
+    queryExecutor->registerPageBoundaries(queryExecutor->getPage(), firstRow, row);
+
     rowIdx = 0;
     for (const QList<QStandardItem*>& row : rowList)
         insertRow(rowIdx++, row);
 
+    if (continuousScrolling && rowIdx >= rowsPerPage && results->hasNext())
+        startStreaming(results);
+
     allDataLoaded = true;
     return true;
 }
@@ -786,13 +858,21 @@ QList<QStandardItem*> SqlQueryModel::loadRow(SqlResultsRowPtr row)
 {
     QList<QStandardItem*> itemList;
     SqlQueryItem* item = nullptr;
-    RowId rowId;
     int colIdx = 0;
+
+    // RowId depends only on the table and on whether the column is editable (see getRowIdValue()),
+    // so it's built once for those and shared by cells (implicitly), instead of building a hash for each cell.
+    QHash<AliasedTable,RowId> editableRowIds;
+    QHash<AliasedTable,RowId> readOnlyRowIds;
     foreach (const QVariant& value, row->valueList().mid(0, resultColumnCount))
     {
         item = new SqlQueryItem();
-        rowId = getRowIdValue(row, colIdx);
-        updateItem(item, value, colIdx, rowId);
+        QHash<AliasedTable,RowId>& rowIds = columnEditionStatus[colIdx] ? editableRowIds : readOnlyRowIds;
+        const AliasedTable& table = tablesForColumns[colIdx];
+        if (!rowIds.contains(table))
+            rowIds[table] = getRowIdValue(row, colIdx);
+
+        updateItem(item, value, colIdx, rowIds[table]);
         itemList << item;
         colIdx++;
     }
@@ -837,9 +917,20 @@ void SqlQueryModel::updateItem(SqlQueryItem* item, const QVariant& value, int co
     else
         alignment = Qt::AlignLeft|Qt::AlignVCenter;
 
-    // This should be equal at most, unless we have UTF-8 string, than there might be more bytes.
-    // If less, than it's not limited.
-    bool limited = value.toByteArray().size() >= cellDataLengthLimit;
+    // Only text and blobs are limited by the executor, to the limit of characters, or bytes respectively.
+    // Other values are not converted, as it would be done for each loaded cell.
+    bool limited = false;
+    switch (value.type())
+    {
+        case QVariant::String:
+            limited = value.toString().size() >= cellDataLengthLimit;
+            break;
+        case QVariant::ByteArray:
+            limited = value.toByteArray().size() >= cellDataLengthLimit;
+            break;
+        default:
+            break;
+    }
 
     item->setJustInsertedWithOutRowId(false);
     item->setValue(value, limited, true);
@@ -1137,9 +1228,17 @@ void SqlQueryModel::handleExecFinished(SqlQueryPtr results)
     }
 
     storeStep1NumbersFromExecution();
+    totalRowsEstimated = false;
+    totalRowsKnown = true;
     if (!loadData(results))
         return;
 
+    if (scrollToEndAfterLoad)
+    {
+        scrollToEndAfterLoad = false;
+        view->scrollToBottom();
+    }
+
     storeStep2NumbersFromExecution();
 
     requiredDbAttaches = queryExecutor->getRequiredDbAttaches();
@@ -1165,7 +1264,8 @@ void SqlQueryModel::handleExecFinished(SqlQueryPtr results)
     if (!countRes || !queryExecutor->getAsyncMode())
     {
         results.clear();
-        detachDatabases();
+        if (!prefetcher || !prefetcher->readsMainResults()) // otherwise results are still being read, databases are detached by stopStreaming()
+            detachDatabases();
     }
 }
 
@@ -1192,17 +1292,29 @@ void SqlQueryModel::handleExecFailed(int code, QString errorMessage)
         emit executionFailed(tr("Error while executing SQL query on database '%1': %2").arg(db->getName(), errorMessage));
 
     restoreNumbersToQueryExecutor();
-    resultsCountingFinished(0, 0, 0);
+    resultsCountingFinished(0, 0, 0, false);
 
     reloading = false;
+    scrollToEndAfterLoad = false;
 }
 
-void SqlQueryModel::resultsCountingFinished(quint64 rowsAffected, quint64 rowsReturned, int totalPages)
+void SqlQueryModel::resultsCountingFinished(quint64 rowsAffected, quint64 rowsReturned, int totalPages, bool estimated)
 {
     this->rowsAffected = rowsAffected;
     this->totalRowsReturned = rowsReturned;
     this->totalPages = totalPages;
-    detachDatabases();
+    this->totalRowsEstimated = estimated;
+    this->totalRowsKnown = queryExecutor->isTotalRowsKnown();
+    if (estimated && queryExecutor->isResultsCountingInProgress())
+    {
+        // Exact count is on its way, attached databases are still needed
+        emit totalRowsAndPagesAvailable();
+        return;
+    }
+
+    if (!prefetcher || !prefetcher->readsMainResults())
+        detachDatabases();
+
     emit totalRowsAndPagesAvailable();
     emit storeExecutionInHistory();
 }
@@ -1220,6 +1332,9 @@ void SqlQueryModel::changeSorting(int logicalIndex, Qt::SortOrder order)
 
     queryExecutor->setSkipRowCounting(true);
     queryExecutor->setSortOrder({QueryExecutor::Sort(order, logicalIndex)});
+    if (continuousScrolling)
+        queryExecutor->setPage(0); // rows are read from the begining in the new order
+
     reloadInternal();
 }
 
@@ -1360,8 +1475,14 @@ Db* SqlQueryModel::getDb() const
 
 void SqlQueryModel::setDb(Db* value)
 {
+    if (db)
+        disconnect(db, SIGNAL(aboutToDisconnect(bool&)), this, SLOT(handleDbAboutToDisconnect(bool&)));
+
     db = value;
     queryExecutor->setDb(db);
+
+    if (db)
+        connect(db, SIGNAL(aboutToDisconnect(bool&)), this, SLOT(handleDbAboutToDisconnect(bool&)));
 }
 
 QueryExecutor::SortList SqlQueryModel::getSortOrder() const
@@ -1503,6 +1624,8 @@ QString SqlQueryModel::getDatabaseForCommit(const QString& database)
 void SqlQueryModel::recalculateRowsAndPages(int rowsDelta)
 {
     totalRowsReturned += rowsDelta;
+    if (rowsDelta != 0)
+        queryExecutor->clearPageBoundaries(); // pages have shifted
 
     int rowsPerPage = getRowsPerPage();
     totalPages = (int)qCeil(((double)totalRowsReturned) / ((double)rowsPerPage));
@@ -1545,6 +1668,173 @@ int SqlQueryModel::getRowsPerPage() const
     return rowsPerPage;
 }
 
+bool SqlQueryModel::isContinuousScrollingEnabled() const
+{
+    return CFG_UI.General.ContinuousScrolling.get() && hardRowLimit < 0 && !explain;
+}
+
+void SqlQueryModel::startStreaming(SqlQueryPtr results)
+{
+    nextWindow = page + 1;
+    fetchRequested = false;
+
+    // Statement kept open in the main connection would make it busy (and the table locked) until all rows are read,
+    // so if possible the query is executed again in a read connection. It starts with the window that was just loaded.
+    Db* readDb = queryExecutor->getResultsQuery().isNull() ? nullptr : queryExecutor->takeReadConnection();
+    if (readDb)
+    {
+        prefetcher = new Prefetcher(this, db, readDb, queryExecutor->getResultsQuery(), queryExecutor->getResultsQueryParameters(),
+                                    getRowsPerPage(), getRowsPerPage());
+    }
+    else
+    {
+        prefetcher = new Prefetcher(this, results, getRowsPerPage());
+    }
+
+    prefetcher->start();
+}
+
+void SqlQueryModel::stopStreaming()
+{
+    if (!prefetcher)
+        return;
+
+    // Reading of the current window might take a while (i.e. long step of the filtered query), so instead of waiting
+    // for it in the UI thread, the statement is interrupted if it's read in the Prefetcher's own connection.
+    // It's repeated, in case reading has just started.
+    prefetcher->abort();
+    while (!prefetcher->wait(10))
+        prefetcher->interruptReading();
+
+    delete prefetcher;
+    prefetcher = nullptr;
+    fetchRequested = false;
+
+    // Prefetcher held the last reference to results, so attached databases can be detached now
+    if (!queryExecutor->isResultsCountingInProgress())
+        detachDatabases();
+}
+
+void SqlQueryModel::appendWindow(const StreamWindow& window)
+{
+    if (!window.errorText.isNull())
+    {
+        stopStreaming();
+        notifyError(tr("Error while loading query results: %1").arg(window.errorText));
+        return;
+    }
+
+    if (!window.rows.isEmpty())
+    {
+        int rowIdx = rowCount();
+        for (const SqlResultsRowPtr& row : window.rows)
+            insertRow(rowIdx++, loadRow(row));
+
+        queryExecutor->registerPageBoundaries(nextWindow++, window.rows.first(), window.rows.last());
+    }
+
+    if (window.last)
+        stopStreaming();
+
+    evictWindows();
+}
+
+void SqlQueryModel::evictWindows()
+{
+    int rowsPerPage = getRowsPerPage();
+    int windowsToEvict = (rowCount() - MAX_LOADED_WINDOWS * rowsPerPage) / rowsPerPage;
+
+    // Only rows above the viewport are evicted. At least one row is left there, so the view is not scrolled to the top,
+    // which would make it load the preceding window.
+    int firstVisibleRow = view->rowAt(0);
+    windowsToEvict = qMin(windowsToEvict, (firstVisibleRow - 1) / rowsPerPage);
+    if (windowsToEvict <= 0)
+        return;
+
+    int rowsToEvict = windowsToEvict * rowsPerPage;
+
+    // Uncommitted changes would be lost
+    for (SqlQueryItem* item : getUncommittedItems())
+    {
+        if (item->index().row() < rowsToEvict)
+            return;
+    }
+
+    // Visible rows have to stay in place after rows above them are removed
+    QScrollBar* scrollBar = view->verticalScrollBar();
+    int scrollValue = scrollBar->value();
+    int scrollStep = (view->verticalScrollMode() == QAbstractItemView::ScrollPerPixel) ? view->verticalHeader()->defaultSectionSize() : 1;
+
+    removeRows(0, rowsToEvict);
+    scrollBar->setValue(scrollValue - rowsToEvict * scrollStep);
+
+    page += windowsToEvict;
+    rowNumBase = page * rowsPerPage + 1;
+    queryExecutor->setPage(page);
+    emit headerDataChanged(Qt::Vertical, 0, rowCount() - 1);
+}
+
+bool SqlQueryModel::isContinuousScrolling() const
+{
+    return continuousScrolling;
+}
+
+bool SqlQueryModel::canFetchMore(const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return false;
+
+    return prefetcher != nullptr;
+}
+
+void SqlQueryModel::fetchMore(const QModelIndex& parent)
+{
+    if (parent.isValid() || !prefetcher)
+        return;
+
+    StreamWindow window;
+    if (!prefetcher->takeWindow(window))
+    {
+        // Not read yet, it will be appended as soon as the Prefetcher provides it
+        fetchRequested = true;
+        return;
+    }
+
+    fetchRequested = false;
+    appendWindow(window);
+}
+
+bool SqlQueryModel::canFetchPrevious() const
+{
+    return continuousScrolling && page > 0 && allDataLoaded && !queryExecutor->isExecutionInProgress() &&
+            getUncommittedItems().isEmpty();
+}
+
+void SqlQueryModel::fetchPrevious()
+{
+    if (!canFetchPrevious())
+        return;
+
+    scrollToEndAfterLoad = true;
+    queryExecutor->setSkipRowCounting(true);
+    queryExecutor->setPage(page - 1);
+    reloadInternal();
+}
+
+void SqlQueryModel::handleWindowPrefetched()
+{
+    if (fetchRequested)
+        fetchMore(QModelIndex());
+}
+
+void SqlQueryModel::handleDbAboutToDisconnect(bool& deny)
+{
+    UNUSED(deny);
+
+    // Closing the database waits for read connections to be given back, while the Prefetcher waits for the model to take windows
+    stopStreaming();
+}
+
 int SqlQueryModel::getQueryCountLimitForSmartMode() const
 {
     return queryExecutor->getQueryCountLimitForSmartMode();
@@ -1801,3 +2091,140 @@ QStringList SqlQueryModel::CommitUpdateQueryBuilder::getAssignmentArgs() const
 {
     return assignmentArgs;
 }
+
+SqlQueryModel::Prefetcher::Prefetcher(SqlQueryModel* model, SqlQueryPtr results, int windowSize) :
+    model(model), results(results), windowSize(windowSize), queue(PREFETCHED_WINDOWS)
+{
+}
+
+SqlQueryModel::Prefetcher::Prefetcher(SqlQueryModel* model, Db* db, Db* readDb, const QString& query, const QHash<QString, QVariant>& args,
+                                      int rowsToSkip, int windowSize) :
+    model(model), db(db), readDb(readDb), query(query), args(args), rowsToSkip(rowsToSkip), windowSize(windowSize), queue(PREFETCHED_WINDOWS)
+{
+}
+
+bool SqlQueryModel::Prefetcher::takeWindow(SqlQueryModel::StreamWindow& window)
+{
+    return queue.tryPop(window);
+}
+
+void SqlQueryModel::Prefetcher::abort()
+{
+    queue.abort();
+}
+
+bool SqlQueryModel::Prefetcher::readsMainResults() const
+{
+    return query.isNull();
+}
+
+void SqlQueryModel::Prefetcher::interruptReading()
+{
+    // Main connection is shared with other queries, so only the read connection is interrupted
+    QMutexLocker locker(&readDbMutex);
+    if (readDb)
+        readDb->interrupt();
+}
+
+void SqlQueryModel::Prefetcher::run()
+{
+    if (readDb)
+    {
+        results = readDb->exec(query, args, Db::Flag::NO_LOCK);
+
+        // These rows were already loaded from results of the main connection
+        for (int i = 0; i < rowsToSkip && results->hasNext() && !queue.isAborted(); i++)
+            results->next();
+    }
+
+    StreamWindow window;
+    SqlResultsRowPtr row;
+    while (!window.last && !queue.isAborted())
+    {
+        window.rows.clear();
+        while (window.rows.size() < windowSize && results->hasNext())
+        {
+            row = results->next();
+            if (!row)
+                break;
+
+            window.rows << row;
+        }
+
+        if (results->isError() && !results->isInterrupted())
+        {
+            window.errorText = results->getErrorText();
+            window.last = true;
+        }
+        else
+        {
+            window.last = window.rows.size() < windowSize || !results->hasNext();
+        }
+
+        // Blocks while the queue is full, so rows are not read faster than the user scrolls
+        if (!queue.push(window))
+            break;
+
+        QMetaObject::invokeMethod(model, "handleWindowPrefetched", Qt::QueuedConnection);
+    }
+
+    results.clear();
+    releaseReadConnection();
+    queue.close();
+}
+
+void SqlQueryModel::Prefetcher::releaseReadConnection()
+{
+    if (!readDb)
+        return;
+
+    // Connection is given back in this thread, so closing the database can wait for it while blocking the GUI thread
+    QMutexLocker locker(&readDbMutex);
+    db->releaseReadConnection(readDb);
+    readDb = nullptr;
+}
+
+SqlQueryModel::CommitWorker::CommitWorker(Db* db, const QList<SqlQueryModel::CommitStatement>& statements) :
+    db(db), statements(statements), executedStatements(0)
+{
+}
+
+int SqlQueryModel::CommitWorker::getExecutedStatements() const
+{
+    return executedStatements.load();
+}
+
+int SqlQueryModel::CommitWorker::getFailedStatement() const
+{
+    return failedStatement;
+}
+
+QString SqlQueryModel::CommitWorker::getErrorText() const
+{
+    return errorText;
+}
+
+void SqlQueryModel::CommitWorker::run()
+{
+    QHash<QString,SqlQueryPtr> preparedQueries;
+    SqlQueryPtr query;
+    for (int i = 0, total = statements.size(); i < total; i++)
+    {
+        const CommitStatement& statement = statements[i];
+        query = preparedQueries.value(statement.query);
+        if (!query)
+        {
+            query = db->prepare(statement.query);
+            preparedQueries[statement.query] = query;
+        }
+
+        query->setArgs(statement.args);
+        if (!query->execute())
+        {
+            failedStatement = i;
+            errorText = query->getErrorText();
+            return;
+        }
+        executedStatements.store(i + 1);
+    }
+}
@@ -10,8 +10,11 @@
 #include "guiSQLiteStudio_global.h"
 #include "sqlqueryitemdelegate.h"
 #include "common/strhash.h"
+#include "common/boundedqueue.h"
 #include <QStandardItemModel>
 #include <QItemSelection>
+#include <QThread>
+#include <QAtomicInt>
 
 class SqlQueryItem;
 class FormView;
@@ -48,6 +51,18 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         qint64 getTotalRowsReturned();
         qint64 getTotalRowsAffected();
         qint64 getTotalPages();
+
+        /**
+         * @brief Tells if total number of rows (and pages) is just an estimation.
+         * @return true if exact counting of rows is still in progress (or was interrupted) and estimated count is provided.
+         */
+        bool isTotalRowsEstimated() const;
+
+        /**
+         * @brief Tells if total number of rows is known at all.
+         * @return false if counting of rows was interrupted before even an estimated count was available.
+         */
+        bool isTotalRowsKnown() const;
         QList<SqlQueryModelColumnPtr> getColumns();
         SqlQueryItem* itemFromIndex(const QModelIndex& index) const;
         SqlQueryItem* itemFromIndex(int row, int column) const;
@@ -145,6 +160,44 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         int getQueryCountLimitForSmartMode() const;
         void setQueryCountLimitForSmartMode(int value);
 
+        /**
+         * @brief Tells if recently loaded results are browsed with continuous scrolling, instead of pages.
+         * @return true if continuous scrolling is used.
+         *
+         * In this mode the query is executed once and its results are read ahead in the background
+         * while the user scrolls down (see fetchMore()). Only a limited number of windows (each of "rows per page" size)
+         * is kept in the model. Rows scrolled far above the viewport are evicted and read again by seeking
+         * to the preceding window (see fetchPrevious()) when the user scrolls back up to them.
+         */
+        bool isContinuousScrolling() const;
+
+        bool canFetchMore(const QModelIndex& parent) const;
+        void fetchMore(const QModelIndex& parent);
+
+        /**
+         * @brief Tells if there are evicted rows above the first row of the model.
+         * @return true if fetchPrevious() can be called.
+         */
+        bool canFetchPrevious() const;
+
+        /**
+         * @brief Loads the window of rows preceding the first row of the model.
+         *
+         * The query is executed again starting from the preceding window and the view is scrolled to the end of that window,
+         * so the user can continue scrolling up. This is used only when the user scrolls back to the evicted rows.
+         */
+        void fetchPrevious();
+
+        /**
+         * @brief Stops reading results in the continuous scrolling mode.
+         *
+         * Query statement read by the Prefetcher is finalized, so it doesn't keep the table locked. If it's read
+         * in a read connection, the statement is interrupted, otherwise this method waits until reading of the current
+         * window is finished. It has to be called before the structure of browsed table is modified. Rows that are already loaded stay
+         * in the model, but no more rows are loaded until the query is executed again.
+         */
+        void stopStreaming();
+
     protected:
         class CommitUpdateQueryBuilder : public RowIdConditionBuilder
         {
@@ -166,6 +219,40 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
                 QStringList assignmentArgs;
         };
 
+        /**
+         * @brief Statement modifying the database, executed while committing data changes.
+         *
+         * Statements are collected for all committed rows first and then executed in order by the CommitWorker.
+         */
+        struct CommitStatement
+        {
+            QString query;
+            QHash<QString,QVariant> args;
+
+            /**
+             * @brief Items marked with committing error if the statement fails.
+             */
+            QList<SqlQueryItem*> items;
+
+            /**
+             * @brief Table of the updated row. It's used together with rowId and newRowId.
+             */
+            AliasedTable table;
+
+            /**
+             * @brief RowId of the updated row.
+             */
+            RowId rowId;
+
+            /**
+             * @brief RowId that the row has after the statement was executed.
+             *
+             * If it's different than rowId (because the statement modified ROWID or PRIMARY KEY columns),
+             * then items of the row are updated with this RowId after successful execution.
+             */
+            RowId newRowId;
+        };
+
         /**
          * @brief commitAddedRow Inserts new row to a table.
          * @param itemsInRow All cells for the new row.
@@ -179,25 +266,29 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         virtual bool commitAddedRow(const QList<SqlQueryItem*>& itemsInRow);
 
         /**
-         * @brief commitEditedRow Updates table row with new values.
+         * @brief getEditedRowStatements Provides statements updating table row with new values.
          * @param itemsInRow Modified cell values.
-         * @return true on success, false on failure.
+         * @param statements List to append statements to.
+         * @return true on success, false if the row cannot be committed.
          * Default implementation should be okay for most cases. It takes all modified cells and updates their
          * values in table basing on the ROWID, database, table and column names - which are all available,
          * unless the cell doesn't referr to the table, but in that case the cell should not be editable for user anyway.
          * <b>Important</b> thing to pay attention to is that the item list passed in arguments contains <b>only modified items</b>.
+         *
+         * Rows with the same set of modified columns get the same UPDATE query, so it's prepared only once for all of them.
          */
-        virtual bool commitEditedRow(const QList<SqlQueryItem*>& itemsInRow);
+        virtual bool getEditedRowStatements(const QList<SqlQueryItem*>& itemsInRow, QList<CommitStatement>& statements);
 
         /**
-         * @brief commitDeletedRow Deletes row from the table.
-         * @param itemsInRow All cells for the deleted row.
-         * @return true on success, false on failure.
-         * Default implementation gets rid of row items from the model and that's all.
+         * @brief getDeletedRowsStatements Provides statements deleting rows from the table.
+         * @param rows All cells for each of deleted rows.
+         * @param statements List to append statements to.
+         * @return true on success, false if rows cannot be committed.
+         * Default implementation provides no statements, so the rows are only removed from the model after commit.
          * Inheriting class can reimplement this, so for example model specialized for single table can delete rows.
-         * The method implementation should delete the row from the database.
+         * The method implementation should provide statements deleting the rows from the database.
          */
-        virtual bool commitDeletedRow(const QList<SqlQueryItem*>& itemsInRow);
+        virtual bool getDeletedRowsStatements(const QList<QList<SqlQueryItem*>>& rows, QList<CommitStatement>& statements);
 
         /**
          * @brief rollbackAddedRow
@@ -252,6 +343,86 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         static const int cellDataLengthLimit = 100;
 
     private:
+        /**
+         * @brief Rows read ahead by the Prefetcher, appended to the model all at once.
+         *
+         * The last window has the "last" flag set. If reading failed, the errorText is set and the window is the last one.
+         */
+        struct StreamWindow
+        {
+            QList<SqlResultsRowPtr> rows;
+            QString errorText;
+            bool last = false;
+        };
+
+        /**
+         * @brief Thread executing statements of the commit.
+         *
+         * Each distinct query is prepared once and then executed with arguments of all statements using it.
+         * Statements are executed within the transaction started by the model.
+         */
+        class CommitWorker : public QThread
+        {
+            public:
+                CommitWorker(Db* db, const QList<CommitStatement>& statements);
+
+                int getExecutedStatements() const;
+                int getFailedStatement() const;
+                QString getErrorText() const;
+
+            protected:
+                void run();
+
+            private:
+                Db* db = nullptr;
+                const QList<CommitStatement>& statements;
+                QAtomicInt executedStatements;
+                int failedStatement = -1;
+                QString errorText;
+        };
+
+        /**
+         * @brief Thread reading results in the continuous scrolling mode.
+         *
+         * It keeps the query statement open and reads windows of rows ahead of the ones displayed,
+         * so they are ready when the user scrolls down to the end of loaded rows.
+         * The model is notified about each window with handleWindowPrefetched().
+         * Once the queue of windows is full (the user doesn't scroll), the thread waits until the model takes a window.
+         *
+         * If possible, the query is executed again in a read connection owned by the Prefetcher, so the statement
+         * doesn't keep the main connection busy and it can be interrupted without affecting other queries.
+         * Otherwise results of the main connection are read.
+         */
+        class Prefetcher : public QThread
+        {
+            public:
+                Prefetcher(SqlQueryModel* model, SqlQueryPtr results, int windowSize);
+                Prefetcher(SqlQueryModel* model, Db* db, Db* readDb, const QString& query, const QHash<QString,QVariant>& args,
+                           int rowsToSkip, int windowSize);
+
+                bool takeWindow(StreamWindow& window);
+                void abort();
+                void interruptReading();
+                bool readsMainResults() const;
+
+            protected:
+                void run();
+
+            private:
+                void releaseReadConnection();
+
+                SqlQueryModel* model = nullptr;
+                Db* db = nullptr;
+                Db* readDb = nullptr;
+                QMutex readDbMutex;
+                QString query;
+                QHash<QString,QVariant> args;
+                int rowsToSkip = 0;
+                SqlQueryPtr results;
+                int windowSize = 0;
+                BoundedQueue<StreamWindow> queue;
+        };
+
         struct TableDetails
         {
             struct ColumnDetails
@@ -283,7 +454,7 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         QList<AliasedTable> getTablesForColumns();
         QList<bool> getColumnEditionEnabledList();
         QList<SqlQueryItem*> toItemList(const QModelIndexList& indexes) const;
-        bool commitRow(const QList<SqlQueryItem*>& itemsInRow);
+        bool execCommitStatements(const QList<CommitStatement>& statements, int& step);
         void rollbackRow(const QList<SqlQueryItem*>& itemsInRow);
         void storeStep1NumbersFromExecution();
         void storeStep2NumbersFromExecution();
@@ -300,6 +471,27 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
         int getInsertRowIndex();
         void notifyItemEditionEnded(const QModelIndex& idx);
         int getRowsPerPage() const;
+        bool isContinuousScrollingEnabled() const;
+        void startStreaming(SqlQueryPtr results);
+        void appendWindow(const StreamWindow& window);
+        void evictWindows();
+
+        /**
+         * @brief Number of windows read ahead by the Prefetcher.
+         */
+        static const int PREFETCHED_WINDOWS = 2;
+
+        /**
+         * @brief Maximum number of windows kept in the model in the continuous scrolling mode.
+         *
+         * Rows above that are evicted from the model, so memory usage doesn't grow while scrolling through large results.
+         */
+        static const int MAX_LOADED_WINDOWS = 5;
+
+        /**
+         * @brief Interval of commit progress updates, in milliseconds.
+         */
+        static const int COMMIT_PROGRESS_INTERVAL = 100;
 
         QString query;
         bool explain = false;
@@ -351,6 +543,18 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
          */
         int totalPages = -1;
 
+        /**
+         * @brief totalRowsEstimated
+         * Tells if totalRowsReturned and totalPages are only estimated (exact counting is in progress, or was interrupted).
+         */
+        bool totalRowsEstimated = false;
+
+        /**
+         * @brief totalRowsKnown
+         * Tells if totalRowsReturned means anything. It's false when counting was interrupted without any estimation.
+         */
+        bool totalRowsKnown = true;
+
         /**
          * @brief page
          * The page variable keeps page of recently sucessfly loaded data.
@@ -402,6 +606,33 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
 
         bool structureOutOfDate = false;
 
+        /**
+         * @brief Tells if continuous scrolling mode was used for the recently loaded results.
+         */
+        bool continuousScrolling = false;
+
+        /**
+         * @brief Reads results ahead in the continuous scrolling mode.
+         *
+         * It's null if results are not streamed, or if all of them were already loaded.
+         */
+        Prefetcher* prefetcher = nullptr;
+
+        /**
+         * @brief Index of the window to be appended next in the continuous scrolling mode.
+         */
+        int nextWindow = 0;
+
+        /**
+         * @brief Tells that the view asked for more rows, but the Prefetcher didn't provide them yet.
+         */
+        bool fetchRequested = false;
+
+        /**
+         * @brief Tells that the view should be scrolled to the last row after data is loaded (see fetchPrevious()).
+         */
+        bool scrollToEndAfterLoad = false;
+
         /**
          * @brief Set of existing model objects, updated for each construction and destruction.
          *
@@ -414,7 +645,9 @@ class GUI_API_EXPORT SqlQueryModel : public QStandardItemModel
     private slots:
         void handleExecFinished(SqlQueryPtr results);
         void handleExecFailed(int code, QString errorMessage);
-        void resultsCountingFinished(quint64 rowsAffected, quint64 rowsReturned, int totalPages);
+        void resultsCountingFinished(quint64 rowsAffected, quint64 rowsReturned, int totalPages, bool estimated);
+        void handleWindowPrefetched();
+        void handleDbAboutToDisconnect(bool& deny);
 
     public slots:
         void itemValueEdited(SqlQueryItem* item);
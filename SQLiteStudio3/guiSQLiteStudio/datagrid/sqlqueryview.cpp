@@ -15,6 +15,7 @@
 #include "windows/editorwindow.h"
 #include "mainwindow.h"
 #include "common/utils_sql.h"
+#include "common/utils.h"
 #include "querygenerator.h"
 #include "services/codeformatter.h"
 #include <QHeaderView>
@@ -29,6 +30,12 @@
 #include <QMenu>
 #include <QMimeData>
 #include <QCryptographicHash>
+#include <QScrollBar>
+#include <QFile>
+#include <QFileDialog>
+#include <QScopedPointer>
+#include <QMessageBox>
+#include <QTemporaryFile>
 
 CFG_KEYS_DEFINE(SqlQueryView)
 
@@ -58,6 +65,8 @@ void SqlQueryView::init()
     connect(this, &QWidget::customContextMenuRequested, this, &SqlQueryView::customContextMenuRequested);
     connect(CFG_UI.Fonts.DataView, SIGNAL(changed(QVariant)), this, SLOT(updateFont()));
     connect(this, SIGNAL(activated(QModelIndex)), this, SLOT(itemActivated(QModelIndex)));
+    connect(verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(fetchPrecedingRowsIfNeeded()));
+    connect(verticalScrollBar(), SIGNAL(sliderReleased()), this, SLOT(fetchPrecedingRowsIfNeeded()));
 
     horizontalHeader()->setSortIndicatorShown(false);
     horizontalHeader()->setSectionsClickable(true);
@@ -83,6 +92,8 @@ void SqlQueryView::createActions()
     createAction(SET_NULL, ICONS.SET_NULL, tr("Set NULL values"), this, SLOT(setNull()), this);
     createAction(ERASE, ICONS.ERASE, tr("Erase values"), this, SLOT(erase()), this);
     createAction(OPEN_VALUE_EDITOR, ICONS.OPEN_VALUE_EDITOR, tr("Edit value in editor"), this, SLOT(openValueEditor()), this);
+    createAction(SAVE_VALUE_TO_FILE, ICONS.SAVE_SQL_FILE, tr("Save value to file"), this, SLOT(saveValueToFile()), this);
+    createAction(LOAD_VALUE_FROM_FILE, ICONS.OPEN_SQL_FILE, tr("Load value from file"), this, SLOT(loadValueFromFile()), this);
     createAction(COMMIT, ICONS.COMMIT, tr("Commit"), this, SLOT(commit()), this);
     createAction(ROLLBACK, ICONS.ROLLBACK, tr("Rollback"), this, SLOT(rollback()), this);
     createAction(SELECTIVE_COMMIT, ICONS.COMMIT, tr("Commit selected cells"), this, SLOT(selectiveCommit()), this);
@@ -110,8 +121,6 @@ void SqlQueryView::setupDefShortcuts()
 
 void SqlQueryView::setupActionsForMenu(SqlQueryItem* currentItem, const QList<SqlQueryItem*>& selectedItems)
 {
-    UNUSED(currentItem);
-
     // Selected items count
     int selCount = selectedItems.size();
 
@@ -145,6 +154,12 @@ void SqlQueryView::setupActionsForMenu(SqlQueryItem* currentItem, const QList<Sq
         contextMenu->addAction(actionMap[ERASE]);
         contextMenu->addAction(actionMap[SET_NULL]);
         contextMenu->addAction(actionMap[OPEN_VALUE_EDITOR]);
+        if (selCount == 1 && currentItem)
+        {
+            contextMenu->addAction(actionMap[SAVE_VALUE_TO_FILE]);
+            if (!simpleBrowserMode && currentItem->getColumn()->canEdit())
+                contextMenu->addAction(actionMap[LOAD_VALUE_FROM_FILE]);
+        }
         contextMenu->addSeparator();
     }
 
@@ -292,6 +307,18 @@ void SqlQueryView::generateDelete()
     MAINWINDOW->openSqlEditor(getModel()->getDb(), sql);
 }
 
+void SqlQueryView::fetchPrecedingRowsIfNeeded()
+{
+    // Evicted rows are loaded when user scrolls up to the top (not while dragging the slider, same as for fetchMore())
+    QScrollBar* scrollBar = verticalScrollBar();
+    if (scrollBar->isSliderDown() || scrollBar->value() > scrollBar->minimum())
+        return;
+
+    SqlQueryModel* model = getModel();
+    if (model && model->canFetchPrevious())
+        model->fetchPrevious();
+}
+
 bool SqlQueryView::editInEditorIfNecessary(SqlQueryItem* item)
 {
     if (item->getColumn()->dataType.getType() == DataType::BLOB)
@@ -671,12 +698,43 @@ void SqlQueryView::openValueEditor(SqlQueryItem* item)
     MultiEditorDialog editor(this);
     editor.setWindowTitle(tr("Edit value"));
     editor.setDataType(item->getColumn()->dataType);
-    editor.setValue(item->getFullValue());
+
+    // Huge values are copied from the database into a file in portions and the editor reads them from there,
+    // instead of loading them into memory at once. The value is not kept open in the database while the dialog is shown,
+    // as it would keep the table locked.
+    QTemporaryFile valueFile;
+    bool streamed = copyValueToFile(item, &valueFile) && editor.setValueDevice(&valueFile);
+    if (!streamed)
+        editor.setValue(item->getFullValue());
+
     editor.setReadOnly(!item->getColumn()->canEdit());
     if (editor.exec() == QDialog::Rejected)
         return;
 
-    item->setValue(editor.getValue());
+    if (!streamed)
+    {
+        item->setValue(editor.getValue());
+        return;
+    }
+
+    if (!editor.isModified())
+        return;
+
+    if (editor.isNull())
+    {
+        item->setValue(QVariant());
+        return;
+    }
+
+    QTemporaryFile editedFile;
+    QString errorText;
+    if (!editedFile.open() || !editor.writeValue(&editedFile, errorText) || !editedFile.seek(0))
+    {
+        notifyError(tr("Could not store edited value: %1").arg(errorText.isEmpty() ? editedFile.errorString() : errorText));
+        return;
+    }
+
+    setValueFromDevice(item, &editedFile);
 }
 
 void SqlQueryView::openValueEditor()
@@ -685,6 +743,226 @@ void SqlQueryView::openValueEditor()
     openValueEditor(currentItem);
 }
 
+void SqlQueryView::saveValueToFile()
+{
+    SqlQueryItem* item = getCurrentItem();
+    if (!item)
+        return;
+
+    QString filePath = QFileDialog::getSaveFileName(this, tr("Save value to file"), getFileDialogInitPath());
+    if (filePath.isNull())
+        return;
+
+    setFileDialogInitPathByFile(filePath);
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly|QIODevice::Truncate))
+    {
+        notifyError(tr("Could not open file %1 for writing: %2").arg(filePath, file.errorString()));
+        return;
+    }
+
+    QScopedPointer<QIODevice> blob(openBlob(item, QIODevice::ReadOnly));
+    if (blob)
+    {
+        if (!copyContents(blob.data(), &file))
+        {
+            notifyError(tr("Could not save value to file %1: %2").arg(filePath, file.errorString()));
+            return;
+        }
+    }
+    else
+    {
+        QVariant value = item->getFullValue();
+        QByteArray bytes = (value.type() == QVariant::ByteArray) ? value.toByteArray() : value.toString().toUtf8();
+        if (file.write(bytes) != bytes.size())
+        {
+            notifyError(tr("Could not save value to file %1: %2").arg(filePath, file.errorString()));
+            return;
+        }
+    }
+
+    notifyInfo(tr("Value saved to file %1").arg(filePath));
+}
+
+void SqlQueryView::loadValueFromFile()
+{
+    if (simpleBrowserMode)
+        return;
+
+    SqlQueryItem* item = getCurrentItem();
+    if (!item || !item->getColumn()->canEdit())
+        return;
+
+    QString filePath = QFileDialog::getOpenFileName(this, tr("Load value from file"), getFileDialogInitPath());
+    if (filePath.isNull())
+        return;
+
+    setFileDialogInitPathByFile(filePath);
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        notifyError(tr("Could not open file %1 for reading: %2").arg(filePath, file.errorString()));
+        return;
+    }
+
+    if (setValueFromDevice(item, &file))
+        notifyInfo(tr("Value loaded from file %1 and stored in the database.").arg(filePath));
+}
+
+bool SqlQueryView::copyValueToFile(SqlQueryItem* item, QFile* file)
+{
+    QScopedPointer<QIODevice> blob(openBlob(item, QIODevice::ReadOnly));
+    if (!blob)
+        return false;
+
+    if (!file->open(QIODevice::ReadWrite) || !copyContents(blob.data(), file) || !file->seek(0))
+    {
+        qWarning() << "Could not copy value to file" << file->fileName() << ":"
+                   << (blob->errorString().isEmpty() ? file->errorString() : blob->errorString());
+        file->close();
+        return false;
+    }
+    return true;
+}
+
+bool SqlQueryView::setValueFromDevice(SqlQueryItem* item, QIODevice* device)
+{
+    if (device->size() < DIRECT_BLOB_LOAD_THRESHOLD || !canUseBlobIo(item))
+    {
+        item->setValue(device->readAll());
+        return false;
+    }
+
+    if (!loadValueIntoBlob(item, device))
+        return false;
+
+    // The cell keeps only a limited preview of the value, just like when it was loaded from the database
+    device->seek(0);
+    item->setValue(device->read(SqlQueryModel::getCellDataLengthLimit()), true, true);
+    return true;
+}
+
+bool SqlQueryView::loadValueIntoBlob(SqlQueryItem* item, QIODevice* file)
+{
+    static_qstring(sqlTpl, "UPDATE %1 SET %2 = zeroblob(:blobSize) WHERE %3");
+    static_qstring(savepointSql, "SAVEPOINT load_value_into_blob");
+    static_qstring(releaseSql, "RELEASE load_value_into_blob");
+    static_qstring(rollbackSql, "ROLLBACK TO load_value_into_blob");
+
+    // Such value would have to be kept in memory until the grid is committed, so it's written directly into the database instead
+    QString question = tr("The value has %1. It's too large to be kept in memory until the commit, so it will be written directly "
+                          "into the database and it cannot be rolled back from the data grid. If there is a transaction open "
+                          "in the database, the value will become a part of it. Do you want to continue?")
+            .arg(formatFileSize(file->size()));
+
+    if (QMessageBox::question(this, tr("Large value"), question, QMessageBox::Yes|QMessageBox::No) != QMessageBox::Yes)
+        return false;
+
+    Db* db = getModel()->getDb();
+    SqlQueryModelColumn* col = item->getColumn();
+    Dialect dialect = db->getDialect();
+
+    QString source = wrapObjIfNeeded(col->table, dialect);
+    if (!col->database.isNull())
+        source.prepend(wrapObjIfNeeded(col->database, dialect)+".");
+
+    RowIdConditionBuilder rowIdBuilder;
+    rowIdBuilder.setRowId(item->getRowId());
+    QString condition = rowIdBuilder.build();
+    QHash<QString, QVariant> args = rowIdBuilder.getQueryArgs();
+    args[":blobSize"] = file->size();
+
+    // Unlike BEGIN, the savepoint works also within a transaction started by the user
+    SqlQueryPtr results = db->exec(savepointSql);
+    if (results->isError())
+    {
+        notifyError(tr("Could not store value in the database: %1").arg(results->getErrorText()));
+        return false;
+    }
+
+    // Space for the value is reserved first, then it's filled in chunks, so the whole file never sits in memory
+    results = db->exec(sqlTpl.arg(source, wrapObjIfNeeded(col->column, dialect), condition), args);
+    QString errorText;
+    if (results->isError())
+    {
+        errorText = results->getErrorText();
+    }
+    else
+    {
+        QScopedPointer<QIODevice> blob(openBlob(item, QIODevice::ReadWrite));
+        if (!blob)
+            errorText = db->getErrorText();
+        else if (!copyContents(file, blob.data()))
+            errorText = blob->errorString().isEmpty() ? file->errorString() : blob->errorString();
+    }
+
+    if (!errorText.isNull())
+    {
+        notifyError(tr("Could not store value in the database: %1").arg(errorText));
+        db->exec(rollbackSql);
+        db->exec(releaseSql);
+        return false;
+    }
+
+    results = db->exec(releaseSql);
+    if (results->isError())
+    {
+        notifyError(tr("Could not store value in the database: %1").arg(results->getErrorText()));
+        db->exec(rollbackSql);
+        db->exec(releaseSql);
+        return false;
+    }
+    return true;
+}
+
+bool SqlQueryView::canUseBlobIo(SqlQueryItem* item)
+{
+    if (!item || item->isUncommitted() || item->isNewRow() || !item->getColumn()->canEdit())
+        return false;
+
+    // Incremental I/O addresses values by the ROWID, so tables WITHOUT ROWID are excluded
+    RowId rowId = item->getRowId();
+    return rowId.size() == 1 && rowId.contains("ROWID");
+}
+
+QIODevice* SqlQueryView::openBlob(SqlQueryItem* item, QIODevice::OpenMode mode)
+{
+    if (!canUseBlobIo(item))
+        return nullptr;
+
+    // Only values that were truncated for the grid are worth streaming, except when writing new contents
+    if (!mode.testFlag(QIODevice::WriteOnly) && (!item->isLimitedValue() || item->getValue().type() != QVariant::ByteArray))
+        return nullptr;
+
+    Db* db = getModel()->getDb();
+    if (!db || !db->isValid())
+        return nullptr;
+
+    SqlQueryModelColumn* col = item->getColumn();
+    QIODevice* blob = db->openBlob(col->database, col->table, col->column, item->getRowId()["ROWID"].toLongLong(), mode);
+    if (!blob)
+        qWarning() << "Could not open value for incremental I/O:" << db->getErrorText();
+
+    return blob;
+}
+
+bool SqlQueryView::copyContents(QIODevice* from, QIODevice* to)
+{
+    QByteArray buffer;
+    while (!from->atEnd())
+    {
+        buffer = from->read(BLOB_IO_CHUNK_SIZE);
+        if (buffer.isEmpty())
+            return false;
+
+        if (to->write(buffer) != buffer.size())
+            return false;
+    }
+    return true;
+}
+
 int qHash(SqlQueryView::Action action)
 {
     return static_cast<int>(action);
@@ -7,6 +7,7 @@
 #include "guiSQLiteStudio_global.h"
 #include "common/table.h"
 #include <QTableView>
+#include <QIODevice>
 
 class SqlQueryItemDelegate;
 class SqlQueryItem;
@@ -16,6 +17,7 @@ class SqlQueryModelColumn;
 class QPushButton;
 class QProgressBar;
 class QMenu;
+class QFile;
 
 CFG_KEY_LIST(SqlQueryView, QObject::tr("Data grid view"),
     CFG_KEY_ENTRY(COPY,              Qt::CTRL + Qt::Key_C,              QObject::tr("Copy cell(s) contents to clipboard"))
@@ -53,6 +55,8 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
             SELECTIVE_COMMIT,
             SELECTIVE_ROLLBACK,
             OPEN_VALUE_EDITOR,
+            SAVE_VALUE_TO_FILE,
+            LOAD_VALUE_FROM_FILE,
             SORT_DIALOG,
             RESET_SORTING,
             GENERATE_SELECT,
@@ -90,6 +94,26 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
         void paste(const QList<QList<QVariant>>& data);
         void addFkActionsToContextMenu(SqlQueryItem* currentItem);
         void goToReferencedRow(const QString& table, const QString& column, const QVariant& value);
+        bool canUseBlobIo(SqlQueryItem* item);
+        QIODevice* openBlob(SqlQueryItem* item, QIODevice::OpenMode mode);
+        bool copyValueToFile(SqlQueryItem* item, QFile* file);
+        bool setValueFromDevice(SqlQueryItem* item, QIODevice* device);
+        bool loadValueIntoBlob(SqlQueryItem* item, QIODevice* file);
+
+        static bool copyContents(QIODevice* from, QIODevice* to);
+
+        /**
+         * @brief Size of a single read/write when streaming values between cells and files.
+         */
+        static const int BLOB_IO_CHUNK_SIZE = 1048576;
+
+        /**
+         * @brief Minimum size of a value to be written directly into the database, when it's loaded from file or edited in the editor.
+         *
+         * Smaller values are loaded as a regular (uncommitted) cell change. Larger ones are written only after the user confirms it,
+         * as they bypass the commit and rollback of the grid.
+         */
+        static const qint64 DIRECT_BLOB_LOAD_THRESHOLD = 16777216;
 
         constexpr static const char* mimeDataId = "application/x-sqlitestudio-data-view-data";
 
@@ -116,6 +140,9 @@ class GUI_API_EXPORT SqlQueryView : public QTableView, public ExtActionContainer
         void generateInsert();
         void generateUpdate();
         void generateDelete();
+        void fetchPrecedingRowsIfNeeded();
+        void saveValueToFile();
+        void loadValueFromFile();
 
     public slots:
         void executionStarted();
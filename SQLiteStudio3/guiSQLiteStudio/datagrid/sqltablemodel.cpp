@@ -103,46 +103,74 @@ bool SqlTableModel::commitAddedRow(const QList<SqlQueryItem*>& itemsInRow)
     return true;
 }
 
-bool SqlTableModel::commitDeletedRow(const QList<SqlQueryItem*>& itemsInRow)
+bool SqlTableModel::getDeletedRowsStatements(const QList<QList<SqlQueryItem*>>& rows, QList<CommitStatement>& statements)
 {
-    if (itemsInRow.size() == 0)
+    static_qstring(batchSql, "DELETE FROM %1 WHERE %2 IN (%3);");
+    static_qstring(argTpl, ":rowIdArg%1");
+
+    Dialect dialect = db->getDialect();
+    QString wrappedTable = wrapObjIfNeeded(table, dialect);
+
+    // Rows identified by a single column (ROWID, or single column PRIMARY KEY of WITHOUT ROWID table) are deleted in batches
+    // Items of the rows are kept along with their keys, so the rows of a failed batch are marked with the error
+    QHash<QString,QList<QVariant>> keysByColumn;
+    QHash<QString,QList<QList<SqlQueryItem*>>> itemsByColumn;
+    QStringList keyColumns;
+    RowId rowId;
+    CommitStatement statement;
+    for (const QList<SqlQueryItem*>& itemsInRow : rows)
     {
-        qCritical() << "Tried to SqlTableModel::commitDeletedRow() with number of items equal to 0!";
-        return false;
-    }
+        if (itemsInRow.size() == 0)
+        {
+            qCritical() << "Tried to SqlTableModel::getDeletedRowsStatements() with number of items in row equal to 0!";
+            return false;
+        }
 
-    // This should not happen anymore (since WITHOUT ROWID tables should be handled properly now,
-    // but we will keep this here for a while, just in case.
-//    if (itemsInRow[0]->isJustInsertedWithOutRowId())
-//    {
-//        QString msg = tr("When inserted new row to the WITHOUT ROWID table, using DEFAULT value for PRIMARY KEY, "
-//                         "the table has to be reloaded in order to delete the new row.");
-//        notifyError(tr("Error while deleting row from table %1: %2").arg(table).arg(msg));
-//        return false;
-//    }
-
-    RowId rowId = itemsInRow[0]->getRowId();
-    if (rowId.isEmpty())
-        return false;
+        rowId = itemsInRow[0]->getRowId();
+        if (rowId.isEmpty())
+            return false;
 
-    Dialect dialect = db->getDialect();
+        if (rowId.size() == 1)
+        {
+            if (!keysByColumn.contains(rowId.begin().key()))
+                keyColumns << rowId.begin().key();
+
+            keysByColumn[rowId.begin().key()] << rowId.begin().value();
+            itemsByColumn[rowId.begin().key()] << itemsInRow;
+            continue;
+        }
 
-    CommitDeleteQueryBuilder queryBuilder;
-    queryBuilder.setTable(wrapObjIfNeeded(table, dialect));
-    queryBuilder.setRowId(rowId);
+        CommitDeleteQueryBuilder queryBuilder;
+        queryBuilder.setTable(wrappedTable);
+        queryBuilder.setRowId(rowId);
 
-    QString sql = queryBuilder.build();
-    QHash<QString, QVariant> args = queryBuilder.getQueryArgs();
+        statement.query = queryBuilder.build();
+        statement.args = queryBuilder.getQueryArgs();
+        statement.items = itemsInRow;
+        statements << statement;
+    }
 
-    SqlQueryPtr result = db->exec(sql, args);
-    if (result->isError())
+    QStringList args;
+    for (const QString& keyColumn : keyColumns)
     {
-        notifyError(tr("Error while deleting row from table %1: %2").arg(table).arg(result->getErrorText()));
-        return false;
-    }
+        const QList<QVariant>& keys = keysByColumn[keyColumn];
+        const QList<QList<SqlQueryItem*>>& keyItems = itemsByColumn[keyColumn];
+        for (int batchStart = 0, total = keys.size(); batchStart < total; batchStart += DELETE_BATCH_SIZE)
+        {
+            args.clear();
+            statement.args.clear();
+            statement.items.clear();
+            for (int i = batchStart, batchEnd = qMin(total, batchStart + DELETE_BATCH_SIZE); i < batchEnd; i++)
+            {
+                args << argTpl.arg(i - batchStart);
+                statement.args[args.last()] = keys[i];
+                statement.items += keyItems[i];
+            }
 
-    if (!SqlQueryModel::commitDeletedRow(itemsInRow))
-        qCritical() << "Could not delete row from SqlQueryView while committing row deletion.";
+            statement.query = batchSql.arg(wrappedTable, keyColumn, args.join(", "));
+            statements << statement;
+        }
+    }
 
     return true;
 }
@@ -27,7 +27,7 @@ class GUI_API_EXPORT SqlTableModel : public SqlQueryModel
 
     protected:
         bool commitAddedRow(const QList<SqlQueryItem*>& itemsInRow);
-        bool commitDeletedRow(const QList<SqlQueryItem*>& itemsInRow);
+        bool getDeletedRowsStatements(const QList<QList<SqlQueryItem*>>& rows, QList<CommitStatement>& statements);
 
     private:
         class CommitDeleteQueryBuilder : public CommitUpdateQueryBuilder
@@ -54,6 +54,13 @@ class GUI_API_EXPORT SqlTableModel : public SqlQueryModel
         QString getDatabasePrefix();
         QString getDataSource();
 
+        /**
+         * @brief Maximum number of rows deleted by a single DELETE statement.
+         *
+         * Each row takes one bound parameter and SQLite limits their number (999 by default in older versions).
+         */
+        static const int DELETE_BATCH_SIZE = 500;
+
         QString table;
         QString database;
         bool isWithOutRowIdTable = false;
@@ -442,6 +442,11 @@ void DataView::updateGridNavigationState()
     bool reloadResultsAvailable = model->canReload();
     bool pageNumEditAvailable = (prevResultsAvailable || nextResultsAvailable);
 
+    // With continuous scrolling rows are loaded while scrolling, there are no pages to navigate
+    bool pagingVisible = !model->isContinuousScrolling();
+    for (Action act : {FIRST_PAGE, PREV_PAGE, PAGE_EDIT, NEXT_PAGE, LAST_PAGE})
+        actionMap[act]->setVisible(pagingVisible);
+
     actionMap[PAGE_EDIT]->setEnabled(navigationState && totalPagesAvailable && pageNumEditAvailable);
     actionMap[REFRESH_DATA]->setEnabled(navigationState && reloadResultsAvailable);
     actionMap[NEXT_PAGE]->setEnabled(navigationState && totalPagesAvailable && nextResultsAvailable);
@@ -593,9 +598,19 @@ void DataView::updatePageEdit()
     updateCurrentFormViewRow();
 }
 
-void DataView::updateResultsCount(int resultsCount)
+void DataView::updateResultsCount(int resultsCount, bool estimated)
 {
-    if (resultsCount >= 0)
+    if (resultsCount >= 0 && estimated)
+    {
+        QString msg = QObject::tr("Total rows loaded: ~%1").arg(resultsCount);
+        rowCountLabel->setText(msg);
+        formViewRowCountLabel->setText(msg);
+
+        static QString estimatedMsg = tr("Number of rows is estimated from the database statistics.");
+        rowCountLabel->setToolTip(estimatedMsg);
+        formViewRowCountLabel->setToolTip(estimatedMsg);
+    }
+    else if (resultsCount >= 0)
     {
         QString msg = QObject::tr("Total rows loaded: %1").arg(resultsCount);
         rowCountLabel->setText(msg);
@@ -616,6 +631,17 @@ void DataView::updateResultsCount(int resultsCount)
     }
 }
 
+void DataView::updateResultsCountUnknown()
+{
+    QString msg = QObject::tr("Total rows loaded: unknown");
+    rowCountLabel->setText(msg);
+    formViewRowCountLabel->setText(msg);
+
+    static QString unknownMsg = tr("Counting of rows was interrupted.\nBrowsing next pages will be possible after the data is refreshed.");
+    rowCountLabel->setToolTip(unknownMsg);
+    formViewRowCountLabel->setToolTip(unknownMsg);
+}
+
 void DataView::updateCurrentFormViewRow()
 {
     int rowsPerPage = CFG_UI.General.NumberOfRowsPerPage.get();
@@ -673,7 +699,11 @@ void DataView::executionSuccessful()
 
 void DataView::totalRowsAndPagesAvailable()
 {
-    updateResultsCount(model->getTotalRowsReturned());
+    if (model->isTotalRowsKnown())
+        updateResultsCount(model->getTotalRowsReturned(), model->isTotalRowsEstimated());
+    else
+        updateResultsCountUnknown();
+
     totalPagesAvailable = true;
     updatePageEdit();
     updateNavigationState();
@@ -129,7 +129,8 @@ class GUI_API_EXPORT DataView : public QTabWidget, public ExtActionContainer
         void updateGridNavigationState();
         void goToPage(const QString& pageStr);
         void updatePageEdit();
-        void updateResultsCount(int resultsCount);
+        void updateResultsCount(int resultsCount, bool estimated = false);
+        void updateResultsCountUnknown();
         void updateCurrentFormViewRow();
         void setFormViewEnabled(bool enabled);
         void readData();
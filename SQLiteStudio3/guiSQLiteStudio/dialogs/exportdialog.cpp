@@ -205,6 +205,7 @@ void ExportDialog::initDbObjectsPage()
     connect(selectableDbListModel, SIGNAL(dataChanged(QModelIndex,QModelIndex)), ui->databaseObjectsPage, SIGNAL(completeChanged()));
     connect(ui->objectsSelectAllButton, SIGNAL(clicked()), this, SLOT(dbObjectsSelectAll()));
     connect(ui->objectsDeselectAllButton, SIGNAL(clicked()), this, SLOT(dbObjectsDeselectAll()));
+    connect(ui->exportDbDataCheck, SIGNAL(toggled(bool)), ui->exportDbParallelCheck, SLOT(setEnabled(bool)));
 }
 
 void ExportDialog::initFormatPage()
@@ -678,7 +679,10 @@ ExportManager::StandardExportConfig ExportDialog::getExportConfig() const
         stdConfig.outputFileName = ui->exportFileEdit->text();
 
     if (exportMode == ExportManager::DATABASE)
+    {
         stdConfig.exportData = ui->exportDbDataCheck->isChecked();
+        stdConfig.parallelTableExport = stdConfig.exportData && ui->exportDbParallelCheck->isChecked();
+    }
     else if (exportMode == ExportManager::TABLE)
         stdConfig.exportData = ui->exportTableDataCheck->isChecked();
     else
@@ -350,6 +350,7 @@ void ImportDialog::accept()
         stdConfig.codec = ui->codecCombo->currentText();
 
     stdConfig.ignoreErrors = ui->ignoreErrorsCheck->isChecked();
+    stdConfig.deferIndexes = ui->deferIndexesCheck->isChecked();
 
     Db* db = DBLIST->getByName(ui->dbNameCombo->currentText());;
     if (!db)
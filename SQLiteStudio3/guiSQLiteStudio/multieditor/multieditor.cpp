@@ -183,6 +183,38 @@ void MultiEditor::setValue(const QVariant& value)
     valueModified = false;
 }
 
+bool MultiEditor::setValueDevice(QIODevice* device)
+{
+    QList<MultiEditorWidget*> unsupportedEditors;
+    for (MultiEditorWidget* editorWidget : editors)
+    {
+        if (editorWidget->setValueDevice(device))
+            editorWidget->setUpToDate(true);
+        else
+            unsupportedEditors << editorWidget;
+    }
+
+    if (unsupportedEditors.size() == editors.size())
+        return false;
+
+    for (MultiEditorWidget* editorWidget : unsupportedEditors)
+    {
+        editors.removeOne(editorWidget);
+        tabs->removeTab(tabs->indexOf(editorWidget));
+        delete editorWidget;
+    }
+
+    // Not going through nullStateChanged(), as it would replace the value in editors
+    nullCheck->blockSignals(true);
+    nullCheck->setChecked(false);
+    nullCheck->blockSignals(false);
+    tabs->setEnabled(true);
+    valueBeforeNull.clear();
+    updateVisibility();
+    valueModified = false;
+    return true;
+}
+
 QVariant MultiEditor::getValue() const
 {
     if (nullCheck->isChecked())
@@ -191,6 +223,16 @@ QVariant MultiEditor::getValue() const
     return getValueOmmitNull();
 }
 
+bool MultiEditor::writeValue(QIODevice* device, QString& errorText)
+{
+    return dynamic_cast<MultiEditorWidget*>(tabs->currentWidget())->writeValue(device, errorText);
+}
+
+bool MultiEditor::isNull() const
+{
+    return nullCheck->isChecked();
+}
+
 bool MultiEditor::isModified() const
 {
     return valueModified;
@@ -12,6 +12,7 @@ class MultiEditorWidget;
 class QLabel;
 class MultiEditorWidgetPlugin;
 class QToolButton;
+class QIODevice;
 
 class GUI_API_EXPORT MultiEditor : public QWidget
 {
@@ -37,7 +38,28 @@ class GUI_API_EXPORT MultiEditor : public QWidget
         void showTab(int idx);
 
         void setValue(const QVariant& value);
+
+        /**
+         * @brief Sets device to read the value from, instead of loading the value into the memory.
+         * @param device Opened device with the value. It has to remain valid as long as this editor is used.
+         * @return true if any of editors supports the device, false otherwise.
+         *
+         * Editors that don't support devices (see MultiEditorWidget::setValueDevice()) are removed,
+         * unless none of editors supports it. In that case nothing is changed and the value has to be set with setValue().
+         */
+        bool setValueDevice(QIODevice* device);
         QVariant getValue() const;
+
+        /**
+         * @brief Writes the value to the device, instead of reading it with getValue().
+         * @param device Device opened for writing.
+         * @param errorText Description of the failure, if any.
+         * @return true on success, false otherwise.
+         *
+         * It's meant for values set with setValueDevice(). NULL value is not written, so check isNull() first.
+         */
+        bool writeValue(QIODevice* device, QString& errorText);
+        bool isNull() const;
         bool isModified() const;
         bool eventFilter(QObject* obj, QEvent* event);
         bool getReadOnly() const;
@@ -33,11 +33,31 @@ void MultiEditorDialog::setValue(const QVariant& value)
     multiEditor->setValue(value);
 }
 
+bool MultiEditorDialog::setValueDevice(QIODevice* device)
+{
+    return multiEditor->setValueDevice(device);
+}
+
 QVariant MultiEditorDialog::getValue()
 {
     return multiEditor->getValue();
 }
 
+bool MultiEditorDialog::writeValue(QIODevice* device, QString& errorText)
+{
+    return multiEditor->writeValue(device, errorText);
+}
+
+bool MultiEditorDialog::isNull() const
+{
+    return multiEditor->isNull();
+}
+
+bool MultiEditorDialog::isModified() const
+{
+    return multiEditor->isModified();
+}
+
 void MultiEditorDialog::setDataType(const DataType& dataType)
 {
     multiEditor->setDataType(dataType);
@@ -7,6 +7,7 @@
 
 class MultiEditor;
 class QDialogButtonBox;
+class QIODevice;
 
 class GUI_API_EXPORT MultiEditorDialog : public QDialog
 {
@@ -16,7 +17,11 @@ class GUI_API_EXPORT MultiEditorDialog : public QDialog
         ~MultiEditorDialog();
 
         void setValue(const QVariant& value);
+        bool setValueDevice(QIODevice* device);
         QVariant getValue();
+        bool writeValue(QIODevice* device, QString& errorText);
+        bool isNull() const;
+        bool isModified() const;
 
         void setDataType(const DataType& dataType);
         void setReadOnly(bool readOnly);
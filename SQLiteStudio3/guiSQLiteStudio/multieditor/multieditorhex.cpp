@@ -24,6 +24,20 @@ void MultiEditorHex::setValue(const QVariant& value)
     hexEdit->setData(value.toByteArray());
 }
 
+bool MultiEditorHex::setValueDevice(QIODevice* device)
+{
+    return hexEdit->setData(*device);
+}
+
+bool MultiEditorHex::writeValue(QIODevice* device, QString& errorText)
+{
+    if (hexEdit->write(*device))
+        return true;
+
+    errorText = hexEdit->errorString();
+    return false;
+}
+
 QVariant MultiEditorHex::getValue()
 {
     return hexEdit->data();
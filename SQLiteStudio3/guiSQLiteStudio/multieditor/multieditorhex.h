@@ -22,6 +22,8 @@ class GUI_API_EXPORT MultiEditorHex : public MultiEditorWidget
         void setReadOnly(bool value);
         QString getTabLabel();
         void focusThisWidget();
+        bool setValueDevice(QIODevice* device);
+        bool writeValue(QIODevice* device, QString& errorText);
 
         QList<QWidget*> getNoScrollWidgets();
 
@@ -1,4 +1,5 @@
 #include "multieditorwidget.h"
+#include "common/unused.h"
 
 MultiEditorWidget::MultiEditorWidget(QWidget *parent) :
     QWidget(parent)
@@ -12,6 +13,19 @@ void MultiEditorWidget::installEventFilter(QObject* filterObj)
         w->installEventFilter(filterObj);
 }
 
+bool MultiEditorWidget::setValueDevice(QIODevice* device)
+{
+    UNUSED(device);
+    return false;
+}
+
+bool MultiEditorWidget::writeValue(QIODevice* device, QString& errorText)
+{
+    UNUSED(device);
+    errorText = tr("This editor cannot write the value in portions.");
+    return false;
+}
+
 bool MultiEditorWidget::isUpToDate() const
 {
     return upToDate;
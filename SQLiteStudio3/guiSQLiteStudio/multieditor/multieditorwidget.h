@@ -4,6 +4,8 @@
 #include "guiSQLiteStudio_global.h"
 #include <QWidget>
 
+class QIODevice;
+
 class GUI_API_EXPORT MultiEditorWidget : public QWidget
 {
     Q_OBJECT
@@ -18,6 +20,28 @@ class GUI_API_EXPORT MultiEditorWidget : public QWidget
         virtual QString getTabLabel() = 0;
         virtual void focusThisWidget() = 0;
 
+        /**
+         * @brief Sets device to read the value from, instead of setValue().
+         * @param device Opened device providing the value.
+         * @return true if the editor can work with the device, false otherwise.
+         *
+         * It's used for values too large to be loaded into the memory at once. The editor should read
+         * only parts of the value that it currently needs. The device remains valid as long as the editor is used.
+         * Default implementation doesn't support devices and returns false.
+         */
+        virtual bool setValueDevice(QIODevice* device);
+
+        /**
+         * @brief Writes the value to the device, instead of getValue().
+         * @param device Device opened for writing.
+         * @param errorText Description of the failure, if any.
+         * @return true on success, false if writing failed, or the editor doesn't support devices.
+         *
+         * It's a counterpart of setValueDevice(), so the value edited from the device is never loaded into the memory at once.
+         * Default implementation doesn't support devices and returns false.
+         */
+        virtual bool writeValue(QIODevice* device, QString& errorText);
+
         void installEventFilter(QObject* filterObj);
 
         bool isUpToDate() const;
@@ -114,11 +114,26 @@ void QHexEdit::setData(const QByteArray &data)
     qHexEdit_p->setData(data);
 }
 
+bool QHexEdit::setData(QIODevice &device)
+{
+    return qHexEdit_p->setData(device);
+}
+
 QByteArray QHexEdit::data()
 {
     return qHexEdit_p->data();
 }
 
+bool QHexEdit::write(QIODevice &device)
+{
+    return qHexEdit_p->write(device);
+}
+
+QString QHexEdit::errorString()
+{
+    return qHexEdit_p->errorString();
+}
+
 void QHexEdit::setAddressAreaColor(const QColor &color)
 {
     qHexEdit_p->setAddressAreaColor(color);
@@ -34,9 +34,10 @@ content for the editor. You can search data inside the content with indexOf()
 and lastIndexOf(). The replace() function is to change located subdata. This
 'replaced' data can also be undone by the undo/redo framework.
 
-This widget can only handle small amounts of data. The size has to be below 10
-megabytes, otherwise the scroll sliders ard not shown and you can't scroll any
-more.
+Large data should be given as a QIODevice (setData(QIODevice&)). It's read
+in chunks only when shown, and only modified chunks are kept in memory. Use
+write() to save the content back in chunks. When the content is too high to be
+scrolled by pixels, the vertical scroll bar scrolls by lines.
 */
 class GUI_API_EXPORT QHexEdit : public QScrollArea
 {
@@ -144,6 +145,24 @@ public:
     */
     void replace( int pos, int len, const QByteArray & after);
 
+    /*! Sets the device as the source of data. The device is read only when the data
+    is shown, so it has to stay open (and not be modified by anyone else) as long as
+    the content is edited. Returns false if the device could not be opened for reading.
+    */
+    bool setData(QIODevice &device);
+
+    /*! Writes the content to the device, in chunks. Returns false if writing failed,
+    or if the content could not be read from the device given to setData().
+    See errorString() for details.
+    */
+    bool write(QIODevice &device);
+
+    /*! Returns description of the last failure of reading the content from the device
+    given to setData(), or of writing it with write(). Returns empty string if there
+    was no failure. Parts of the content that could not be read are shown as zeros.
+    */
+    QString errorString();
+
     /*! Gives back a formatted image of the content of QHexEdit
     */
     QString toReadableString();
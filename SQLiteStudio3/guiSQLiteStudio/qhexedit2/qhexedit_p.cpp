@@ -1,5 +1,6 @@
 #include <QtGui>
 #include <QApplication>
+#include <QScrollBar>
 
 #include "qhexedit_p.h"
 #include "commands.h"
@@ -8,12 +9,14 @@ const int HEXCHARS_IN_LINE = 47;
 const int GAP_ADR_HEX = 10;
 const int GAP_HEX_ASCII = 16;
 const int BYTES_PER_LINE = 16;
+const int MAX_SCROLL_HEIGHT = 1000000;
 
 QHexEditPrivate::QHexEditPrivate(QScrollArea *parent) : QWidget(parent)
 {
     _undoStack = new QUndoStack(this);
 
     _scrollArea = parent;
+    _firstLine = 0;
     setAddressWidth(4);
     setAddressOffset(0);
     setAddressArea(true);
@@ -34,6 +37,8 @@ QHexEditPrivate::QHexEditPrivate(QScrollArea *parent) : QWidget(parent)
     connect(&_cursorTimer, SIGNAL(timeout()), this, SLOT(updateCursor()));
     _cursorTimer.setInterval(500);
     _cursorTimer.start();
+
+    connect(_scrollArea->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(updateFirstLine(int)));
 }
 
 void QHexEditPrivate::setAddressOffset(int offset)
@@ -51,15 +56,36 @@ void QHexEditPrivate::setData(const QByteArray &data)
 {
     _xData.setData(data);
     _undoStack->clear();
+    _firstLine = 0;
     adjust();
     setCursorPos(0);
 }
 
+bool QHexEditPrivate::setData(QIODevice &device)
+{
+    bool ok = _xData.setIODevice(device);
+    _undoStack->clear();
+    _firstLine = 0;
+    adjust();
+    setCursorPos(0);
+    return ok;
+}
+
 QByteArray QHexEditPrivate::data()
 {
     return _xData.data();
 }
 
+bool QHexEditPrivate::write(QIODevice &device)
+{
+    return _xData.write(device);
+}
+
+QString QHexEditPrivate::errorString()
+{
+    return _xData.errorString();
+}
+
 void QHexEditPrivate::setAddressAreaColor(const QColor &color)
 {
     _addressAreaColor = color;
@@ -110,9 +136,9 @@ XByteArray & QHexEditPrivate::xData()
 
 int QHexEditPrivate::indexOf(const QByteArray & ba, int from)
 {
-    if (from > (_xData.data().length() - 1))
-        from = _xData.data().length() - 1;
-    int idx = _xData.data().indexOf(ba, from);
+    if (from > (_xData.size() - 1))
+        from = _xData.size() - 1;
+    int idx = _xData.indexOf(ba, from);
     if (idx > -1)
     {
         int curPos = idx*2;
@@ -155,7 +181,7 @@ int QHexEditPrivate::lastIndexOf(const QByteArray & ba, int from)
     from -= ba.length();
     if (from < 0)
         from = 0;
-    int idx = _xData.data().lastIndexOf(ba, from);
+    int idx = _xData.lastIndexOf(ba, from);
     if (idx > -1)
     {
         int curPos = idx*2;
@@ -302,8 +328,7 @@ QString QHexEditPrivate::selectionToReadableString()
 void QHexEditPrivate::keyPressEvent(QKeyEvent *event)
 {
     int charX = (_cursorX - _xPosHex) / _charWidth;
-    int posX = (charX / 3) * 2 + (charX % 3);
-    int posBa = (_cursorY / _charHeight) * BYTES_PER_LINE + posX / 2;
+    int posBa = _cursorPosition / 2;
 
 
 /*****************************************************************************/
@@ -459,7 +484,7 @@ if (!_readOnly)
             // Change content
             if (_xData.size() > 0)
             {
-                QByteArray hexValue = _xData.data().mid(posBa, 1).toHex();
+                QByteArray hexValue = _xData.data(posBa, 1).toHex();
                 if ((charX % 3) == 0)
                     hexValue[0] = key;
                 else
@@ -476,9 +501,10 @@ if (!_readOnly)
         if (event->matches(QKeySequence::Cut))
         {
             QString result = QString();
+            QByteArray selected = _xData.data(getSelectionBegin(), getSelectionEnd() - getSelectionBegin());
             for (int idx = getSelectionBegin(); idx < getSelectionEnd(); idx++)
             {
-                result += _xData.data().mid(idx, 1).toHex() + " ";
+                result += selected.mid(idx - getSelectionBegin(), 1).toHex() + " ";
                 if ((idx % 16) == 15)
                     result.append("\n");
             }
@@ -558,9 +584,10 @@ if (!_readOnly)
     if (event->matches(QKeySequence::Copy))
     {
         QString result = QString();
+        QByteArray selected = _xData.data(getSelectionBegin(), getSelectionEnd() - getSelectionBegin());
         for (int idx = getSelectionBegin(); idx < getSelectionEnd(); idx++)
         {
-            result += _xData.data().mid(idx, 1).toHex() + " ";
+            result += selected.mid(idx - getSelectionBegin(), 1).toHex() + " ";
             if ((idx % 16) == 15)
                 result.append('\n');
         }
@@ -616,13 +643,18 @@ void QHexEditPrivate::paintEvent(QPaintEvent *event)
     painter.setPen(this->palette().color(QPalette::WindowText));
 
     // calc position
-    int firstLineIdx = ((event->rect().top()/ _charHeight) - _charHeight) * BYTES_PER_LINE;
-    if (firstLineIdx < 0)
-        firstLineIdx = 0;
-    int lastLineIdx = ((event->rect().bottom() / _charHeight) + _charHeight) * BYTES_PER_LINE;
+    int firstLine = yToLine(event->rect().top()) - 1;
+    if (firstLine < 0)
+        firstLine = 0;
+    int firstLineIdx = firstLine * BYTES_PER_LINE;
+    int lastLineIdx = (yToLine(event->rect().bottom()) + 2) * BYTES_PER_LINE;
     if (lastLineIdx > _xData.size())
         lastLineIdx = _xData.size();
-    int yPosStart = ((firstLineIdx) / BYTES_PER_LINE) * _charHeight + _charHeight;
+    int yPosStart = lineToY(firstLine) + _charHeight;
+
+    // only the painted part of data is read
+    QByteArray changedBa;
+    QByteArray dataBa = _xData.data(firstLineIdx, lastLineIdx - firstLineIdx, &changedBa);
 
     // paint address area
     if (_addressArea)
@@ -636,7 +668,7 @@ void QHexEditPrivate::paintEvent(QPaintEvent *event)
     }
 
     // paint hex area
-    QByteArray hexBa(_xData.data().mid(firstLineIdx, lastLineIdx - firstLineIdx + 1).toHex());
+    QByteArray hexBa(dataBa.toHex());
     QBrush highLighted = QBrush(_highlightingColor);
     QPen colHighlighted = QPen(this->palette().color(QPalette::WindowText));
     QBrush selected = QBrush(_selectionColor);
@@ -663,7 +695,7 @@ void QHexEditPrivate::paintEvent(QPaintEvent *event)
                 {
                     // hilight diff bytes
                     painter.setBackground(highLighted);
-                    if (_xData.dataChanged(posBa))
+                    if (changedBa[posBa - firstLineIdx])
                     {
                         painter.setPen(colHighlighted);
                         painter.setBackgroundMode(Qt::OpaqueMode);
@@ -713,7 +745,10 @@ void QHexEditPrivate::paintEvent(QPaintEvent *event)
                     painter.setBackgroundMode(Qt::TransparentMode);
                 }
 
-                painter.drawText(xPosAscii, yPos, _xData.asciiChar(lineIdx + colIdx));
+                char ch = dataBa[lineIdx + colIdx - firstLineIdx];
+                if ((ch < 0x20) or (ch > 0x7e))
+                    ch = '.';
+                painter.drawText(xPosAscii, yPos, QChar(ch));
                 xPosAscii += _charWidth;
             }
         }
@@ -758,7 +793,7 @@ void QHexEditPrivate::setCursorPos(int position)
 
     // calc position
     _cursorPosition = position;
-    _cursorY = (position / (2 * BYTES_PER_LINE)) * _charHeight + 4;
+    _cursorY = lineToY(position / (2 * BYTES_PER_LINE)) + 4;
     int x = (position % (2 * BYTES_PER_LINE));
     _cursorX = (((x / 2) * 3) + (x % 2)) * _charWidth + _xPosHex;
 
@@ -779,7 +814,7 @@ int QHexEditPrivate::cursorPos(QPoint pos)
             x = (x / 3) * 2;
         else
             x = ((x / 3) * 2) + 1;
-        int y = ((pos.y() - 3) / _charHeight) * 2 * BYTES_PER_LINE;
+        int y = yToLine(pos.y() - 3) * 2 * BYTES_PER_LINE;
         result = x + y;
     }
     return result;
@@ -853,6 +888,17 @@ void QHexEditPrivate::updateCursor()
     update(_cursorX, _cursorY, _charWidth, _charHeight);
 }
 
+void QHexEditPrivate::updateFirstLine(int value)
+{
+    if (!isScaled())
+        return;
+
+    int maximum = _scrollArea->verticalScrollBar()->maximum();
+    _firstLine = (maximum > 0) ? int(qint64(value) * maxFirstLine() / maximum) : 0;
+    setCursorPos(_cursorPosition);
+    update();
+}
+
 void QHexEditPrivate::adjust()
 {
     _charWidth = fontMetrics().width(QLatin1Char('9'));
@@ -866,7 +912,9 @@ void QHexEditPrivate::adjust()
     _xPosAscii = _xPosHex + HEXCHARS_IN_LINE * _charWidth + GAP_HEX_ASCII;
 
     // tell QAbstractScollbar, how big we are
-    setMinimumHeight(((_xData.size()/16 + 1) * _charHeight) + 5);
+    setMinimumHeight(qMin(((_xData.size()/16 + 1) * _charHeight) + 5, MAX_SCROLL_HEIGHT));
+    if (_firstLine > maxFirstLine())
+        _firstLine = maxFirstLine();
     if(_asciiArea)
         setMinimumWidth(_xPosAscii + (BYTES_PER_LINE * _charWidth));
     else
@@ -879,5 +927,50 @@ void QHexEditPrivate::ensureVisible()
 {
     // scrolls to cursorx, cusory (which are set by setCursorPos)
     // x-margin is 3 pixels, y-margin is half of charHeight
+    if (isScaled())
+    {
+        // lines are scrolled by moving first visible line, the scrollbar only follows it
+        int line = _cursorPosition / (2 * BYTES_PER_LINE);
+        int visibleLines = qMax(1, _scrollArea->viewport()->height() / _charHeight - 1);
+        if (line < _firstLine)
+            _firstLine = line;
+        else if (line >= (_firstLine + visibleLines))
+            _firstLine = qMin(line - visibleLines + 1, maxFirstLine());
+
+        QScrollBar *scrollBar = _scrollArea->verticalScrollBar();
+        scrollBar->blockSignals(true);
+        scrollBar->setValue(int(qint64(_firstLine) * scrollBar->maximum() / qMax(1, maxFirstLine())));
+        scrollBar->blockSignals(false);
+        setCursorPos(_cursorPosition);
+        update();
+    }
     _scrollArea->ensureVisible(_cursorX, _cursorY + _charHeight/2, 3, _charHeight/2 + 2);
 }
+
+bool QHexEditPrivate::isScaled()
+{
+    return (((_xData.size()/16 + 1) * qint64(_charHeight)) + 5) > MAX_SCROLL_HEIGHT;
+}
+
+int QHexEditPrivate::maxFirstLine()
+{
+    int visibleLines = _scrollArea->viewport()->height() / _charHeight;
+    return qMax(0, _xData.size()/16 + 1 - visibleLines);
+}
+
+int QHexEditPrivate::lineToY(int line)
+{
+    if (!isScaled())
+        return line * _charHeight;
+
+    // -y() is the top of the visible part of this widget
+    return -y() + (line - _firstLine) * _charHeight;
+}
+
+int QHexEditPrivate::yToLine(int y)
+{
+    if (!isScaled())
+        return y / _charHeight;
+
+    return qMax(0, _firstLine + (y + this->y()) / _charHeight);
+}
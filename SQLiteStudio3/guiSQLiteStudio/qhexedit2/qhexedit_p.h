@@ -26,7 +26,10 @@ public:
     int cursorPos();
 
     void setData(QByteArray const &data);
+    bool setData(QIODevice &device);
     QByteArray data();
+    bool write(QIODevice &device);
+    QString errorString();
 
     void setHighlightingColor(QColor const &color);
     QColor highlightingColor();
@@ -89,11 +92,18 @@ protected:
 
 private slots:
     void updateCursor();
+    void updateFirstLine(int value);
 
 private:
     void adjust();
     void ensureVisible();
 
+    // Content higher than the limit is scrolled by lines, not by pixels (see lineToY())
+    bool isScaled();
+    int maxFirstLine();
+    int lineToY(int line);
+    int yToLine(int y);
+
     QColor _addressAreaColor;
     QColor _highlightingColor;
     QColor _selectionColor;
@@ -121,6 +131,7 @@ private:
     int _selectionInit;                     // That's, where we pressed the mouse button
 
     int _size;
+    int _firstLine;                         // first visible line, used only when isScaled()
 };
 
 /** \endcond docNever */
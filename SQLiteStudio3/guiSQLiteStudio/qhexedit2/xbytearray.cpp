@@ -1,11 +1,16 @@
 #include "xbytearray.h"
 
+const int CHUNK_SIZE = 0x1000;
+const int BUFFER_SIZE = 0x10000;
+
 XByteArray::XByteArray()
 {
     _oldSize = -99;
     _addressNumbers = 4;
     _addressOffset = 0;
-
+    _size = 0;
+    _device = &_buffer;
+    _buffer.open(QIODevice::ReadOnly);
 }
 
 int XByteArray::addressOffset()
@@ -31,50 +36,143 @@ void XByteArray::setAddressWidth(int width)
     }
 }
 
-QByteArray & XByteArray::data()
+QByteArray XByteArray::data(int pos, int len, QByteArray *changed)
 {
-    return _data;
+    QByteArray result;
+    if (changed)
+        changed->clear();
+
+    if ((pos < 0) or (pos >= _size))
+        return result;
+
+    if ((len < 0) or ((pos + len) > _size))
+        len = _size - pos;
+
+    result.reserve(len);
+    int idx = chunkIndexBefore(pos);
+    while (len > 0)
+    {
+        int count;
+        if ((idx >= 0) and (pos < chunkEnd(idx)))
+        {
+            // modified data
+            const Chunk &chunk = _chunks[idx];
+            int chunkOfs = pos - chunk.absPos;
+            count = qMin(len, chunk.data.size() - chunkOfs);
+            result += chunk.data.mid(chunkOfs, count);
+            if (changed)
+                *changed += chunk.dataChanged.mid(chunkOfs, count);
+        }
+        else
+        {
+            // original data, up to the next chunk
+            int next = nextChunkPos(idx);
+            if (next <= pos)
+            {
+                idx++;
+                continue;
+            }
+            count = qMin(len, next - pos);
+            result += readDevice(devicePos(idx, pos), count);
+            if (changed)
+                *changed += QByteArray(count, char(0));
+        }
+        pos += count;
+        len -= count;
+    }
+    return result;
 }
 
 void XByteArray::setData(QByteArray data)
 {
-    _data = data;
-    _changedData = QByteArray(data.length(), char(0));
+    _buffer.close();
+    _buffer.setData(data);
+    _buffer.open(QIODevice::ReadOnly);
+    setIODevice(_buffer);
+}
+
+bool XByteArray::setIODevice(QIODevice &device)
+{
+    bool ok = device.isOpen() or device.open(QIODevice::ReadOnly);
+    _device = ok ? &device : &_buffer;
+    _chunks.clear();
+    _size = ok ? int(device.size()) : 0;
+    _errorString = ok ? QString() : device.errorString();
+    return ok;
+}
+
+bool XByteArray::write(QIODevice &device)
+{
+    // zeros shown in place of unreadable data must not be written as if they were the content
+    _errorString.clear();
+    for (int pos = 0; pos < _size; pos += BUFFER_SIZE)
+    {
+        QByteArray buffer = data(pos, BUFFER_SIZE);
+        if (!_errorString.isEmpty())
+            return false;
+
+        if (device.write(buffer) != buffer.size())
+        {
+            _errorString = device.errorString();
+            return false;
+        }
+    }
+    return true;
+}
+
+QString XByteArray::errorString()
+{
+    return _errorString;
+}
+
+char XByteArray::at(int i)
+{
+    QByteArray ba = data(i, 1);
+    return ba.isEmpty() ? char(0) : ba[0];
 }
 
 bool XByteArray::dataChanged(int i)
 {
-    return bool(_changedData[i]);
+    QByteArray changed = dataChanged(i, 1);
+    return !changed.isEmpty() and bool(changed[0]);
 }
 
 QByteArray XByteArray::dataChanged(int i, int len)
 {
-    return _changedData.mid(i, len);
+    QByteArray changed;
+    data(i, len, &changed);
+    return changed;
 }
 
 void XByteArray::setDataChanged(int i, bool state)
 {
-    _changedData[i] = char(state);
+    setDataChanged(i, QByteArray(1, char(state)));
 }
 
 void XByteArray::setDataChanged(int i, const QByteArray & state)
 {
-    int length = state.length();
-    int len;
-    if ((i + length) > _changedData.length())
-        len = _changedData.length() - i;
-    else
-        len = length;
-    _changedData.replace(i, len, state);
+    int len = state.length();
+    if ((i + len) > _size)
+        len = _size - i;
+
+    int done = 0;
+    while (done < len)
+    {
+        Chunk &chunk = _chunks[loadChunk(i + done, false)];
+        int chunkOfs = i + done - chunk.absPos;
+        int count = qMin(len - done, chunk.data.size() - chunkOfs);
+        chunk.dataChanged.replace(chunkOfs, count, state.constData() + done, count);
+        done += count;
+    }
 }
 
 int XByteArray::realAddressNumbers()
 {
-    if (_oldSize != _data.size())
+    if (_oldSize != _size)
     {
         // is addressNumbers wide enought?
         QString test = QString("%1")
-                      .arg(_data.size() + _addressOffset, _addressNumbers, 16, QChar('0'));
+                      .arg(_size + _addressOffset, _addressNumbers, 16, QChar('0'));
         _realAddressNumbers = test.size();
     }
     return _realAddressNumbers;
@@ -82,58 +180,134 @@ int XByteArray::realAddressNumbers()
 
 int XByteArray::size()
 {
-    return _data.size();
+    return _size;
 }
 
-QByteArray & XByteArray::insert(int i, char ch)
+int XByteArray::indexOf(const QByteArray & ba, int from)
 {
-    _data.insert(i, ch);
-    _changedData.insert(i, char(1));
-    return _data;
+    if (ba.isEmpty())
+        return -1;
+
+    // buffers overlap, so matches crossing the buffer boundary are found too
+    for (int pos = qMax(from, 0); pos < _size; pos += BUFFER_SIZE)
+    {
+        int idx = data(pos, BUFFER_SIZE + ba.size() - 1).indexOf(ba);
+        if (idx > -1)
+            return pos + idx;
+    }
+    return -1;
 }
 
-QByteArray & XByteArray::insert(int i, const QByteArray & ba)
+int XByteArray::lastIndexOf(const QByteArray & ba, int from)
 {
-    _data.insert(i, ba);
-    _changedData.insert(i, QByteArray(ba.length(), char(1)));
-    return _data;
+    if (ba.isEmpty())
+        return -1;
+
+    for (int end = qMin(from, _size - 1); end >= 0; end -= BUFFER_SIZE)
+    {
+        int start = qMax(0, end - BUFFER_SIZE + 1);
+        int idx = data(start, end - start + ba.size()).lastIndexOf(ba, end - start);
+        if (idx > -1)
+            return start + idx;
+    }
+    return -1;
 }
 
-QByteArray & XByteArray::remove(int i, int len)
+void XByteArray::insert(int i, char ch)
 {
-    _data.remove(i, len);
-    _changedData.remove(i, len);
-    return _data;
+    insert(i, QByteArray(1, ch));
 }
 
-QByteArray & XByteArray::replace(int index, char ch)
+void XByteArray::insert(int i, const QByteArray & ba)
 {
-    _data[index] = ch;
-    _changedData[index] = char(1);
-    return _data;
+    if ((i < 0) or (i > _size) or ba.isEmpty())
+        return;
+
+    int idx = loadChunk(i, true);
+    Chunk &chunk = _chunks[idx];
+    chunk.data.insert(i - chunk.absPos, ba);
+    chunk.dataChanged.insert(i - chunk.absPos, QByteArray(ba.length(), char(1)));
+    shiftChunks(idx + 1, ba.length());
+    _size += ba.length();
 }
 
-QByteArray & XByteArray::replace(int index, const QByteArray & ba)
+void XByteArray::remove(int i, int len)
+{
+    if ((i < 0) or (i >= _size))
+        return;
+
+    if ((i + len) > _size)
+        len = _size - i;
+
+    while (len > 0)
+    {
+        int count;
+        int idx = chunkIndexBefore(i);
+        if ((idx >= 0) and (i < chunkEnd(idx)))
+        {
+            Chunk &chunk = _chunks[idx];
+            int chunkOfs = i - chunk.absPos;
+            count = qMin(len, chunk.data.size() - chunkOfs);
+            chunk.data.remove(chunkOfs, count);
+            chunk.dataChanged.remove(chunkOfs, count);
+        }
+        else
+        {
+            // original data doesn't need to be read, it's enough to skip it in the device
+            Chunk chunk;
+            count = qMin(len, nextChunkPos(idx) - i);
+            chunk.absPos = i;
+            chunk.devPos = devicePos(idx, i);
+            chunk.devSize = count;
+            _chunks.insert(++idx, chunk);
+        }
+        shiftChunks(idx + 1, -count);
+        _size -= count;
+        len -= count;
+    }
+}
+
+void XByteArray::replace(int index, char ch)
+{
+    replace(index, 1, QByteArray(1, ch));
+}
+
+void XByteArray::replace(int index, const QByteArray & ba)
 {
     int len = ba.length();
-    return replace(index, len, ba);
+    replace(index, len, ba);
 }
 
-QByteArray & XByteArray::replace(int index, int length, const QByteArray & ba)
+void XByteArray::replace(int index, int length, const QByteArray & ba)
 {
     int len;
-    if ((index + length) > _data.length())
-        len = _data.length() - index;
+    if ((index + length) > _size)
+        len = _size - index;
     else
         len = length;
-    _data.replace(index, len, ba.mid(0, len));
-    _changedData.replace(index, len, QByteArray(len, char(1)));
-    return _data;
+
+    if (ba.length() < len)
+    {
+        remove(index, len);
+        insert(index, ba);
+        return;
+    }
+
+    int done = 0;
+    while (done < len)
+    {
+        Chunk &chunk = _chunks[loadChunk(index + done, false)];
+        int chunkOfs = index + done - chunk.absPos;
+        int count = qMin(len - done, chunk.data.size() - chunkOfs);
+        chunk.data.replace(chunkOfs, count, ba.constData() + done, count);
+        chunk.dataChanged.replace(chunkOfs, count, QByteArray(count, char(1)));
+        done += count;
+    }
 }
 
 QChar XByteArray::asciiChar(int index)
 {
-    char ch = _data[index];
+    char ch = at(index);
     if ((ch < 0x20) or (ch > 0x7e))
             ch = '.';
     return QChar(ch);
@@ -145,7 +319,7 @@ QString XByteArray::toRedableString(int start, int end)
     if (_addressNumbers > adrWidth)
         adrWidth = _addressNumbers;
     if (end < 0)
-        end = _data.size();
+        end = _size;
 
     QString result;
     for (int i=start; i < end; i += 16)
@@ -153,15 +327,98 @@ QString XByteArray::toRedableString(int start, int end)
         QString adrStr = QString("%1").arg(_addressOffset + i, adrWidth, 16, QChar('0'));
         QString hexStr;
         QString ascStr;
-        for (int j=0; j<16; j++)
+        QByteArray line = data(i, 16);
+        for (int j=0; j<line.size(); j++)
         {
-            if ((i + j) < _data.size())
-            {
-                hexStr.append(" ").append(_data.mid(i+j, 1).toHex());
-                ascStr.append(asciiChar(i+j));
-            }
+            char ch = line[j];
+            hexStr.append(" ").append(line.mid(j, 1).toHex());
+            ascStr.append(((ch < 0x20) or (ch > 0x7e)) ? QChar('.') : QChar(ch));
         }
         result += adrStr + " " + QString("%1").arg(hexStr, -48) + "  " + QString("%1").arg(ascStr, -17) + "\n";
     }
     return result;
 }
+
+int XByteArray::chunkIndexBefore(int pos)
+{
+    // index of the last chunk starting at or before pos, or -1
+    int low = 0;
+    int high = _chunks.size();
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if (_chunks[mid].absPos <= pos)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low - 1;
+}
+
+int XByteArray::chunkEnd(int idx)
+{
+    if (idx < 0)
+        return 0;
+
+    return _chunks[idx].absPos + _chunks[idx].data.size();
+}
+
+int XByteArray::nextChunkPos(int idx)
+{
+    if ((idx + 1) < _chunks.size())
+        return _chunks[idx + 1].absPos;
+
+    return _size;
+}
+
+int XByteArray::devicePos(int idx, int pos)
+{
+    // original data following the chunk continues right after bytes replaced by the chunk
+    if (idx < 0)
+        return pos;
+
+    const Chunk &chunk = _chunks[idx];
+    return chunk.devPos + chunk.devSize + pos - chunkEnd(idx);
+}
+
+int XByteArray::loadChunk(int pos, bool forInsert)
+{
+    int idx = chunkIndexBefore(pos);
+    int end = chunkEnd(idx);
+    if ((idx >= 0) and ((pos < end) or (forInsert and (pos == end))))
+        return idx;
+
+    Chunk chunk;
+    chunk.absPos = qMax(end, pos - pos % CHUNK_SIZE);
+    chunk.devPos = devicePos(idx, chunk.absPos);
+    chunk.devSize = qMin(chunk.absPos + CHUNK_SIZE, nextChunkPos(idx)) - chunk.absPos;
+    chunk.data = readDevice(chunk.devPos, chunk.devSize);
+    chunk.dataChanged = QByteArray(chunk.devSize, char(0));
+    _chunks.insert(idx + 1, chunk);
+    return idx + 1;
+}
+
+void XByteArray::shiftChunks(int fromIdx, int delta)
+{
+    for (int idx = fromIdx; idx < _chunks.size(); idx++)
+        _chunks[idx].absPos += delta;
+}
+
+QByteArray XByteArray::readDevice(int devPos, int len)
+{
+    QByteArray result;
+    if (_device->seek(devPos))
+        result = _device->read(len);
+
+    // the failure is reported with errorString(), zeros only keep the size consistent for rendering
+    if (result.size() < len)
+    {
+        _errorString = _device->errorString();
+        if (_errorString.isEmpty())
+            _errorString = QString("Could not read %1 bytes at position %2.").arg(len).arg(devPos);
+
+        result.append(QByteArray(len - result.size(), char(0)));
+    }
+
+    return result;
+}
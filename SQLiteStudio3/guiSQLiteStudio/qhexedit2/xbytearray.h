@@ -11,6 +11,10 @@ XByteArray comprehend the data itself and informations to store if it was
 changed. The QHexEdit component uses these informations to perform nice
 rendering of the data
 
+The data is read from a QIODevice (a QBuffer for data set as QByteArray)
+only when it's requested. Only chunks that were modified are kept in memory,
+so the content can be much larger than the available memory.
+
 XByteArray also provides some functionality to insert, replace and remove
 single chars and QByteArras. Additionally some functions support rendering
 and converting to readable strings.
@@ -26,8 +30,12 @@ public:
     int addressWidth();
     void setAddressWidth(int width);
 
-    QByteArray & data();
+    QByteArray data(int pos = 0, int len = -1, QByteArray *changed = 0);
     void setData(QByteArray data);
+    bool setIODevice(QIODevice &device);
+    bool write(QIODevice &device);
+    QString errorString();
+    char at(int i);
 
     bool dataChanged(int i);
     QByteArray dataChanged(int i, int len);
@@ -37,14 +45,17 @@ public:
     int realAddressNumbers();
     int size();
 
-    QByteArray & insert(int i, char ch);
-    QByteArray & insert(int i, const QByteArray & ba);
+    int indexOf(const QByteArray & ba, int from);
+    int lastIndexOf(const QByteArray & ba, int from);
+
+    void insert(int i, char ch);
+    void insert(int i, const QByteArray & ba);
 
-    QByteArray & remove(int pos, int len);
+    void remove(int pos, int len);
 
-    QByteArray & replace(int index, char ch);
-    QByteArray & replace(int index, const QByteArray & ba);
-    QByteArray & replace(int index, int length, const QByteArray & ba);
+    void replace(int index, char ch);
+    void replace(int index, const QByteArray & ba);
+    void replace(int index, int length, const QByteArray & ba);
 
     QChar asciiChar(int index);
     QString toRedableString(int start=0, int end=-1);
@@ -54,8 +65,30 @@ signals:
 public slots:
 
 private:
-    QByteArray _data;
-    QByteArray _changedData;
+    /*! Part of the data copied from the device for modification. Bytes between
+    chunks were not modified and are read directly from the device. */
+    struct Chunk
+    {
+        QByteArray data;
+        QByteArray dataChanged;
+        int absPos;                         // position of the chunk in edited data
+        int devPos;                         // position of replaced bytes in the device
+        int devSize;                        // number of replaced bytes in the device
+    };
+
+    int chunkIndexBefore(int pos);
+    int chunkEnd(int idx);
+    int nextChunkPos(int idx);
+    int devicePos(int idx, int pos);
+    int loadChunk(int pos, bool forInsert);
+    void shiftChunks(int fromIdx, int delta);
+    QByteArray readDevice(int devPos, int len);
+
+    QBuffer _buffer;                        // device for data set as QByteArray
+    QIODevice *_device;
+    QString _errorString;                   // last failure of reading the device or writing the data
+    QList<Chunk> _chunks;
+    int _size;
 
     int _addressNumbers;                    // wanted width of address area
     int _addressOffset;                     // will be added to the real addres inside bytearray
@@ -80,6 +80,7 @@ CFG_CATEGORIES(Ui,
         CFG_ENTRY(bool,                  ShowRegularTableLabels,     false)
         CFG_ENTRY(bool,                  ShowVirtualTableLabels,     true)
         CFG_ENTRY(int,                   NumberOfRowsPerPage,        1000)
+        CFG_ENTRY(bool,                  ContinuousScrolling,        false)
         CFG_ENTRY(QString,               Style,                      &Cfg::getStyleDefaultValue)
         CFG_ENTRY(Cfg::Session,          Session,                    Cfg::Session())
         CFG_ENTRY(bool,                  RestoreSession,             true)
@@ -123,6 +123,7 @@ void FunctionsEditor::init()
     connect(ui->finalCodeEdit, SIGNAL(textChanged()), this, SLOT(updateModified()));
     connect(ui->nameEdit, SIGNAL(textChanged(QString)), this, SLOT(updateModified()));
     connect(ui->undefArgsCheck, SIGNAL(clicked()), this, SLOT(updateModified()));
+    connect(ui->deterministicCheck, SIGNAL(clicked()), this, SLOT(updateModified()));
     connect(ui->allDatabasesRadio, SIGNAL(clicked()), this, SLOT(updateModified()));
     connect(ui->selDatabasesRadio, SIGNAL(clicked()), this, SLOT(updateModified()));
     connect(ui->langCombo, SIGNAL(currentTextChanged(QString)), this, SLOT(updateModified()));
@@ -167,6 +168,7 @@ void FunctionsEditor::functionDeselected(int row)
     model->setLang(row, ui->langCombo->currentText());
     model->setType(row, getCurrentFunctionType());
     model->setUndefinedArgs(row, ui->undefArgsCheck->isChecked());
+    model->setDeterministic(row, ui->deterministicCheck->isChecked() && !model->isAggregate(row));
     model->setAllDatabases(row, ui->allDatabasesRadio->isChecked());
     model->setCode(row, ui->mainCodeEdit->toPlainText());
     model->setModified(row, currentModified);
@@ -199,6 +201,7 @@ void FunctionsEditor::functionSelected(int row)
     ui->mainCodeEdit->setPlainText(model->getCode(row));
     ui->finalCodeEdit->setPlainText(model->getFinalCode(row));
     ui->undefArgsCheck->setChecked(model->getUndefinedArgs(row));
+    ui->deterministicCheck->setChecked(model->getDeterministic(row));
     ui->langCombo->setCurrentText(model->getLang(row));
 
     // Arguments
@@ -243,6 +246,7 @@ void FunctionsEditor::clearEdits()
     ui->mainCodeEdit->setPlainText(QString::null);
     ui->langCombo->setCurrentText(QString::null);
     ui->undefArgsCheck->setChecked(true);
+    ui->deterministicCheck->setChecked(false);
     ui->argsList->clear();
     ui->allDatabasesRadio->setChecked(true);
     ui->typeCombo->setCurrentIndex(0);
@@ -369,13 +373,14 @@ void FunctionsEditor::updateModified()
         bool finalCodeDiff = model->getFinalCode(row) != ui->finalCodeEdit->toPlainText();
         bool langDiff = model->getLang(row) != ui->langCombo->currentText();
         bool undefArgsDiff = model->getUndefinedArgs(row) != ui->undefArgsCheck->isChecked();
+        bool deterministicDiff = model->getDeterministic(row) != ui->deterministicCheck->isChecked();
         bool allDatabasesDiff = model->getAllDatabases(row) != ui->allDatabasesRadio->isChecked();
         bool argDiff = getCurrentArgList() != model->getArguments(row);
         bool dbDiff = getCurrentDatabases().toSet() != model->getDatabases(row).toSet(); // QSet to ignore order
         bool typeDiff = model->getType(row) != getCurrentFunctionType();
 
         currentModified = (nameDiff || codeDiff || typeDiff || langDiff || undefArgsDiff || allDatabasesDiff || argDiff || dbDiff ||
-                           initCodeDiff || finalCodeDiff);
+                           initCodeDiff || finalCodeDiff || deterministicDiff);
     }
 
     updateCurrentFunctionState();
@@ -425,6 +430,7 @@ void FunctionsEditor::updateCurrentFunctionState()
     ui->initCodeGroup->setVisible(aggregate);
     ui->mainCodeGroup->setTitle(aggregate ? tr("Per step code:") : tr("Function implementation code:"));
     ui->finalCodeGroup->setVisible(aggregate);
+    ui->deterministicCheck->setEnabled(langOk && !aggregate);
 
     ui->databasesList->setEnabled(ui->selDatabasesRadio->isChecked());
 
@@ -140,6 +140,16 @@ void FunctionsEditorModel::setUndefinedArgs(int row, bool value)
     SETTER(functionList[row]->data.undefinedArgs, value);
 }
 
+bool FunctionsEditorModel::getDeterministic(int row) const
+{
+    GETTER(functionList[row]->data.deterministic, false);
+}
+
+void FunctionsEditorModel::setDeterministic(int row, bool value)
+{
+    SETTER(functionList[row]->data.deterministic, value);
+}
+
 bool FunctionsEditorModel::getAllDatabases(int row) const
 {
     GETTER(functionList[row]->data.allDatabases, true);
@@ -51,6 +51,8 @@ class GUI_API_EXPORT FunctionsEditorModel : public QAbstractListModel
         bool isScalar(int row) const;
         bool getUndefinedArgs(int row) const;
         void setUndefinedArgs(int row, bool value);
+        bool getDeterministic(int row) const;
+        void setDeterministic(int row, bool value);
         bool getAllDatabases(int row) const;
         void setAllDatabases(int row, bool value);
         void setData(const QList<FunctionManager::ScriptFunction*>& functions);
@@ -355,10 +355,16 @@ void TableWindow::executeStructureChanges()
     {
         DdlPreviewDialog dialog(db, this);
         dialog.setDdl(sqls);
+        if (existingTable && tableModifier)
+            dialog.setInfo(getStructureChangesCostInfo());
+
         if (dialog.exec() != QDialog::Accepted)
             return;
     }
 
+    // Results read in the background would keep the table locked and make DROP TABLE fail
+    dataModel->stopStreaming();
+
     modifyingThisTable = true;
     structureExecutor->setDb(db);
     structureExecutor->setQueries(sqls);
@@ -368,6 +374,22 @@ void TableWindow::executeStructureChanges()
     structureExecutor->exec();
 }
 
+QString TableWindow::getStructureChangesCostInfo() const
+{
+    qint64 rows = tableModifier->getEstimatedRowsToRewrite();
+    if (rows == 0 && !tableModifier->isRebuildRequired())
+        return tr("Changes will be made in place, without copying table data.", "table window");
+
+    QString msg = tableModifier->isRebuildRequired() ?
+                tr("Table data will be copied to a new table.", "table window") :
+                tr("Table data will be rewritten.", "table window");
+
+    if (rows < 0)
+        return msg + " " + tr("Number of affected rows could not be estimated.", "table window");
+
+    return msg + " " + tr("Estimated number of rows to rewrite: %1.", "table window").arg(rows);
+}
+
 void TableWindow::updateAfterInit()
 {
     updateStructureCommitState();
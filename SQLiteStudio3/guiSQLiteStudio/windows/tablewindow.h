@@ -150,6 +150,7 @@ class GUI_API_EXPORT TableWindow : public MdiChild
         void editConstraint(const QModelIndex& idx);
         void delConstraint(const QModelIndex& idx);
         void executeStructureChanges();
+        QString getStructureChangesCostInfo() const;
         void updateAfterInit();
         QModelIndex structureCurrentIndex() const;
         void addConstraint(ConstraintDialog::Constraint mode);
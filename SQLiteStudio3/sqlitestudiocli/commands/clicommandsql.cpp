@@ -97,24 +97,26 @@ void CliCommandSql::printResultsClassic(QueryExecutor* executor, SqlQueryPtr res
     qOut << "\n";
 
     // Data
-    SqlResultsRowPtr row;
-    QList<QVariant> values;
-    int i;
+    static const int batchSize = 1000;
+    int colCount;
     while (results->hasNext())
     {
-        row = results->next();
-        i = 0;
-        values = row->valueList().mid(0, resultColumnCount);
-        foreach (QVariant value, values)
+        const SqlResultsBlock& block = results->nextBatch(batchSize);
+        if (block.isEmpty())
+            break;
+
+        colCount = qMin(resultColumnCount, block.columnCount());
+        for (int row = 0; row < block.rowCount(); row++)
         {
-            qOut << getValueString(value);
-            if ((i + 1) < resultColumnCount)
-                qOut << "|";
+            for (int col = 0; col < colCount; col++)
+            {
+                qOut << getValueString(block.value(row, col));
+                if ((col + 1) < resultColumnCount)
+                    qOut << "|";
+            }
 
-            i++;
+            qOut << "\n";
         }
-
-        qOut << "\n";
     }
     qOut.flush();
 }